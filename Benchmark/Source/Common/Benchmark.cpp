@@ -0,0 +1,192 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#else
+#include <sys/resource.h>
+#endif
+
+static std::atomic<uint64_t> sAllocationCount = 0;
+static std::atomic<uint64_t> sAllocationBytes = 0;
+
+static void* Internal_Allocate(size_t size)
+{
+	sAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	sAllocationBytes.fetch_add(size, std::memory_order_relaxed);
+
+	void* ptr = std::malloc(size > 0 ? size : 1);
+	if (!ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(size_t size) { return Internal_Allocate(size); }
+void* operator new[](size_t size) { return Internal_Allocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { try { return Internal_Allocate(size); } catch (...) { return nullptr; } }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { try { return Internal_Allocate(size); } catch (...) { return nullptr; } }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+namespace Cosmos::Benchmark
+{
+	AllocationStats GetAllocationStats()
+	{
+		AllocationStats stats;
+		stats.count = sAllocationCount.load(std::memory_order_relaxed);
+		stats.bytes = sAllocationBytes.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	void ResetPeakMemory()
+	{
+		#if defined(__linux__)
+		// writting 5 into clear_refs resets VmHWM to the current resident size
+		std::ofstream clearRefs("/proc/self/clear_refs");
+		if (clearRefs.is_open()) clearRefs << "5";
+		#endif
+	}
+
+	uint64_t GetPeakMemory()
+	{
+		#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters = {};
+		GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+		return (uint64_t)counters.PeakWorkingSetSize;
+		#elif defined(__linux__)
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line)) {
+			if (line.rfind("VmHWM:", 0) == 0) return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+		}
+		return 0;
+		#else
+		struct rusage usage = {};
+		getrusage(RUSAGE_SELF, &usage);
+		return (uint64_t)usage.ru_maxrss; // bytes on macos
+		#endif
+	}
+
+	Options ParseOptions(int argc, char** argv, const std::vector<size_t>& defaultSizes)
+	{
+		Options options;
+		options.sizes = defaultSizes;
+
+		for (int i = 1; i < argc; i++) {
+			const char* arg = argv[i];
+			const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+			if (std::strcmp(arg, "--sizes") == 0 && value) {
+				options.sizes.clear();
+				for (const char* cur = value; *cur; ) {
+					char* end = nullptr;
+					size_t size = (size_t)std::strtoull(cur, &end, 10);
+					if (end == cur) break;
+					if (size > 0) options.sizes.push_back(size);
+					cur = *end == ',' ? end + 1 : end;
+				}
+				i++;
+			}
+
+			else if (std::strcmp(arg, "--iterations") == 0 && value) {
+				options.iterations = std::max(1, std::atoi(value));
+				i++;
+			}
+
+			else if (std::strcmp(arg, "--threads") == 0 && value) {
+				options.threads = (uint32_t)std::max(0, std::atoi(value));
+				i++;
+			}
+
+			else if (std::strcmp(arg, "--csv") == 0 && value) {
+				options.csvPath = value;
+				i++;
+			}
+
+			else {
+				std::printf("usage: %s [--sizes 1000,10000] [--iterations N] [--threads N] [--csv path]\n", argv[0]);
+				std::exit(1);
+			}
+		}
+
+		return options;
+	}
+
+	Result Run(const std::string& group, const std::string& name, size_t entities, uint32_t iterations, const std::function<uint64_t()>& fn, const std::function<void()>& reset)
+	{
+		Result best;
+		best.group = group;
+		best.name = name;
+		best.entities = entities;
+		best.milliseconds = -1.0;
+
+		for (uint32_t i = 0; i < std::max(1u, iterations); i++) {
+			if (reset) reset();
+
+			ResetPeakMemory();
+			AllocationStats before = GetAllocationStats();
+			auto begin = std::chrono::steady_clock::now();
+
+			uint64_t bytes = fn();
+
+			double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+			AllocationStats after = GetAllocationStats();
+			uint64_t peakMemory = GetPeakMemory();
+
+			if (best.milliseconds < 0.0 || milliseconds < best.milliseconds) {
+				best.bytes = bytes;
+				best.milliseconds = milliseconds;
+				best.allocations = after.count - before.count;
+				best.allocatedBytes = after.bytes - before.bytes;
+			}
+
+			best.peakMemory = std::max(best.peakMemory, peakMemory);
+		}
+
+		return best;
+	}
+
+	void PrintHeader(const char* title)
+	{
+		std::printf("\n%s\n", title);
+		std::printf("%-22s %-34s %10s %12s %10s %10s %14s %12s %12s %10s\n", "group", "case", "entities", "bytes", "ms", "MB/s", "entities/s", "allocs", "alloc MB", "peak MB");
+	}
+
+	void Report(const Result& result, const Options& options)
+	{
+		double seconds = result.milliseconds / 1000.0;
+		double megabytes = (double)result.bytes / (1024.0 * 1024.0);
+		double throughput = seconds > 0.0 && result.bytes > 0 ? megabytes / seconds : 0.0;
+		double entityRate = seconds > 0.0 ? (double)result.entities / seconds : 0.0;
+
+		std::printf("%-22s %-34s %10zu %12llu %10.3f %10.1f %14.0f %12llu %12.2f %10.1f\n",
+			result.group.c_str(), result.name.c_str(), result.entities, (unsigned long long)result.bytes, result.milliseconds, throughput, entityRate,
+			(unsigned long long)result.allocations, (double)result.allocatedBytes / (1024.0 * 1024.0), (double)result.peakMemory / (1024.0 * 1024.0));
+		std::fflush(stdout);
+
+		if (options.csvPath.empty()) return;
+
+		// appended, so runs of different builds/machines can be compared side by side
+		bool exists = std::ifstream(options.csvPath).good();
+		std::ofstream csv(options.csvPath, std::ios::app);
+		if (!exists) csv << "group,case,entities,bytes,ms,mb_per_s,entities_per_s,allocations,allocated_bytes,peak_bytes\n";
+
+		csv << result.group << "," << result.name << "," << result.entities << "," << result.bytes << "," << result.milliseconds << "," << throughput << ","
+			<< entityRate << "," << result.allocations << "," << result.allocatedBytes << "," << result.peakMemory << "\n";
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Cosmos::Benchmark
+{
+	/// @brief heap allocations made through operator new since the process started
+	struct AllocationStats
+	{
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+	};
+
+	/// @brief the measurements of a single benchmark case, taken from it's fastest iteration
+	struct Result
+	{
+		std::string name = {};
+		std::string group = {};
+		size_t entities = 0;
+		uint64_t bytes = 0;
+		double milliseconds = 0.0;
+		uint64_t allocations = 0;
+		uint64_t allocatedBytes = 0;
+		uint64_t peakMemory = 0;
+	};
+
+	/// @brief command line options shared by every benchmark
+	struct Options
+	{
+		std::vector<size_t> sizes = {};
+		uint32_t iterations = 3;
+		uint32_t threads = 0;
+		std::string csvPath = {};
+	};
+
+	/// @brief returns the allocation counters, they're incremented by the global operator new replaced in Benchmark.cpp
+	/// the engine is a shared library, on windows it's allocations are served by it's own runtime and aren't counted
+	AllocationStats GetAllocationStats();
+
+	/// @brief resets the peak resident memory, so each case reports it's own peak (linux only, elsewhere it's the process peak)
+	void ResetPeakMemory();
+
+	/// @brief returns the peak resident memory in bytes
+	uint64_t GetPeakMemory();
+
+	/// @brief parses --sizes 1000,10000 --iterations N --threads N --csv path, falling back to defaultSizes
+	Options ParseOptions(int argc, char** argv, const std::vector<size_t>& defaultSizes);
+
+	/// @brief runs a case iterations times, reset runs before every iteration and isn't measured, fn returns how many bytes it processed
+	Result Run(const std::string& group, const std::string& name, size_t entities, uint32_t iterations, const std::function<uint64_t()>& fn, const std::function<void()>& reset = {});
+
+	/// @brief prints the table header
+	void PrintHeader(const char* title);
+
+	/// @brief prints a result row and appends it to the csv file when one was given
+	void Report(const Result& result, const Options& options);
+}
@@ -0,0 +1,71 @@
+#include "Common/Benchmark.h"
+
+#include <Core/Application.h>
+#include <Scene/World.h>
+
+#include <cstdio>
+#include <random>
+
+using namespace Cosmos;
+
+/// @brief a headless application rendering a generated world, nothing but the engine runs on it's frames
+class FrameApplication : public Application
+{
+public:
+
+	FrameApplication(const ApplicationCreateInfo& ci, size_t entities)
+		: Application(ci)
+	{
+		std::mt19937 rng(1234);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+		World* world = GetRendererRef()->GetWorld();
+		for (size_t i = 0; i < entities; i++) world->CreateEntity("Entity", { position(rng), position(rng), position(rng) });
+	}
+
+protected:
+
+	virtual void Shutdown() override {}
+};
+
+/// @brief the allocations counted by the global operator new replaced in Benchmark.cpp, every thread of the process included
+static uint64_t CountAllocations()
+{
+	return Benchmark::GetAllocationStats().count;
+}
+
+// checks that steady-state frames don't touch the global heap: a headless run of --sizes N entities (the first size given)
+// fails when any measured frame allocated through operator new, jobs and std::function captures included
+int main(int argc, char** argv)
+{
+	Benchmark::Options options = Benchmark::ParseOptions(argc, argv, { 1000 });
+
+	ApplicationCreateInfo ci = {};
+	ci.appName = "Frame Benchmark";
+	ci.validations = false;
+	#if defined(_WIN32) || defined(_WIN64)
+	ci.assetsPath = "../data";
+	#else
+	ci.assetsPath = "data";
+	#endif
+	ci.headless = true;
+	ci.headlessWarmupFrames = 120;
+	ci.headlessFrames = 1000;
+	ci.allocationCounter = CountAllocations;
+
+	size_t entities = options.sizes.front();
+	FrameApplication app(ci, entities);
+	app.Run();
+
+	const FrameStatistics& statistics = app.GetHeadlessStatisticsRef();
+	FrameStatistics::Summary frames = statistics.Summarize(FrameStatistics::Frame);
+	std::printf("%zu entities, %zu frames: %zu frames allocated, %llu allocations, mean frame %.3fms\n",
+		entities, frames.samples, statistics.GetAllocatingFrames(), (unsigned long long)statistics.GetAllocations(), frames.mean * 1000.0);
+
+	if (statistics.GetAllocatingFrames() > 0) {
+		std::printf("FAILED: steady-state frames allocated from the global heap\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include "Common/Benchmark.h"
+
+#include <Util/ID.h>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+using namespace Cosmos;
+
+/// @brief the previous IDGenerator, a mutex around an unordered_set, kept as the baseline
+class MutexIDGenerator
+{
+public:
+
+	ID Create()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		uint32_t newId = ++mCounter;
+		mActiveIds.insert(newId);
+		return ID{ newId };
+	}
+
+	bool Destroy(ID id)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mActiveIds.erase(id.GetValue()) > 0;
+	}
+
+	bool IsValid(ID id) const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mActiveIds.find(id.GetValue()) != mActiveIds.end();
+	}
+
+private:
+
+	uint32_t mCounter = 0;
+	std::unordered_set<uint32_t> mActiveIds;
+	mutable std::mutex mMutex;
+};
+
+/// @brief how many ids each thread holds at once
+static constexpr size_t BATCH_SIZE = 256;
+
+/// @brief every thread repeatedly creates a batch of ids, validates them and destroys them, simulating entities spawned from workers
+template<typename Generator>
+static uint64_t Contend(Generator& generator, uint32_t threadCount, size_t operationsPerThread)
+{
+	std::vector<std::thread> threads;
+	std::atomic<uint64_t> invalid = 0;
+
+	for (uint32_t t = 0; t < threadCount; t++) {
+		threads.emplace_back([&generator, &invalid, operationsPerThread]() {
+			ID batch[BATCH_SIZE];
+			for (size_t done = 0; done < operationsPerThread; done += BATCH_SIZE) {
+				for (ID& id : batch) id = generator.Create();
+				for (ID& id : batch) if (!generator.IsValid(id)) invalid++;
+				for (ID& id : batch) generator.Destroy(id);
+			}
+			});
+	}
+
+	for (std::thread& thread : threads) thread.join();
+
+	if (invalid > 0) std::printf("%llu ids were invalid right after being created\n", (unsigned long long)invalid.load());
+	return 0;
+}
+
+/// @brief regression checks run before timing, an id recreated by value while in the free-list must not be pushed twice
+static bool Verify()
+{
+	IDGenerator generator(64);
+	ID a = generator.Create();
+	ID b = generator.Create();
+	generator.Destroy(a);
+	generator.Destroy(b);
+
+	// b is live again but still linked in the free-list, destroying it must not link it a second time
+	if (!generator.Create(b.GetValue()) || !generator.Destroy(b)) return false;
+
+	ID first = generator.Create();
+	ID second = generator.Create();
+	ID third = generator.Create();
+	if (first == second || first == third || second == third) return false;
+	if (first == ID::Null() || second == ID::Null() || third == ID::Null()) return false;
+
+	// the recycled ids come back exactly once, the third one is brand new
+	return (first == b || first == a) && (second == b || second == a) && third.GetValue() == 3;
+}
+
+int main(int argc, char** argv)
+{
+	if (!Verify()) {
+		std::printf("IDGenerator failed the free-list regression check\n");
+		return 1;
+	}
+
+	Benchmark::Options options = Benchmark::ParseOptions(argc, argv, { 1000000 });
+	uint32_t maxThreads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+	for (size_t operations : options.sizes) {
+		Benchmark::PrintHeader(("IDGenerator contention, " + std::to_string(operations) + " create/validate/destroy per thread").c_str());
+
+		for (uint32_t threads = 1; threads <= maxThreads; threads *= 2) {
+			std::string name = std::to_string(threads) + " thread(s)";
+			size_t total = operations * threads;
+
+			// generators are created outside of the measured region, only the contention is timed
+			std::unique_ptr<MutexIDGenerator> mutexGenerator;
+			Benchmark::Report(Benchmark::Run("mutex", name, total, options.iterations,
+				[&]() { return Contend(*mutexGenerator, threads, operations); },
+				[&]() { mutexGenerator = std::make_unique<MutexIDGenerator>(); }), options);
+
+			// twice every thread's batch, a destroyed id is briefly neither live nor recyclable while it's pushed back
+			std::unique_ptr<IDGenerator> lockFreeGenerator;
+			Benchmark::Report(Benchmark::Run("lock-free", name, total, options.iterations,
+				[&]() { return Contend(*lockFreeGenerator, threads, operations); },
+				[&]() { lockFreeGenerator = std::make_unique<IDGenerator>((uint32_t)(2 * BATCH_SIZE * threads)); }), options);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include "Common/Benchmark.h"
+
+#include <Util/Library.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+
+using namespace Cosmos;
+
+/// @brief the previous Library backing store, std::unordered_map behind the same interface, kept as the baseline
+template<typename Key, typename Value>
+class NodeLibrary
+{
+public:
+
+	inline bool Insert(const Key& key, Value value) { return mContent.emplace(key, std::move(value)).second; }
+
+	inline Value* TryGet(const Key& key)
+	{
+		auto it = mContent.find(key);
+		return it != mContent.end() ? &it->second : nullptr;
+	}
+
+	inline bool Erase(const Key& key) { return mContent.erase(key) > 0; }
+
+	inline auto begin() { return mContent.begin(); }
+	inline auto end() { return mContent.end(); }
+
+private:
+
+	std::unordered_map<Key, Value> mContent;
+};
+
+/// @brief the keys a case works on, entity ids are mostly sequential but random keys stress the hashing
+struct KeySet
+{
+	std::vector<uint32_t> keys;
+	std::vector<uint32_t> lookups; // the same keys in a shuffled order
+	std::vector<uint32_t> misses;
+};
+
+static KeySet GenerateKeys(size_t count, bool sequential)
+{
+	std::mt19937 rng(1234);
+	KeySet set;
+	set.keys.resize(count);
+
+	if (sequential) std::iota(set.keys.begin(), set.keys.end(), 1u);
+	else for (uint32_t& key : set.keys) key = rng() | 1u; // odd keys, so even keys are guaranteed misses
+
+	set.lookups = set.keys;
+	std::shuffle(set.lookups.begin(), set.lookups.end(), rng);
+
+	set.misses.resize(count);
+	for (size_t i = 0; i < count; i++) set.misses[i] = sequential ? (uint32_t)(count + i + 1) : (rng() & ~1u);
+
+	return set;
+}
+
+template<typename Map>
+static void BenchmarkMap(const char* group, const KeySet& set, const Benchmark::Options& options)
+{
+	size_t count = set.keys.size();
+	uint32_t iterations = count >= 1000000 ? std::min(options.iterations, 2u) : options.iterations;
+	std::unique_ptr<Map> map;
+	uint64_t sink = 0;
+
+	auto fill = [&]() {
+		map = std::make_unique<Map>();
+		for (uint32_t key : set.keys) map->Insert(key, (uint64_t)key);
+		};
+
+	auto report = [&](const char* name, const std::function<uint64_t()>& fn, const std::function<void()>& reset) {
+		Benchmark::Report(Benchmark::Run(group, name, count, iterations, fn, reset), options);
+		};
+
+	report("insert", [&]() {
+		for (uint32_t key : set.keys) map->Insert(key, (uint64_t)key);
+		return (uint64_t)0;
+		}, [&]() { map = std::make_unique<Map>(); });
+
+	fill();
+
+	report("lookup (hit)", [&]() {
+		for (uint32_t key : set.lookups) sink += *map->TryGet(key);
+		return (uint64_t)0;
+		}, {});
+
+	report("lookup (miss)", [&]() {
+		for (uint32_t key : set.misses) sink += map->TryGet(key) != nullptr;
+		return (uint64_t)0;
+		}, {});
+
+	report("iterate", [&]() {
+		for (auto& [key, value] : *map) sink += value;
+		return (uint64_t)0;
+		}, {});
+
+	report("erase", [&]() {
+		for (uint32_t key : set.lookups) sink += map->Erase(key);
+		return (uint64_t)0;
+		}, fill);
+
+	// an entity registry churns, erased ids are re-inserted later on
+	report("erase + reinsert half", [&]() {
+		for (size_t i = 0; i < count; i += 2) map->Erase(set.lookups[i]);
+		for (size_t i = 0; i < count; i += 2) map->Insert(set.lookups[i], (uint64_t)i);
+		return (uint64_t)0;
+		}, fill);
+
+	map.reset();
+	if (sink == 1) std::printf("\n"); // keeps the lookups from being optimized away
+}
+
+int main(int argc, char** argv)
+{
+	Benchmark::Options options = Benchmark::ParseOptions(argc, argv, { 1000, 10000, 100000, 1000000 });
+
+	for (size_t count : options.sizes) {
+		for (bool sequential : { true, false }) {
+			KeySet set = GenerateKeys(count, sequential);
+			Benchmark::PrintHeader(("Library<uint32_t, uint64_t> with " + std::to_string(count) + (sequential ? " sequential" : " random") + " keys").c_str());
+
+			BenchmarkMap<NodeLibrary<uint32_t, uint64_t>>("unordered_map", set, options);
+			BenchmarkMap<Library<uint32_t, uint64_t>>("flat map", set, options);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,211 @@
+#include "Common/Benchmark.h"
+
+#include <Scene/ComponentSerializer.h>
+#include <Scene/Entity.h>
+#include <Scene/SceneJournal.h>
+#include <Util/Datafile.h>
+#include <Util/Memory.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+
+using namespace Cosmos;
+
+/// @brief how the generated entities are composed
+enum class ComponentMix
+{
+	TransformOnly,
+	TransformAndEditor,
+	Random
+};
+
+static const char* ComponentMixName(ComponentMix mix)
+{
+	switch (mix)
+	{
+		case ComponentMix::TransformOnly: return "transform";
+		case ComponentMix::TransformAndEditor: return "transform+editor";
+		case ComponentMix::Random: return "random";
+	}
+	return "unknown";
+}
+
+/// @brief a set of entities living outside of any world
+struct SyntheticScene
+{
+	std::vector<std::string> names;
+	std::vector<Unique<Entity>> storage;
+	std::vector<Entity*> entities;
+
+	~SyntheticScene()
+	{
+		for (Entity* entity : entities) ComponentSerializer::RemoveAll(entity);
+	}
+
+	/// @brief returns the entity with id, ids are sequential starting at 1
+	Entity* Find(uint32_t id) const
+	{
+		return id > 0 && id <= entities.size() ? entities[id - 1] : nullptr;
+	}
+
+	/// @brief removes every component, so loads start from empty entities
+	void Clear()
+	{
+		for (Entity* entity : entities) ComponentSerializer::RemoveAll(entity);
+	}
+};
+
+/// @brief creates count entities, withComponents false creates empty entities to load into
+static void Generate(SyntheticScene& scene, size_t count, ComponentMix mix, bool withComponents)
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+	std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+	scene.names.reserve(count);
+	scene.storage.reserve(count);
+	scene.entities.reserve(count);
+
+	for (size_t i = 0; i < count; i++) {
+		uint32_t id = (uint32_t)i + 1;
+		scene.names.push_back("Entity " + std::to_string(id));
+		scene.storage.push_back(CreateUnique<Entity>(scene.names.back().c_str(), id));
+		scene.entities.push_back(scene.storage.back().get());
+
+		if (!withComponents) continue;
+
+		Entity* entity = scene.entities.back();
+		bool hasTransform = mix != ComponentMix::Random || chance(rng) < 0.8f;
+		bool hasEditor = mix == ComponentMix::TransformAndEditor || (mix == ComponentMix::Random && chance(rng) < 0.5f);
+
+		if (hasTransform) {
+			entity->AddComponent<TransformComponent>();
+			TransformComponent* transform = entity->GetComponent<TransformComponent>();
+			transform->translation = { position(rng), position(rng), position(rng) };
+			transform->rotation = { chance(rng) * 360.0f, chance(rng) * 360.0f, chance(rng) * 360.0f };
+			transform->scale = { 1.0f, 1.0f, 1.0f };
+		}
+
+		if (hasEditor) {
+			entity->AddComponent<EditorComponent>();
+			entity->GetComponent<EditorComponent>()->visible = chance(rng) < 0.9f;
+		}
+	}
+}
+
+static uint64_t FileSize(const std::filesystem::path& path)
+{
+	std::error_code ec;
+	uint64_t size = std::filesystem::file_size(path, ec);
+	return ec ? 0 : size;
+}
+
+static void BenchmarkScene(size_t count, ComponentMix mix, const Benchmark::Options& options, const std::filesystem::path& directory)
+{
+	const std::string group = std::string(ComponentMixName(mix));
+	uint32_t iterations = count >= 1000000 ? 1 : options.iterations;
+
+	SyntheticScene source;
+	SyntheticScene target;
+	Generate(source, count, mix, true);
+	Generate(target, count, mix, false);
+
+	auto report = [&](const char* name, const std::function<uint64_t()>& fn, const std::function<void()>& reset = {}) {
+		Benchmark::Report(Benchmark::Run(group, name, count, iterations, fn, reset), options);
+		};
+
+	auto resolve = [&target](uint32_t id) { return target.Find(id); };
+	auto clearTarget = [&target]() { target.Clear(); };
+
+	// text format, component save/load into a datafile and the datafile itself
+	const std::string textPath = (directory / "scene.txt").string();
+	const std::string compressedPath = (directory / "scene.txt.compressed").string();
+
+	// the whole text save, components into the datafile and the datafile onto the disk, the write alone is measured below
+	Datafile saved;
+	report("component save (text)", [&]() {
+		saved = Datafile();
+		for (Entity* entity : source.entities) ComponentSerializer::SaveText(entity, saved);
+		Datafile::Write(saved, textPath);
+		return FileSize(textPath);
+		});
+
+	report("datafile write", [&]() { Datafile::Write(saved, textPath); return FileSize(textPath); });
+	report("datafile write (compressed)", [&]() { Datafile::Write(saved, compressedPath, ',', true); return FileSize(compressedPath); });
+
+	Datafile loaded;
+	report("datafile read", [&]() { loaded = Datafile(); Datafile::Read(loaded, textPath); return FileSize(textPath); });
+	report("datafile read (compressed)", [&]() { Datafile compressed; Datafile::Read(compressed, compressedPath); return FileSize(compressedPath); });
+	report("datafile read (indexed)", [&]() { Datafile indexed; Datafile::ReadIndexed(indexed, textPath); return FileSize(textPath); });
+
+	report("component load (text)", [&]() {
+		for (size_t i = 0; i < loaded.GetChildrenCount(); i++) {
+			const std::string& name = loaded.GetChildName(i);
+			Entity* entity = target.Find((uint32_t)std::strtoul(name.c_str(), nullptr, 10));
+			if (entity) ComponentSerializer::LoadText(entity, loaded[name]);
+		}
+		return FileSize(textPath);
+		}, clearTarget);
+
+	saved = Datafile();
+	loaded = Datafile();
+
+	// binary component blocks
+	std::vector<uint8_t> binary;
+	report("component save (binary)", [&]() {
+		binary.clear();
+		ComponentSerializer::SaveBinary(source.entities, binary);
+		return (uint64_t)binary.size();
+		});
+
+	report("component load (binary)", [&]() {
+		ComponentSerializer::LoadBinary(binary.data(), binary.size(), resolve);
+		return (uint64_t)binary.size();
+		}, clearTarget);
+
+	// journaled scene, snapshot + incremental records
+	const std::string scenePath = (directory / "scene.bin").string();
+	SceneJournal journal;
+
+	report("journal snapshot write", [&]() {
+		journal.WriteSnapshot(scenePath, source.entities);
+		return FileSize(scenePath);
+		});
+
+	report("journal read", [&]() {
+		SceneJournal reader;
+		reader.Read(scenePath, [&target](uint32_t id, const char*) { return target.Find(id); }, [](uint32_t) {});
+		return FileSize(scenePath);
+		}, clearTarget);
+
+	std::vector<Entity*> modified;
+	for (size_t i = 0; i < source.entities.size(); i += 100) modified.push_back(source.entities[i]);
+
+	report("journal append (1% dirty)", [&]() {
+		uint64_t before = journal.GetJournalSize();
+		journal.Append(modified, {});
+		return journal.GetJournalSize() - before;
+		}, [&]() { journal.WriteSnapshot(scenePath, source.entities); });
+
+	journal.WaitCompaction();
+}
+
+int main(int argc, char** argv)
+{
+	Benchmark::Options options = Benchmark::ParseOptions(argc, argv, { 1000, 10000, 100000, 1000000 });
+
+	std::error_code ec;
+	std::filesystem::path directory = std::filesystem::temp_directory_path(ec) / "cosmos_serialization_benchmark";
+	std::filesystem::create_directories(directory, ec);
+
+	for (size_t count : options.sizes) {
+		for (ComponentMix mix : { ComponentMix::TransformOnly, ComponentMix::TransformAndEditor, ComponentMix::Random }) {
+			Benchmark::PrintHeader(("Scene with " + std::to_string(count) + " entities, " + ComponentMixName(mix) + " components").c_str());
+			BenchmarkScene(count, mix, options, directory);
+		}
+	}
+
+	std::filesystem::remove_all(directory, ec);
+	return 0;
+}
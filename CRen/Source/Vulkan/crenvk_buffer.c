@@ -1,6 +1,7 @@
 #include "Vulkan/crenvk_buffer.h"
 
 #include "cren_error.h"
+#include "cren_memory.h"
 #include "Vulkan/crenvk_core.h"
 #include <memm/memm.h>
 #include <string.h>
@@ -14,32 +15,27 @@ CREN_API vkBuffer* crenvk_buffer_create(VkDevice device, VkPhysicalDevice physic
         return NULL;
     }
 
-    vkBuffer* buffer = (vkBuffer*)malloc(sizeof(vkBuffer));
-    if (!buffer) {
+    // the buffer and it's per-frame arrays share one block, 8 bytes aligned arrays first and the flags last
+    size_t headerSize = (sizeof(vkBuffer) + 15) & ~(size_t)15;
+    size_t blockSize = headerSize + (sizeof(VkBuffer) + sizeof(VkDeviceMemory) + sizeof(void*) + sizeof(bool)) * frameCount;
+    uint8_t* block = (uint8_t*)cren_memory_alloc(CREN_MEMORY_TAG_BUFFERS, blockSize);
+    if (!block) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate buffer structure");
         return NULL;
     }
 
+    memset(block, 0, blockSize);
+    vkBuffer* buffer = (vkBuffer*)block;
+    buffer->buffers = (VkBuffer*)(block + headerSize);
+    buffer->memories = (VkDeviceMemory*)(buffer->buffers + frameCount);
+    buffer->mappedPointers = (void**)(buffer->memories + frameCount);
+    buffer->isMapped = (bool*)(buffer->mappedPointers + frameCount);
+
     buffer->size = size;
     buffer->usage = usage;
     buffer->memoryProperties = memoryProperties;
     buffer->frameCount = frameCount;
-
-    // allocate arrays for per-frame resources
-    buffer->buffers = (VkBuffer*)malloc(sizeof(VkBuffer) * frameCount);
-    buffer->memories = (VkDeviceMemory*)malloc(sizeof(VkDeviceMemory) * frameCount);
-    buffer->mappedPointers = (void**)malloc(sizeof(void*) * frameCount);
-    buffer->isMapped = (bool*)malloc(sizeof(bool) * frameCount);
-
-    if (!buffer->buffers || !buffer->memories || !buffer->mappedPointers || !buffer->isMapped) {
-        CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate buffer arrays");
-        crenvk_buffer_destroy(device, buffer);
-        return NULL;
-    }
-
-    // initialize arrays
-    memset(buffer->mappedPointers, 0, sizeof(void*) * frameCount);
-    memset(buffer->isMapped, 0, sizeof(bool) * frameCount);
+    buffer->memorySize = 0;
 
     // create each buffer
     for (uint32_t i = 0; i < frameCount; i++)
@@ -49,7 +45,7 @@ CREN_API vkBuffer* crenvk_buffer_create(VkDevice device, VkPhysicalDevice physic
         bufferInfo.usage = usage;
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        VkResult result = vkCreateBuffer(device, &bufferInfo, NULL, &buffer->buffers[i]);
+        VkResult result = vkCreateBuffer(device, &bufferInfo, CRENVK_ALLOCATOR, &buffer->buffers[i]);
         if (result != VK_SUCCESS) {
             CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create buffer %u: %d", i, result);
             crenvk_buffer_destroy(device, buffer);
@@ -66,13 +62,16 @@ CREN_API vkBuffer* crenvk_buffer_create(VkDevice device, VkPhysicalDevice physic
         allocInfo.allocationSize = memRequirements.size;
         allocInfo.memoryTypeIndex = crenvk_device_find_memory_type(physicalDevice,memRequirements.memoryTypeBits,memoryProperties);
 
-        result = vkAllocateMemory(device, &allocInfo, NULL, &buffer->memories[i]);
+        result = vkAllocateMemory(device, &allocInfo, CRENVK_ALLOCATOR, &buffer->memories[i]);
         if (result != VK_SUCCESS) {
             CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate buffer memory %u: %d", i, result);
             crenvk_buffer_destroy(device, buffer);
             return NULL;
         }
 
+        buffer->memorySize = allocInfo.allocationSize;
+        cren_memory_track(CREN_MEMORY_TAG_BUFFERS, (size_t)allocInfo.allocationSize);
+
         // bind memory
         result = vkBindBufferMemory(device, buffer->buffers[i], buffer->memories[i], 0);
         if (result != VK_SUCCESS) {
@@ -105,27 +104,23 @@ CREN_API void crenvk_buffer_destroy(VkDevice device, vkBuffer* buffer)
                     crenvk_buffer_unmap(device, buffer, i);
                 }
 
-                vkDestroyBuffer(device, buffer->buffers[i], NULL);
+                vkDestroyBuffer(device, buffer->buffers[i], CRENVK_ALLOCATOR);
                 buffer->buffers[i] = VK_NULL_HANDLE;
             }
         }
-        free(buffer->buffers);
     }
 
     if (buffer->memories) {
         for (uint32_t i = 0; i < buffer->frameCount; i++) {
             if (buffer->memories[i] != VK_NULL_HANDLE) {
-                vkFreeMemory(device, buffer->memories[i], NULL);
+                vkFreeMemory(device, buffer->memories[i], CRENVK_ALLOCATOR);
+                cren_memory_untrack(CREN_MEMORY_TAG_BUFFERS, (size_t)buffer->memorySize);
                 buffer->memories[i] = VK_NULL_HANDLE;
             }
         }
-        free(buffer->memories);
     }
 
-    if (buffer->mappedPointers) free(buffer->mappedPointers);
-    if (buffer->isMapped) free(buffer->isMapped);
-
-    free(buffer);
+    cren_memory_free(buffer); // the per-frame arrays live in the same block
 }
 
 CREN_API VkResult crenvk_buffer_map(VkDevice device, vkBuffer* buffer, uint32_t frameIndex)
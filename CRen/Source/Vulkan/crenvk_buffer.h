@@ -21,6 +21,7 @@ typedef struct vkBuffer
     bool* isMapped;
 
     uint32_t frameCount;
+    VkDeviceSize memorySize; // device memory of each frame, tracked under CREN_MEMORY_TAG_BUFFERS
 } vkBuffer;
 
 #ifdef __cplusplus 
@@ -3,13 +3,17 @@
 #include "cren_error.h"
 #include "cren_context.h"
 #include "crenvk_buffer.h"
+#include "crenvk_primitives.h"
+#include "cren_pool.h"
+#include "cren_profiler.h"
 #include <memm/memm.h>
 
 #if defined (CREN_BUILD_WITH_VULKAN)
 
 /// @brief handles the resize code, used internally
-static void internal_crenvk_resize(CRenVulkanBackend* backend, CRenContext* context, const CRenCallbacks* callbacks, CRenCamera* camera, bool customViewport, bool vsync, bool* hintResize)
+static void internal_crenvk_resize(CRenVulkanBackend* backend, CRenContext* context, const CRenCallbacks* callbacks, CRenCamera* camera, bool customViewport, CRen_PresentMode presentMode, bool* hintResize)
 {
+	CREN_PROFILE_BEGIN("Resize");
     vkDeviceWaitIdle(backend->device.device);
 
 	CRen_MSAA msaa = cren_get_msaa(context);
@@ -25,7 +29,7 @@ static void internal_crenvk_resize(CRenVulkanBackend* backend, CRenContext* cont
     crenvk_renderphase_default_destroy(backend->defaultRenderphase, backend->device.device, true, false);
 	
     crenvk_swapchain_destroy(&backend->swapchain, backend->device.device);
-	crenvk_swapchain_create(&backend->swapchain, backend->device.device, backend->device.physicalDevice, backend->device.surface, newExtent.width, newExtent.height, vsync);
+	crenvk_swapchain_create(&backend->swapchain, backend->device.device, backend->device.physicalDevice, backend->device.surface, newExtent.width, newExtent.height, presentMode);
 
    	crenvk_renderphase_default_create(backend->device.device, backend->device.physicalDevice, backend->device.surface, backend->swapchain.swapchainFormat.format, (VkSampleCountFlagBits)msaa, !customViewport, backend->defaultRenderphase);
     crenvk_renderphase_default_create_framebuffers(backend->defaultRenderphase, backend->device.device, backend->device.physicalDevice, backend->swapchain.swapchainImageViews, backend->swapchain.swapchainImageCount, backend->swapchain.swapchainExtent, backend->swapchain.swapchainFormat.format);
@@ -54,18 +58,23 @@ static void internal_crenvk_resize(CRenVulkanBackend* backend, CRenContext* cont
  	}
  	
  	*hintResize = false;
+	CREN_PROFILE_END();
 }
 
-CREN_API CRenVulkanBackend crenvk_initialize(CRenContext* context, unsigned int width, unsigned int height, const CRenCallbacks* callbacks, const char* appName, const char* rootPath, unsigned int appVersion, CRen_RendererAPI api, CRen_MSAA msaa, bool vsync, bool validations, bool customViewport)
+CREN_API CRenVulkanBackend crenvk_initialize(CRenContext* context, unsigned int width, unsigned int height, const CRenCallbacks* callbacks, const char* appName, const char* rootPath, unsigned int appVersion, CRen_RendererAPI api, CRen_MSAA msaa, CRen_PresentMode presentMode, bool validations, bool customViewport, bool headless)
 {
     VkResult res = VK_SUCCESS;
     ctoolbox_result toolboxres = CTOOLBOX_SUCCESS;
     CRenVulkanBackend backend = { 0 };
 
     crenvk_instance_create(context, &backend.instance, appName, appVersion, api, validations, callbacks->getVulkanRequiredInstanceExtensions);
-	callbacks->createVulkanSurfaceCallback(context, backend.instance.instance, &backend.device.surface);
+
+    // headless has no surface, the swapchain is made of offscreen images
+    if (!headless) callbacks->createVulkanSurfaceCallback(context, backend.instance.instance, &backend.device.surface);
+
     crenvk_device_create(&backend.device, backend.instance.instance, validations);
-    crenvk_swapchain_create(&backend.swapchain, backend.device.device, backend.device.physicalDevice, backend.device.surface, width, height, vsync);
+    crenvk_swapchain_create(&backend.swapchain, backend.device.device, backend.device.physicalDevice, backend.device.surface, width, height, presentMode);
+    crenvk_frame_timer_create(&backend.frameTimer, &backend.device);
 
     // default renderphase
     backend.defaultRenderphase = (vkDefaultRenderphase*)malloc(sizeof(vkDefaultRenderphase));
@@ -105,6 +114,12 @@ CREN_API CRenVulkanBackend crenvk_initialize(CRenContext* context, unsigned int
         CREN_ASSERT(res == VK_SUCCESS, "CRen has failed to create it's viewport framebuffers");
     }
 
+    // primitives, their objects are recycled instead of going to the heap on every create/destroy
+    backend.texturePool = cren_pool_create(sizeof(CRenVKTexture2D), 64, CREN_MEMORY_TAG_TEXTURES);
+    CREN_ASSERT(backend.texturePool != NULL, "Failed to create the vulkan texture pool");
+    backend.quadPool = cren_pool_create(sizeof(CRenVKQuad), 256, CREN_MEMORY_TAG_PRIMITIVES);
+    CREN_ASSERT(backend.quadPool != NULL, "Failed to create the vulkan quad pool");
+
     // buffers
     vkBuffer* cameraBuffer = crenvk_buffer_create(backend.device.device, backend.device.physicalDevice, sizeof(BufferCamera), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, CREN_CONCURRENTLY_RENDERED_FRAMES);
 	CREN_ASSERT(cameraBuffer != NULL, "Failed to create camera buffer");
@@ -149,7 +164,12 @@ CREN_API void crenvk_terminate(CRenVulkanBackend* backend)
     crenvk_renderphase_default_destroy(backend->defaultRenderphase, backend->device.device, true, false);
     free(backend->defaultRenderphase);
 
+    // primitives
+    cren_pool_destroy(backend->quadPool);
+    cren_pool_destroy(backend->texturePool);
+
     // core objects
+    crenvk_frame_timer_destroy(&backend->frameTimer, backend->device.device);
     crenvk_swapchain_destroy(&backend->swapchain, backend->device.device);
     crenvk_device_destroy(&backend->device, backend->instance.instance);
     crenvk_instance_destroy(&backend->instance);
@@ -171,15 +191,26 @@ CREN_API void crenvk_render(void* context, CRenVulkanBackend* backend, float tim
 {
 	CRenContext* ctx = (CRenContext*)context;
 	bool customViewport = cren_using_custom_viewport(ctx);
-	bool vsync = cren_using_vsync(ctx);
+	CRen_PresentMode presentMode = cren_get_requested_present_mode(ctx);
 
 	uint32_t currentFrame = backend->swapchain.currentFrame;
+	bool offscreen = backend->swapchain.offscreen;
+
+	CREN_PROFILE_BEGIN("Wait Frame Fence");
 	vkWaitForFences(backend->device.device, 1, &backend->swapchain.framesInFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
-	VkResult res = vkAcquireNextImageKHR(backend->device.device, backend->swapchain.swapchain, UINT64_MAX, backend->swapchain.imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &backend->swapchain.imageIndex);
+	crenvk_frame_timer_collect(&backend->frameTimer, backend->device.device, currentFrame);
+	CREN_PROFILE_END();
+
+	// offscreen images belong to a frame in flight, it's fence was just waited on
+	VkResult res = VK_SUCCESS;
+	CREN_PROFILE_BEGIN("Acquire Image");
+	if (offscreen) backend->swapchain.imageIndex = currentFrame;
+	else res = vkAcquireNextImageKHR(backend->device.device, backend->swapchain.swapchain, UINT64_MAX, backend->swapchain.imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &backend->swapchain.imageIndex);
+	CREN_PROFILE_END();
 
 	// failed to acquire next image, must recreate
 	if (res == VK_ERROR_OUT_OF_DATE_KHR) {
-		internal_crenvk_resize(backend, ctx, callbacks, camera, customViewport, vsync, hintResize);
+		internal_crenvk_resize(backend, ctx, callbacks, camera, customViewport, presentMode, hintResize);
 
 		// advance frame even on recreation to avoid stalling
 		backend->swapchain.currentFrame = (currentFrame + 1) % CREN_CONCURRENTLY_RENDERED_FRAMES;
@@ -190,10 +221,21 @@ CREN_API void crenvk_render(void* context, CRenVulkanBackend* backend, float tim
 	vkResetFences(backend->device.device, 1, &backend->swapchain.framesInFlightFences[currentFrame]);
 
 	// manage renderpasses/render phases
+	CREN_PROFILE_BEGIN("Default Renderphase");
 	crenvk_renderphase_default_update(backend->defaultRenderphase, context, backend, currentFrame, backend->swapchain.imageIndex, customViewport, timestep, callbacks->render);
+	CREN_PROFILE_END();
+
+	CREN_PROFILE_BEGIN("Picking Renderphase");
 	crenvk_renderphase_picking_update(backend->pickingRenderphase, context, backend, currentFrame, backend->swapchain.imageIndex, customViewport, timestep, callbacks->render);
+	CREN_PROFILE_END();
+
+	CREN_PROFILE_BEGIN("Viewport Renderphase");
 	crenvk_renderphase_viewport_update(backend->viewportRenderphase, context, backend, currentFrame, backend->swapchain.imageIndex, customViewport, timestep, callbacks->render);
+	CREN_PROFILE_END();
+
+	CREN_PROFILE_BEGIN("UI Renderphase");
 	crenvk_renderphase_ui_update(backend->uiRenderphase, context, backend, currentFrame, backend->swapchain.imageIndex, callbacks->drawUIRawData);
+	CREN_PROFILE_END();
 
 	// submit command buffers
 	VkSwapchainKHR swapChains[] = { backend->swapchain.swapchain };
@@ -204,41 +246,40 @@ CREN_API void crenvk_render(void* context, CRenVulkanBackend* backend, float tim
 	VkSubmitInfo submitInfo = { 0 };
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 	submitInfo.pNext = NULL;
-	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.waitSemaphoreCount = offscreen ? 0 : 1; // offscreen images aren't acquired nor presented
 	submitInfo.pWaitSemaphores = waitSemaphores;
 	submitInfo.pWaitDstStageMask = waitStages;
-	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.signalSemaphoreCount = offscreen ? 0 : 1;
 	submitInfo.pSignalSemaphores = signalSemaphores;
 
-	if (customViewport) {
-		VkCommandBuffer commandBuffers[4] = { 0 };
-		commandBuffers[0] = backend->defaultRenderphase->renderpass->commandBuffers[currentFrame];
-		commandBuffers[1] = backend->pickingRenderphase->renderpass->commandBuffers[currentFrame];
-		commandBuffers[2] = backend->viewportRenderphase->renderpass->commandBuffers[currentFrame];
-		commandBuffers[3] = backend->uiRenderphase->renderpass->commandBuffers[currentFrame];
-
-		submitInfo.commandBufferCount = CREN_STATIC_ARRAY_SIZE(commandBuffers);
-		submitInfo.pCommandBuffers = commandBuffers;
-
-		VkResult queueSubmit = vkQueueSubmit(backend->device.graphicsQueue, 1, &submitInfo, backend->swapchain.framesInFlightFences[currentFrame]);
-		if (queueSubmit != VK_SUCCESS) {
-			CREN_ASSERT(1, "Renderer update was not able to submit frame to graphics queue");
-		}
+	// the frame timer's timestamps surround the renderphases
+	VkCommandBuffer commandBuffers[6] = { 0 };
+	uint32_t commandBufferCount = 0;
+	vkFrameTimer* timer = &backend->frameTimer;
+	if (timer->supported) commandBuffers[commandBufferCount++] = timer->beginCommandBuffers[currentFrame];
+	commandBuffers[commandBufferCount++] = backend->defaultRenderphase->renderpass->commandBuffers[currentFrame];
+	commandBuffers[commandBufferCount++] = backend->pickingRenderphase->renderpass->commandBuffers[currentFrame];
+	if (customViewport) commandBuffers[commandBufferCount++] = backend->viewportRenderphase->renderpass->commandBuffers[currentFrame];
+	commandBuffers[commandBufferCount++] = backend->uiRenderphase->renderpass->commandBuffers[currentFrame];
+	if (timer->supported) commandBuffers[commandBufferCount++] = timer->endCommandBuffers[currentFrame];
+
+	submitInfo.commandBufferCount = commandBufferCount;
+	submitInfo.pCommandBuffers = commandBuffers;
+
+	CREN_PROFILE_BEGIN("Submit");
+	VkResult queueSubmit = vkQueueSubmit(backend->device.graphicsQueue, 1, &submitInfo, backend->swapchain.framesInFlightFences[currentFrame]);
+	CREN_PROFILE_END();
+
+	if (queueSubmit != VK_SUCCESS) {
+		CREN_ASSERT(1, "Renderer update was not able to submit frame to graphics queue");
 	}
+	timer->pending[currentFrame] = timer->supported && queueSubmit == VK_SUCCESS;
 
-	else {
-		VkCommandBuffer commandBuffers[3] = { 0 };
-		commandBuffers[0] = backend->defaultRenderphase->renderpass->commandBuffers[currentFrame];
-		commandBuffers[1] = backend->pickingRenderphase->renderpass->commandBuffers[currentFrame];
-		commandBuffers[2] = backend->uiRenderphase->renderpass->commandBuffers[currentFrame];
-
-		submitInfo.commandBufferCount = CREN_STATIC_ARRAY_SIZE(commandBuffers);
-		submitInfo.pCommandBuffers = commandBuffers;
-
-		VkResult queueSubmit = vkQueueSubmit(backend->device.graphicsQueue, 1, &submitInfo, backend->swapchain.framesInFlightFences[currentFrame]);
-		if (queueSubmit != VK_SUCCESS) {
-			CREN_ASSERT(1, "Renderer update was not able to submit frame to graphics queue");
-		}
+	// nothing to present, a resize only recreates the offscreen images
+	if (offscreen) {
+		if (*hintResize == true) internal_crenvk_resize(backend, ctx, callbacks, camera, customViewport, presentMode, hintResize);
+		backend->swapchain.currentFrame = (currentFrame + 1) % CREN_CONCURRENTLY_RENDERED_FRAMES;
+		return;
 	}
 
 	// present the image
@@ -250,11 +291,13 @@ CREN_API void crenvk_render(void* context, CRenVulkanBackend* backend, float tim
 	presentInfo.pSwapchains = swapChains;
 	presentInfo.pImageIndices = &backend->swapchain.imageIndex;
 
+	CREN_PROFILE_BEGIN("Present");
 	res = vkQueuePresentKHR(backend->device.graphicsQueue, &presentInfo);
+	CREN_PROFILE_END();
 
 	// failed to present the image, must recreate
 	if (res == VK_ERROR_OUT_OF_DATE_KHR || res == VK_SUBOPTIMAL_KHR || *hintResize == true) {
-		internal_crenvk_resize(backend, ctx, callbacks, camera, customViewport, vsync, hintResize);
+		internal_crenvk_resize(backend, ctx, callbacks, camera, customViewport, presentMode, hintResize);
 	}
 
 	else if (res != VK_SUCCESS) {
@@ -281,7 +324,7 @@ CREN_API uint32_t crenvk_pick_object(void* context, CRenVulkanBackend* backend,
     bufferCI.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
     bufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    res = vkCreateBuffer(backend->device.device, &bufferCI, NULL, &stagingBuffer);
+    res = vkCreateBuffer(backend->device.device, &bufferCI, CRENVK_ALLOCATOR, &stagingBuffer);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create staging buffer for picking");
         return 0;
@@ -294,7 +337,7 @@ CREN_API uint32_t crenvk_pick_object(void* context, CRenVulkanBackend* backend,
 
     uint32_t memType = crenvk_device_find_memory_type(backend->device.physicalDevice, memReq.memoryTypeBits,VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
     if (memType == UINT32_MAX) {
-        vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+        vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "No suitable memory type for picking");
         return 0;
     }
@@ -304,17 +347,17 @@ CREN_API uint32_t crenvk_pick_object(void* context, CRenVulkanBackend* backend,
     allocInfo.allocationSize = alignedSize;
     allocInfo.memoryTypeIndex = memType;
 
-    res = vkAllocateMemory(backend->device.device, &allocInfo, NULL, &stagingMemory);
+    res = vkAllocateMemory(backend->device.device, &allocInfo, CRENVK_ALLOCATOR, &stagingMemory);
     if (res != VK_SUCCESS) {
-        vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+        vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate memory for picking");
         return 0;
     }
 
     res = vkBindBufferMemory(backend->device.device, stagingBuffer, stagingMemory, 0);
     if (res != VK_SUCCESS) {
-        vkFreeMemory(backend->device.device, stagingMemory, NULL);
-        vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+        vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
+        vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to bind buffer memory for picking");
         return 0;
     }
@@ -327,8 +370,8 @@ CREN_API uint32_t crenvk_pick_object(void* context, CRenVulkanBackend* backend,
 
     res = vkAllocateCommandBuffers(backend->device.device, &cmdAlloc, &cmdBuffer);
     if (res != VK_SUCCESS) {
-        vkFreeMemory(backend->device.device, stagingMemory, NULL);
-        vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+        vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
+        vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate command buffer for picking");
         return 0;
     }
@@ -339,8 +382,8 @@ CREN_API uint32_t crenvk_pick_object(void* context, CRenVulkanBackend* backend,
 
     res = vkBeginCommandBuffer(cmdBuffer, &beginInfo);
     if (res != VK_SUCCESS) {
-        vkFreeMemory(backend->device.device, stagingMemory, NULL);
-        vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+        vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
+        vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
         vkFreeCommandBuffers(backend->device.device, backend->pickingRenderphase->renderpass->commandPool, 1, &cmdBuffer);
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to begin command buffer for picking");
         return 0;
@@ -392,8 +435,8 @@ CREN_API uint32_t crenvk_pick_object(void* context, CRenVulkanBackend* backend,
 
     res = vkEndCommandBuffer(cmdBuffer);
     if (res != VK_SUCCESS) {
-        vkFreeMemory(backend->device.device, stagingMemory, NULL);
-        vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+        vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
+        vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
         vkFreeCommandBuffers(backend->device.device, backend->pickingRenderphase->renderpass->commandPool, 1, &cmdBuffer);
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to end command buffer for picking");
         return 0;
@@ -401,10 +444,10 @@ CREN_API uint32_t crenvk_pick_object(void* context, CRenVulkanBackend* backend,
 
     VkFenceCreateInfo fenceCI = { 0 };
     fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    res = vkCreateFence(backend->device.device, &fenceCI, NULL, &fence);
+    res = vkCreateFence(backend->device.device, &fenceCI, CRENVK_ALLOCATOR, &fence);
     if (res != VK_SUCCESS) {
-        vkFreeMemory(backend->device.device, stagingMemory, NULL);
-        vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+        vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
+        vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
         vkFreeCommandBuffers(backend->device.device, backend->pickingRenderphase->renderpass->commandPool, 1, &cmdBuffer);
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create fence for picking");
         return 0;
@@ -417,20 +460,20 @@ CREN_API uint32_t crenvk_pick_object(void* context, CRenVulkanBackend* backend,
 
     res = vkQueueSubmit(backend->device.graphicsQueue, 1, &submit, fence);
     if (res != VK_SUCCESS) {
-        vkDestroyFence(backend->device.device, fence, NULL);
-        vkFreeMemory(backend->device.device, stagingMemory, NULL);
-        vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+        vkDestroyFence(backend->device.device, fence, CRENVK_ALLOCATOR);
+        vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
+        vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
         vkFreeCommandBuffers(backend->device.device, backend->pickingRenderphase->renderpass->commandPool, 1, &cmdBuffer);
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to submit picking command buffer");
         return 0;
     }
 
     res = vkWaitForFences(backend->device.device, 1, &fence, VK_TRUE, UINT64_MAX);
-    vkDestroyFence(backend->device.device, fence, NULL);
+    vkDestroyFence(backend->device.device, fence, CRENVK_ALLOCATOR);
 
     if (res != VK_SUCCESS) {
-        vkFreeMemory(backend->device.device, stagingMemory, NULL);
-        vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+        vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
+        vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
         vkFreeCommandBuffers(backend->device.device, backend->pickingRenderphase->renderpass->commandPool, 1, &cmdBuffer);
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to wait for picking fence");
         return 0;
@@ -453,8 +496,8 @@ CREN_API uint32_t crenvk_pick_object(void* context, CRenVulkanBackend* backend,
     }
 
     vkFreeCommandBuffers(backend->device.device, backend->pickingRenderphase->renderpass->commandPool, 1, &cmdBuffer);
-    vkFreeMemory(backend->device.device, stagingMemory, NULL);
-    vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
+    vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
+    vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
 
     return pixelValue;
 }
@@ -16,19 +16,22 @@ typedef struct CRenVulkanBackend
 	vkInstance instance;
 	vkDevice device;
 	vkSwapchain swapchain;
+	vkFrameTimer frameTimer;
 	vkDefaultRenderphase* defaultRenderphase;
 	vkPickingRenderphase* pickingRenderphase;
 	vkUIRenderphase* uiRenderphase;
 	vkViewportRenderphase* viewportRenderphase;
 	shashtable* buffersLib;
 	shashtable* pipelinesLib;
+	CRenPool* texturePool; // CRenVKTexture2D
+	CRenPool* quadPool; // CRenVKQuad
 } CRenVulkanBackend;
 
 #ifdef __cplusplus 
 extern "C" {
 #endif
 
-/// @brief initializes the vulkan context
+/// @brief initializes the vulkan context, headless creates no surface and renders into offscreen images
 CREN_API CRenVulkanBackend crenvk_initialize
 (
 	CRenContext* context,
@@ -40,9 +43,10 @@ CREN_API CRenVulkanBackend crenvk_initialize
 	unsigned int appVersion,
 	CRen_RendererAPI api,
 	CRen_MSAA msaa,
-	bool vsync,
+	CRen_PresentMode presentMode,
 	bool validations,
-	bool customViewport
+	bool customViewport,
+	bool headless
 );
 
 /// @brief shutdown the vulkan context
@@ -1,5 +1,6 @@
 #include "crenvk_core.h"
 #include "cren_error.h"
+#include "cren_memory.h"
 #include "cren_platform.h"
 
 #include <memm/memm.h>
@@ -9,6 +10,59 @@
 
 #if defined (CREN_BUILD_WITH_VULKAN)
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Allocation
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief driver allocations, scopes aren't tracked apart since they all live as long as the objects that made them
+static void* VKAPI_PTR internal_crenvk_allocation(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    return cren_memory_alloc_aligned(CREN_MEMORY_TAG_DRIVER, size, alignment);
+}
+
+/// @brief driver reallocations, vulkan expects null on failure with the original left untouched (as cren_memory_realloc does)
+static void* VKAPI_PTR internal_crenvk_reallocation(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    if (!original) return cren_memory_alloc_aligned(CREN_MEMORY_TAG_DRIVER, size, alignment);
+    return cren_memory_realloc(original, size, alignment);
+}
+
+/// @brief driver releases
+static void VKAPI_PTR internal_crenvk_free(void* userData, void* memory)
+{
+    cren_memory_free(memory);
+}
+
+/// @brief memory the driver allocated by itself (executable code), only reported
+static void VKAPI_PTR internal_crenvk_internal_allocation(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope)
+{
+    cren_memory_track(CREN_MEMORY_TAG_DRIVER, size);
+}
+
+/// @brief the driver released memory it allocated by itself
+static void VKAPI_PTR internal_crenvk_internal_free(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope)
+{
+    cren_memory_untrack(CREN_MEMORY_TAG_DRIVER, size);
+}
+
+static const VkAllocationCallbacks sAllocationCallbacks = {
+    NULL,
+    internal_crenvk_allocation,
+    internal_crenvk_reallocation,
+    internal_crenvk_free,
+    internal_crenvk_internal_allocation,
+    internal_crenvk_internal_free
+};
+
+CREN_API const VkAllocationCallbacks* crenvk_get_allocation_callbacks()
+{
+    #if CREN_USE_VULKAN_ALLOCATION_CALLBACKS
+    return &sAllocationCallbacks;
+    #else
+    return NULL;
+    #endif
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Instance
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -95,7 +149,7 @@ void crenvk_instance_create(CRenContext* context, vkInstance* instance, const ch
     }
 
     // create instance
-    VkResult result = vkCreateInstance(&instanceCI, NULL, &instance->instance);
+    VkResult result = vkCreateInstance(&instanceCI, CRENVK_ALLOCATOR, &instance->instance);
     if (result != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create Vulkan Instance: %d", result);
         return;
@@ -106,7 +160,7 @@ void crenvk_instance_create(CRenContext* context, vkInstance* instance, const ch
         PFN_vkCreateDebugUtilsMessengerEXT createDebugFunc = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance->instance, "vkCreateDebugUtilsMessengerEXT");
         
         if (createDebugFunc) {
-            result = createDebugFunc(instance->instance, &debugUtilsCI, NULL, &instance->debugger);
+            result = createDebugFunc(instance->instance, &debugUtilsCI, CRENVK_ALLOCATOR, &instance->debugger);
             if (result != VK_SUCCESS) {
                 CREN_LOG(CREN_LOG_SEVERITY_WARN, "Failed to create Vulkan Debug Messenger: %d", result);
                 instance->debugger = VK_NULL_HANDLE;
@@ -124,12 +178,12 @@ void crenvk_instance_destroy(vkInstance* instance)
     if (instance->validationsEnabled) {
         PFN_vkDestroyDebugUtilsMessengerEXT func = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance->instance, "vkDestroyDebugUtilsMessengerEXT");
         if (instance->instance != VK_NULL_HANDLE || instance->debugger != VK_NULL_HANDLE) {
-            func(instance->instance, instance->debugger, NULL);
+            func(instance->instance, instance->debugger, CRENVK_ALLOCATOR);
         }
     }
 
     if (instance->instance != VK_NULL_HANDLE) {
-        vkDestroyInstance(instance->instance, NULL);
+        vkDestroyInstance(instance->instance, CRENVK_ALLOCATOR);
     }
 }
 
@@ -287,7 +341,7 @@ static void internal_crenvk_create_logical_device(VkPhysicalDevice physicalDevic
     }
     
     // create the device
-    CREN_ASSERT(vkCreateDevice(physicalDevice, &deviceCI, NULL, device) == VK_SUCCESS, "Failed to create vulkan logical device");
+    CREN_ASSERT(vkCreateDevice(physicalDevice, &deviceCI, CRENVK_ALLOCATOR, device) == VK_SUCCESS, "Failed to create vulkan logical device");
 
     // retrieve queues
     vkGetDeviceQueue(*device, indices.graphicFamily, 0, graphicsQueue);
@@ -320,8 +374,8 @@ void crenvk_device_destroy(vkDevice* device, VkInstance instance)
 {
     if (instance == VK_NULL_HANDLE || !device) return;
 
-    if (device->device) vkDestroyDevice(device->device, NULL);
-    if (device->surface) vkDestroySurfaceKHR(instance, device->surface, NULL);
+    if (device->device) vkDestroyDevice(device->device, CRENVK_ALLOCATOR);
+    if (device->surface) vkDestroySurfaceKHR(instance, device->surface, NULL); // created by the application's callback without allocation callbacks
 }
 
 vkQueueFamilyIndices crenvk_device_find_queue_families(VkPhysicalDevice device, VkSurfaceKHR surface)
@@ -350,9 +404,10 @@ vkQueueFamilyIndices crenvk_device_find_queue_families(VkPhysicalDevice device,
             indices.computeFound = 1;
         }
 
-        // check for presentation support
+        // check for presentation support, headless never presents so the graphics queue stands for it
         VkBool32 present_support = VK_FALSE;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &present_support);
+        if (surface != VK_NULL_HANDLE) vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &present_support);
+        else present_support = (queue_families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
         if (present_support) {
             indices.presentFamily = i;
             indices.presentFound = 1;
@@ -375,7 +430,7 @@ VkResult crenvk_device_create_buffer(VkDevice device, VkPhysicalDevice physicalD
     bufferCI.usage = usage;
     bufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    res = vkCreateBuffer(device, &bufferCI, NULL, buffer);
+    res = vkCreateBuffer(device, &bufferCI, CRENVK_ALLOCATOR, buffer);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create buffer on GPU");
         return res;
@@ -390,18 +445,18 @@ VkResult crenvk_device_create_buffer(VkDevice device, VkPhysicalDevice physicalD
     allocInfo.allocationSize = memRequirements.size;
     allocInfo.memoryTypeIndex = crenvk_device_find_memory_type(physicalDevice, memRequirements.memoryTypeBits, properties);
 
-    res = vkAllocateMemory(device, &allocInfo, NULL, memory);
+    res = vkAllocateMemory(device, &allocInfo, CRENVK_ALLOCATOR, memory);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate memory for GPU buffer");
-        vkDestroyBuffer(device, *buffer, NULL);
+        vkDestroyBuffer(device, *buffer, CRENVK_ALLOCATOR);
         return res;
     }
 
     res = vkBindBufferMemory(device, *buffer, *memory, 0);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to bind GPU memory with buffer");
-        vkDestroyBuffer(device, *buffer, NULL);
-        vkFreeMemory(device, *memory, NULL);
+        vkDestroyBuffer(device, *buffer, CRENVK_ALLOCATOR);
+        vkFreeMemory(device, *memory, CRENVK_ALLOCATOR);
         return res;
     }
 
@@ -531,7 +586,7 @@ VkResult crenvk_device_create_image(uint32_t width, uint32_t height, uint32_t mi
     imageCI.samples = samples;
     imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    res = vkCreateImage(device, &imageCI, NULL, image);
+    res = vkCreateImage(device, &imageCI, CRENVK_ALLOCATOR, image);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create device image (%d)", res);
         return res;
@@ -546,7 +601,7 @@ VkResult crenvk_device_create_image(uint32_t width, uint32_t height, uint32_t mi
     allocInfo.allocationSize = memRequirements.size;
     allocInfo.memoryTypeIndex = crenvk_device_find_memory_type(physicalDevice, memRequirements.memoryTypeBits, memoryProperties);
 
-    res = vkAllocateMemory(device, &allocInfo, NULL, memory);
+    res = vkAllocateMemory(device, &allocInfo, CRENVK_ALLOCATOR, memory);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate memory for the device image (%d)", res);
         return res;
@@ -588,7 +643,7 @@ VkResult crenvk_device_create_image_view(VkDevice device, VkImage image, VkForma
         imageViewCI.components = *swizzle;
     }
 
-    VkResult res = vkCreateImageView(device, &imageViewCI, NULL, outView);
+    VkResult res = vkCreateImageView(device, &imageViewCI, CRENVK_ALLOCATOR, outView);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create image view (VkResult: %d)", res);
         return res;
@@ -620,7 +675,7 @@ VkResult crenvk_device_create_image_sampler(VkDevice device, VkPhysicalDevice ph
     samplerCI.compareOp = VK_COMPARE_OP_ALWAYS;
     samplerCI.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 
-    VkResult res = vkCreateSampler(device, &samplerCI, NULL, outSampler);
+    VkResult res = vkCreateSampler(device, &samplerCI, CRENVK_ALLOCATOR, outSampler);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create image sampler");
         return res;
@@ -844,23 +899,32 @@ static VkSurfaceFormatKHR internal_crenvk_choose_swapchain_surface_format(VkSurf
     return formats[0];
 }
 
-/// @brief chooses the most suitable presentation mode for the swapchain
-static VkPresentModeKHR internal_crenvk_choose_swapchain_present_mode(VkPresentModeKHR* modes, uint32_t quantity, bool vsync)
+/// @brief chooses the requested presentation mode for the swapchain, or the closest one the surface supports
+static VkPresentModeKHR internal_crenvk_choose_swapchain_present_mode(VkPresentModeKHR* modes, uint32_t quantity, CRen_PresentMode requested)
 {
     // handle edge cases and vsync request
-    if (modes == NULL || quantity == 0 || vsync)  return VK_PRESENT_MODE_FIFO_KHR; // fallback to FIFO
+    if (modes == NULL || quantity == 0 || requested == CREN_PRESENT_MODE_FIFO)  return VK_PRESENT_MODE_FIFO_KHR; // fallback to FIFO
 
-    // search for the best non-VSync mode
+    // search for the requested non-VSync mode, the other one is the fallback as it doesn't wait on the display either
+    int mailboxModeAvailable = 0;
     int immediateModeAvailable = 0;
     for (uint32_t i = 0; i < quantity; i++) {
-        if (modes[i] == VK_PRESENT_MODE_MAILBOX_KHR)  return VK_PRESENT_MODE_MAILBOX_KHR; // prefer MAILBOX (multiple buffering) if available
-        if (modes[i] == VK_PRESENT_MODE_IMMEDIATE_KHR) immediateModeAvailable = 1; // mark IMMEDIATE mode as available for fallback
+        if (modes[i] == VK_PRESENT_MODE_MAILBOX_KHR) mailboxModeAvailable = 1;
+        if (modes[i] == VK_PRESENT_MODE_IMMEDIATE_KHR) immediateModeAvailable = 1;
+    }
+
+    if (requested == CREN_PRESENT_MODE_MAILBOX) {
+        if (mailboxModeAvailable) return VK_PRESENT_MODE_MAILBOX_KHR;
+        if (immediateModeAvailable) return VK_PRESENT_MODE_IMMEDIATE_KHR;
     }
 
-    // fallback to IMMEDIATE if available
-    if (immediateModeAvailable) return VK_PRESENT_MODE_IMMEDIATE_KHR;
+    if (requested == CREN_PRESENT_MODE_IMMEDIATE) {
+        if (immediateModeAvailable) return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        if (mailboxModeAvailable) return VK_PRESENT_MODE_MAILBOX_KHR;
+    }
 
     // fallback to FIFO (always supported)
+    CREN_LOG(CREN_LOG_SEVERITY_WARN, "Requested present mode is not supported by the surface, using FIFO");
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
@@ -876,11 +940,82 @@ static VkExtent2D internal_crenvk_choose_swapchain_extent(const VkSurfaceCapabil
     return actualExtent;
 }
 
-void crenvk_swapchain_create(vkSwapchain* swapchain, VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t width, uint32_t height, bool vsync)
+/// @brief creates the syncronization objects used on every frame, one set per swapchain image
+static void internal_crenvk_swapchain_create_sync(vkSwapchain* swapchain, VkDevice device)
+{
+    VkSemaphoreCreateInfo semaphoreCI = { 0 };
+    semaphoreCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreCI.pNext = NULL;
+    semaphoreCI.flags = 0;
+
+    VkFenceCreateInfo fenceCI = { 0 };
+    fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceCI.pNext = NULL;
+    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    swapchain->imageAvailableSemaphores = (VkSemaphore*)malloc(sizeof(VkSemaphore) * swapchain->swapchainImageCount);
+    swapchain->finishedRenderingSemaphores = (VkSemaphore*)malloc(sizeof(VkSemaphore) * swapchain->swapchainImageCount);
+    swapchain->framesInFlightFences = (VkFence*)malloc(sizeof(VkFence) * swapchain->swapchainImageCount);
+
+    swapchain->swapchainSyncCount = swapchain->swapchainImageCount;
+    for (size_t i = 0; i < swapchain->swapchainSyncCount; i++) {
+        CREN_ASSERT(vkCreateSemaphore(device, &semaphoreCI, CRENVK_ALLOCATOR, &swapchain->imageAvailableSemaphores[i]) == VK_SUCCESS, "Failed to create image available semaphore");
+        CREN_ASSERT(vkCreateSemaphore(device, &semaphoreCI, CRENVK_ALLOCATOR, &swapchain->finishedRenderingSemaphores[i]) == VK_SUCCESS, "Failed to create rendering finished semaphore");
+        CREN_ASSERT(vkCreateFence(device, &fenceCI, CRENVK_ALLOCATOR, &swapchain->framesInFlightFences[i]) == VK_SUCCESS, "Failed to create syncronizer fence");
+    }
+}
+
+/// @brief creates the images a headless swapchain renders to, each frame in flight owns one so the frame's fence guards it
+static void internal_crenvk_swapchain_create_offscreen(vkSwapchain* swapchain, VkDevice device, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height)
+{
+    swapchain->offscreen = true;
+    swapchain->swapchain = VK_NULL_HANDLE;
+    swapchain->swapchainFormat.format = VK_FORMAT_B8G8R8A8_UNORM; // same as the one preferred for surfaces
+    swapchain->swapchainFormat.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    swapchain->swapchainPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR; // there's no display to wait on
+    swapchain->swapchainExtent.width = width > 0 ? width : 1;
+    swapchain->swapchainExtent.height = height > 0 ? height : 1;
+    swapchain->swapchainImageCount = CREN_CONCURRENTLY_RENDERED_FRAMES;
+
+    swapchain->swapchainImages = (VkImage*)malloc(swapchain->swapchainImageCount * sizeof(VkImage));
+    swapchain->swapchainImageViews = (VkImageView*)malloc(sizeof(VkImageView) * swapchain->swapchainImageCount);
+    swapchain->swapchainImagesMemory = (VkDeviceMemory*)malloc(sizeof(VkDeviceMemory) * swapchain->swapchainImageCount);
+
+    for (uint32_t i = 0; i < swapchain->swapchainImageCount; i++) {
+        swapchain->swapchainImages[i] = VK_NULL_HANDLE;
+        swapchain->swapchainImagesMemory[i] = VK_NULL_HANDLE;
+        swapchain->swapchainImageViews[i] = VK_NULL_HANDLE;
+
+        VkResult res = crenvk_device_create_image
+        (
+            swapchain->swapchainExtent.width, swapchain->swapchainExtent.height, 1, 1, device, physicalDevice,
+            &swapchain->swapchainImages[i], &swapchain->swapchainImagesMemory[i], swapchain->swapchainFormat.format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0
+        );
+        if (res != VK_SUCCESS) {
+            CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create offscreen swapchain image");
+            continue;
+        }
+
+        crenvk_device_create_image_view(device, swapchain->swapchainImages[i], swapchain->swapchainFormat.format, VK_IMAGE_ASPECT_COLOR_BIT, 1, 1, VK_IMAGE_VIEW_TYPE_2D, NULL, &swapchain->swapchainImageViews[i]);
+    }
+
+    internal_crenvk_swapchain_create_sync(swapchain, device);
+}
+
+void crenvk_swapchain_create(vkSwapchain* swapchain, VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t width, uint32_t height, CRen_PresentMode presentMode)
 {
+    if (surface == VK_NULL_HANDLE) {
+        internal_crenvk_swapchain_create_offscreen(swapchain, device, physicalDevice, width, height);
+        return;
+    }
+
+    swapchain->offscreen = false;
+    swapchain->swapchainImagesMemory = NULL;
+
     vkSwapchainDetails details = internal_crenvk_query_swapchain_details(physicalDevice, surface);
     swapchain->swapchainFormat = internal_crenvk_choose_swapchain_surface_format(details.surfaceFormats, details.surfaceFormatCount);
-    swapchain->swapchainPresentMode = internal_crenvk_choose_swapchain_present_mode(details.presentModes, details.presentModeCount, vsync);
+    swapchain->swapchainPresentMode = internal_crenvk_choose_swapchain_present_mode(details.presentModes, details.presentModeCount, presentMode);
     swapchain->swapchainExtent = internal_crenvk_choose_swapchain_extent(&details.capabilities, width, height);
 
     // images in the swapchain
@@ -917,7 +1052,7 @@ void crenvk_swapchain_create(vkSwapchain* swapchain, VkDevice device, VkPhysical
         swapchainCI.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
     }
 
-    CREN_ASSERT(vkCreateSwapchainKHR(device, &swapchainCI, NULL, &swapchain->swapchain) == VK_SUCCESS, "Failed to create swapchain");
+    CREN_ASSERT(vkCreateSwapchainKHR(device, &swapchainCI, CRENVK_ALLOCATOR, &swapchain->swapchain) == VK_SUCCESS, "Failed to create swapchain");
 
     vkGetSwapchainImagesKHR(device, swapchain->swapchain, &swapchain->swapchainImageCount, NULL);
     swapchain->swapchainImages = (VkImage*)malloc(swapchain->swapchainImageCount * sizeof(VkImage));
@@ -930,26 +1065,7 @@ void crenvk_swapchain_create(vkSwapchain* swapchain, VkDevice device, VkPhysical
     }
 
     // syncronization objects
-    VkSemaphoreCreateInfo semaphoreCI = { 0 };
-    semaphoreCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    semaphoreCI.pNext = NULL;
-    semaphoreCI.flags = 0;
-
-    VkFenceCreateInfo fenceCI = { 0 };
-    fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceCI.pNext = NULL;
-    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    swapchain->imageAvailableSemaphores = (VkSemaphore*)malloc(sizeof(VkSemaphore) * swapchain->swapchainImageCount);
-    swapchain->finishedRenderingSemaphores = (VkSemaphore*)malloc(sizeof(VkSemaphore) * swapchain->swapchainImageCount);
-    swapchain->framesInFlightFences = (VkFence*)malloc(sizeof(VkFence) * swapchain->swapchainImageCount);
-
-    swapchain->swapchainSyncCount = swapchain->swapchainImageCount;
-    for (size_t i = 0; i < swapchain->swapchainSyncCount; i++) {
-        CREN_ASSERT(vkCreateSemaphore(device, &semaphoreCI, NULL, &swapchain->imageAvailableSemaphores[i]) == VK_SUCCESS, "Failed to create image available semaphore");
-        CREN_ASSERT(vkCreateSemaphore(device, &semaphoreCI, NULL, &swapchain->finishedRenderingSemaphores[i]) == VK_SUCCESS, "Failed to create rendering finished semaphore");
-        CREN_ASSERT(vkCreateFence(device, &fenceCI, NULL, &swapchain->framesInFlightFences[i]) == VK_SUCCESS, "Failed to create syncronizer fence");
-    }
+    internal_crenvk_swapchain_create_sync(swapchain, device);
 
     // free details
     free(details.presentModes);
@@ -959,20 +1075,130 @@ void crenvk_swapchain_create(vkSwapchain* swapchain, VkDevice device, VkPhysical
 void crenvk_swapchain_destroy(vkSwapchain* swapchain, VkDevice device)
 {
     for (uint32_t i = 0; i < swapchain->swapchainSyncCount; i++) {
-        if (swapchain->imageAvailableSemaphores[i]) vkDestroySemaphore(device, swapchain->imageAvailableSemaphores[i], NULL);
-        if (swapchain->finishedRenderingSemaphores[i]) vkDestroySemaphore(device, swapchain->finishedRenderingSemaphores[i], NULL);
-        if (swapchain->framesInFlightFences[i]) vkDestroyFence(device, swapchain->framesInFlightFences[i], NULL);
+        if (swapchain->imageAvailableSemaphores[i]) vkDestroySemaphore(device, swapchain->imageAvailableSemaphores[i], CRENVK_ALLOCATOR);
+        if (swapchain->finishedRenderingSemaphores[i]) vkDestroySemaphore(device, swapchain->finishedRenderingSemaphores[i], CRENVK_ALLOCATOR);
+        if (swapchain->framesInFlightFences[i]) vkDestroyFence(device, swapchain->framesInFlightFences[i], CRENVK_ALLOCATOR);
     }
     free(swapchain->imageAvailableSemaphores);
     free(swapchain->finishedRenderingSemaphores);
     free(swapchain->framesInFlightFences);
 
-    for (uint32_t i = 0; i < swapchain->swapchainImageCount; i++) vkDestroyImageView(device, swapchain->swapchainImageViews[i], NULL);
+    for (uint32_t i = 0; i < swapchain->swapchainImageCount; i++) vkDestroyImageView(device, swapchain->swapchainImageViews[i], CRENVK_ALLOCATOR);
+
+    // offscreen images are ours, swapchain images are vkDestroyed internally
+    if (swapchain->offscreen) {
+        for (uint32_t i = 0; i < swapchain->swapchainImageCount; i++) {
+            vkDestroyImage(device, swapchain->swapchainImages[i], CRENVK_ALLOCATOR);
+            vkFreeMemory(device, swapchain->swapchainImagesMemory[i], CRENVK_ALLOCATOR);
+        }
+        free(swapchain->swapchainImagesMemory);
+        swapchain->swapchainImagesMemory = NULL;
+    }
 
     free(swapchain->swapchainImageViews);
-    free(swapchain->swapchainImages); // swapchain images are vkDestroyed internally
+    free(swapchain->swapchainImages);
+
+    if (swapchain->swapchain != VK_NULL_HANDLE) vkDestroySwapchainKHR(device, swapchain->swapchain, CRENVK_ALLOCATOR);
+}
+
+CRen_PresentMode crenvk_swapchain_get_present_mode(const vkSwapchain* swapchain)
+{
+    switch (swapchain->swapchainPresentMode)
+    {
+        case VK_PRESENT_MODE_MAILBOX_KHR: return CREN_PRESENT_MODE_MAILBOX;
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return CREN_PRESENT_MODE_IMMEDIATE;
+        default: return CREN_PRESENT_MODE_FIFO;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Frame timing
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void crenvk_frame_timer_create(vkFrameTimer* timer, const vkDevice* device)
+{
+    memset(timer, 0, sizeof(vkFrameTimer));
+
+    // timestampComputeAndGraphics guarantees every graphics queue writes timestamps
+    const VkPhysicalDeviceLimits* limits = &device->physicalDeviceProperties.limits;
+    if (!limits->timestampComputeAndGraphics || limits->timestampPeriod <= 0.0f) {
+        CREN_LOG(CREN_LOG_SEVERITY_WARN, "The graphics queue doesn't support timestamps, gpu frame times won't be available");
+        return;
+    }
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device->physicalDevice, &familyCount, NULL);
+    VkQueueFamilyProperties families[16] = { 0 };
+    if (familyCount > (uint32_t)CREN_STATIC_ARRAY_SIZE(families)) familyCount = (uint32_t)CREN_STATIC_ARRAY_SIZE(families);
+    vkGetPhysicalDeviceQueueFamilyProperties(device->physicalDevice, &familyCount, families);
+
+    uint32_t validBits = (uint32_t)device->graphicsQueueIndex < familyCount ? families[device->graphicsQueueIndex].timestampValidBits : 0;
+    if (validBits == 0) return;
+
+    timer->timestampPeriod = (double)limits->timestampPeriod;
+    timer->timestampMask = validBits >= 64 ? UINT64_MAX : ((1ull << validBits) - 1);
+
+    VkQueryPoolCreateInfo queryPoolCI = { 0 };
+    queryPoolCI.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolCI.queryCount = CREN_CONCURRENTLY_RENDERED_FRAMES * 2;
+    if (vkCreateQueryPool(device->device, &queryPoolCI, CRENVK_ALLOCATOR, &timer->queryPool) != VK_SUCCESS) return;
+
+    VkCommandPoolCreateInfo cmdPoolCI = { 0 };
+    cmdPoolCI.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    cmdPoolCI.queueFamilyIndex = device->graphicsQueueIndex;
+    if (vkCreateCommandPool(device->device, &cmdPoolCI, CRENVK_ALLOCATOR, &timer->commandPool) != VK_SUCCESS) {
+        crenvk_frame_timer_destroy(timer, device->device);
+        return;
+    }
+
+    VkCommandBufferAllocateInfo cmdBufferAllocInfo = { 0 };
+    cmdBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    cmdBufferAllocInfo.commandPool = timer->commandPool;
+    cmdBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdBufferAllocInfo.commandBufferCount = CREN_CONCURRENTLY_RENDERED_FRAMES;
+    if (vkAllocateCommandBuffers(device->device, &cmdBufferAllocInfo, timer->beginCommandBuffers) != VK_SUCCESS ||
+        vkAllocateCommandBuffers(device->device, &cmdBufferAllocInfo, timer->endCommandBuffers) != VK_SUCCESS) {
+        crenvk_frame_timer_destroy(timer, device->device);
+        return;
+    }
+
+    // the commands never change, they're recorded once and resubmitted with every frame using the same slot
+    VkCommandBufferBeginInfo beginInfo = { 0 };
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    for (uint32_t i = 0; i < CREN_CONCURRENTLY_RENDERED_FRAMES; i++) {
+        vkBeginCommandBuffer(timer->beginCommandBuffers[i], &beginInfo);
+        vkCmdResetQueryPool(timer->beginCommandBuffers[i], timer->queryPool, i * 2, 2);
+        vkCmdWriteTimestamp(timer->beginCommandBuffers[i], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timer->queryPool, i * 2);
+        vkEndCommandBuffer(timer->beginCommandBuffers[i]);
+
+        vkBeginCommandBuffer(timer->endCommandBuffers[i], &beginInfo);
+        vkCmdWriteTimestamp(timer->endCommandBuffers[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timer->queryPool, i * 2 + 1);
+        vkEndCommandBuffer(timer->endCommandBuffers[i]);
+    }
+
+    timer->supported = true;
+}
+
+void crenvk_frame_timer_destroy(vkFrameTimer* timer, VkDevice device)
+{
+    if (timer->commandPool != VK_NULL_HANDLE) vkDestroyCommandPool(device, timer->commandPool, CRENVK_ALLOCATOR);
+    if (timer->queryPool != VK_NULL_HANDLE) vkDestroyQueryPool(device, timer->queryPool, CRENVK_ALLOCATOR);
+    memset(timer, 0, sizeof(vkFrameTimer));
+}
+
+void crenvk_frame_timer_collect(vkFrameTimer* timer, VkDevice device, uint32_t frame)
+{
+    if (!timer->supported || !timer->pending[frame]) return;
+    timer->pending[frame] = false;
+
+    uint64_t timestamps[2] = { 0 };
+    VkResult res = vkGetQueryPoolResults(device, timer->queryPool, frame * 2, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (res != VK_SUCCESS) return;
 
-    vkDestroySwapchainKHR(device, swapchain->swapchain, NULL);
+    uint64_t ticks = (timestamps[1] - timestamps[0]) & timer->timestampMask;
+    timer->lastFrameTime = (double)ticks * timer->timestampPeriod * 1e-9;
 }
 
 #endif // CREN_BUILD_WITH_VULKAN
\ No newline at end of file
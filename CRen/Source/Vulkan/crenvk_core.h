@@ -52,8 +52,9 @@ typedef struct {
     uint32_t presentModeCount;
 } vkSwapchainDetails;
 
-/// @brief cren vulkan swapchain
+/// @brief cren vulkan swapchain, without a surface it's made of offscreen images that are rendered to but never presented
 typedef struct {
+    bool offscreen;
     VkSurfaceFormatKHR swapchainFormat;
     VkPresentModeKHR swapchainPresentMode;
     VkExtent2D swapchainExtent;
@@ -61,6 +62,7 @@ typedef struct {
     VkSwapchainKHR swapchain;
     VkImage* swapchainImages;
     VkImageView* swapchainImageViews;
+    VkDeviceMemory* swapchainImagesMemory; // offscreen only, swapchain images are owned by the swapchain
 
     // used on sync
     uint32_t imageIndex;
@@ -71,10 +73,34 @@ typedef struct {
     VkFence* framesInFlightFences;
 } vkSwapchain;
 
+/// @brief gpu timestamps written around every frame in flight, measuring how long the gpu spends on a frame
+typedef struct {
+    bool supported;
+    double timestampPeriod;     // nanoseconds per tick
+    uint64_t timestampMask;     // valid bits of a timestamp
+    VkQueryPool queryPool;      // two queries per frame in flight
+    VkCommandPool commandPool;
+    VkCommandBuffer beginCommandBuffers[CREN_CONCURRENTLY_RENDERED_FRAMES];
+    VkCommandBuffer endCommandBuffers[CREN_CONCURRENTLY_RENDERED_FRAMES];
+    bool pending[CREN_CONCURRENTLY_RENDERED_FRAMES]; // submitted and not read back yet
+    double lastFrameTime;       // seconds, of the last frame read back
+} vkFrameTimer;
+
 #ifdef __cplusplus 
 extern "C" {
 #endif
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Allocation
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief returns the host allocation callbacks given to every vulkan object cren creates, the driver's memory goes through cren's host allocator under CREN_MEMORY_TAG_DRIVER
+/// returns NULL (the driver's own allocator) when CREN_USE_VULKAN_ALLOCATION_CALLBACKS is 0
+CREN_API const VkAllocationCallbacks* crenvk_get_allocation_callbacks();
+
+/// @brief shorthand for the allocation callbacks on vkCreate*/vkDestroy* calls, objects must be destroyed with the callbacks they were created with
+#define CRENVK_ALLOCATOR crenvk_get_allocation_callbacks()
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Instance
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -99,6 +125,7 @@ CREN_API void crenvk_device_create(vkDevice* device, VkInstance instance, bool v
 CREN_API void crenvk_device_destroy(vkDevice* device, VkInstance instance);
 
 /// @brief queries the queue indices for graphics, presentation and compute based on physical device and surface
+/// without a surface (headless) nothing is presented, the presentation queue is the graphics one
 CREN_API vkQueueFamilyIndices crenvk_device_find_queue_families(VkPhysicalDevice device, VkSurfaceKHR surface);
 
 /// @brief creates a buffer on the gpu
@@ -144,12 +171,29 @@ CREN_API void crenvk_device_insert_image_memory_barrier(VkCommandBuffer cmdBuffe
 // Swapchain
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/// @brief Creates the cren vulkan swapchain
-CREN_API void crenvk_swapchain_create(vkSwapchain* swapchain, VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t width, uint32_t height, bool vsync);
+/// @brief Creates the cren vulkan swapchain, presenting with presentMode or the closest supported mode
+/// without a surface (headless) it creates offscreen images of the requested size instead, one per frame in flight
+CREN_API void crenvk_swapchain_create(vkSwapchain* swapchain, VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t width, uint32_t height, CRen_PresentMode presentMode);
 
 /// @brief Releases all used resources by the swapchain
 CREN_API void crenvk_swapchain_destroy(vkSwapchain* swapchain, VkDevice device);
 
+/// @brief returns the cren present mode matching a vulkan one
+CREN_API CRen_PresentMode crenvk_swapchain_get_present_mode(const vkSwapchain* swapchain);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Frame timing
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief creates the frame timer, it's left unsupported (and never submitted) if the graphics queue can't write timestamps
+CREN_API void crenvk_frame_timer_create(vkFrameTimer* timer, const vkDevice* device);
+
+/// @brief releases the frame timer resources
+CREN_API void crenvk_frame_timer_destroy(vkFrameTimer* timer, VkDevice device);
+
+/// @brief reads back the timestamps of a frame in flight, call it once it's fence has been waited on
+CREN_API void crenvk_frame_timer_collect(vkFrameTimer* timer, VkDevice device, uint32_t frame);
+
 #ifdef __cplusplus 
 }
 #endif
@@ -4,6 +4,7 @@
 #include "cren_error.h"
 #include "cren_platform.h"
 #include "crenvk_buffer.h"
+#include "crenvk_core.h"
 
 #include <memm/memm.h>
 
@@ -124,7 +125,7 @@ CREN_API VkResult crenvk_pipeline_create(VkDevice device, vkPipelineCreateInfo*
 	descSetLayoutCI.flags = 0;
 	descSetLayoutCI.bindingCount = ci->bindingsCount;
 	descSetLayoutCI.pBindings = ci->bindings;
-	CREN_ASSERT(vkCreateDescriptorSetLayout(device, &descSetLayoutCI, NULL, &outPipe->descriptorSetLayout) == VK_SUCCESS, "Failed to create descriptor set layout");
+	CREN_ASSERT(vkCreateDescriptorSetLayout(device, &descSetLayoutCI, CRENVK_ALLOCATOR, &outPipe->descriptorSetLayout) == VK_SUCCESS, "Failed to create descriptor set layout");
 
 	// pipeline layout
 	VkPipelineLayoutCreateInfo pipelineLayoutCI = { 0 };
@@ -135,7 +136,7 @@ CREN_API VkResult crenvk_pipeline_create(VkDevice device, vkPipelineCreateInfo*
 	pipelineLayoutCI.pSetLayouts = &outPipe->descriptorSetLayout;
 	pipelineLayoutCI.pushConstantRangeCount = ci->pushConstantsCount;
 	pipelineLayoutCI.pPushConstantRanges = ci->pushConstants;
-	CREN_ASSERT(vkCreatePipelineLayout(device, &pipelineLayoutCI, NULL, &outPipe->layout) == VK_SUCCESS, "Failed to create pipeline layout");
+	CREN_ASSERT(vkCreatePipelineLayout(device, &pipelineLayoutCI, CRENVK_ALLOCATOR, &outPipe->layout) == VK_SUCCESS, "Failed to create pipeline layout");
 
 	// vertex input state
 	outPipe->vertexInputState = internal_crenvk_pipeline_populate_visci(outPipe, ci->vertexComponents, ci->vertexComponentsCount);
@@ -215,16 +216,16 @@ CREN_API void crenvk_pipeline_destroy(VkDevice device, vkPipeline* pipeline)
 
 	vkDeviceWaitIdle(device);
 
-	vkDestroyPipeline(device, pipeline->pipeline, NULL);
-	vkDestroyPipelineLayout(device, pipeline->layout, NULL); 
-	vkDestroyDescriptorSetLayout(device, pipeline->descriptorSetLayout, NULL);
+	vkDestroyPipeline(device, pipeline->pipeline, CRENVK_ALLOCATOR);
+	vkDestroyPipelineLayout(device, pipeline->layout, CRENVK_ALLOCATOR); 
+	vkDestroyDescriptorSetLayout(device, pipeline->descriptorSetLayout, CRENVK_ALLOCATOR);
 
 	if (pipeline->bindingsDescription != NULL) free(pipeline->bindingsDescription);
 	if (pipeline->attributesDescription != NULL) free(pipeline->attributesDescription);
 
 	// not ideal since shader module was first introduced on shader struct, but it's the same module after-all
-	vkDestroyShaderModule(device, pipeline->shaderStages[0].module, NULL);
-	vkDestroyShaderModule(device, pipeline->shaderStages[1].module, NULL);
+	vkDestroyShaderModule(device, pipeline->shaderStages[0].module, CRENVK_ALLOCATOR);
+	vkDestroyShaderModule(device, pipeline->shaderStages[1].module, CRENVK_ALLOCATOR);
 
 	free(pipeline);
 }
@@ -258,7 +259,7 @@ CREN_API VkResult crenvk_pipeline_build(VkDevice device, vkPipeline* pipeline)
 	ci.renderPass = pipeline->renderpass->renderPass;
 	ci.subpass = 0;
 
-	VkResult res = vkCreateGraphicsPipelines(device, pipeline->cache, 1, &ci, NULL, &pipeline->pipeline);
+	VkResult res = vkCreateGraphicsPipelines(device, pipeline->cache, 1, &ci, CRENVK_ALLOCATOR, &pipeline->pipeline);
 	if (res != VK_SUCCESS) {
 		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to build the graphics pipeline {%d}", res);
 		return res;
@@ -299,7 +300,7 @@ CREN_API vkShader crenvk_pipeline_create_shader(VkDevice device, const char* nam
     moduleCI.flags = 0;
     moduleCI.codeSize = spirvSize;
     moduleCI.pCode = spirvCode;
-    CREN_ASSERT(vkCreateShaderModule(device, &moduleCI, NULL, &shader.shaderStageCI.module) == VK_SUCCESS, "Failed to create shader module");
+    CREN_ASSERT(vkCreateShaderModule(device, &moduleCI, CRENVK_ALLOCATOR, &shader.shaderStageCI.module) == VK_SUCCESS, "Failed to create shader module");
     
     free(spirvCode);
     return shader;
@@ -309,17 +310,28 @@ CREN_API void crenvk_pipeline_renderpass_release(VkDevice device, vkRenderpass*
 {
 	vkDeviceWaitIdle(device);
 
-	if (renderpass->renderPass != VK_NULL_HANDLE) vkDestroyRenderPass(device, renderpass->renderPass, NULL);
+	if (renderpass->renderPass != VK_NULL_HANDLE) vkDestroyRenderPass(device, renderpass->renderPass, CRENVK_ALLOCATOR);
 	if (renderpass->commandBuffers) vkFreeCommandBuffers(device, renderpass->commandPool, CREN_CONCURRENTLY_RENDERED_FRAMES, renderpass->commandBuffers);
-	if (renderpass->commandPool != VK_NULL_HANDLE) vkDestroyCommandPool(device, renderpass->commandPool, NULL);
+	if (renderpass->commandPool != VK_NULL_HANDLE) vkDestroyCommandPool(device, renderpass->commandPool, CRENVK_ALLOCATOR);
 
 	for (unsigned int i = 0; i < renderpass->framebuffersCount; i++) {
-		vkDestroyFramebuffer(device, renderpass->framebuffers[i], NULL);
+		vkDestroyFramebuffer(device, renderpass->framebuffers[i], CRENVK_ALLOCATOR);
 	}
 	free(renderpass->framebuffers);
 	free(renderpass);
 }
 
+CREN_API void crenvk_pipeline_preload_quad(const char* rootPath)
+{
+	const char* shaders[] = { "shaders/compiled/quad.vert.spv", "shaders/compiled/quad.frag.spv", "shaders/compiled/quad_picking.vert.spv", "shaders/compiled/quad_picking.frag.spv" };
+
+	for (size_t i = 0; i < sizeof(shaders) / sizeof(shaders[0]); i++) {
+		char path[CREN_PATH_MAX_SIZE];
+		cren_get_path(shaders[i], rootPath, 0, path, sizeof(path));
+		cren_preload_file(path);
+	}
+}
+
 CREN_API VkResult crenvk_pipeline_create_quad(shashtable* pipelines, vkRenderpass* usedRenderpass, vkRenderpass* pickingRenderpass, VkDevice device, const char* rootPath)
 {
 	// default pipeline
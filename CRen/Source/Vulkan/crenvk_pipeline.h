@@ -122,6 +122,9 @@ CREN_API void crenvk_pipeline_renderpass_release(VkDevice device, vkRenderpass*
 /// @brief creates the quad-related pipelines
 CREN_API VkResult crenvk_pipeline_create_quad(shashtable* pipelines, vkRenderpass* usedRenderpass, vkRenderpass* pickingRenderpass, VkDevice device, const char* rootPath);
 
+/// @brief reads the spirv of the quad-related pipelines ahead of time, it needs no device so it may overlap it's creation on another thread
+CREN_API void crenvk_pipeline_preload_quad(const char* rootPath);
+
 #ifdef __cplusplus 
 }
 #endif
@@ -2,7 +2,9 @@
 
 #include "cren_context.h"
 #include "cren_error.h"
+#include "cren_memory.h"
 #include "cren_platform.h"
+#include "cren_pool.h"
 #include "crenvk_buffer.h"
 
 #include <memm/memm.h>
@@ -30,13 +32,12 @@ CREN_API VkResult crenvk_texture2d_create_from_path(CRenVulkanBackend* backend,
     }
 
     // allocate and initialize texture structure
-    CRenVKTexture2D* texture = (CRenVKTexture2D*)malloc(sizeof(CRenVKTexture2D));
+    CRenVKTexture2D* texture = (CRenVKTexture2D*)cren_pool_alloc(backend->texturePool);
     if (!texture) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate memory for texture: %s", path);
         return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    memset(texture, 0, sizeof(CRenVKTexture2D));
     texture->image = VK_NULL_HANDLE;
     texture->memory = VK_NULL_HANDLE;
     texture->view = VK_NULL_HANDLE;
@@ -90,6 +91,11 @@ CREN_API VkResult crenvk_texture2d_create_from_path(CRenVulkanBackend* backend,
             break;
         }
 
+        VkMemoryRequirements memRequirements;
+        vkGetImageMemoryRequirements(backend->device.device, texture->image, &memRequirements);
+        texture->memorySize = memRequirements.size;
+        cren_memory_track(CREN_MEMORY_TAG_TEXTURES, (size_t)texture->memorySize);
+
         // transfer operations
         cmd = crenvk_device_begin_commandbuffer_singletime(backend->device.device, renderpass->commandPool);
         if (!cmd) {
@@ -181,11 +187,10 @@ CREN_API VkResult crenvk_texture2d_create_from_path(CRenVulkanBackend* backend,
 
     // cleanup
     if (pixels) cren_stbimage_destroy(pixels);
-    if (stagingBuffer != VK_NULL_HANDLE) vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
-    if (stagingMemory != VK_NULL_HANDLE) vkFreeMemory(backend->device.device, stagingMemory, NULL);
+    if (stagingBuffer != VK_NULL_HANDLE) vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
+    if (stagingMemory != VK_NULL_HANDLE) vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
     if (texture) {
         crenvk_texture2d_destroy(backend, texture);
-        free(texture);
     }
 
     return result;
@@ -208,12 +213,11 @@ CREN_API VkResult crenvk_texture2d_create_from_buffer(CRenVulkanBackend* backend
     }
 
     // allocate and initialize texture structure
-    CRenVKTexture2D* texture = (CRenVKTexture2D*)malloc(sizeof(CRenVKTexture2D));
+    CRenVKTexture2D* texture = (CRenVKTexture2D*)cren_pool_alloc(backend->texturePool);
     if (!texture) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate memory for texture from buffer");
         return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
-    memset(texture, 0, sizeof(CRenVKTexture2D));
 
     // initialize with safe defaults
     texture->image = VK_NULL_HANDLE;
@@ -259,6 +263,11 @@ CREN_API VkResult crenvk_texture2d_create_from_buffer(CRenVulkanBackend* backend
             break;
         }
 
+        VkMemoryRequirements memRequirements;
+        vkGetImageMemoryRequirements(backend->device.device, texture->image, &memRequirements);
+        texture->memorySize = memRequirements.size;
+        cren_memory_track(CREN_MEMORY_TAG_TEXTURES, (size_t)texture->memorySize);
+
         // begin command buffer for transfer operations
         cmd = crenvk_device_begin_commandbuffer_singletime(backend->device.device, renderpass->commandPool);
         if (!cmd) {
@@ -349,11 +358,10 @@ CREN_API VkResult crenvk_texture2d_create_from_buffer(CRenVulkanBackend* backend
     } while (0);
 
     // cleanup
-    if (stagingBuffer != VK_NULL_HANDLE) vkDestroyBuffer(backend->device.device, stagingBuffer, NULL);
-    if (stagingMemory != VK_NULL_HANDLE) vkFreeMemory(backend->device.device, stagingMemory, NULL);
+    if (stagingBuffer != VK_NULL_HANDLE) vkDestroyBuffer(backend->device.device, stagingBuffer, CRENVK_ALLOCATOR);
+    if (stagingMemory != VK_NULL_HANDLE) vkFreeMemory(backend->device.device, stagingMemory, CRENVK_ALLOCATOR);
     if (texture) {
         crenvk_texture2d_destroy(backend, texture);
-        free(texture);
     }
 
     return result;
@@ -365,12 +373,15 @@ CREN_API void crenvk_texture2d_destroy(CRenVulkanBackend* backend, CRenVKTexture
     CREN_ASSERT(backend != NULL, "Vulkan Backend is NULL");
     CREN_ASSERT(texture != NULL, "Vulkan Texture is NULL");
 
-    if (texture->sampler != VK_NULL_HANDLE) vkDestroySampler(backend->device.device, texture->sampler, NULL);
-    if (texture->view != VK_NULL_HANDLE) vkDestroyImageView(backend->device.device, texture->view, NULL);
-    if (texture->image != VK_NULL_HANDLE) vkDestroyImage(backend->device.device, texture->image, NULL);
-    if (texture->memory != VK_NULL_HANDLE) vkFreeMemory(backend->device.device, texture->memory, NULL);
+    if (texture->sampler != VK_NULL_HANDLE) vkDestroySampler(backend->device.device, texture->sampler, CRENVK_ALLOCATOR);
+    if (texture->view != VK_NULL_HANDLE) vkDestroyImageView(backend->device.device, texture->view, CRENVK_ALLOCATOR);
+    if (texture->image != VK_NULL_HANDLE) vkDestroyImage(backend->device.device, texture->image, CRENVK_ALLOCATOR);
+    if (texture->memory != VK_NULL_HANDLE) {
+        vkFreeMemory(backend->device.device, texture->memory, CRENVK_ALLOCATOR);
+        if (texture->memorySize > 0) cren_memory_untrack(CREN_MEMORY_TAG_TEXTURES, (size_t)texture->memorySize);
+    }
 
-    free(texture);
+    cren_pool_free(backend->texturePool, texture);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -393,18 +404,18 @@ CREN_API VkResult crenvk_quad_create_from_path(CRenVulkanBackend* backend, const
     }
 
     // allocate and initialize quad structure
-    CRenVKQuad* quad = (CRenVKQuad*)malloc(sizeof(CRenVKQuad));
+    CRenVKQuad* quad = (CRenVKQuad*)cren_pool_alloc(backend->quadPool);
     if (!quad) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate memory for quad: %s", albedoPath);
         return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    memset(quad, 0, sizeof(CRenVKQuad));
     for (uint32_t i = 0; i < CREN_CONCURRENTLY_RENDERED_FRAMES; i++) {
         quad->descriptorSets[i] = VK_NULL_HANDLE;
     }
     quad->buffer = NULL;
     quad->descriptorPool = VK_NULL_HANDLE;
+    quad->staleFrames = 0;
     quad->params.billboard = 0.0f;
     quad->params.uv_rotation = 0.0f;
     quad->params.lockAxis.xy.x = 0.0f;
@@ -486,7 +497,7 @@ CREN_API VkResult crenvk_quad_create_from_path(CRenVulkanBackend* backend, const
         descriptorPoolCI.pPoolSizes = poolSizes;
         descriptorPoolCI.maxSets = CREN_CONCURRENTLY_RENDERED_FRAMES;
 
-        result = vkCreateDescriptorPool(backend->device.device, &descriptorPoolCI, NULL, &quad->descriptorPool);
+        result = vkCreateDescriptorPool(backend->device.device, &descriptorPoolCI, CRENVK_ALLOCATOR, &quad->descriptorPool);
         if (result != VK_SUCCESS) {
             CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create descriptor pool for quad: %s", albedoPath);
             break;
@@ -527,7 +538,6 @@ CREN_API VkResult crenvk_quad_create_from_path(CRenVulkanBackend* backend, const
     if (staging) crenvk_buffer_destroy(backend->device.device, staging);
     if (quad) {
         crenvk_quad_destroy(backend, quad);
-        free(quad);
     }
 
     return result;
@@ -537,24 +547,16 @@ CREN_API void crenvk_quad_destroy(CRenVulkanBackend* backend, CRenVKQuad* quad)
 {
     if (!quad || !backend) return;
     if (quad->buffer) crenvk_buffer_destroy(backend->device.device, quad->buffer);
-    if (quad->descriptorPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(backend->device.device, quad->descriptorPool, NULL);
+    if (quad->descriptorPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(backend->device.device, quad->descriptorPool, CRENVK_ALLOCATOR);
 
-    free(quad);
+    cren_pool_free(backend->quadPool, quad);
 }
 
 CREN_API void crenvk_quad_update(CRenVulkanBackend* backend, CRenVKQuad* quad)
 {
     if (!backend || !quad) return;
     
-    if (quad->buffer) {
-        for(uint32_t i = 0; i < CREN_CONCURRENTLY_RENDERED_FRAMES; i++) {
-            
-            crenvk_buffer_map(backend->device.device, quad->buffer, i);
-            crenvk_buffer_copy(quad->buffer, i, &quad->params, sizeof(BufferQuad), 0);
-            crenvk_buffer_flush(backend->device.device, quad->buffer, i, sizeof(BufferQuad), backend->device.atomSize, 0);
-            crenvk_buffer_unmap(backend->device.device, quad->buffer, i);
-        }
-    }
+    quad->staleFrames = (1u << CREN_CONCURRENTLY_RENDERED_FRAMES) - 1;
 }
 
 CREN_API void crenvk_quad_render(CRenVulkanBackend* backend, CRenVKQuad* quad, CRen_RenderStage stage, const fmat4 modelMatrix, uint32_t id, bool usingCustomViewport)
@@ -590,6 +592,15 @@ CREN_API void crenvk_quad_render(CRenVulkanBackend* backend, CRenVKQuad* quad, C
 
     pipelineLayout = crenPipe->layout;
 
+    // the frame's fence was waited on, it's buffer isn't read by the gpu anymore
+    if (quad->buffer && (quad->staleFrames & (1u << currentFrame))) {
+        crenvk_buffer_map(backend->device.device, quad->buffer, currentFrame);
+        crenvk_buffer_copy(quad->buffer, currentFrame, &quad->params, sizeof(BufferQuad), 0);
+        crenvk_buffer_flush(backend->device.device, quad->buffer, currentFrame, sizeof(BufferQuad), backend->device.atomSize, 0);
+        crenvk_buffer_unmap(backend->device.device, quad->buffer, currentFrame);
+        quad->staleFrames &= ~(1u << currentFrame);
+    }
+
     BufferConstant constants = { 0 };
     constants.id = id;
     constants.model = modelMatrix;
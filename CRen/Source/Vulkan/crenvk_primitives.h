@@ -23,6 +23,7 @@ typedef struct CRenVKTexture2D
 	VkSampler sampler;
 	VkImageView view;
 	VkDescriptorSet uiDescriptor;
+	VkDeviceSize memorySize; // tracked under CREN_MEMORY_TAG_TEXTURES
 } CRenVKTexture2D;
 
 /// @brief creates a 2d texture based on disk path
@@ -42,6 +43,7 @@ CREN_API void crenvk_texture2d_destroy(CRenVulkanBackend* backend, CRenVKTexture
 typedef struct CRenVKQuad
 {
 	BufferQuad params;
+	uint32_t staleFrames; // bit per frame in flight whose buffer still holds older params
 	vkBuffer* buffer;
 	VkDescriptorPool descriptorPool;
 	VkDescriptorSet descriptorSets[CREN_CONCURRENTLY_RENDERED_FRAMES];
@@ -53,7 +55,7 @@ CREN_API VkResult crenvk_quad_create_from_path(CRenVulkanBackend* backend, const
 /// @brief releases all resources used by a quad
 CREN_API void crenvk_quad_destroy(CRenVulkanBackend* backend, CRenVKQuad* quad);
 
-/// @brief re-upload modified data to the gpu
+/// @brief marks the params as modified, each frame's buffer is re-uploaded once that frame draws the quad again, so buffers still read by the gpu are left alone
 CREN_API void crenvk_quad_update(CRenVulkanBackend* backend, CRenVKQuad* quad);
 
 /// @brief renders the quad into the world
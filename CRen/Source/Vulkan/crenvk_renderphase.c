@@ -14,7 +14,7 @@
 
 CREN_API VkResult crenvk_renderphase_default_create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, VkFormat format, VkSampleCountFlagBits msaa, bool finalPhase, vkDefaultRenderphase* outPhase)
 {
-    if (device == VK_NULL_HANDLE || physicalDevice == VK_NULL_HANDLE || surface == VK_NULL_HANDLE || outPhase == NULL) return VK_ERROR_INVALID_EXTERNAL_HANDLE;
+    if (device == VK_NULL_HANDLE || physicalDevice == VK_NULL_HANDLE || outPhase == NULL) return VK_ERROR_INVALID_EXTERNAL_HANDLE;
 
     VkResult res = VK_SUCCESS;
     outPhase->renderpass = (vkRenderpass*)malloc(sizeof(vkRenderpass));
@@ -100,7 +100,7 @@ CREN_API VkResult crenvk_renderphase_default_create(VkDevice device, VkPhysicalD
     renderPassCI.pSubpasses = &subpass;
     renderPassCI.dependencyCount = 2u;
     renderPassCI.pDependencies = dependencies;
-    CREN_ASSERT(vkCreateRenderPass(device, &renderPassCI, NULL, &outPhase->renderpass->renderPass) == VK_SUCCESS, "Failed to create default renderphase's renderpass");
+    CREN_ASSERT(vkCreateRenderPass(device, &renderPassCI, CRENVK_ALLOCATOR, &outPhase->renderpass->renderPass) == VK_SUCCESS, "Failed to create default renderphase's renderpass");
 
     // command pool and command buffers
     vkRenderpass* renderpass = outPhase->renderpass;
@@ -110,7 +110,7 @@ CREN_API VkResult crenvk_renderphase_default_create(VkDevice device, VkPhysicalD
     cmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     cmdPoolInfo.queueFamilyIndex = indices.graphicFamily;
     cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    res = vkCreateCommandPool(device, &cmdPoolInfo, NULL, &renderpass->commandPool);
+    res = vkCreateCommandPool(device, &cmdPoolInfo, CRENVK_ALLOCATOR, &renderpass->commandPool);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create default renderphase command pool");
         return res;
@@ -137,13 +137,13 @@ CREN_API void crenvk_renderphase_default_destroy(vkDefaultRenderphase* renderpha
     if (destroyRenderpass) crenvk_pipeline_renderpass_release(device, renderphase->renderpass);
     if (destroyPipeline) crenvk_pipeline_destroy(device, renderphase->pipeline);
 
-    vkDestroyImage(device, renderphase->colorImage, NULL);
-    vkFreeMemory(device, renderphase->colorMemory, NULL);
-    vkDestroyImageView(device, renderphase->colorView, NULL);
+    vkDestroyImage(device, renderphase->colorImage, CRENVK_ALLOCATOR);
+    vkFreeMemory(device, renderphase->colorMemory, CRENVK_ALLOCATOR);
+    vkDestroyImageView(device, renderphase->colorView, CRENVK_ALLOCATOR);
 
-    vkDestroyImage(device, renderphase->depthImage, NULL);
-    vkFreeMemory(device, renderphase->depthMemory, NULL);
-    vkDestroyImageView(device, renderphase->depthView, NULL);
+    vkDestroyImage(device, renderphase->depthImage, CRENVK_ALLOCATOR);
+    vkFreeMemory(device, renderphase->depthMemory, CRENVK_ALLOCATOR);
+    vkDestroyImageView(device, renderphase->depthView, CRENVK_ALLOCATOR);
 }
 
 CREN_API VkResult crenvk_renderphase_default_create_framebuffers(vkDefaultRenderphase* phase, VkDevice device, VkPhysicalDevice physicalDevice, VkImageView* views, uint32_t viewsCount, VkExtent2D extent, VkFormat colorFormat)
@@ -228,7 +228,7 @@ CREN_API VkResult crenvk_renderphase_default_create_framebuffers(vkDefaultRender
         fbci.height = extent.height;
         fbci.layers = 1;
 
-        res = vkCreateFramebuffer(device, &fbci, NULL, &renderpass->framebuffers[i]);
+        res = vkCreateFramebuffer(device, &fbci, CRENVK_ALLOCATOR, &renderpass->framebuffers[i]);
         if (res != VK_SUCCESS) {
             CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create default renderphase framebuffer");
             return res;
@@ -241,16 +241,16 @@ CREN_API VkResult crenvk_renderphase_default_create_framebuffers(vkDefaultRender
 CREN_API void crenvk_renderphase_default_recreate(vkDefaultRenderphase* phase, vkSwapchain* swapchain, VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, VkSampleCountFlagBits msaa, VkExtent2D extent, bool finalPhase, bool vsync)
 {
     // must recreate some default phase objects
-    vkDestroyImageView(device, phase->depthView, NULL);
-    vkDestroyImage(device, phase->depthImage, NULL);
-    vkFreeMemory(device, phase->depthMemory, NULL);
+    vkDestroyImageView(device, phase->depthView, CRENVK_ALLOCATOR);
+    vkDestroyImage(device, phase->depthImage, CRENVK_ALLOCATOR);
+    vkFreeMemory(device, phase->depthMemory, CRENVK_ALLOCATOR);
 
-    vkDestroyImageView(device, phase->colorView, NULL);
-    vkDestroyImage(device, phase->colorImage, NULL);
-    vkFreeMemory(device, phase->colorMemory, NULL);
+    vkDestroyImageView(device, phase->colorView, CRENVK_ALLOCATOR);
+    vkDestroyImage(device, phase->colorImage, CRENVK_ALLOCATOR);
+    vkFreeMemory(device, phase->colorMemory, CRENVK_ALLOCATOR);
 
     for (uint32_t i = 0; i < phase->renderpass->framebuffersCount; i++) {
-        vkDestroyFramebuffer(device, phase->renderpass->framebuffers[i], NULL);
+        vkDestroyFramebuffer(device, phase->renderpass->framebuffers[i], CRENVK_ALLOCATOR);
     }
     free(phase->renderpass->framebuffers);
 
@@ -323,7 +323,7 @@ CREN_API void crenvk_renderphase_default_update(vkDefaultRenderphase* phase, voi
 
 CREN_API VkResult crenvk_renderphase_picking_create(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, vkPickingRenderphase* outPhase)
 {
-    if (device == VK_NULL_HANDLE || physicalDevice == VK_NULL_HANDLE || surface == VK_NULL_HANDLE || !outPhase) return VK_ERROR_INITIALIZATION_FAILED;
+    if (device == VK_NULL_HANDLE || physicalDevice == VK_NULL_HANDLE || !outPhase) return VK_ERROR_INITIALIZATION_FAILED;
 
     outPhase->renderpass = (vkRenderpass*)malloc(sizeof(vkRenderpass));
     outPhase->imageSize = 1 * 8; // (RED Channel) * 8 bits
@@ -398,7 +398,7 @@ CREN_API VkResult crenvk_renderphase_picking_create(VkDevice device, VkPhysicalD
     renderPassCI.dependencyCount = 2U;
     renderPassCI.pDependencies = dependencies;
 
-    VkResult res = vkCreateRenderPass(device, &renderPassCI, NULL, &outPhase->renderpass->renderPass);
+    VkResult res = vkCreateRenderPass(device, &renderPassCI, CRENVK_ALLOCATOR, &outPhase->renderpass->renderPass);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create picking renderphase renderpass");
         return res;
@@ -410,7 +410,7 @@ CREN_API VkResult crenvk_renderphase_picking_create(VkDevice device, VkPhysicalD
     cmdPoolInfo.queueFamilyIndex = indices.graphicFamily;
     cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
-    res = vkCreateCommandPool(device, &cmdPoolInfo, NULL, &outPhase->renderpass->commandPool);
+    res = vkCreateCommandPool(device, &cmdPoolInfo, CRENVK_ALLOCATOR, &outPhase->renderpass->commandPool);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create picking renderphasse command pool");
         return res;
@@ -438,14 +438,14 @@ CREN_API void crenvk_renderphase_picking_destroy(vkPickingRenderphase* phase, Vk
     if (destroyRenderpass) crenvk_pipeline_renderpass_release(device, phase->renderpass);
     if (destroyPipeline) crenvk_pipeline_destroy(device, phase->pipeline);
 
-    vkDestroyImageView(device, phase->depthView, NULL);
-    vkDestroyImage(device, phase->depthImage, NULL);
-    vkFreeMemory(device, phase->depthMemory, NULL);
+    vkDestroyImageView(device, phase->depthView, CRENVK_ALLOCATOR);
+    vkDestroyImage(device, phase->depthImage, CRENVK_ALLOCATOR);
+    vkFreeMemory(device, phase->depthMemory, CRENVK_ALLOCATOR);
 
     for (uint32_t i = 0; i < phase->colorImageCount; i++) {
-        vkDestroyImageView(device, phase->colorView[i], NULL);
-        vkDestroyImage(device, phase->colorImage[i], NULL);
-        vkFreeMemory(device, phase->colorMemory[i], NULL);
+        vkDestroyImageView(device, phase->colorView[i], CRENVK_ALLOCATOR);
+        vkDestroyImage(device, phase->colorImage[i], CRENVK_ALLOCATOR);
+        vkFreeMemory(device, phase->colorMemory[i], CRENVK_ALLOCATOR);
     }
     free(phase->colorImage);
     free(phase->colorMemory);
@@ -556,7 +556,7 @@ CREN_API VkResult crenvk_renderphase_picking_create_framebuffers(vkPickingRender
         framebufferCI.width = extent.width;
         framebufferCI.height = extent.height;
         framebufferCI.layers = 1;
-        res = vkCreateFramebuffer(device, &framebufferCI, NULL, &phase->renderpass->framebuffers[i]);
+        res = vkCreateFramebuffer(device, &framebufferCI, CRENVK_ALLOCATOR, &phase->renderpass->framebuffers[i]);
         if (res != VK_SUCCESS) {
             CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create picking framebuffer");
             return res;
@@ -569,21 +569,21 @@ CREN_API VkResult crenvk_renderphase_picking_create_framebuffers(vkPickingRender
 CREN_API void crenvk_renderphase_picking_recreate(vkPickingRenderphase* phase, vkSwapchain* swapchain, VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, VkQueue graphicsQueue, VkExtent2D extent)
 {
     CREN_LOG(CREN_LOG_SEVERITY_TRACE,"Recreating %s with extent %dx%d", "Picking", extent.width, extent.height);
-    vkDestroyImage(device, phase->depthImage, NULL);
-    vkFreeMemory(device, phase->depthMemory, NULL);
-    vkDestroyImageView(device, phase->depthView, NULL);
+    vkDestroyImage(device, phase->depthImage, CRENVK_ALLOCATOR);
+    vkFreeMemory(device, phase->depthMemory, CRENVK_ALLOCATOR);
+    vkDestroyImageView(device, phase->depthView, CRENVK_ALLOCATOR);
 
     for (uint32_t i = 0; i < phase->colorImageCount; i++) {
-        vkDestroyImage(device, phase->colorImage[i], NULL);
-        vkFreeMemory(device, phase->colorMemory[i], NULL);
-        vkDestroyImageView(device, phase->colorView[i], NULL);
+        vkDestroyImage(device, phase->colorImage[i], CRENVK_ALLOCATOR);
+        vkFreeMemory(device, phase->colorMemory[i], CRENVK_ALLOCATOR);
+        vkDestroyImageView(device, phase->colorView[i], CRENVK_ALLOCATOR);
     }
     free(phase->colorImage);
     free(phase->colorMemory);
     free(phase->colorView);
 
     for (uint32_t i = 0; i < phase->renderpass->framebuffersCount; i++) {
-        vkDestroyFramebuffer(device, phase->renderpass->framebuffers[i], NULL);
+        vkDestroyFramebuffer(device, phase->renderpass->framebuffers[i], CRENVK_ALLOCATOR);
     }
     free(phase->renderpass->framebuffers);
 
@@ -630,10 +630,10 @@ CREN_API void crenvk_renderphase_picking_update(vkPickingRenderphase* phase, voi
     viewport.maxDepth = 1.0f;
     vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
 
-    float2 screenCoord = cren_get_mousepos((CRenContext*)context);
+    float2 screenCoord = cren_get_render_mousepos((CRenContext*)context);
     float2 winSize = { (float)vkBackend->swapchain.swapchainExtent.width, (float)vkBackend->swapchain.swapchainExtent.height };
     if (cren_using_custom_viewport((CRenContext*)context)) {
-        winSize = cren_get_viewport_size((CRenContext*)context);
+        winSize = cren_get_render_viewport_size((CRenContext*)context);
     }
     uint32_t fbX = (uint32_t)(screenCoord.xy.x * vkBackend->swapchain.swapchainExtent.width / winSize.xy.x);
     uint32_t fbY = (uint32_t)(screenCoord.xy.y * vkBackend->swapchain.swapchainExtent.height / winSize.xy.y);
@@ -705,7 +705,7 @@ CREN_API VkResult crenvk_renderphase_ui_create(VkDevice device, VkPhysicalDevice
     info.pSubpasses = &subpass;
     info.dependencyCount = 1;
     info.pDependencies = &dependency;
-    VkResult res = vkCreateRenderPass(device, &info, NULL, &outPhase->renderpass->renderPass);
+    VkResult res = vkCreateRenderPass(device, &info, CRENVK_ALLOCATOR, &outPhase->renderpass->renderPass);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create ui renderphase renderpass");
         return res;
@@ -717,7 +717,7 @@ CREN_API VkResult crenvk_renderphase_ui_create(VkDevice device, VkPhysicalDevice
     cmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     cmdPoolInfo.queueFamilyIndex = indices.graphicFamily;
     cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    res = vkCreateCommandPool(device, &cmdPoolInfo, NULL, &outPhase->renderpass->commandPool);
+    res = vkCreateCommandPool(device, &cmdPoolInfo, CRENVK_ALLOCATOR, &outPhase->renderpass->commandPool);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create ui renderphase command pool");
         return res;
@@ -744,7 +744,7 @@ CREN_API VkResult crenvk_renderphase_ui_create(VkDevice device, VkPhysicalDevice
     descInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     descInfo.bindingCount = 1;
     descInfo.pBindings = binding;
-    res = vkCreateDescriptorSetLayout(device, &descInfo, NULL, &outPhase->descSetLayout);
+    res = vkCreateDescriptorSetLayout(device, &descInfo, CRENVK_ALLOCATOR, &outPhase->descSetLayout);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create ui descriptor set layout");
         return res;
@@ -772,7 +772,7 @@ CREN_API VkResult crenvk_renderphase_ui_create(VkDevice device, VkPhysicalDevice
     poolCI.maxSets = 1000 * 11U;
     poolCI.poolSizeCount = 11U;
     poolCI.pPoolSizes = poolSizes;
-    res = vkCreateDescriptorPool(device, &poolCI, NULL, &outPhase->descPool);
+    res = vkCreateDescriptorPool(device, &poolCI, CRENVK_ALLOCATOR, &outPhase->descPool);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create descriptor pool for the ui");
         return res;
@@ -787,8 +787,8 @@ CREN_API void crenvk_renderphase_ui_destroy(vkUIRenderphase* phase, VkDevice dev
 
     if (destroyRenderpass) crenvk_pipeline_renderpass_release(device, phase->renderpass);
 
-    vkDestroyDescriptorSetLayout(device, phase->descSetLayout, NULL);
-    vkDestroyDescriptorPool(device, phase->descPool, NULL);
+    vkDestroyDescriptorSetLayout(device, phase->descSetLayout, CRENVK_ALLOCATOR);
+    vkDestroyDescriptorPool(device, phase->descPool, CRENVK_ALLOCATOR);
 }
 
 CREN_API VkResult crenvk_renderphase_ui_framebuffers_create(vkUIRenderphase* phase, VkDevice device, VkExtent2D extent, VkImageView* swapchainViews, uint32_t swapchainViewsCount)
@@ -809,7 +809,7 @@ CREN_API VkResult crenvk_renderphase_ui_framebuffers_create(vkUIRenderphase* pha
         framebufferCI.height = extent.height;
         framebufferCI.layers = 1;
 
-        VkResult res = vkCreateFramebuffer(device, &framebufferCI, NULL, &phase->renderpass->framebuffers[i]);
+        VkResult res = vkCreateFramebuffer(device, &framebufferCI, CRENVK_ALLOCATOR, &phase->renderpass->framebuffers[i]);
         if (res != VK_SUCCESS) {
             CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create ui renderphase framebuffer");
             return res;
@@ -821,7 +821,7 @@ CREN_API VkResult crenvk_renderphase_ui_framebuffers_create(vkUIRenderphase* pha
 CREN_API void crenvk_renderphase_ui_recreate(vkUIRenderphase* phase, vkSwapchain* swapchain, VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, VkExtent2D extent)
 {
     for (uint32_t i = 0; i < phase->renderpass->framebuffersCount; i++) {
-        vkDestroyFramebuffer(device, phase->renderpass->framebuffers[i], NULL);
+        vkDestroyFramebuffer(device, phase->renderpass->framebuffers[i], CRENVK_ALLOCATOR);
     }
     free(phase->renderpass->framebuffers);
     crenvk_renderphase_ui_framebuffers_create(phase, device, extent, swapchain->swapchainImageViews, swapchain->swapchainImageCount);
@@ -949,7 +949,7 @@ CREN_API VkResult crenvk_renderphase_viewport_create(VkDevice device, VkPhysical
     renderPassCI.dependencyCount = dependenciesSize;
     renderPassCI.pDependencies = dependencies;
 
-    VkResult res = vkCreateRenderPass(device, &renderPassCI, NULL, &outPhase->renderpass->renderPass);
+    VkResult res = vkCreateRenderPass(device, &renderPassCI, CRENVK_ALLOCATOR, &outPhase->renderpass->renderPass);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create vulkan renderpass for the viewport render phase");
         return res;
@@ -961,7 +961,7 @@ CREN_API VkResult crenvk_renderphase_viewport_create(VkDevice device, VkPhysical
     cmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     cmdPoolInfo.queueFamilyIndex = indices.graphicFamily;
     cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    res = vkCreateCommandPool(device, &cmdPoolInfo, NULL, &outPhase->renderpass->commandPool);
+    res = vkCreateCommandPool(device, &cmdPoolInfo, CRENVK_ALLOCATOR, &outPhase->renderpass->commandPool);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create viewport renderphase command pool");
         return res;
@@ -987,17 +987,17 @@ CREN_API void crenvk_renderphase_viewport_destroy(vkViewportRenderphase* phase,
     vkDeviceWaitIdle(device);
     if (destroyRenderpass) crenvk_pipeline_renderpass_release(device, phase->renderpass);
 
-    vkDestroySampler(device, phase->sampler, NULL);
-    vkDestroyDescriptorPool(device, phase->descriptorPool, NULL);
-    vkDestroyDescriptorSetLayout(device, phase->descriptorSetLayout, NULL);
+    vkDestroySampler(device, phase->sampler, CRENVK_ALLOCATOR);
+    vkDestroyDescriptorPool(device, phase->descriptorPool, CRENVK_ALLOCATOR);
+    vkDestroyDescriptorSetLayout(device, phase->descriptorSetLayout, CRENVK_ALLOCATOR);
 
-    vkDestroyImageView(device, phase->depthView, NULL);
-    vkDestroyImage(device, phase->depthImage, NULL);
-    vkFreeMemory(device, phase->depthMemory, NULL);
+    vkDestroyImageView(device, phase->depthView, CRENVK_ALLOCATOR);
+    vkDestroyImage(device, phase->depthImage, CRENVK_ALLOCATOR);
+    vkFreeMemory(device, phase->depthMemory, CRENVK_ALLOCATOR);
 
-    vkDestroyImageView(device, phase->colorView, NULL);
-    vkDestroyImage(device, phase->colorImage, NULL);
-    vkFreeMemory(device, phase->colorMemory, NULL);
+    vkDestroyImageView(device, phase->colorView, CRENVK_ALLOCATOR);
+    vkDestroyImage(device, phase->colorImage, CRENVK_ALLOCATOR);
+    vkFreeMemory(device, phase->colorMemory, CRENVK_ALLOCATOR);
 }
 
 CREN_API VkResult crenvk_renderphase_viewport_create_framebuffers(vkViewportRenderphase* phase, VkDevice device, VkPhysicalDevice physicalDevice, VkQueue graphicsQueue, VkImageView* swapchainViews, uint32_t swapchainViewCount, VkExtent2D extent)
@@ -1014,7 +1014,7 @@ CREN_API VkResult crenvk_renderphase_viewport_create_framebuffers(vkViewportRend
     poolCI.maxSets = (unsigned int)(2 * CREN_STATIC_ARRAY_SIZE(poolSizes));
     poolCI.poolSizeCount = (unsigned int)CREN_STATIC_ARRAY_SIZE(poolSizes);
     poolCI.pPoolSizes = poolSizes;
-    VkResult res = vkCreateDescriptorPool(device, &poolCI, NULL, &phase->descriptorPool);
+    VkResult res = vkCreateDescriptorPool(device, &poolCI, CRENVK_ALLOCATOR, &phase->descriptorPool);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create viewport descriptor pool");
         return res;
@@ -1030,7 +1030,7 @@ CREN_API VkResult crenvk_renderphase_viewport_create_framebuffers(vkViewportRend
     info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     info.bindingCount = 1;
     info.pBindings = binding;
-    res = vkCreateDescriptorSetLayout(device, &info, NULL, &phase->descriptorSetLayout);
+    res = vkCreateDescriptorSetLayout(device, &info, CRENVK_ALLOCATOR, &phase->descriptorSetLayout);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create vulkan descriptor set layout for the viewport render phase");
         return res;
@@ -1159,7 +1159,7 @@ CREN_API VkResult crenvk_renderphase_viewport_create_framebuffers(vkViewportRend
         framebufferCI.width = extent.width;
         framebufferCI.height = extent.height;
         framebufferCI.layers = 1;
-        res = vkCreateFramebuffer(device, &framebufferCI, NULL, &phase->renderpass->framebuffers[i]);
+        res = vkCreateFramebuffer(device, &framebufferCI, CRENVK_ALLOCATOR, &phase->renderpass->framebuffers[i]);
         if (res != VK_SUCCESS) {
             CREN_LOG(CREN_LOG_SEVERITY_FATAL, "Failed to create viewport renderphase framebuffer");
             return res;
@@ -1174,7 +1174,7 @@ CREN_API void crenvk_renderphase_viewport_recreate(vkViewportRenderphase* phase,
     crenvk_renderphase_viewport_destroy(phase, device, false);
 
     for (uint32_t i = 0; i < phase->renderpass->framebuffersCount; i++) {
-        vkDestroyFramebuffer(device, phase->renderpass->framebuffers[i], NULL);
+        vkDestroyFramebuffer(device, phase->renderpass->framebuffers[i], CRENVK_ALLOCATOR);
     }
     free(phase->renderpass->framebuffers);
 
@@ -7,8 +7,12 @@
 #include "cren_context.h"
 #include "cren_defines.h"
 #include "cren_error.h"
+#include "cren_idpool.h"
+#include "cren_memory.h"
 #include "cren_platform.h"
+#include "cren_pool.h"
 #include "cren_primitives.h"
+#include "cren_profiler.h"
 #include "cren_types.h"
 
 #ifdef CREN_BUILD_WITH_VULKAN
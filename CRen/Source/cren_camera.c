@@ -98,6 +98,11 @@ CREN_API void cren_camera_destroy(CRenCamera* camera)
 	if (camera) free(camera);
 }
 
+CREN_API void cren_camera_copy(CRenCamera* dst, const CRenCamera* src)
+{
+	if (dst && src && dst != src) *dst = *src;
+}
+
 CREN_API void cren_camera_update(CRenCamera* camera, float timestep)
 {
 	if (!camera->shouldMove) return;
@@ -245,6 +250,12 @@ CREN_API void cren_camera_move(CRenCamera* camera, CRen_CameraDirection dir, boo
 	}
 }
 
+CREN_API bool cren_camera_is_moving(CRenCamera* camera)
+{
+	if (!camera) return false;
+	return camera->shouldMove && (camera->movingForward || camera->movingBackward || camera->movingLeft || camera->movingRight);
+}
+
 CREN_API bool cren_camera_get_speed_modifier(CRenCamera* camera, float* value)
 {
 	if (!camera) return false;
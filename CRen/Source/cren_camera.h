@@ -54,12 +54,18 @@ CREN_API bool cren_camera_get_lock(CRenCamera* camera);
 /// @brief moves/stops moving the camera towards a direction
 CREN_API void cren_camera_move(CRenCamera* camera, CRen_CameraDirection dir, bool moving);
 
+/// @brief returns if the camera is moving towards any direction, it changes every update while it is
+CREN_API bool cren_camera_is_moving(CRenCamera* camera);
+
 /// @brief returns if the camera speed modifier is currently applyed
 CREN_API bool cren_camera_get_speed_modifier(CRenCamera* camera, float* value);
 
 /// @brief sets/unsets the camera's speed modifier
 CREN_API void cren_camera_set_speed_modifier(CRenCamera* camera, bool status, float value);
 
+/// @brief copies the whole state of a camera into another, the camera holds no references so the copy is independent
+CREN_API void cren_camera_copy(CRenCamera* dst, const CRenCamera* src);
+
 /// @brief returns the camera's current 3d position
 CREN_API float3 cren_camera_get_position(CRenCamera* camera);
 
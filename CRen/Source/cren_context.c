@@ -1,21 +1,52 @@
 #include "cren_context.h"
 
 #include "cren_error.h"
+#include "cren_idpool.h"
+#include "cren_platform.h"
+#include "cren_primitives.h"
 #include "Vulkan/crenvk_context.h"
 #include <memm/memm.h>
-#include <ctoolbox/idgen.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+typedef CRITICAL_SECTION CRenDeviceLock;
+#define CREN_DEVICE_LOCK_INIT(lock) InitializeCriticalSection(lock)
+#define CREN_DEVICE_LOCK_DESTROY(lock) DeleteCriticalSection(lock)
+#define CREN_DEVICE_LOCK(lock) EnterCriticalSection(lock)
+#define CREN_DEVICE_UNLOCK(lock) LeaveCriticalSection(lock)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t CRenDeviceLock;
+#define CREN_DEVICE_LOCK_DESTROY(lock) pthread_mutex_destroy(lock)
+#define CREN_DEVICE_LOCK(lock) pthread_mutex_lock(lock)
+#define CREN_DEVICE_UNLOCK(lock) pthread_mutex_unlock(lock)
+
+/// @brief the device lock is taken again by the calls cren makes on itself (quad creation creating it's texture, etc)
+static void CREN_DEVICE_LOCK_INIT(CRenDeviceLock* lock)
+{
+	pthread_mutexattr_t attributes;
+	pthread_mutexattr_init(&attributes);
+	pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(lock, &attributes);
+	pthread_mutexattr_destroy(&attributes);
+}
+#endif
 
 struct CRenContext
 {
     // core info
 	CRenCreateInfo createInfo;
     CRenCamera* camera;
-	idgen* idgen;
+	CRenCamera* renderCamera;	// camera used by cren_render, the main camera when NULL
+	CRenIDPool* idpool;
+	CRenDeviceLock deviceLock;
+	CRenDeviceLock viewLock;	// guards the mouse and viewport info, set every frame it mustn't wait on the device held by a frame
 
     // hints
     bool currentlyMinimized;
 	bool usingCustomViewport;
-	bool usingVSync;
+	CRen_PresentMode presentMode; // requested, the swapchain may be using another
     bool mustResize;
 
     // callbacks
@@ -26,6 +57,9 @@ struct CRenContext
 	float2 framebufferSize;
 	float2 viewportPos;		// only when usingCustomViewport
 	float2 viewportSize;	// only when usingCustomViewport
+	bool renderViewSet;
+	float2 renderMousePos;		// what cren_render picks with once set with cren_set_render_view, the live ones otherwise
+	float2 renderViewportSize;
 
     // backend renderer api
 	CRen_MSAA msaa;
@@ -38,23 +72,35 @@ CREN_API CRenContext* cren_initialize(const CRenCreateInfo createInfo)
 {
 	memm_init();
 
-	CRenContext* context = malloc(sizeof(CRenContext));
+	// the host allocator must be in place before cren allocates anything
+	bool customAllocator = createInfo.allocator.allocate != NULL || createInfo.allocator.free != NULL;
+	if (customAllocator && !cren_memory_set_allocator(&createInfo.allocator)) {
+		CREN_LOG(CREN_LOG_SEVERITY_WARN, "Host allocator was not installed, using malloc/free");
+	}
+
+	CRenContext* context = (CRenContext*)cren_memory_alloc(CREN_MEMORY_TAG_GENERAL, sizeof(CRenContext));
 	CREN_ASSERT(context != NULL, "Failed to allocate memory for CRen");
 
 	context->createInfo = createInfo;
 	context->usingCustomViewport = createInfo.customViewport;
-	context->usingVSync = createInfo.vsync;
+	context->presentMode = createInfo.vsync ? CREN_PRESENT_MODE_FIFO : CREN_PRESENT_MODE_MAILBOX;
 	context->currentlyMinimized = false;
 	context->mustResize = true;
 	context->framebufferSize.xy.x = context->createInfo.width;
 	context->framebufferSize.xy.y = context->createInfo.height;
 	context->msaa = context->createInfo.msaa;
+	context->renderCamera = NULL;
+	context->renderViewSet = false;
+	CREN_DEVICE_LOCK_INIT(&context->deviceLock);
+	CREN_DEVICE_LOCK_INIT(&context->viewLock);
 	
 	context->camera = cren_camera_create(CREN_CAMERA_TYPE_FREE_LOOK, (float)createInfo.width / (float)createInfo.height, createInfo.api);
 	CREN_ASSERT(context->camera != NULL, "Faield to create CRen's main camera");
 
-	context->idgen = idgen_create(1);
-	CREN_ASSERT(context->idgen != NULL, "Failed to create CRen's id generator");
+	context->idpool = cren_idpool_create();
+	CREN_ASSERT(context->idpool != NULL, "Failed to create CRen's id pool");
+
+	cren_primitives_initialize();
 
 	return context;
 }
@@ -67,25 +113,39 @@ CREN_API void cren_create_renderer(CRenContext* context)
 		context, context->createInfo.width, context->createInfo.height, &context->callbacks,
 		context->createInfo.appName, context->createInfo.assetsPath,
 		context->createInfo.appVersion, context->createInfo.api, context->createInfo.msaa,
-		context->createInfo.vsync, context->createInfo.validations, context->createInfo.customViewport
+		context->presentMode, context->createInfo.validations, context->createInfo.customViewport,
+		context->createInfo.headless
 	);
 	#else
 	#error "Unsupported Renderer Backend"
 	#endif
 }
 
+CREN_API void cren_preload_renderer_assets(const char* assetsPath)
+{
+	#ifdef CREN_BUILD_WITH_VULKAN
+	crenvk_pipeline_preload_quad(assetsPath);
+	#else
+	#error "Unsupported Renderer Backend"
+	#endif
+}
+
 CREN_API void cren_shutdown(CRenContext* context)
 {
 	CREN_ASSERT(context != NULL, "CRen context is NULL and this should not occur");
 
-	idgen_destroy(context->idgen);
+	cren_idpool_destroy(context->idpool);
 	cren_camera_destroy(context->camera);
 
 	#ifdef CREN_BUILD_WITH_VULKAN
 	if (context) crenvk_terminate(&context->backend);
 	#endif
 
-	free(context);
+	cren_primitives_shutdown();
+	cren_release_preloads();
+	CREN_DEVICE_LOCK_DESTROY(&context->deviceLock);
+	CREN_DEVICE_LOCK_DESTROY(&context->viewLock);
+	cren_memory_free(context);
 
 	// memory leak checkage
 	char leaksMessage[2028];
@@ -100,33 +160,58 @@ CREN_API void cren_update(CRenContext* context, float timestep)
 	cren_camera_update(context->camera, timestep);
 }
 
-CREN_API void cren_render(CRenContext* context, float timestep)
+CREN_API bool cren_render(CRenContext* context, float timestep)
 {
+	CRenCamera* camera = context->renderCamera ? context->renderCamera : context->camera;
+	bool rendered = false;
+
+	// the whole frame holds the device, it waits on the frame fences and submits to the graphics queue
+	CREN_DEVICE_LOCK(&context->deviceLock);
 	#ifdef CREN_BUILD_WITH_VULKAN
 	if (!context->currentlyMinimized) {
-		crenvk_update(&context->backend, timestep, context->camera);
-		crenvk_render(context, &context->backend, timestep, &context->callbacks, context->camera, &context->mustResize);
+		crenvk_update(&context->backend, timestep, camera);
+		crenvk_render(context, &context->backend, timestep, &context->callbacks, camera, &context->mustResize);
+		rendered = true;
 	}
 	#else
 	#error "Undefined backend"
 	#endif
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
+
+	return rendered;
 }
 
 CREN_API void cren_resize(CRenContext* context, int width, int height)
 {
+	CREN_DEVICE_LOCK(&context->deviceLock);
 	context->framebufferSize.xy.x = width;
 	context->framebufferSize.xy.y = height;
 	context->mustResize = true; // vulkan will pickup the change automatically
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
 }
 
 CREN_API void cren_minimize(CRenContext* context)
 {
+	CREN_DEVICE_LOCK(&context->deviceLock);
 	context->currentlyMinimized = 1; // vulkan will pickup the change automatically
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
 }
 
 CREN_API void cren_restore(CRenContext* context)
 {
+	CREN_DEVICE_LOCK(&context->deviceLock);
 	context->currentlyMinimized = 0; // vulkan will pickup the change automatically
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
+}
+
+CREN_API void cren_lock(CRenContext* context)
+{
+	if (context) CREN_DEVICE_LOCK(&context->deviceLock);
+}
+
+CREN_API void cren_unlock(CRenContext* context)
+{
+	if (context) CREN_DEVICE_UNLOCK(&context->deviceLock);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -139,6 +224,49 @@ CREN_API CRenCamera* cren_get_main_camera(CRenContext* context)
 	return context->camera;
 }
 
+CREN_API CRenCamera* cren_get_render_camera(CRenContext* context)
+{
+	if (!context) return NULL;
+	return context->renderCamera ? context->renderCamera : context->camera;
+}
+
+CREN_API void cren_set_render_camera(CRenContext* context, CRenCamera* camera)
+{
+	if (!context) return;
+	CREN_DEVICE_LOCK(&context->deviceLock);
+	context->renderCamera = camera;
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
+}
+
+CREN_API void cren_set_render_view(CRenContext* context, const float2 mousePos, const float2 viewportSize)
+{
+	if (!context) return;
+	CREN_DEVICE_LOCK(&context->deviceLock);
+	context->renderViewSet = true;
+	context->renderMousePos = mousePos;
+	context->renderViewportSize = viewportSize;
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
+}
+
+CREN_API float2 cren_get_render_mousepos(CRenContext* context)
+{
+	if (!context) return (float2) { 0.0f, 0.0f };
+	return context->renderViewSet ? context->renderMousePos : cren_get_mousepos(context);
+}
+
+CREN_API float2 cren_get_render_viewport_size(CRenContext* context)
+{
+	if (!context) return (float2) { 0.0f, 0.0f };
+	if (!context->usingCustomViewport) return (float2) { 0.0f, 0.0f };
+	return context->renderViewSet ? context->renderViewportSize : cren_get_viewport_size(context);
+}
+
+CREN_API bool cren_is_headless(CRenContext* context)
+{
+	if (!context) return false;
+	return context->createInfo.headless;
+}
+
 CREN_API bool cren_are_validations_enabled(CRenContext* context)
 {
 	if (!context) return false;
@@ -147,7 +275,49 @@ CREN_API bool cren_are_validations_enabled(CRenContext* context)
 
 bool cren_using_vsync(CRenContext* context)
 {
-	return context->usingVSync;
+	return cren_get_present_mode(context) == CREN_PRESENT_MODE_FIFO;
+}
+
+CREN_API CRen_PresentMode cren_get_present_mode(CRenContext* context)
+{
+	if (!context) return CREN_PRESENT_MODE_FIFO;
+	#ifdef CREN_BUILD_WITH_VULKAN
+	// the render thread may be recreating the swapchain
+	CREN_DEVICE_LOCK(&context->deviceLock);
+	CRen_PresentMode mode = crenvk_swapchain_get_present_mode(&context->backend.swapchain);
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
+	return mode;
+	#else
+	return context->presentMode;
+	#endif
+}
+
+CREN_API CRen_PresentMode cren_get_requested_present_mode(CRenContext* context)
+{
+	if (!context) return CREN_PRESENT_MODE_FIFO;
+	return context->presentMode;
+}
+
+CREN_API void cren_set_present_mode(CRenContext* context, CRen_PresentMode mode)
+{
+	if (!context || mode >= CREN_PRESENT_MODE_MAX) return;
+
+	CREN_DEVICE_LOCK(&context->deviceLock);
+	if (context->presentMode != mode) {
+		context->presentMode = mode;
+		context->mustResize = true; // the swapchain is recreated with the new mode
+	}
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
+}
+
+CREN_API double cren_get_gpu_frame_time(CRenContext* context)
+{
+	if (!context) return 0.0;
+	#ifdef CREN_BUILD_WITH_VULKAN
+	return context->backend.frameTimer.lastFrameTime;
+	#else
+	return 0.0;
+	#endif
 }
 
 CREN_API CRen_MSAA cren_get_msaa(CRenContext *context)
@@ -169,41 +339,56 @@ CREN_API void* cren_get_vulkan_backend(CRenContext* context)
 CREN_API float2 cren_get_mousepos(CRenContext* context)
 {
 	if (!context) return (float2) {.xy.x = 0.0f, .xy.y = 0.0f };
-	return context->mousePos;
+	CREN_DEVICE_LOCK(&context->viewLock);
+	float2 pos = context->mousePos;
+	CREN_DEVICE_UNLOCK(&context->viewLock);
+	return pos;
 }
 
 CREN_API void cren_set_mousepos(CRenContext* context, const float2 pos)
 {
 	if (!context) return;
+	CREN_DEVICE_LOCK(&context->viewLock);
 	context->mousePos = pos;
+	CREN_DEVICE_UNLOCK(&context->viewLock);
 }
 
 CREN_API float2 cren_get_viewport_pos(CRenContext* context)
 {
 	if (!context) return (float2){ 0.0f, 0.0f };
 	if (!context->usingCustomViewport) return (float2) { 0.0f, 0.0f };
-	return context->viewportPos;
+	CREN_DEVICE_LOCK(&context->viewLock);
+	float2 pos = context->viewportPos;
+	CREN_DEVICE_UNLOCK(&context->viewLock);
+	return pos;
 }
 
 CREN_API void cren_set_viewport_pos(CRenContext* context, const float2 pos)
 {
 	if (!context) return;
 	if (!context->usingCustomViewport) return;
+	CREN_DEVICE_LOCK(&context->viewLock);
 	context->viewportPos = pos;
+	CREN_DEVICE_UNLOCK(&context->viewLock);
 }
 
 CREN_API float2 cren_get_viewport_size(CRenContext* context)
 {
 	if (!context) return (float2) { 0.0f, 0.0f };
 	if (!context->usingCustomViewport) return (float2) { 0.0f, 0.0f };
-	return context->viewportSize;
+	CREN_DEVICE_LOCK(&context->viewLock);
+	float2 size = context->viewportSize;
+	CREN_DEVICE_UNLOCK(&context->viewLock);
+	return size;
 }
 
 CREN_API void cren_set_viewport_size(CRenContext* context, const float2 size)
 {
 	if (!context) return;
 	if (!context->usingCustomViewport) return;
+	CREN_DEVICE_LOCK(&context->viewLock);
 	context->viewportSize = size;
+	CREN_DEVICE_UNLOCK(&context->viewLock);
 }
 
 CREN_API float2 cren_get_framebuffer_size(CRenContext* context)
@@ -215,8 +400,10 @@ CREN_API float2 cren_get_framebuffer_size(CRenContext* context)
 CREN_API void cren_set_framebuffer_size(CRenContext* context, const float2 size)
 {
 	if (!context) return;
+	CREN_DEVICE_LOCK(&context->deviceLock);
 	context->framebufferSize = size;
 	context->mustResize = true;
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -228,29 +415,54 @@ CREN_API uint32_t cren_pick_object(CRenContext* context, float2 screenCoord)
 	if (!context) return 0;
 	uint32_t res = 0;
 	#ifdef CREN_BUILD_WITH_VULKAN
+	CREN_DEVICE_LOCK(&context->deviceLock);
 	res = crenvk_pick_object(context, &context->backend, screenCoord);
+	CREN_DEVICE_UNLOCK(&context->deviceLock);
 	#else 
 	#error "Undefined backend"
 	#endif
-	return res;
+
+	// ids are never above the high-water mark, anything else read back is not an object (cleared or stale pixels)
+	return res < cren_get_id_high_water(context) ? res : 0;
 }
 
 CREN_API uint32_t cren_create_id(CRenContext* context)
 {
 	if (!context) return 0;
-	return idgen_next(context->idgen);
+
+	uint32_t id = 0;
+	cren_idpool_reserve(context->idpool, &id, 1);
+	return id;
 }
 
 CREN_API bool cren_register_id(CRenContext* context, uint32_t id)
 {
 	if (!context) return false;
-	return idgen_register(context->idgen, id);
+	return cren_idpool_claim(context->idpool, id);
 }
 
 CREN_API bool cren_unregister_id(CRenContext* context, uint32_t id)
 {
 	if (!context) return false;
-	return idgen_unregister(context->idgen, id);
+	return cren_idpool_release(context->idpool, &id, 1) == 1;
+}
+
+CREN_API uint32_t cren_reserve_ids(CRenContext* context, uint32_t* ids, uint32_t count)
+{
+	if (!context) return 0;
+	return cren_idpool_reserve(context->idpool, ids, count);
+}
+
+CREN_API uint32_t cren_release_ids(CRenContext* context, const uint32_t* ids, uint32_t count)
+{
+	if (!context) return 0;
+	return cren_idpool_release(context->idpool, ids, count);
+}
+
+CREN_API uint32_t cren_get_id_high_water(CRenContext* context)
+{
+	if (!context) return 0;
+	return cren_idpool_get_high_water(context->idpool);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -5,6 +5,7 @@
 #include "cren_types.h"
 #include "cren_camera.h"
 #include "cren_callbacks.h"
+#include "cren_memory.h"
 #include <vecmath/vecmath.h>
 
 /// @brief cren creation needed information
@@ -18,8 +19,10 @@ typedef struct CRenCreateInfo
 	uint32_t height;
 	CRen_MSAA msaa;
 	bool validations;
-	bool vsync;
+	bool vsync; // initial present mode, FIFO when set and MAILBOX otherwise (see cren_set_present_mode)
 	bool customViewport;
+	bool headless; // no window surface, frames are rendered into offscreen images and never presented (width/height is their size)
+	CRenAllocator allocator; // optional, left zeroed cren allocates from malloc/free
 } CRenCreateInfo;
 
 #ifdef __cplusplus 
@@ -36,6 +39,9 @@ CREN_API CRenContext* cren_initialize(const CRenCreateInfo createInfo);
 /// @brief creates the renderer underneath the library, this is a separate function in order to callbacks to be properly assigned
 CREN_API void cren_create_renderer(CRenContext* context);
 
+/// @brief reads the files the renderer is created with (shaders) ahead of time, it needs no context so it may run on another thread while the window and context are created
+CREN_API void cren_preload_renderer_assets(const char* assetsPath);
+
 /// @brief shutsdown and free used resources
 CREN_API void cren_shutdown(CRenContext* context);
 
@@ -43,7 +49,8 @@ CREN_API void cren_shutdown(CRenContext* context);
 CREN_API void cren_update(CRenContext* context, float timestep);
 
 /// @brief performs the frame rendering, setting-up all resources required for drawing the current frame and presenting the previously rendered
-CREN_API void cren_render(CRenContext* context, float timestep);
+/// returns false if no frame went through the renderer (minimized), true otherwise even if the frame was dropped for a swapchain recreation
+CREN_API bool cren_render(CRenContext* context, float timestep);
 
 /// @brief resizes the renderer, call this on every window resize event
 CREN_API void cren_resize(CRenContext* context, int width, int height);
@@ -54,6 +61,13 @@ CREN_API void cren_minimize(CRenContext* context);
 /// @brief restores the renderer to it's last known size, resuming the rendering process
 CREN_API void cren_restore(CRenContext* context);
 
+/// @brief takes the device lock, cren takes it on every call that records or submits gpu work (render, picking, primitives creation/destruction)
+/// hold it to use the device/queues directly from a thread other than the one calling cren_render, it's recursive
+CREN_API void cren_lock(CRenContext* context);
+
+/// @brief releases the device lock taken with cren_lock
+CREN_API void cren_unlock(CRenContext* context);
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Getters/Setters
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -61,12 +75,44 @@ CREN_API void cren_restore(CRenContext* context);
 /// @brief returns the cren main camera, we're only using one right now
 CREN_API CRenCamera* cren_get_main_camera(CRenContext* context);
 
+/// @brief returns the camera cren_render draws with, the main camera unless another was set
+CREN_API CRenCamera* cren_get_render_camera(CRenContext* context);
+
+/// @brief sets the camera cren_render draws with (NULL restores the main camera), used to render from a copy of the main camera while it keeps being updated elsewhere
+CREN_API void cren_set_render_camera(CRenContext* context, CRenCamera* camera);
+
+/// @brief sets the mouse position and viewport size cren_render picks with, used to render with the ones captured alongside the render camera
+/// while the live ones keep being updated elsewhere, cren_render uses the live ones until it's first called
+CREN_API void cren_set_render_view(CRenContext* context, const float2 mousePos, const float2 viewportSize);
+
+/// @brief returns the mouse position cren_render picks at
+CREN_API float2 cren_get_render_mousepos(CRenContext* context);
+
+/// @brief returns the viewport size cren_render picks with, no effect unless a custom viewport is active
+CREN_API float2 cren_get_render_viewport_size(CRenContext* context);
+
+/// @brief returns if cren renders offscreen, without a window surface
+CREN_API bool cren_is_headless(CRenContext* context);
+
 /// @brief returns if validation errors are enabled
 CREN_API bool cren_are_validations_enabled(CRenContext* context);
 
-/// @brief returns the curernt status of vertical syncronization
+/// @brief returns the curernt status of vertical syncronization, if the swapchain presents with FIFO
 CREN_API bool cren_using_vsync(CRenContext* context);
 
+/// @brief returns the present mode the swapchain is using
+CREN_API CRen_PresentMode cren_get_present_mode(CRenContext* context);
+
+/// @brief returns the present mode last requested, the swapchain falls back to a supported one when it's not available
+CREN_API CRen_PresentMode cren_get_requested_present_mode(CRenContext* context);
+
+/// @brief requests a present mode, the swapchain is recreated with it on the next frame
+CREN_API void cren_set_present_mode(CRenContext* context, CRen_PresentMode mode);
+
+/// @brief returns how long the gpu took on the last frame read back, in seconds, 0 when timestamps aren't supported
+/// the measure spans the frame's submission, so it includes the gpu waiting on the swapchain image
+CREN_API double cren_get_gpu_frame_time(CRenContext* context);
+
 /// @brief returns the current msaa applyed
 CREN_API CRen_MSAA cren_get_msaa(CRenContext* context);
 
@@ -104,7 +150,7 @@ CREN_API void cren_set_framebuffer_size(CRenContext* context, const float2 size)
 /// Fun
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/// @brief attempts to pick an object on the screen based on screen coordinates
+/// @brief attempts to pick an object on the screen based on screen coordinates, returns 0 if there is none, picked values at or above the id high-water mark are discarded
 CREN_API uint32_t cren_pick_object(CRenContext* context, float2 screenCoord);
 
 /// @brief create and register internally and returns an id
@@ -116,6 +162,15 @@ CREN_API bool cren_register_id(CRenContext* context, uint32_t id);
 /// @brief unregister an id, returns true if successfully unregistered
 CREN_API bool cren_unregister_id(CRenContext* context, uint32_t id);
 
+/// @brief reserves up to count ids at once with a single access to the id pool, returns how many were reserved
+CREN_API uint32_t cren_reserve_ids(CRenContext* context, uint32_t* ids, uint32_t count);
+
+/// @brief releases many ids at once with a single access to the id pool, returns how many were released
+CREN_API uint32_t cren_release_ids(CRenContext* context, const uint32_t* ids, uint32_t count);
+
+/// @brief returns one past the highest id ever reserved, ids are recycled before the id space grows so this stays close to the live object count
+CREN_API uint32_t cren_get_id_high_water(CRenContext* context);
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Callbacks
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
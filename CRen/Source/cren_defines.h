@@ -9,6 +9,11 @@
 /// @brief how many frames are simultaneously rendered
 #define CREN_CONCURRENTLY_RENDERED_FRAMES 2
 
+/// @brief routes the vulkan driver's host allocations through cren's host allocator (accounted under the driver tag), 0 leaves them to the driver
+#ifndef CREN_USE_VULKAN_ALLOCATION_CALLBACKS
+#define CREN_USE_VULKAN_ALLOCATION_CALLBACKS 1
+#endif
+
 /// @brief how many characters a path may have
 #define CREN_PATH_MAX_SIZE 128
 
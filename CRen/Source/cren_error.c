@@ -1,4 +1,10 @@
+// clock_gettime and the timed condition wait are posix, not c11
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 #include "cren_error.h"
+#include "cren_profiler.h"
 
 #if defined(_WIN32) || (defined(__linux__) && !defined(__ANDROID__)) || (defined(__APPLE__) && defined(__MACH__))
 #include <stdio.h>
@@ -6,12 +12,144 @@
 #include <stdlib.h>
 #elif defined(__ANDROID__)
 #include <android/log.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
 #endif
 #include <time.h>
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+typedef HANDLE CRenLogThread;
+static SRWLOCK sWakeLock = SRWLOCK_INIT;
+static CONDITION_VARIABLE sWakeCondition = CONDITION_VARIABLE_INIT;
+static CONDITION_VARIABLE sFlushCondition = CONDITION_VARIABLE_INIT;
+static SRWLOCK sWriteLock = SRWLOCK_INIT;
+#define CREN_LOG_LOCK(lock) AcquireSRWLockExclusive(lock)
+#define CREN_LOG_UNLOCK(lock) ReleaseSRWLockExclusive(lock)
+#define CREN_LOG_WAIT(condition, lock, milliseconds) SleepConditionVariableSRW(condition, lock, milliseconds, 0)
+#define CREN_LOG_SIGNAL(condition) WakeConditionVariable(condition)
+#define CREN_LOG_BROADCAST(condition) WakeAllConditionVariable(condition)
+#define CREN_LOG_YIELD() SwitchToThread()
+#else
+#include <pthread.h>
+#include <sched.h>
+typedef pthread_t CRenLogThread;
+static pthread_mutex_t sWakeLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sWakeCondition = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t sFlushCondition = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t sWriteLock = PTHREAD_MUTEX_INITIALIZER;
+#define CREN_LOG_LOCK(lock) pthread_mutex_lock(lock)
+#define CREN_LOG_UNLOCK(lock) pthread_mutex_unlock(lock)
+#define CREN_LOG_WAIT(condition, lock, milliseconds) internal_cren_log_timed_wait(condition, lock, milliseconds)
+#define CREN_LOG_SIGNAL(condition) pthread_cond_signal(condition)
+#define CREN_LOG_BROADCAST(condition) pthread_cond_broadcast(condition)
+#define CREN_LOG_YIELD() sched_yield()
+#endif
+
+// the queue positions are published sequentially consistent, the logging thread going to sleep must see them (or be woken)
+#if defined(_MSC_VER)
+#define CREN_THREAD_LOCAL __declspec(thread)
+#define CREN_LOG_ATOMIC_LOAD(ptr) (uint64_t)InterlockedCompareExchange64((volatile LONG64*)(ptr), 0, 0)
+#define CREN_LOG_ATOMIC_STORE(ptr, value) InterlockedExchange64((volatile LONG64*)(ptr), (LONG64)(value))
+#define CREN_LOG_ATOMIC_EXCHANGE(ptr, value) (uint64_t)InterlockedExchange64((volatile LONG64*)(ptr), (LONG64)(value))
+#define CREN_LOG_ATOMIC_ADD(ptr, value) (uint64_t)InterlockedExchangeAdd64((volatile LONG64*)(ptr), (LONG64)(value))
+#define CREN_LOG_ATOMIC_CAS(ptr, expected, desired) (InterlockedCompareExchange64((volatile LONG64*)(ptr), (LONG64)(desired), (LONG64)(expected)) == (LONG64)(expected))
+#define CREN_LOG_ATOMIC_LOAD32(ptr) (uint32_t)InterlockedCompareExchange((volatile LONG*)(ptr), 0, 0)
+#define CREN_LOG_ATOMIC_STORE32(ptr, value) InterlockedExchange((volatile LONG*)(ptr), (LONG)(value))
+#define CREN_LOG_ATOMIC_EXCHANGE32(ptr, value) (uint32_t)InterlockedExchange((volatile LONG*)(ptr), (LONG)(value))
+#define CREN_LOG_ATOMIC_ADD32(ptr, value) (uint32_t)InterlockedExchangeAdd((volatile LONG*)(ptr), (LONG)(value))
+#else
+#define CREN_THREAD_LOCAL _Thread_local
+#define CREN_LOG_ATOMIC_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_SEQ_CST)
+#define CREN_LOG_ATOMIC_STORE(ptr, value) __atomic_store_n(ptr, (uint64_t)(value), __ATOMIC_SEQ_CST)
+#define CREN_LOG_ATOMIC_EXCHANGE(ptr, value) __atomic_exchange_n(ptr, (uint64_t)(value), __ATOMIC_SEQ_CST)
+#define CREN_LOG_ATOMIC_ADD(ptr, value) __atomic_fetch_add(ptr, (uint64_t)(value), __ATOMIC_SEQ_CST)
+#define CREN_LOG_ATOMIC_CAS(ptr, expected, desired) internal_cren_log_cas(ptr, expected, desired)
+#define CREN_LOG_ATOMIC_LOAD32(ptr) __atomic_load_n(ptr, __ATOMIC_SEQ_CST)
+#define CREN_LOG_ATOMIC_STORE32(ptr, value) __atomic_store_n(ptr, (uint32_t)(value), __ATOMIC_SEQ_CST)
+#define CREN_LOG_ATOMIC_EXCHANGE32(ptr, value) __atomic_exchange_n(ptr, (uint32_t)(value), __ATOMIC_SEQ_CST)
+#define CREN_LOG_ATOMIC_ADD32(ptr, value) __atomic_fetch_add(ptr, (uint32_t)(value), __ATOMIC_SEQ_CST)
+#endif
+
 /// @brief defines how many characters a log message may have (vulkan messages can be more than 1024)
 #define CREN_ERRORLOG_MAX_CHARS 2048
 
+/// @brief how many messages the queue holds before messages below errors are dropped (power of two)
+#define CREN_LOG_QUEUE_SIZE 256
+#define CREN_LOG_QUEUE_MASK (CREN_LOG_QUEUE_SIZE - 1)
+
+/// @brief the longest the logging thread sleeps without being woken, bounds how late a message is written if a wake up is missed
+#define CREN_LOG_SLEEP_MS 100
+
+/// @brief a queued message, formatted by the caller so the arguments don't have to outlive the call
+typedef struct CRenLogRecord
+{
+    uint64_t sequence;		// the queue position it's ready to be written at plus one, or to be claimed at when free
+    uint64_t timestamp;		// profiler clock nanoseconds
+    CRen_LogSeverity severity;
+    const char* file;
+    int line;
+    uint32_t suppressed;	// messages the call site dropped before this one
+    char message[CREN_ERRORLOG_MAX_CHARS];
+} CRenLogRecord;
+
+/// @brief bounded multiple producer single consumer queue, producers claim positions with a compare and swap and the logging thread is the only one reading
+static CRenLogRecord sQueue[CREN_LOG_QUEUE_SIZE];
+static uint64_t sTail = 0;		// next position a producer claims
+static uint64_t sHead = 0;		// next position the logging thread writes, only it changes it
+static uint64_t sWritten = 0;	// positions written so far, waited on when flushing
+static uint64_t sDropped = 0;	// messages dropped because the queue was full
+
+static CRenLogThread sThread;
+static uint32_t sRunning = 0;	// the logging thread is up and messages go through the queue
+static uint32_t sProducers = 0;	// callers between seeing the queue running and publishing their message, shutdown waits on them
+static uint32_t sStopping = 0;
+static uint32_t sSleeping = 0;
+
+// the outputs are guarded by the write lock, so replacing them waits for what's being written with them
+static CRenLogSink sSink = NULL;
+static void* sSinkUserData = NULL;
+static FILE* sFile = NULL;
+static bool sConsole = true;
+
+// wall clock time the profiler clock started at, the timestamps are turned into dates with it
+static time_t sWallEpoch = 0;
+static uint64_t sClockEpoch = 0;
+
+static CREN_THREAD_LOCAL bool tLogger = false;	// the logging thread itself, it can't wait on itself
+static CREN_THREAD_LOCAL bool tWriting = false;	// within a sink, messages it logs are dropped instead of deadlocking on the write lock
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// internal
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if !defined(_MSC_VER)
+/// @brief compare and swap without writing back the current value, as the interlocked one
+static bool internal_cren_log_cas(uint64_t* ptr, uint64_t expected, uint64_t desired)
+{
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#endif
+
+#if !defined(_WIN32)
+/// @brief waits on a condition for at most milliseconds
+static void internal_cren_log_timed_wait(pthread_cond_t* condition, pthread_mutex_t* lock, uint32_t milliseconds)
+{
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_sec += milliseconds / 1000;
+    until.tv_nsec += (long)(milliseconds % 1000) * 1000000l;
+    if (until.tv_nsec >= 1000000000l) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000l;
+    }
+
+    pthread_cond_timedwait(condition, lock, &until);
+}
+#endif
+
 /// @brief string-fy the log severity
 static const char* internal_log_cstr(CRen_LogSeverity severity)
 {
@@ -48,35 +186,370 @@ static void internal_log_format(char* outBuffer, size_t size, const struct tm* l
     );
 }
 
-CREN_API void cren_log_message(CRen_LogSeverity severity, const char* file, int line, const char* fmt, ...)
+/// @brief writes a message into the outputs, the write lock must be held
+static void internal_cren_log_write(CRen_LogSeverity severity, const char* file, int line, uint64_t timestamp, uint32_t suppressed, const char* message)
 {
-    char buffer[CREN_ERRORLOG_MAX_CHARS];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buffer, CREN_ERRORLOG_MAX_CHARS, fmt, args);
-    va_end(args);
+    char buffer[CREN_ERRORLOG_MAX_CHARS + 64];
+    if (suppressed > 0) {
+        snprintf(buffer, sizeof(buffer), "%s (%u more from here were suppressed)", message, suppressed);
+        message = buffer;
+    }
 
-    char log_message[CREN_ERRORLOG_MAX_CHARS + 256];
-    time_t now = time(NULL);
-    struct tm* local_time = localtime(&now);
+    // only the write lock holder calls localtime, so it's static buffer isn't shared
+    time_t seconds = sWallEpoch + (time_t)((timestamp - sClockEpoch) / 1000000000ull);
+    struct tm* local_time = localtime(&seconds);
 
-    internal_log_format(log_message, sizeof(log_message), local_time, file, line, severity, buffer);
+    char log_message[CREN_ERRORLOG_MAX_CHARS + 320];
+    internal_log_format(log_message, sizeof(log_message), local_time, file, line, severity, message);
 
-    if (severity == CREN_LOG_SEVERITY_FATAL) {
+    if (sConsole) {
         #if defined(__ANDROID__)
-        __android_log_print(ANDROID_LOG_ERROR, "CRen", log_message);
+        __android_log_print(severity == CREN_LOG_SEVERITY_FATAL ? ANDROID_LOG_ERROR : ANDROID_LOG_DEBUG, "CRen", "%s", log_message);
         #else
         printf("%s\n", log_message);
         #endif
+    }
+
+    if (sFile) fprintf(sFile, "%s\n", log_message);
+
+    if (sSink) {
+        tWriting = true;
+        sSink(sSinkUserData, severity, file, line, message);
+        tWriting = false;
+    }
+}
+
+/// @brief pushes the buffered console and file output out
+static void internal_cren_log_flush_outputs()
+{
+    #if !defined(__ANDROID__)
+    if (sConsole) fflush(stdout);
+    #endif
+    if (sFile) fflush(sFile);
+}
+
+/// @brief writes every message ready in the queue, only the logging thread (or the one shutting it down) calls it, returns how many were written
+static uint64_t internal_cren_log_drain()
+{
+    uint64_t written = 0;
+    CREN_LOG_LOCK(&sWriteLock);
+
+    for (;;) {
+        CRenLogRecord* record = &sQueue[sHead & CREN_LOG_QUEUE_MASK];
+        if (CREN_LOG_ATOMIC_LOAD(&record->sequence) != sHead + 1) break;
+
+        internal_cren_log_write(record->severity, record->file, record->line, record->timestamp, record->suppressed, record->message);
+
+        // frees the slot for the position it'll be claimed at the next time around
+        CREN_LOG_ATOMIC_STORE(&record->sequence, sHead + CREN_LOG_QUEUE_SIZE);
+        sHead++;
+        written++;
+    }
+
+    uint64_t dropped = CREN_LOG_ATOMIC_EXCHANGE(&sDropped, 0);
+    if (dropped > 0) {
+        char message[128];
+        snprintf(message, sizeof(message), "%llu messages were dropped, the log queue was full", (unsigned long long)dropped);
+        internal_cren_log_write(CREN_LOG_SEVERITY_WARN, __FILE__, __LINE__, cren_profiler_now(), 0, message);
+    }
+
+    if (written > 0 || dropped > 0) internal_cren_log_flush_outputs();
+    CREN_LOG_UNLOCK(&sWriteLock);
+
+    if (written > 0) {
+        CREN_LOG_LOCK(&sWakeLock);
+        CREN_LOG_ATOMIC_STORE(&sWritten, sHead);
+        CREN_LOG_BROADCAST(&sFlushCondition);
+        CREN_LOG_UNLOCK(&sWakeLock);
+    }
+
+    return written;
+}
+
+/// @brief returns if the next message in the queue is ready to be written
+static bool internal_cren_log_ready()
+{
+    return CREN_LOG_ATOMIC_LOAD(&sQueue[sHead & CREN_LOG_QUEUE_MASK].sequence) == sHead + 1;
+}
+
+/// @brief writes messages as they're queued until stopped
+#if defined(_WIN32)
+static DWORD WINAPI internal_cren_log_thread(LPVOID userData)
+#else
+static void* internal_cren_log_thread(void* userData)
+#endif
+{
+    (void)userData;
+    tLogger = true;
+
+    for (;;) {
+        if (internal_cren_log_drain() > 0) continue;
+        if (CREN_LOG_ATOMIC_LOAD32(&sStopping)) break;
+
+        // the sleeping flag is raised before looking at the queue once more, a producer publishing meanwhile sees it and wakes it up
+        CREN_LOG_LOCK(&sWakeLock);
+        CREN_LOG_ATOMIC_STORE32(&sSleeping, 1);
+        if (!internal_cren_log_ready() && !CREN_LOG_ATOMIC_LOAD32(&sStopping)) CREN_LOG_WAIT(&sWakeCondition, &sWakeLock, CREN_LOG_SLEEP_MS);
+        CREN_LOG_ATOMIC_STORE32(&sSleeping, 0);
+        CREN_LOG_UNLOCK(&sWakeLock);
+    }
+
+    return 0;
+}
+
+/// @brief wakes the logging thread up
+static void internal_cren_log_wake()
+{
+    CREN_LOG_LOCK(&sWakeLock);
+    CREN_LOG_SIGNAL(&sWakeCondition);
+    CREN_LOG_UNLOCK(&sWakeLock);
+}
+
+static void internal_cren_log_atexit()
+{
+    cren_log_shutdown();
+}
+
+/// @brief prepares the queue and starts the logging thread, once
+#if defined(_WIN32)
+static INIT_ONCE sStartOnce = INIT_ONCE_STATIC_INIT;
+static BOOL CALLBACK internal_cren_log_start(PINIT_ONCE once, PVOID parameter, PVOID* context)
+#else
+static pthread_once_t sStartOnce = PTHREAD_ONCE_INIT;
+static void internal_cren_log_start()
+#endif
+{
+    sWallEpoch = time(NULL);
+    sClockEpoch = cren_profiler_now();
+
+    for (uint64_t i = 0; i < CREN_LOG_QUEUE_SIZE; i++) sQueue[i].sequence = i;
+
+    // without the thread messages are written by the callers, as before
+    #if defined(_WIN32)
+    (void)once; (void)parameter; (void)context;
+    sThread = CreateThread(NULL, 0, internal_cren_log_thread, NULL, 0, NULL);
+    bool started = sThread != NULL;
+    #else
+    bool started = pthread_create(&sThread, NULL, internal_cren_log_thread, NULL) == 0;
+    #endif
+
+    if (started) {
+        CREN_LOG_ATOMIC_STORE32(&sRunning, 1);
+        atexit(internal_cren_log_atexit);
+    }
+
+    #if defined(_WIN32)
+    return TRUE;
+    #endif
+}
+
+/// @brief returns if a message from a call site is within it's rate, outSuppressed receives how many it dropped since it last logged
+static bool internal_cren_log_site_allows(CRenLogSite* site, uint64_t now, uint32_t* outSuppressed)
+{
+    *outSuppressed = 0;
+    if (!site || CREN_LOG_RATE_LIMIT <= 0) return true;
+
+    // the window restarts every second, racing threads may let a couple more through and that's fine
+    uint64_t windowStart = CREN_LOG_ATOMIC_LOAD(&site->windowStart);
+    if (now - windowStart >= 1000000000ull && CREN_LOG_ATOMIC_CAS(&site->windowStart, windowStart, now)) {
+        CREN_LOG_ATOMIC_STORE32(&site->count, 0);
+    }
+
+    if (CREN_LOG_ATOMIC_ADD32(&site->count, 1) >= (uint32_t)CREN_LOG_RATE_LIMIT) {
+        CREN_LOG_ATOMIC_ADD32(&site->suppressed, 1);
+        return false;
+    }
+
+    *outSuppressed = CREN_LOG_ATOMIC_EXCHANGE32(&site->suppressed, 0);
+    return true;
+}
+
+/// @brief formats and writes a message on the calling thread
+static void internal_cren_log_write_now(CRen_LogSeverity severity, const char* file, int line, uint64_t timestamp, uint32_t suppressed, const char* fmt, va_list args)
+{
+    char buffer[CREN_ERRORLOG_MAX_CHARS];
+    vsnprintf(buffer, CREN_ERRORLOG_MAX_CHARS, fmt, args);
+
+    CREN_LOG_LOCK(&sWriteLock);
+    internal_cren_log_write(severity, file, line, timestamp, suppressed, buffer);
+    internal_cren_log_flush_outputs();
+    CREN_LOG_UNLOCK(&sWriteLock);
+}
+
+/// @brief queues a message, or writes it right away when it's fatal or there's no logging thread
+static void internal_cren_log_push(CRenLogSite* site, CRen_LogSeverity severity, const char* file, int line, const char* fmt, va_list args)
+{
+    // a sink logging would wait on the write lock it's called with
+    if (tWriting) return;
+
+    #if defined(_WIN32)
+    InitOnceExecuteOnce(&sStartOnce, internal_cren_log_start, NULL, NULL);
+    #else
+    pthread_once(&sStartOnce, internal_cren_log_start);
+    #endif
+
+    // errors are never rate limited, they're what's looked for when something went wrong
+    uint64_t timestamp = cren_profiler_now();
+    uint32_t suppressed = 0;
+    if (severity < CREN_LOG_SEVERITY_ERROR && !internal_cren_log_site_allows(site, timestamp, &suppressed)) return;
+
+    // fatal messages are the last ones, everything before them is written first and then them on the spot
+    if (severity == CREN_LOG_SEVERITY_FATAL) {
+        cren_log_flush();
+        internal_cren_log_write_now(severity, file, line, timestamp, suppressed, fmt, args);
         abort();
     }
 
-    else
-    {
-        #if defined(__ANDROID__)
-        __android_log_print(ANDROID_LOG_DEBUG, "CRen", log_message)
-        #else
-        printf("%s\n", log_message);
-        #endif
+    // announced before looking at the running flag, a shutdown either sees the producer and waits for it or the producer sees it stopped
+    CREN_LOG_ATOMIC_ADD32(&sProducers, 1);
+    if (!CREN_LOG_ATOMIC_LOAD32(&sRunning)) {
+        CREN_LOG_ATOMIC_ADD32(&sProducers, (uint32_t)-1);
+        internal_cren_log_write_now(severity, file, line, timestamp, suppressed, fmt, args);
+        return;
+    }
+
+    // claims a position, the slot it maps to is free once it's sequence reaches the position
+    CRenLogRecord* record = NULL;
+    uint64_t position = CREN_LOG_ATOMIC_LOAD(&sTail);
+
+    for (;;) {
+        record = &sQueue[position & CREN_LOG_QUEUE_MASK];
+        int64_t distance = (int64_t)(CREN_LOG_ATOMIC_LOAD(&record->sequence) - position);
+
+        if (distance == 0) {
+            if (CREN_LOG_ATOMIC_CAS(&sTail, position, position + 1)) break;
+            position = CREN_LOG_ATOMIC_LOAD(&sTail);
+        }
+
+        // full, errors wait for the logging thread to make room while the rest is only counted, it's up until the producers are done
+        else if (distance < 0) {
+            if (severity < CREN_LOG_SEVERITY_ERROR || tLogger) {
+                CREN_LOG_ATOMIC_ADD(&sDropped, 1);
+                CREN_LOG_ATOMIC_ADD32(&sProducers, (uint32_t)-1);
+                return;
+            }
+
+            internal_cren_log_wake();
+            CREN_LOG_YIELD();
+            position = CREN_LOG_ATOMIC_LOAD(&sTail);
+        }
+
+        else position = CREN_LOG_ATOMIC_LOAD(&sTail);
+    }
+
+    record->timestamp = timestamp;
+    record->severity = severity;
+    record->file = file;
+    record->line = line;
+    record->suppressed = suppressed;
+    vsnprintf(record->message, CREN_ERRORLOG_MAX_CHARS, fmt, args);
+
+    CREN_LOG_ATOMIC_STORE(&record->sequence, position + 1);
+    if (CREN_LOG_ATOMIC_LOAD32(&sSleeping)) internal_cren_log_wake();
+    CREN_LOG_ATOMIC_ADD32(&sProducers, (uint32_t)-1);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// external
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CREN_API void cren_log_message(CRen_LogSeverity severity, const char* file, int line, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    internal_cren_log_push(NULL, severity, file, line, fmt, args);
+    va_end(args);
+}
+
+CREN_API void cren_log_message_site(CRenLogSite* site, CRen_LogSeverity severity, const char* file, int line, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    internal_cren_log_push(site, severity, file, line, fmt, args);
+    va_end(args);
+}
+
+CREN_API void cren_log_set_sink(CRenLogSink sink, void* userData)
+{
+    CREN_LOG_LOCK(&sWriteLock);
+    sSink = sink;
+    sSinkUserData = userData;
+    CREN_LOG_UNLOCK(&sWriteLock);
+}
+
+CREN_API void cren_log_set_console(bool enabled)
+{
+    CREN_LOG_LOCK(&sWriteLock);
+    sConsole = enabled;
+    CREN_LOG_UNLOCK(&sWriteLock);
+}
+
+CREN_API bool cren_log_set_file(const char* path)
+{
+    FILE* file = NULL;
+    if (path) {
+        file = fopen(path, "w");
+        if (!file) {
+            CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to open %s for writing the log", path);
+            return false;
+        }
+    }
+
+    CREN_LOG_LOCK(&sWriteLock);
+    FILE* previous = sFile;
+    sFile = file;
+    CREN_LOG_UNLOCK(&sWriteLock);
+
+    if (previous) fclose(previous);
+    return true;
+}
+
+CREN_API void cren_log_flush()
+{
+    if (tLogger || !CREN_LOG_ATOMIC_LOAD32(&sRunning)) return;
+
+    // positions claimed before now, a producer still formatting into one is waited on as well
+    uint64_t target = CREN_LOG_ATOMIC_LOAD(&sTail);
+    internal_cren_log_wake();
+
+    CREN_LOG_LOCK(&sWakeLock);
+    while (CREN_LOG_ATOMIC_LOAD(&sWritten) < target && CREN_LOG_ATOMIC_LOAD32(&sRunning)) {
+        CREN_LOG_WAIT(&sFlushCondition, &sWakeLock, CREN_LOG_SLEEP_MS);
     }
+    CREN_LOG_UNLOCK(&sWakeLock);
+}
+
+CREN_API void cren_log_shutdown()
+{
+    if (tLogger || !CREN_LOG_ATOMIC_EXCHANGE32(&sRunning, 0)) return;
+
+    // no message is accepted into the queue anymore, the ones being queued are published before the logging thread stops
+    // so the final drain writes them, the thread is still up meanwhile for errors waiting on room
+    while (CREN_LOG_ATOMIC_LOAD32(&sProducers) > 0) {
+        internal_cren_log_wake();
+        CREN_LOG_YIELD();
+    }
+
+    CREN_LOG_ATOMIC_STORE32(&sStopping, 1);
+    internal_cren_log_wake();
+
+    // on windows the thread may already be gone when this runs at exit, it's handle is signaled then and what it left behind is written here
+    #if defined(_WIN32)
+    WaitForSingleObject(sThread, INFINITE);
+    CloseHandle(sThread);
+    #else
+    pthread_join(sThread, NULL);
+    #endif
+
+    internal_cren_log_drain();
+
+    // anyone still flushing stops waiting, the queue has no reader anymore
+    CREN_LOG_LOCK(&sWakeLock);
+    CREN_LOG_BROADCAST(&sFlushCondition);
+    CREN_LOG_UNLOCK(&sWakeLock);
+
+    CREN_LOG_LOCK(&sWriteLock);
+    if (sFile) fclose(sFile);
+    sFile = NULL;
+    CREN_LOG_UNLOCK(&sWriteLock);
 }
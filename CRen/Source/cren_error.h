@@ -4,13 +4,56 @@
 #include "cren_defines.h"
 #include "cren_types.h"
 
+/// @brief the lowest severity compiled in, messages below it are stripped from the build (LOG_MIN_SEVERITY on cmake)
+#ifndef CREN_LOG_MIN_SEVERITY
+	#define CREN_LOG_MIN_SEVERITY CREN_LOG_SEVERITY_TRACE
+#endif
+
+/// @brief how many messages below errors a call site logs per second, the ones over it are counted and reported with the next one it logs, 0 for no limit
+/// errors and fatal messages are never limited
+#ifndef CREN_LOG_RATE_LIMIT
+	#define CREN_LOG_RATE_LIMIT 32
+#endif
+
+/// @brief rate limiting state of a log call site
+typedef struct CRenLogSite
+{
+	uint64_t windowStart;	// when the current one second window started, in profiler clock nanoseconds
+	uint32_t count;			// messages within the window
+	uint32_t suppressed;	// messages dropped since the site last logged
+} CRenLogSite;
+
+/// @brief receives a log message, message is the formatted text without the date/file/severity prefix
+typedef void (*CRenLogSink)(void* userData, CRen_LogSeverity severity, const char* file, int line, const char* message);
+
 #ifdef __cplusplus 
 extern "C" {
 #endif
 
 /// @brief logs a message error into the platform output/console (this function is designed to be called by the library, use macros instead)
+/// the message is formatted by the caller and queued, a logging thread writes it, fatal messages are written right away after the queue is flushed
 CREN_API void cren_log_message(CRen_LogSeverity severity, const char* file, int line, const char* fmt, ...);
 
+/// @brief same as cren_log_message but rate limited by the call site's state, the macros keep one per call site
+CREN_API void cren_log_message_site(CRenLogSite* site, CRen_LogSeverity severity, const char* file, int line, const char* fmt, ...);
+
+/// @brief sets a function receiving every message on the logging thread besides the console and file, NULL removes it
+/// once it returns the previous sink is no longer called
+CREN_API void cren_log_set_sink(CRenLogSink sink, void* userData);
+
+/// @brief enables or disables writing messages to the platform output/console, enabled by default
+CREN_API void cren_log_set_console(bool enabled);
+
+/// @brief also writes messages into a file (truncated), NULL closes the current one, returns false if it couldn't be opened
+CREN_API bool cren_log_set_file(const char* path);
+
+/// @brief blocks until every message queued before it is written
+CREN_API void cren_log_flush();
+
+/// @brief writes what's queued and stops the logging thread, later messages are written by the callers themselves
+/// it's called when the process exits, calling it sooner is only needed if the logging thread mustn't outlive something (a sink's user data)
+CREN_API void cren_log_shutdown();
+
 #ifdef __cplusplus 
 }
 #endif
@@ -20,7 +63,7 @@ CREN_API void cren_log_message(CRen_LogSeverity severity, const char* file, int
 	#define CREN_LOG(...)
 	#define CREN_ASSERT(condition, msg) ((void)0)
 #else
-	#define CREN_LOG(severity, ...) cren_log_message(severity, __FILE__, __LINE__, __VA_ARGS__);
+	#define CREN_LOG(severity, ...) do { if ((int)(severity) >= (int)(CREN_LOG_MIN_SEVERITY)) { static CRenLogSite crenLogSite; cren_log_message_site(&crenLogSite, severity, __FILE__, __LINE__, __VA_ARGS__); } } while (0)
 	#define CREN_ASSERT(condition, ...) if (!(condition)) { cren_log_message(CREN_LOG_SEVERITY_FATAL, __FILE__, __LINE__, __VA_ARGS__); }
 #endif
 
@@ -0,0 +1,300 @@
+#include "cren_idpool.h"
+
+#include "cren_error.h"
+#include <memm/memm.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+typedef SRWLOCK CRenIDPoolLock;
+#define CREN_IDPOOL_LOCK_INIT(lock) InitializeSRWLock(lock)
+#define CREN_IDPOOL_LOCK_DESTROY(lock)
+#define CREN_IDPOOL_LOCK(lock) AcquireSRWLockExclusive(lock)
+#define CREN_IDPOOL_UNLOCK(lock) ReleaseSRWLockExclusive(lock)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t CRenIDPoolLock;
+#define CREN_IDPOOL_LOCK_INIT(lock) pthread_mutex_init(lock, NULL)
+#define CREN_IDPOOL_LOCK_DESTROY(lock) pthread_mutex_destroy(lock)
+#define CREN_IDPOOL_LOCK(lock) pthread_mutex_lock(lock)
+#define CREN_IDPOOL_UNLOCK(lock) pthread_mutex_unlock(lock)
+#endif
+
+/// @brief how many ids a page of the reserved bitset covers
+#define CREN_IDPOOL_PAGE_BITS 16
+#define CREN_IDPOOL_PAGE_WORDS ((1u << CREN_IDPOOL_PAGE_BITS) / 64)
+
+/// @brief a range of never-used ids, [begin, end)
+typedef struct CRenIDRange
+{
+	uint32_t begin;
+	uint32_t end;
+} CRenIDRange;
+
+/// @brief the pool is meant to be accessed in blocks (see cren_idpool_reserve), so a plain lock is enough
+struct CRenIDPool
+{
+	CRenIDPoolLock lock;
+
+	// one bit per id, set while reserved, split in pages allocated uppon first use so a high id doesn't cover every id below it
+	uint64_t** pages;
+	uint32_t pageCount;
+
+	// released ids, ids claimed while sitting here are skipped when popped
+	uint32_t* freeIDs;
+	uint32_t freeCount;
+	uint32_t freeCapacity;
+
+	// never-used ids jumped over by claims ahead of next, in increasing order, consumed from the head
+	CRenIDRange* skipped;
+	uint32_t skippedHead;
+	uint32_t skippedCount;
+	uint32_t skippedCapacity;
+
+	// next never-used id
+	uint32_t next;
+};
+
+/// @brief allocates the reserved bitset page covering id, returns false on allocation failure
+static bool internal_cren_idpool_cover(CRenIDPool* pool, uint32_t id)
+{
+	uint32_t page = id >> CREN_IDPOOL_PAGE_BITS;
+
+	if (page >= pool->pageCount) {
+		uint32_t newCount = pool->pageCount > 0 ? pool->pageCount : 4;
+		while (newCount <= page) newCount *= 2;
+
+		uint64_t** pages = (uint64_t**)malloc(sizeof(uint64_t*) * newCount);
+		if (!pages) return false;
+
+		memset(pages, 0, sizeof(uint64_t*) * newCount);
+		if (pool->pages) {
+			memcpy(pages, pool->pages, sizeof(uint64_t*) * pool->pageCount);
+			free(pool->pages);
+		}
+
+		pool->pages = pages;
+		pool->pageCount = newCount;
+	}
+
+	if (!pool->pages[page]) {
+		pool->pages[page] = (uint64_t*)malloc(sizeof(uint64_t) * CREN_IDPOOL_PAGE_WORDS);
+		if (!pool->pages[page]) return false;
+		memset(pool->pages[page], 0, sizeof(uint64_t) * CREN_IDPOOL_PAGE_WORDS);
+	}
+
+	return true;
+}
+
+/// @brief returns the word holding the id's bit, NULL if it's page was never allocated
+static inline uint64_t* internal_cren_idpool_word(CRenIDPool* pool, uint32_t id)
+{
+	uint32_t page = id >> CREN_IDPOOL_PAGE_BITS;
+	if (page >= pool->pageCount || !pool->pages[page]) return NULL;
+	return &pool->pages[page][(id & ((1u << CREN_IDPOOL_PAGE_BITS) - 1)) >> 6];
+}
+
+static inline bool internal_cren_idpool_test(CRenIDPool* pool, uint32_t id)
+{
+	uint64_t* word = internal_cren_idpool_word(pool, id);
+	return word && (*word >> (id & 63)) & 1;
+}
+
+/// @brief marks a covered id as reserved
+static inline void internal_cren_idpool_set(CRenIDPool* pool, uint32_t id)
+{
+	*internal_cren_idpool_word(pool, id) |= 1ull << (id & 63);
+}
+
+/// @brief pushes an id into the free list, returns false on allocation failure
+static bool internal_cren_idpool_push_free(CRenIDPool* pool, uint32_t id)
+{
+	if (pool->freeCount == pool->freeCapacity) {
+		uint32_t newCapacity = pool->freeCapacity > 0 ? pool->freeCapacity * 2 : 256;
+		uint32_t* freeIDs = (uint32_t*)malloc(sizeof(uint32_t) * newCapacity);
+		if (!freeIDs) return false;
+
+		if (pool->freeIDs) {
+			memcpy(freeIDs, pool->freeIDs, sizeof(uint32_t) * pool->freeCount);
+			free(pool->freeIDs);
+		}
+
+		pool->freeIDs = freeIDs;
+		pool->freeCapacity = newCapacity;
+	}
+
+	pool->freeIDs[pool->freeCount++] = id;
+	return true;
+}
+
+/// @brief records a range of never-used ids jumped over, returns false on allocation failure
+static bool internal_cren_idpool_push_skipped(CRenIDPool* pool, uint32_t begin, uint32_t end)
+{
+	// consumed ranges at the head are reclaimed before growing
+	if (pool->skippedHead > 0 && pool->skippedCount == pool->skippedCapacity) {
+		memmove(pool->skipped, pool->skipped + pool->skippedHead, sizeof(CRenIDRange) * (pool->skippedCount - pool->skippedHead));
+		pool->skippedCount -= pool->skippedHead;
+		pool->skippedHead = 0;
+	}
+
+	if (pool->skippedCount == pool->skippedCapacity) {
+		uint32_t newCapacity = pool->skippedCapacity > 0 ? pool->skippedCapacity * 2 : 16;
+		CRenIDRange* skipped = (CRenIDRange*)malloc(sizeof(CRenIDRange) * newCapacity);
+		if (!skipped) return false;
+
+		if (pool->skipped) {
+			memcpy(skipped, pool->skipped, sizeof(CRenIDRange) * pool->skippedCount);
+			free(pool->skipped);
+		}
+
+		pool->skipped = skipped;
+		pool->skippedCapacity = newCapacity;
+	}
+
+	pool->skipped[pool->skippedCount].begin = begin;
+	pool->skipped[pool->skippedCount].end = end;
+	pool->skippedCount++;
+	return true;
+}
+
+CREN_API CRenIDPool* cren_idpool_create()
+{
+	CRenIDPool* pool = (CRenIDPool*)malloc(sizeof(CRenIDPool));
+	CREN_ASSERT(pool != NULL, "Failed to allocate memory for the id pool");
+
+	memset(pool, 0, sizeof(CRenIDPool));
+	CREN_IDPOOL_LOCK_INIT(&pool->lock);
+	pool->next = 1;
+
+	return pool;
+}
+
+CREN_API void cren_idpool_destroy(CRenIDPool* pool)
+{
+	if (!pool) return;
+
+	CREN_IDPOOL_LOCK_DESTROY(&pool->lock);
+	for (uint32_t i = 0; i < pool->pageCount; i++) {
+		if (pool->pages[i]) free(pool->pages[i]);
+	}
+
+	if (pool->pages) free(pool->pages);
+	if (pool->freeIDs) free(pool->freeIDs);
+	if (pool->skipped) free(pool->skipped);
+	free(pool);
+}
+
+CREN_API uint32_t cren_idpool_reserve(CRenIDPool* pool, uint32_t* ids, uint32_t count)
+{
+	if (!pool || !ids) return 0;
+
+	uint32_t reserved = 0;
+	CREN_IDPOOL_LOCK(&pool->lock);
+
+	// released ids first
+	while (reserved < count && pool->freeCount > 0) {
+		uint32_t id = pool->freeIDs[--pool->freeCount];
+		if (internal_cren_idpool_test(pool, id)) continue;
+
+		internal_cren_idpool_set(pool, id);
+		ids[reserved++] = id;
+	}
+
+	// never-used ids jumped over by claims, skipping the ones claimed later on
+	while (reserved < count && pool->skippedHead < pool->skippedCount) {
+		CRenIDRange* range = &pool->skipped[pool->skippedHead];
+		uint32_t id = range->begin;
+		if (!internal_cren_idpool_cover(pool, id)) break;
+
+		if (++range->begin == range->end) pool->skippedHead++;
+		if (internal_cren_idpool_test(pool, id)) continue;
+
+		internal_cren_idpool_set(pool, id);
+		ids[reserved++] = id;
+	}
+
+	if (pool->skippedHead == pool->skippedCount) pool->skippedHead = pool->skippedCount = 0;
+
+	// never-used ids
+	while (reserved < count && pool->next < UINT32_MAX) {
+		uint32_t id = pool->next++;
+		if (!internal_cren_idpool_cover(pool, id)) {
+			pool->next--;
+			break;
+		}
+
+		internal_cren_idpool_set(pool, id);
+		ids[reserved++] = id;
+	}
+
+	CREN_IDPOOL_UNLOCK(&pool->lock);
+	return reserved;
+}
+
+CREN_API uint32_t cren_idpool_release(CRenIDPool* pool, const uint32_t* ids, uint32_t count)
+{
+	if (!pool || !ids) return 0;
+
+	uint32_t released = 0;
+	CREN_IDPOOL_LOCK(&pool->lock);
+
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t id = ids[i];
+		if (id == 0 || !internal_cren_idpool_test(pool, id)) continue;
+
+		// an id that can't be tracked as free stays reserved, leaking it is better than handing it out twice
+		if (!internal_cren_idpool_push_free(pool, id)) break;
+
+		*internal_cren_idpool_word(pool, id) &= ~(1ull << (id & 63));
+		released++;
+	}
+
+	CREN_IDPOOL_UNLOCK(&pool->lock);
+	return released;
+}
+
+CREN_API bool cren_idpool_claim(CRenIDPool* pool, uint32_t id)
+{
+	if (!pool || id == 0 || id == UINT32_MAX) return false;
+
+	bool result = false;
+	CREN_IDPOOL_LOCK(&pool->lock);
+
+	if (internal_cren_idpool_cover(pool, id) && !internal_cren_idpool_test(pool, id)) {
+		// the ids jumped over are kept as a single range, so the space below the claimed id is still handed out
+		if (id >= pool->next) {
+			result = id == pool->next || internal_cren_idpool_push_skipped(pool, pool->next, id);
+			if (result) pool->next = id + 1;
+		}
+
+		else result = true;
+
+		if (result) internal_cren_idpool_set(pool, id);
+	}
+
+	CREN_IDPOOL_UNLOCK(&pool->lock);
+	return result;
+}
+
+CREN_API bool cren_idpool_is_reserved(CRenIDPool* pool, uint32_t id)
+{
+	if (!pool) return false;
+
+	CREN_IDPOOL_LOCK(&pool->lock);
+	bool result = internal_cren_idpool_test(pool, id);
+	CREN_IDPOOL_UNLOCK(&pool->lock);
+
+	return result;
+}
+
+CREN_API uint32_t cren_idpool_get_high_water(CRenIDPool* pool)
+{
+	if (!pool) return 0;
+
+	CREN_IDPOOL_LOCK(&pool->lock);
+	uint32_t next = pool->next;
+	CREN_IDPOOL_UNLOCK(&pool->lock);
+
+	return next;
+}
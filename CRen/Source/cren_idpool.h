@@ -0,0 +1,36 @@
+#ifndef CREN_IDPOOL_INCLUDED
+#define CREN_IDPOOL_INCLUDED
+
+#include "cren_defines.h"
+#include "cren_types.h"
+
+#ifdef __cplusplus 
+extern "C" {
+#endif
+
+/// @brief creates the pool of object ids, ids start at 1 since 0 means no object on the picking buffer
+CREN_API CRenIDPool* cren_idpool_create();
+
+/// @brief releases the pool resources
+CREN_API void cren_idpool_destroy(CRenIDPool* pool);
+
+/// @brief reserves up to count ids at once, released ids are handed out before never-used ones (keeping the id space compact), returns how many were reserved
+CREN_API uint32_t cren_idpool_reserve(CRenIDPool* pool, uint32_t* ids, uint32_t count);
+
+/// @brief releases reserved ids back into the pool, returns how many were actually reserved
+CREN_API uint32_t cren_idpool_release(CRenIDPool* pool, const uint32_t* ids, uint32_t count);
+
+/// @brief reserves a specific id, returns false if it's already reserved
+CREN_API bool cren_idpool_claim(CRenIDPool* pool, uint32_t id);
+
+/// @brief returns if the id is currently reserved
+CREN_API bool cren_idpool_is_reserved(CRenIDPool* pool, uint32_t id);
+
+/// @brief returns one past the highest id ever reserved, the size a per-id table (picking buffers) must have
+CREN_API uint32_t cren_idpool_get_high_water(CRenIDPool* pool);
+
+#ifdef __cplusplus 
+}
+#endif
+
+#endif // CREN_IDPOOL_INCLUDED
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "cren_memory.h"
+
+#include "cren_error.h"
+#include <memm/memm.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define CREN_ATOMIC_LOAD(ptr) (uint64_t)InterlockedCompareExchange64((volatile LONG64*)(ptr), 0, 0)
+#define CREN_ATOMIC_ADD(ptr, value) (uint64_t)InterlockedExchangeAdd64((volatile LONG64*)(ptr), (LONG64)(value))
+#define CREN_ATOMIC_EXCHANGE(ptr, value) (uint64_t)InterlockedExchange64((volatile LONG64*)(ptr), (LONG64)(value))
+#define CREN_ATOMIC_CAS(ptr, expected, desired) (InterlockedCompareExchange64((volatile LONG64*)(ptr), (LONG64)(desired), (LONG64)(expected)) == (LONG64)(expected))
+#else
+#define CREN_ATOMIC_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define CREN_ATOMIC_ADD(ptr, value) __atomic_fetch_add(ptr, (uint64_t)(value), __ATOMIC_RELAXED)
+#define CREN_ATOMIC_EXCHANGE(ptr, value) __atomic_exchange_n(ptr, (uint64_t)(value), __ATOMIC_RELAXED)
+#define CREN_ATOMIC_CAS(ptr, expected, desired) __atomic_compare_exchange_n(ptr, &(expected), (uint64_t)(desired), true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#endif
+
+/// @brief the counters of a tag, a cache line each so threads allocating under different tags don't contend
+typedef struct align_as(64) CRenMemoryCounters
+{
+	uint64_t liveBytes;
+	uint64_t peakBytes;
+	uint64_t liveAllocations;
+	uint64_t totalAllocations;
+	uint64_t frameAllocations;
+	uint64_t frameBytes;
+	uint64_t lastFrameAllocations;
+	uint64_t lastFrameBytes;
+} CRenMemoryCounters;
+
+/// @brief prepended to every host allocation, offset leads back to the start of the block the allocator returned
+typedef struct CRenMemoryHeader
+{
+	uint64_t size;
+	uint32_t tag;
+	uint32_t offset;
+} CRenMemoryHeader;
+
+/// @brief what malloc guarantees on every platform cren runs on, bigger alignments are made by over-allocating
+#define CREN_MEMORY_MALLOC_ALIGNMENT (2 * sizeof(void*))
+
+static CRenMemoryCounters sCounters[CREN_MEMORY_TAG_MAX];
+static CRenAllocator sAllocator = { NULL, NULL, NULL }; // no callbacks means malloc/free
+static uint64_t sHostAllocations = 0; // live, the allocator can't be replaced while any is around
+
+static const char* sTagNames[CREN_MEMORY_TAG_MAX] = {
+	"General",
+	"Textures",
+	"Buffers",
+	"Entities",
+	"UI",
+	"Datafile",
+	"Scene",
+	"Primitives",
+	"Driver"
+};
+
+CREN_API const char* cren_memory_tag_name(CRen_MemoryTag tag)
+{
+	if (tag < 0 || tag >= CREN_MEMORY_TAG_MAX) return "Unknown";
+	return sTagNames[tag];
+}
+
+CREN_API void cren_memory_track(CRen_MemoryTag tag, size_t size)
+{
+	if (tag < 0 || tag >= CREN_MEMORY_TAG_MAX) tag = CREN_MEMORY_TAG_GENERAL;
+	CRenMemoryCounters* counters = &sCounters[tag];
+
+	uint64_t live = CREN_ATOMIC_ADD(&counters->liveBytes, size) + size;
+	CREN_ATOMIC_ADD(&counters->liveAllocations, 1);
+	CREN_ATOMIC_ADD(&counters->totalAllocations, 1);
+	CREN_ATOMIC_ADD(&counters->frameAllocations, 1);
+	CREN_ATOMIC_ADD(&counters->frameBytes, size);
+
+	// the peak only moves up, losing the race to a bigger value ends the loop
+	uint64_t peak = CREN_ATOMIC_LOAD(&counters->peakBytes);
+	while (live > peak) {
+		if (CREN_ATOMIC_CAS(&counters->peakBytes, peak, live)) break;
+		peak = CREN_ATOMIC_LOAD(&counters->peakBytes);
+	}
+}
+
+CREN_API void cren_memory_untrack(CRen_MemoryTag tag, size_t size)
+{
+	if (tag < 0 || tag >= CREN_MEMORY_TAG_MAX) tag = CREN_MEMORY_TAG_GENERAL;
+	CRenMemoryCounters* counters = &sCounters[tag];
+
+	CREN_ATOMIC_ADD(&counters->liveBytes, (uint64_t)0 - (uint64_t)size);
+	CREN_ATOMIC_ADD(&counters->liveAllocations, (uint64_t)0 - 1);
+}
+
+CREN_API bool cren_memory_set_allocator(const CRenAllocator* allocator)
+{
+	if (allocator && (!allocator->allocate || !allocator->free)) {
+		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Host allocator must provide both allocate and free");
+		return false;
+	}
+
+	if (CREN_ATOMIC_LOAD(&sHostAllocations) != 0) {
+		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Host allocator can't be replaced while %llu allocations are alive", (unsigned long long)CREN_ATOMIC_LOAD(&sHostAllocations));
+		return false;
+	}
+
+	CRenAllocator defaultAllocator = { NULL, NULL, NULL };
+	sAllocator = allocator ? *allocator : defaultAllocator;
+	return true;
+}
+
+CREN_API void* cren_memory_alloc(CRen_MemoryTag tag, size_t size)
+{
+	return cren_memory_alloc_aligned(tag, size, 16);
+}
+
+CREN_API void* cren_memory_alloc_aligned(CRen_MemoryTag tag, size_t size, size_t alignment)
+{
+	if (tag < 0 || tag >= CREN_MEMORY_TAG_MAX) tag = CREN_MEMORY_TAG_GENERAL;
+	if (alignment < 16) alignment = 16;
+	if ((alignment & (alignment - 1)) != 0) {
+		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Alignment %zu is not a power of two", alignment);
+		return NULL;
+	}
+
+	// the header sits right before the returned memory, taking a whole alignment step so the memory stays aligned
+	size_t headerSize = alignment;
+	uint8_t* block = NULL;
+	uint8_t* ptr = NULL;
+
+	if (sAllocator.allocate) {
+		block = (uint8_t*)sAllocator.allocate(sAllocator.userData, headerSize + size, alignment);
+		ptr = block + headerSize;
+	}
+
+	else {
+		size_t padding = alignment > CREN_MEMORY_MALLOC_ALIGNMENT ? alignment : 0;
+		block = (uint8_t*)malloc(headerSize + size + padding);
+		ptr = (uint8_t*)(((uintptr_t)block + headerSize + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	}
+
+	if (!block) {
+		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate %zu bytes for %s", size, cren_memory_tag_name(tag));
+		return NULL;
+	}
+
+	CRenMemoryHeader* header = (CRenMemoryHeader*)ptr - 1;
+	header->size = size;
+	header->tag = (uint32_t)tag;
+	header->offset = (uint32_t)(ptr - block);
+
+	CREN_ATOMIC_ADD(&sHostAllocations, 1);
+	cren_memory_track(tag, size);
+	return ptr;
+}
+
+CREN_API void* cren_memory_realloc(void* ptr, size_t size, size_t alignment)
+{
+	if (!ptr) return cren_memory_alloc_aligned(CREN_MEMORY_TAG_GENERAL, size, alignment);
+
+	if (size == 0) {
+		cren_memory_free(ptr);
+		return NULL;
+	}
+
+	CRenMemoryHeader* header = (CRenMemoryHeader*)ptr - 1;
+	void* resized = cren_memory_alloc_aligned((CRen_MemoryTag)header->tag, size, alignment);
+	if (!resized) return NULL; // the original is left untouched
+
+	memcpy(resized, ptr, header->size < size ? (size_t)header->size : size);
+	cren_memory_free(ptr);
+	return resized;
+}
+
+CREN_API void cren_memory_free(void* ptr)
+{
+	if (!ptr) return;
+
+	CRenMemoryHeader* header = (CRenMemoryHeader*)ptr - 1;
+	uint8_t* block = (uint8_t*)ptr - header->offset;
+	cren_memory_untrack((CRen_MemoryTag)header->tag, (size_t)header->size);
+	CREN_ATOMIC_ADD(&sHostAllocations, (uint64_t)0 - 1);
+
+	if (sAllocator.free) sAllocator.free(sAllocator.userData, block);
+	else free(block);
+}
+
+CREN_API void cren_memory_begin_frame()
+{
+	for (int i = 0; i < CREN_MEMORY_TAG_MAX; i++) {
+		CRenMemoryCounters* counters = &sCounters[i];
+		CREN_ATOMIC_EXCHANGE(&counters->lastFrameAllocations, CREN_ATOMIC_EXCHANGE(&counters->frameAllocations, 0));
+		CREN_ATOMIC_EXCHANGE(&counters->lastFrameBytes, CREN_ATOMIC_EXCHANGE(&counters->frameBytes, 0));
+	}
+}
+
+CREN_API void cren_memory_get_stats(CRen_MemoryTag tag, CRenMemoryStats* outStats)
+{
+	if (!outStats) return;
+	if (tag < 0 || tag >= CREN_MEMORY_TAG_MAX) tag = CREN_MEMORY_TAG_GENERAL;
+	CRenMemoryCounters* counters = &sCounters[tag];
+
+	outStats->liveBytes = CREN_ATOMIC_LOAD(&counters->liveBytes);
+	outStats->peakBytes = CREN_ATOMIC_LOAD(&counters->peakBytes);
+	outStats->liveAllocations = CREN_ATOMIC_LOAD(&counters->liveAllocations);
+	outStats->totalAllocations = CREN_ATOMIC_LOAD(&counters->totalAllocations);
+	outStats->frameAllocations = CREN_ATOMIC_LOAD(&counters->lastFrameAllocations);
+	outStats->frameBytes = CREN_ATOMIC_LOAD(&counters->lastFrameBytes);
+}
@@ -0,0 +1,64 @@
+#ifndef CREN_MEMORY_INCLUDED
+#define CREN_MEMORY_INCLUDED
+
+#include "cren_defines.h"
+#include "cren_types.h"
+
+/// @brief the counters of a memory tag
+typedef struct CRenMemoryStats
+{
+	uint64_t liveBytes;
+	uint64_t peakBytes;
+	uint64_t liveAllocations;
+	uint64_t totalAllocations;
+	uint64_t frameAllocations; // allocations made during the last complete frame
+	uint64_t frameBytes; // bytes allocated during the last complete frame
+} CRenMemoryStats;
+
+/// @brief host memory callbacks, every host allocation cren makes (the vulkan driver's included) is served by them
+typedef struct CRenAllocator
+{
+	void* userData;
+	void* (*allocate)(void* userData, size_t size, size_t alignment); // alignment is a power of two
+	void (*free)(void* userData, void* ptr);
+} CRenAllocator;
+
+#ifdef __cplusplus 
+extern "C" {
+#endif
+
+/// @brief returns the display name of a memory tag
+CREN_API const char* cren_memory_tag_name(CRen_MemoryTag tag);
+
+/// @brief records an allocation made elsewhere (device memory, objects with their own allocator) under tag, the counters are lock-free
+CREN_API void cren_memory_track(CRen_MemoryTag tag, size_t size);
+
+/// @brief records the release of an allocation previously recorded with cren_memory_track
+CREN_API void cren_memory_untrack(CRen_MemoryTag tag, size_t size);
+
+/// @brief replaces the host allocator, null restores the default (malloc/free), fails while memory from the previous one is alive
+CREN_API bool cren_memory_set_allocator(const CRenAllocator* allocator);
+
+/// @brief allocates size bytes from the host allocator and records them under tag, the memory is aligned to 16 bytes
+CREN_API void* cren_memory_alloc(CRen_MemoryTag tag, size_t size);
+
+/// @brief allocates size bytes aligned to alignment (a power of two) from the host allocator and records them under tag
+CREN_API void* cren_memory_alloc_aligned(CRen_MemoryTag tag, size_t size, size_t alignment);
+
+/// @brief resizes memory returned by the cren_memory allocation functions keeping it's tag, null ptr allocates and size 0 frees
+CREN_API void* cren_memory_realloc(void* ptr, size_t size, size_t alignment);
+
+/// @brief releases memory returned by the cren_memory allocation functions, null is ignored
+CREN_API void cren_memory_free(void* ptr);
+
+/// @brief closes the current frame, it's allocation counts become the frame counts reported by the stats
+CREN_API void cren_memory_begin_frame();
+
+/// @brief fills the counters of a memory tag
+CREN_API void cren_memory_get_stats(CRen_MemoryTag tag, CRenMemoryStats* outStats);
+
+#ifdef __cplusplus 
+}
+#endif
+
+#endif // CREN_MEMORY_INCLUDED
\ No newline at end of file
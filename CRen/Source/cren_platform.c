@@ -4,8 +4,22 @@
 #include <memm/memm.h>
 #include <stb/stb_image.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+static SRWLOCK sPreloadLock = SRWLOCK_INIT;
+#define CREN_PRELOAD_LOCK() AcquireSRWLockExclusive(&sPreloadLock)
+#define CREN_PRELOAD_UNLOCK() ReleaseSRWLockExclusive(&sPreloadLock)
+#else
+#include <pthread.h>
+static pthread_mutex_t sPreloadLock = PTHREAD_MUTEX_INITIALIZER;
+#define CREN_PRELOAD_LOCK() pthread_mutex_lock(&sPreloadLock)
+#define CREN_PRELOAD_UNLOCK() pthread_mutex_unlock(&sPreloadLock)
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // internal
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -89,6 +103,91 @@ static unsigned int* internal_cren_android_load_file(const char* path, size_t* o
 
 #endif
 
+/// @brief a file read or an image decoded ahead of time, handed to the first load asking for it
+typedef struct CRenPreload
+{
+    struct CRenPreload* next;
+    char* path;
+    int desiredChannels;    // -1 for a file
+    void* data;
+    size_t size;
+    int width;
+    int height;
+    int channels;
+} CRenPreload;
+
+static CRenPreload* sPreloads = NULL;
+
+/// @brief returns what was preloaded from path, NULL if nothing was, the preload lock must be held
+static CRenPreload* internal_cren_find_preload(const char* path, int desiredChannels)
+{
+    for (CRenPreload* preload = sPreloads; preload; preload = preload->next) {
+        if (preload->desiredChannels == desiredChannels && strcmp(preload->path, path) == 0) return preload;
+    }
+
+    return NULL;
+}
+
+/// @brief keeps data loaded from path, the preload owns it from now on
+static void internal_cren_add_preload(const char* path, int desiredChannels, void* data, size_t size, int width, int height, int channels)
+{
+    CRenPreload* preload = (CRenPreload*)calloc(1, sizeof(CRenPreload));
+    char* pathCopy = (char*)malloc(strlen(path) + 1);
+    if (!preload || !pathCopy) {
+        free(preload);
+        free(pathCopy);
+        free(data);
+        return;
+    }
+
+    strcpy(pathCopy, path);
+    preload->path = pathCopy;
+    preload->desiredChannels = desiredChannels;
+    preload->data = data;
+    preload->size = size;
+    preload->width = width;
+    preload->height = height;
+    preload->channels = channels;
+
+    // two threads may have preloaded the same path, the first one stays
+    CREN_PRELOAD_LOCK();
+    if (internal_cren_find_preload(path, desiredChannels)) {
+        CREN_PRELOAD_UNLOCK();
+        free(preload->data);
+        free(preload->path);
+        free(preload);
+        return;
+    }
+
+    preload->next = sPreloads;
+    sPreloads = preload;
+    CREN_PRELOAD_UNLOCK();
+}
+
+/// @brief hands what was preloaded over to the caller and forgets about it, NULL if nothing was, the buffer is released with free
+static void* internal_cren_take_preload(const char* path, int desiredChannels, size_t* outSize, int* outWidth, int* outHeight, int* outChannels)
+{
+    CREN_PRELOAD_LOCK();
+    CRenPreload** link = &sPreloads;
+    while (*link && ((*link)->desiredChannels != desiredChannels || strcmp((*link)->path, path) != 0)) link = &(*link)->next;
+
+    CRenPreload* preload = *link;
+    if (preload) *link = preload->next;
+    CREN_PRELOAD_UNLOCK();
+
+    if (!preload) return NULL;
+
+    void* data = preload->data;
+    if (outSize) *outSize = preload->size;
+    if (outWidth) *outWidth = preload->width;
+    if (outHeight) *outHeight = preload->height;
+    if (outChannels) *outChannels = preload->channels;
+
+    free(preload->path);
+    free(preload);
+    return data;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // external
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -128,6 +227,10 @@ CREN_API void cren_get_path(const char* subpath, const char* assetsRoot, bool re
 
 CREN_API uint8_t* cren_stbimage_load_from_file(const char* path, int desiredChannels, int* outWidth, int* outHeight, int* outChannels)
 {
+    // the preloaded pixels came from stbi_load, the caller releases them the same way as the ones loaded here
+    uint8_t* preloaded = (uint8_t*)internal_cren_take_preload(path, desiredChannels, NULL, outWidth, outHeight, outChannels);
+    if (preloaded) return preloaded;
+
     int x, y, channels = 0;
     stbi_uc* pixels = stbi_load(path, &x, &y, &channels, desiredChannels);
 
@@ -149,6 +252,9 @@ CREN_API const char* cren_stbimage_get_error()
 
 CREN_API unsigned int* cren_load_file(const char* path, size_t* outSize)
 {
+    unsigned int* preloaded = (unsigned int*)internal_cren_take_preload(path, -1, outSize, NULL, NULL, NULL);
+    if (preloaded) return preloaded;
+
     #if defined(__linux__) && defined(__ANDROID__)
         return internal_cren_android_load_file(path, outSize);
     #elif defined(_WIN32) || defined(_WIN64) || (defined(__linux__) && !defined(__ANDROID__))
@@ -157,3 +263,53 @@ CREN_API unsigned int* cren_load_file(const char* path, size_t* outSize)
         #error "This will need checking for ios and probably be different from macos";
     #endif
 }
+
+CREN_API bool cren_preload_file(const char* path)
+{
+    size_t size = 0;
+    unsigned int* data = NULL;
+
+    #if defined(__linux__) && defined(__ANDROID__)
+        data = internal_cren_android_load_file(path, &size);
+    #elif defined(_WIN32) || defined(_WIN64) || (defined(__linux__) && !defined(__ANDROID__))
+        data = internal_cren_dekstop_load_file(path, &size);
+    #endif
+
+    if (!data) {
+        CREN_LOG(CREN_LOG_SEVERITY_WARN, "Failed to preload %s", path);
+        return false;
+    }
+
+    internal_cren_add_preload(path, -1, data, size, 0, 0, 0);
+    return true;
+}
+
+CREN_API bool cren_preload_image(const char* path, int desiredChannels)
+{
+    int width = 0, height = 0, channels = 0;
+    stbi_uc* pixels = stbi_load(path, &width, &height, &channels, desiredChannels);
+    if (!pixels) {
+        CREN_LOG(CREN_LOG_SEVERITY_WARN, "Failed to preload image %s: %s", path, stbi_failure_reason());
+        return false;
+    }
+
+    size_t size = (size_t)width * (size_t)height * (size_t)(desiredChannels > 0 ? desiredChannels : channels);
+    internal_cren_add_preload(path, desiredChannels, pixels, size, width, height, channels);
+    return true;
+}
+
+CREN_API void cren_release_preloads()
+{
+    CREN_PRELOAD_LOCK();
+    CRenPreload* preload = sPreloads;
+    sPreloads = NULL;
+    CREN_PRELOAD_UNLOCK();
+
+    while (preload) {
+        CRenPreload* next = preload->next;
+        free(preload->data);
+        free(preload->path);
+        free(preload);
+        preload = next;
+    }
+}
@@ -26,6 +26,15 @@ CREN_API const char* cren_stbimage_get_error();
 /// @brief loads a file given it's path
 CREN_API unsigned int* cren_load_file(const char* path, size_t* outSize);
 
+/// @brief reads a file ahead of time, may be called from any thread, the next cren_load_file of it takes the data instead of reading it again
+CREN_API bool cren_preload_file(const char* path);
+
+/// @brief decodes an image ahead of time, may be called from any thread, the next cren_stbimage_load_from_file with the same channels takes the pixels
+CREN_API bool cren_preload_image(const char* path, int desiredChannels);
+
+/// @brief frees everything preloaded but never loaded, loads go back to the disk
+CREN_API void cren_release_preloads();
+
 #ifdef __cplusplus 
 }
 #endif
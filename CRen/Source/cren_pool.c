@@ -0,0 +1,171 @@
+#include "cren_pool.h"
+
+#include "cren_error.h"
+#include "cren_memory.h"
+#include <memm/memm.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+typedef SRWLOCK CRenPoolLock;
+#define CREN_POOL_LOCK_INIT(lock) InitializeSRWLock(lock)
+#define CREN_POOL_LOCK_DESTROY(lock)
+#define CREN_POOL_LOCK(lock) AcquireSRWLockExclusive(lock)
+#define CREN_POOL_UNLOCK(lock) ReleaseSRWLockExclusive(lock)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t CRenPoolLock;
+#define CREN_POOL_LOCK_INIT(lock) pthread_mutex_init(lock, NULL)
+#define CREN_POOL_LOCK_DESTROY(lock) pthread_mutex_destroy(lock)
+#define CREN_POOL_LOCK(lock) pthread_mutex_lock(lock)
+#define CREN_POOL_UNLOCK(lock) pthread_mutex_unlock(lock)
+#endif
+
+/// @brief blocks are handed out aligned as malloc would
+#define CREN_POOL_BLOCK_ALIGNMENT 16
+
+/// @brief a released block, the link lives in the block memory itself
+typedef struct CRenPoolFreeBlock
+{
+	struct CRenPoolFreeBlock* next;
+} CRenPoolFreeBlock;
+
+/// @brief a chunk of blocks, the blocks follow the (block aligned) chunk header
+typedef struct CRenPoolChunk
+{
+	struct CRenPoolChunk* next;
+} CRenPoolChunk;
+
+/// @brief chunks are never returned to the host allocator before the pool is destroyed, the pool stays at it's peak size
+struct CRenPool
+{
+	CRenPoolLock lock;
+	CRen_MemoryTag tag;
+	size_t blockSize;
+	uint32_t blocksPerChunk;
+
+	CRenPoolChunk* chunks;
+	CRenPoolFreeBlock* freeBlocks;
+
+	// blocks of the newest chunk that were never handed out, carved lazily so a new chunk isn't walked upfront
+	uint8_t* untouched;
+	uint32_t untouchedCount;
+
+	uint32_t liveCount;
+};
+
+/// @brief size of the chunk header, keeping the blocks after it aligned
+static size_t internal_cren_pool_chunk_header_size()
+{
+	return (sizeof(CRenPoolChunk) + CREN_POOL_BLOCK_ALIGNMENT - 1) & ~(size_t)(CREN_POOL_BLOCK_ALIGNMENT - 1);
+}
+
+CREN_API CRenPool* cren_pool_create(size_t blockSize, uint32_t blocksPerChunk, CRen_MemoryTag tag)
+{
+	if (blockSize == 0 || blocksPerChunk == 0) {
+		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Invalid pool block size or blocks per chunk");
+		return NULL;
+	}
+
+	CRenPool* pool = (CRenPool*)cren_memory_alloc(tag, sizeof(CRenPool));
+	if (!pool) {
+		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate memory for the pool");
+		return NULL;
+	}
+
+	memset(pool, 0, sizeof(CRenPool));
+	CREN_POOL_LOCK_INIT(&pool->lock);
+	pool->tag = tag;
+	pool->blocksPerChunk = blocksPerChunk;
+
+	// a released block must be able to hold the free list link
+	if (blockSize < sizeof(CRenPoolFreeBlock)) blockSize = sizeof(CRenPoolFreeBlock);
+	pool->blockSize = (blockSize + CREN_POOL_BLOCK_ALIGNMENT - 1) & ~(size_t)(CREN_POOL_BLOCK_ALIGNMENT - 1);
+
+	return pool;
+}
+
+CREN_API void cren_pool_destroy(CRenPool* pool)
+{
+	if (!pool) return;
+
+	if (pool->liveCount > 0) {
+		CREN_LOG(CREN_LOG_SEVERITY_WARN, "Pool of %s destroyed with %u blocks still in use", cren_memory_tag_name(pool->tag), pool->liveCount);
+	}
+
+	CRenPoolChunk* chunk = pool->chunks;
+	while (chunk) {
+		CRenPoolChunk* next = chunk->next;
+		cren_memory_free(chunk);
+		chunk = next;
+	}
+
+	CREN_POOL_LOCK_DESTROY(&pool->lock);
+	cren_memory_free(pool);
+}
+
+CREN_API void* cren_pool_alloc(CRenPool* pool)
+{
+	if (!pool) return NULL;
+
+	CREN_POOL_LOCK(&pool->lock);
+
+	void* block = NULL;
+	if (pool->freeBlocks) {
+		block = pool->freeBlocks;
+		pool->freeBlocks = pool->freeBlocks->next;
+	}
+
+	else {
+		if (pool->untouchedCount == 0) {
+			size_t headerSize = internal_cren_pool_chunk_header_size();
+			CRenPoolChunk* chunk = (CRenPoolChunk*)cren_memory_alloc_aligned(pool->tag, headerSize + pool->blockSize * pool->blocksPerChunk, CREN_POOL_BLOCK_ALIGNMENT);
+			if (!chunk) {
+				CREN_POOL_UNLOCK(&pool->lock);
+				CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to grow the pool of %s", cren_memory_tag_name(pool->tag));
+				return NULL;
+			}
+
+			chunk->next = pool->chunks;
+			pool->chunks = chunk;
+			pool->untouched = (uint8_t*)chunk + headerSize;
+			pool->untouchedCount = pool->blocksPerChunk;
+		}
+
+		block = pool->untouched;
+		pool->untouched += pool->blockSize;
+		pool->untouchedCount--;
+	}
+
+	pool->liveCount++;
+	CREN_POOL_UNLOCK(&pool->lock);
+
+	memset(block, 0, pool->blockSize);
+	return block;
+}
+
+CREN_API void cren_pool_free(CRenPool* pool, void* block)
+{
+	if (!pool || !block) return;
+
+	CREN_POOL_LOCK(&pool->lock);
+
+	CRenPoolFreeBlock* freeBlock = (CRenPoolFreeBlock*)block;
+	freeBlock->next = pool->freeBlocks;
+	pool->freeBlocks = freeBlock;
+	pool->liveCount--;
+
+	CREN_POOL_UNLOCK(&pool->lock);
+}
+
+CREN_API uint32_t cren_pool_get_live_count(CRenPool* pool)
+{
+	if (!pool) return 0;
+
+	CREN_POOL_LOCK(&pool->lock);
+	uint32_t count = pool->liveCount;
+	CREN_POOL_UNLOCK(&pool->lock);
+
+	return count;
+}
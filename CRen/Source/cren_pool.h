@@ -0,0 +1,30 @@
+#ifndef CREN_POOL_INCLUDED
+#define CREN_POOL_INCLUDED
+
+#include "cren_defines.h"
+#include "cren_types.h"
+
+#ifdef __cplusplus 
+extern "C" {
+#endif
+
+/// @brief creates a pool of fixed-size blocks, memory is taken from the host allocator blocksPerChunk blocks at a time and accounted under tag
+CREN_API CRenPool* cren_pool_create(size_t blockSize, uint32_t blocksPerChunk, CRen_MemoryTag tag);
+
+/// @brief releases the pool and all it's chunks, blocks still in use are reported as leaks
+CREN_API void cren_pool_destroy(CRenPool* pool);
+
+/// @brief returns a zeroed block, recently released blocks are handed out first since they're likely still cached
+CREN_API void* cren_pool_alloc(CRenPool* pool);
+
+/// @brief returns a block to the pool, null is ignored
+CREN_API void cren_pool_free(CRenPool* pool, void* block);
+
+/// @brief returns how many blocks are currently in use
+CREN_API uint32_t cren_pool_get_live_count(CRenPool* pool);
+
+#ifdef __cplusplus 
+}
+#endif
+
+#endif // CREN_POOL_INCLUDED
\ No newline at end of file
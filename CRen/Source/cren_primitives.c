@@ -2,9 +2,17 @@
 
 #include "cren_context.h"
 #include "cren_error.h"
+#include "cren_pool.h"
 #include "Vulkan/crenvk_primitives.h"
 #include <memm/memm.h>
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pools, created and released with the context (see cren_primitives_initialize)
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static CRenPool* sTexturePool = NULL;
+static CRenPool* sQuadPool = NULL;
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Texture
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -23,8 +31,7 @@ struct CRenTexture2D
 
 CREN_API CRenTexture2D* cren_texture2d_create_from_path(CRenContext* context, const char* path, bool uiTexture)
 {
-    CRenTexture2D* texture = (CRenTexture2D*)malloc(sizeof(CRenTexture2D));
-    texture->backend = NULL;
+    CRenTexture2D* texture = (CRenTexture2D*)cren_pool_alloc(sTexturePool);
     if (!texture) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate memory for CRenTexture2D");
         return NULL;
@@ -33,6 +40,7 @@ CREN_API CRenTexture2D* cren_texture2d_create_from_path(CRenContext* context, co
     texture->path = path;
 
     #ifdef CREN_BUILD_WITH_VULKAN
+    cren_lock(context);
     VkResult result = crenvk_texture2d_create_from_path
     (
         cren_get_vulkan_backend(context),
@@ -44,10 +52,11 @@ CREN_API CRenTexture2D* cren_texture2d_create_from_path(CRenContext* context, co
         &texture->height,
         &texture->mipLevels
     );
+    cren_unlock(context);
     if (result != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create vulkan Texture 2D");
 
-        free(texture);
+        cren_pool_free(sTexturePool, texture);
         return NULL;
     }
     #endif
@@ -57,7 +66,7 @@ CREN_API CRenTexture2D* cren_texture2d_create_from_path(CRenContext* context, co
 
 CREN_API CRenTexture2D* cren_texture2d_create_from_buffer(CRenContext* context, uint8_t* buffer, size_t bufferLen, int32_t width, int32_t height, bool uiTexture)
 {
-    CRenTexture2D* texture = (CRenTexture2D*)malloc(sizeof(CRenTexture2D));
+    CRenTexture2D* texture = (CRenTexture2D*)cren_pool_alloc(sTexturePool);
     if (!texture) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate memory for CRenTexture2D");
         return NULL;
@@ -67,7 +76,7 @@ CREN_API CRenTexture2D* cren_texture2d_create_from_buffer(CRenContext* context,
     texture->height = height;
 
     #ifdef CREN_BUILD_WITH_VULKAN
-    
+    cren_lock(context);
     VkResult result = crenvk_texture2d_create_from_buffer
     (
         cren_get_vulkan_backend(context),
@@ -80,10 +89,11 @@ CREN_API CRenTexture2D* cren_texture2d_create_from_buffer(CRenContext* context,
         &texture->backend,
         &texture->mipLevels
     );
+    cren_unlock(context);
     if (result != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create vulkan Texture 2D");
 
-        free(texture);
+        cren_pool_free(sTexturePool, texture);
         return NULL;
     }
     #endif
@@ -96,10 +106,12 @@ CREN_API void cren_texture2d_destroy(CRenContext* context, CRenTexture2D* textur
     if (!context || !texture) return;
 
     #ifdef CREN_BUILD_WITH_VULKAN
+    cren_lock(context);
     if (texture->backend) crenvk_texture2d_destroy(cren_get_vulkan_backend(context), texture->backend);
+    cren_unlock(context);
     #endif
 
-    free(texture);
+    cren_pool_free(sTexturePool, texture);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -118,7 +130,7 @@ struct CRenQuad
 
 CREN_API CRenQuad* cren_quad_create(CRenContext* context, const char* albedoPath, uint32_t id)
 {
-    CRenQuad* quad = (CRenQuad*)malloc(sizeof(CRenQuad));
+    CRenQuad* quad = (CRenQuad*)cren_pool_alloc(sQuadPool);
     if (!quad) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create CRen Quad");
         return NULL;
@@ -128,21 +140,22 @@ CREN_API CRenQuad* cren_quad_create(CRenContext* context, const char* albedoPath
     quad->texture = cren_texture2d_create_from_path(context, albedoPath, false);
     if (!quad->texture) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create albedo texture for CRen Quad");
-        free(quad);
+        cren_pool_free(sQuadPool, quad);
         return NULL;
     }
 
     #ifdef CREN_BUILD_WITH_VULKAN
     quad->backend = NULL;
+    cren_lock(context);
     VkResult res = crenvk_quad_create_from_path(cren_get_vulkan_backend(context), albedoPath, cren_using_custom_viewport(context), &quad->backend);
+    if (res == VK_SUCCESS) crenvk_quad_update_descriptors(cren_get_vulkan_backend(context), quad->backend, quad->texture->backend);
+    cren_unlock(context);
     if (res != VK_SUCCESS) {
         CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to create CRen Quad vulkan backend");
-        crenvk_texture2d_destroy(cren_get_vulkan_backend(context), quad->texture->backend);
-        free(quad);
+        cren_texture2d_destroy(context, quad->texture);
+        cren_pool_free(sQuadPool, quad);
         return NULL;
     }
-
-    crenvk_quad_update_descriptors(cren_get_vulkan_backend(context), quad->backend, quad->texture->backend);
     #endif
 
     return quad;
@@ -154,15 +167,19 @@ CREN_API void cren_quad_destroy(CRenContext* context, CRenQuad* quad)
 
     cren_texture2d_destroy(context, quad->texture);
     #ifdef CREN_BUILD_WITH_VULKAN
+    cren_lock(context);
     crenvk_quad_destroy(cren_get_vulkan_backend(context), quad->backend);
+    cren_unlock(context);
     #endif
-    free(quad);
+    cren_pool_free(sQuadPool, quad);
 }
 
 CREN_API void cren_quad_update(CRenContext* context, CRenQuad* quad)
 {
     #ifdef CREN_BUILD_WITH_VULKAN
+    cren_lock(context);
     crenvk_quad_update(cren_get_vulkan_backend(context), quad->backend);
+    cren_unlock(context);
     #endif
 }
 
@@ -197,6 +214,7 @@ CREN_API void cren_quad_set_billboard(CRenContext* context, CRenQuad* quad, bool
     if (!context) return;
     if (quad) {
         if (quad->backend) {
+            cren_lock(context);
             if (value) {
                 quad->backend->params.billboard = 1.0f;
             }
@@ -206,6 +224,7 @@ CREN_API void cren_quad_set_billboard(CRenContext* context, CRenQuad* quad, bool
             }
 
             cren_quad_update(context, quad);
+            cren_unlock(context);
         }
     }
 }
@@ -224,6 +243,7 @@ CREN_API void cren_quad_set_lock_axis_x(CRenContext* context, CRenQuad* quad, bo
 {
     if (!context) return;
     if (quad) {
+        cren_lock(context);
         if (lock) {
             quad->backend->params.lockAxis.xy.x = 1.0f;
         }
@@ -233,6 +253,7 @@ CREN_API void cren_quad_set_lock_axis_x(CRenContext* context, CRenQuad* quad, bo
         }
 
         cren_quad_update(context, quad);
+        cren_unlock(context);
     }
 }
 
@@ -250,6 +271,7 @@ CREN_API void cren_quad_set_lock_axis_y(CRenContext* context, CRenQuad* quad, bo
 {
     if (!context) return;
     if (quad) {
+        cren_lock(context);
         if (lock) {
             quad->backend->params.lockAxis.xy.y = 1.0f;
         }
@@ -259,5 +281,27 @@ CREN_API void cren_quad_set_lock_axis_y(CRenContext* context, CRenQuad* quad, bo
         }
 
         cren_quad_update(context, quad);
+        cren_unlock(context);
     }
 }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pools lifetime
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CREN_API void cren_primitives_initialize()
+{
+    sTexturePool = cren_pool_create(sizeof(CRenTexture2D), 64, CREN_MEMORY_TAG_TEXTURES);
+    CREN_ASSERT(sTexturePool != NULL, "Failed to create the texture pool");
+
+    sQuadPool = cren_pool_create(sizeof(CRenQuad), 256, CREN_MEMORY_TAG_PRIMITIVES);
+    CREN_ASSERT(sQuadPool != NULL, "Failed to create the quad pool");
+}
+
+CREN_API void cren_primitives_shutdown()
+{
+    cren_pool_destroy(sQuadPool);
+    cren_pool_destroy(sTexturePool);
+    sQuadPool = NULL;
+    sTexturePool = NULL;
+}
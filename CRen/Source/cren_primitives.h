@@ -9,6 +9,16 @@
 extern "C" {
 #endif
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Pools, primitive objects are recycled instead of going to the heap on every create/destroy
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief creates the pools primitive objects are allocated from, called by cren_initialize
+CREN_API void cren_primitives_initialize();
+
+/// @brief releases the primitive pools, called by cren_shutdown once every primitive was destroyed
+CREN_API void cren_primitives_shutdown();
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Texture, this is most used internally or used by an user interface
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -32,7 +42,7 @@ CREN_API CRenQuad* cren_quad_create(CRenContext* context, const char* albedoPath
 /// @brief destroys a quad object
 CREN_API void cren_quad_destroy(CRenContext* context, CRenQuad* quad);
 
-/// @brief sends the quad data to the gpu
+/// @brief sends the quad data to the gpu, each frame in flight picks it up the next time it draws the quad
 CREN_API void cren_quad_update(CRenContext* context, CRenQuad* quad);
 
 /// @brief renders the quad into the world
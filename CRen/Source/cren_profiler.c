@@ -0,0 +1,360 @@
+// clock_gettime is posix, not c11
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "cren_profiler.h"
+
+#include "cren_error.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(_MSC_VER)
+#define CREN_THREAD_LOCAL __declspec(thread)
+#define CREN_ATOMIC_LOAD_ACQUIRE(ptr) (uint64_t)InterlockedCompareExchange64((volatile LONG64*)(ptr), 0, 0)
+#define CREN_ATOMIC_STORE_RELEASE(ptr, value) InterlockedExchange64((volatile LONG64*)(ptr), (LONG64)(value))
+#define CREN_ATOMIC_ADD(ptr, value) (uint32_t)InterlockedExchangeAdd((volatile LONG*)(ptr), (LONG)(value))
+#define CREN_ATOMIC_CAS(ptr, expected, desired) (InterlockedCompareExchange64((volatile LONG64*)(ptr), (LONG64)(desired), (LONG64)(expected)) == (LONG64)(expected))
+#define CREN_ATOMIC_LOAD_PTR(ptr) InterlockedCompareExchangePointer((PVOID volatile*)(ptr), NULL, NULL)
+#define CREN_ATOMIC_CAS_PTR(ptr, expected, desired) (InterlockedCompareExchangePointer((PVOID volatile*)(ptr), (PVOID)(desired), (PVOID)(expected)) == (PVOID)(expected))
+#define CREN_ATOMIC_EXCHANGE_PTR(ptr, value) InterlockedExchangePointer((PVOID volatile*)(ptr), (PVOID)(value))
+#define CREN_ATOMIC_LOAD32_RELAXED(ptr) (*(volatile const uint32_t*)(ptr))
+#define CREN_ATOMIC_FENCE_RELEASE() MemoryBarrier()
+#define CREN_ATOMIC_FENCE_ACQUIRE() MemoryBarrier()
+#else
+#define CREN_THREAD_LOCAL _Thread_local
+#define CREN_ATOMIC_LOAD_ACQUIRE(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define CREN_ATOMIC_STORE_RELEASE(ptr, value) __atomic_store_n(ptr, (uint64_t)(value), __ATOMIC_RELEASE)
+#define CREN_ATOMIC_ADD(ptr, value) __atomic_fetch_add(ptr, (uint32_t)(value), __ATOMIC_RELAXED)
+#define CREN_ATOMIC_CAS(ptr, expected, desired) __atomic_compare_exchange_n(ptr, &(expected), (uint64_t)(desired), false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#define CREN_ATOMIC_LOAD_PTR(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define CREN_ATOMIC_CAS_PTR(ptr, expected, desired) __atomic_compare_exchange_n(ptr, &(expected), desired, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)
+#define CREN_ATOMIC_EXCHANGE_PTR(ptr, value) __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL)
+#define CREN_ATOMIC_LOAD32_RELAXED(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define CREN_ATOMIC_FENCE_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define CREN_ATOMIC_FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#endif
+
+#define CREN_PROFILER_RING_MASK (CREN_PROFILER_RING_SIZE - 1)
+#define CREN_PROFILER_THREAD_NAME_SIZE 32
+
+
+CREN_API uint64_t cren_profiler_now()
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (uint64_t)((counter.QuadPart / frequency.QuadPart) * 1000000000ull + (counter.QuadPart % frequency.QuadPart) * 1000000000ull / frequency.QuadPart);
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+#endif
+}
+
+#ifndef CREN_PROFILER_DISABLED
+
+/// @brief a finished zone
+typedef struct CRenProfilerZone
+{
+	const char* name;
+	uint64_t begin;
+	uint64_t end;
+	uint32_t depth;
+} CRenProfilerZone;
+
+/// @brief zones of a thread, only the thread itself writes into it so recording takes no locks
+typedef struct CRenProfilerThread
+{
+	struct CRenProfilerThread* next;
+	uint32_t id;
+	uint64_t nameVersion; // odd while the name is being replaced, the exporter copies it again if it changed meanwhile
+	uint64_t name[CREN_PROFILER_THREAD_NAME_SIZE / sizeof(uint64_t)];
+	uint64_t head; // how many zones were ever recorded, published with release so the exporter sees whole zones
+	uint32_t depth;
+	const char* openNames[CREN_PROFILER_MAX_DEPTH];
+	uint64_t openBegins[CREN_PROFILER_MAX_DEPTH];
+	CRenProfilerZone ring[CREN_PROFILER_RING_SIZE];
+} CRenProfilerThread;
+
+static CRenProfilerThread* sThreads = NULL; // every thread that recorded since the last shutdown, pushed lock-free
+static uint32_t sThreadCount = 0;
+static uint32_t sGeneration = 0; // bumped by a shutdown, the zones threads registered before it are gone
+static uint64_t sEpoch = 0; // when the first thread registered, the exported timestamps start from it
+static CREN_THREAD_LOCAL CRenProfilerThread* tThread = NULL;
+static CREN_THREAD_LOCAL uint32_t tGeneration = 0;
+
+/// @brief returns the calling thread's zones, registering it on it's first zone (or the first one after a shutdown)
+static CRenProfilerThread* internal_cren_profiler_get_thread()
+{
+	if (tThread && tGeneration == CREN_ATOMIC_LOAD32_RELAXED(&sGeneration)) return tThread;
+
+	// plain calloc, the buffers live until the profiler is shut down (zones of finished threads are still exported) and would otherwise keep the host allocator from being replaced
+	CRenProfilerThread* thread = (CRenProfilerThread*)calloc(1, sizeof(CRenProfilerThread));
+	if (!thread) {
+		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate the profiler zones of a thread");
+		return NULL;
+	}
+
+	thread->id = CREN_ATOMIC_ADD(&sThreadCount, 1) + 1;
+	snprintf((char*)thread->name, sizeof(thread->name), "Thread %u", thread->id);
+
+	uint64_t epoch = 0;
+	CREN_ATOMIC_CAS(&sEpoch, epoch, cren_profiler_now());
+
+	CRenProfilerThread* head = NULL;
+	do {
+		head = (CRenProfilerThread*)CREN_ATOMIC_LOAD_PTR(&sThreads);
+		thread->next = head;
+	} while (!CREN_ATOMIC_CAS_PTR(&sThreads, head, thread));
+
+	tThread = thread;
+	tGeneration = CREN_ATOMIC_LOAD32_RELAXED(&sGeneration);
+	return thread;
+}
+
+/// @brief reads a word the exporter and the recording thread share, without ordering
+static uint64_t internal_cren_profiler_load_relaxed(const uint64_t* ptr)
+{
+#if defined(_MSC_VER)
+	return *(const volatile uint64_t*)ptr;
+#else
+	return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+#endif
+}
+
+/// @brief writes a word the exporter and the recording thread share, without ordering
+static void internal_cren_profiler_store_relaxed(uint64_t* ptr, uint64_t value)
+{
+#if defined(_MSC_VER)
+	*(volatile uint64_t*)ptr = value;
+#else
+	__atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+#endif
+}
+
+/// @brief replaces the name of the calling thread's zones, only the thread itself does
+static void internal_cren_profiler_store_name(CRenProfilerThread* thread, const char* name)
+{
+	uint64_t words[CREN_PROFILER_THREAD_NAME_SIZE / sizeof(uint64_t)] = { 0 };
+	snprintf((char*)words, sizeof(words), "%s", name);
+
+	uint64_t version = thread->nameVersion;
+	internal_cren_profiler_store_relaxed(&thread->nameVersion, version + 1);
+	CREN_ATOMIC_FENCE_RELEASE();
+	for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) internal_cren_profiler_store_relaxed(&thread->name[i], words[i]);
+	CREN_ATOMIC_STORE_RELEASE(&thread->nameVersion, version + 2);
+}
+
+/// @brief copies the name of a thread's zones, retrying while the thread replaces it
+static void internal_cren_profiler_load_name(const CRenProfilerThread* thread, char* outName)
+{
+	uint64_t words[CREN_PROFILER_THREAD_NAME_SIZE / sizeof(uint64_t)];
+
+	for (;;) {
+		uint64_t version = CREN_ATOMIC_LOAD_ACQUIRE(&thread->nameVersion);
+		for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) words[i] = internal_cren_profiler_load_relaxed(&thread->name[i]);
+		CREN_ATOMIC_FENCE_ACQUIRE();
+
+		if ((version & 1) == 0 && internal_cren_profiler_load_relaxed(&thread->nameVersion) == version) break;
+	}
+
+	memcpy(outName, words, sizeof(words));
+	outName[sizeof(words) - 1] = '\0';
+}
+
+/// @brief writes a zone into it's ring slot, field by field atomically since the exporter may be copying the slot meanwhile
+static void internal_cren_profiler_store_zone(CRenProfilerZone* slot, const char* name, uint64_t begin, uint64_t end, uint32_t depth)
+{
+#if defined(_MSC_VER)
+	*(const char* volatile*)&slot->name = name;
+	*(volatile uint64_t*)&slot->begin = begin;
+	*(volatile uint64_t*)&slot->end = end;
+	*(volatile uint32_t*)&slot->depth = depth;
+#else
+	__atomic_store_n(&slot->name, name, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->begin, begin, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->end, end, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->depth, depth, __ATOMIC_RELAXED);
+#endif
+}
+
+/// @brief copies a zone out of it's ring slot, it may be torn if the thread overwrote the slot meanwhile (the exporter checks the head afterwards)
+static void internal_cren_profiler_load_zone(CRenProfilerZone* outZone, const CRenProfilerZone* slot)
+{
+#if defined(_MSC_VER)
+	outZone->name = *(const char* const volatile*)&slot->name;
+	outZone->begin = *(const volatile uint64_t*)&slot->begin;
+	outZone->end = *(const volatile uint64_t*)&slot->end;
+	outZone->depth = *(const volatile uint32_t*)&slot->depth;
+#else
+	outZone->name = __atomic_load_n(&slot->name, __ATOMIC_RELAXED);
+	outZone->begin = __atomic_load_n(&slot->begin, __ATOMIC_RELAXED);
+	outZone->end = __atomic_load_n(&slot->end, __ATOMIC_RELAXED);
+	outZone->depth = __atomic_load_n(&slot->depth, __ATOMIC_RELAXED);
+#endif
+}
+
+/// @brief writes a string as a json string, the zone names are literals but may be anything
+static void internal_cren_profiler_write_string(FILE* file, const char* str)
+{
+	fputc('"', file);
+	for (const char* c = str; *c; c++) {
+		if (*c == '"' || *c == '\\') fputc('\\', file);
+		if ((unsigned char)*c >= 0x20) fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+CREN_API void cren_profiler_begin(const char* name)
+{
+	CRenProfilerThread* thread = internal_cren_profiler_get_thread();
+	if (!thread) return;
+
+	// zones past the max depth are only counted, so their ends still pair up
+	if (thread->depth < CREN_PROFILER_MAX_DEPTH) {
+		thread->openNames[thread->depth] = name;
+		thread->openBegins[thread->depth] = cren_profiler_now();
+	}
+
+	thread->depth++;
+}
+
+CREN_API void cren_profiler_end()
+{
+	CRenProfilerThread* thread = tThread;
+	if (!thread || tGeneration != CREN_ATOMIC_LOAD32_RELAXED(&sGeneration) || thread->depth == 0) return;
+
+	uint32_t depth = --thread->depth;
+	if (depth >= CREN_PROFILER_MAX_DEPTH) return;
+
+	// the head published by the last zone is ordered before overwriting the slot, an exporter that copied any of this zone then sees that head
+	uint64_t head = thread->head;
+	CREN_ATOMIC_FENCE_RELEASE();
+	internal_cren_profiler_store_zone(&thread->ring[head & CREN_PROFILER_RING_MASK], thread->openNames[depth], thread->openBegins[depth], cren_profiler_now(), depth);
+
+	CREN_ATOMIC_STORE_RELEASE(&thread->head, head + 1);
+}
+
+CREN_API void cren_profiler_set_thread_name(const char* name)
+{
+	CRenProfilerThread* thread = internal_cren_profiler_get_thread();
+	if (!thread || !name) return;
+
+	internal_cren_profiler_store_name(thread, name);
+}
+
+CREN_API bool cren_profiler_export_chrome(const char* path)
+{
+	FILE* file = fopen(path, "wb");
+	if (!file) {
+		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to open %s for writing the profiler trace", path);
+		return false;
+	}
+
+	CRenProfilerZone* zones = (CRenProfilerZone*)malloc(sizeof(CRenProfilerZone) * CREN_PROFILER_RING_SIZE);
+	if (!zones) {
+		CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to allocate the profiler export buffer");
+		fclose(file);
+		return false;
+	}
+
+	// timestamps are written in microseconds from when profiling started
+	uint64_t origin = CREN_ATOMIC_LOAD_ACQUIRE(&sEpoch);
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	bool firstEvent = true;
+
+	for (CRenProfilerThread* thread = (CRenProfilerThread*)CREN_ATOMIC_LOAD_PTR(&sThreads); thread; thread = thread->next) {
+		char name[CREN_PROFILER_THREAD_NAME_SIZE];
+		internal_cren_profiler_load_name(thread, name);
+
+		fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", firstEvent ? "" : ",", thread->id);
+		internal_cren_profiler_write_string(file, name);
+		fprintf(file, "}}");
+		firstEvent = false;
+
+		// the zones are copied out first, the ones the thread overwrote meanwhile are dropped by checking it's head again
+		// the fence pairs with the one before overwriting a slot, any overwrite the copy saw is accounted on the head read after it
+		uint64_t head = CREN_ATOMIC_LOAD_ACQUIRE(&thread->head);
+		uint64_t copied = head > CREN_PROFILER_RING_SIZE ? head - CREN_PROFILER_RING_SIZE : 0;
+		for (uint64_t i = copied; i < head; i++) internal_cren_profiler_load_zone(&zones[i - copied], &thread->ring[i & CREN_PROFILER_RING_MASK]);
+		CREN_ATOMIC_FENCE_ACQUIRE();
+
+		// the slot of the zone being recorded right now is gone too
+		uint64_t headAfter = CREN_ATOMIC_LOAD_ACQUIRE(&thread->head) + 1;
+		uint64_t first = headAfter > CREN_PROFILER_RING_SIZE ? headAfter - CREN_PROFILER_RING_SIZE : 0;
+		if (first < copied) first = copied;
+
+		for (uint64_t i = first; i < head; i++) {
+			const CRenProfilerZone* zone = &zones[i - copied];
+			if (!zone->name || zone->begin < origin) continue;
+
+			fprintf(file, ",\n{\"name\":");
+			internal_cren_profiler_write_string(file, zone->name);
+			fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}",
+				thread->id, (double)(zone->begin - origin) / 1000.0, (double)(zone->end - zone->begin) / 1000.0, zone->depth);
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	bool written = ferror(file) == 0;
+	fclose(file);
+	free(zones);
+
+	if (written) CREN_LOG(CREN_LOG_SEVERITY_INFO, "Profiler trace written to %s", path);
+	return written;
+}
+
+CREN_API void cren_profiler_shutdown()
+{
+	// threads registered before the bump record into new zones if they profile again, instead of into the freed ones
+	CRenProfilerThread* thread = (CRenProfilerThread*)CREN_ATOMIC_EXCHANGE_PTR(&sThreads, NULL);
+	CREN_ATOMIC_ADD(&sGeneration, 1);
+
+	while (thread) {
+		CRenProfilerThread* next = thread->next;
+		free(thread);
+		thread = next;
+	}
+
+	tThread = NULL;
+}
+
+#else
+
+CREN_API void cren_profiler_begin(const char* name)
+{
+	(void)name;
+}
+
+CREN_API void cren_profiler_end()
+{
+}
+
+CREN_API void cren_profiler_set_thread_name(const char* name)
+{
+	(void)name;
+}
+
+CREN_API bool cren_profiler_export_chrome(const char* path)
+{
+	(void)path;
+	return false;
+}
+
+CREN_API void cren_profiler_shutdown()
+{
+}
+
+#endif // CREN_PROFILER_DISABLED
@@ -0,0 +1,49 @@
+#ifndef CREN_PROFILER_INCLUDED
+#define CREN_PROFILER_INCLUDED
+
+#include "cren_defines.h"
+
+/// @brief how many finished zones each thread keeps, older ones are overwritten (power of two)
+#define CREN_PROFILER_RING_SIZE 32768
+
+/// @brief how deep zones may nest, deeper ones aren't recorded
+#define CREN_PROFILER_MAX_DEPTH 64
+
+#ifdef __cplusplus 
+extern "C" {
+#endif
+
+/// @brief returns the profiler clock, in nanoseconds
+CREN_API uint64_t cren_profiler_now();
+
+/// @brief opens a zone on the calling thread, name must outlive the profiler (a string literal), use the macros instead
+CREN_API void cren_profiler_begin(const char* name);
+
+/// @brief closes the last zone opened on the calling thread and records it into the thread's ring, use the macros instead
+CREN_API void cren_profiler_end();
+
+/// @brief names the calling thread on the exported trace
+CREN_API void cren_profiler_set_thread_name(const char* name);
+
+/// @brief writes the zones every thread still holds as chrome trace-event json (chrome://tracing, perfetto), returns false if it couldn't be written
+/// threads keep recording while exporting, zones overwritten during the export are left out
+CREN_API bool cren_profiler_export_chrome(const char* path);
+
+/// @brief frees the zones of every thread, call it once the other threads stopped recording (after the last export)
+/// threads profiling afterwards start over with new zones
+CREN_API void cren_profiler_shutdown();
+
+#ifdef __cplusplus 
+}
+#endif
+
+/// @brief macros for profiling zones, removed entirely when CREN_PROFILER_DISABLED is defined (the functions are empty then, nothing is allocated)
+#ifdef CREN_PROFILER_DISABLED
+	#define CREN_PROFILE_BEGIN(name) ((void)0)
+	#define CREN_PROFILE_END() ((void)0)
+#else
+	#define CREN_PROFILE_BEGIN(name) cren_profiler_begin(name)
+	#define CREN_PROFILE_END() cren_profiler_end()
+#endif
+
+#endif // CREN_PROFILER_INCLUDED
\ No newline at end of file
@@ -17,6 +17,12 @@ typedef struct CRenTexture2D CRenTexture2D;
 /// @brief opaque cren quad primitive
 typedef struct CRenQuad CRenQuad;
 
+/// @brief opaque cren id pool
+typedef struct CRenIDPool CRenIDPool;
+
+/// @brief opaque cren fixed-size object pool
+typedef struct CRenPool CRenPool;
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Enumerations
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -61,6 +67,22 @@ typedef enum CRen_LogSeverity
 	CREN_LOG_SEVERITY_FATAL
 } CRen_LogSeverity;
 
+/// @brief what a tracked allocation is used for
+typedef enum CRen_MemoryTag
+{
+	CREN_MEMORY_TAG_GENERAL,
+	CREN_MEMORY_TAG_TEXTURES,
+	CREN_MEMORY_TAG_BUFFERS,
+	CREN_MEMORY_TAG_ENTITIES,
+	CREN_MEMORY_TAG_UI,
+	CREN_MEMORY_TAG_DATAFILE,
+	CREN_MEMORY_TAG_SCENE,
+	CREN_MEMORY_TAG_PRIMITIVES,
+	CREN_MEMORY_TAG_DRIVER,
+
+	CREN_MEMORY_TAG_MAX
+} CRen_MemoryTag;
+
 /// @brief what version of the rendering API is desired
 typedef enum CRen_RendererAPI
 {
@@ -82,6 +104,16 @@ typedef enum CRen_MSAA
 	CREN_MSAA_X64 = 0x00000040
 } CRen_MSAA;
 
+/// @brief how finished frames are handed to the display
+typedef enum CRen_PresentMode
+{
+	CREN_PRESENT_MODE_FIFO = 0,		// waits for the vertical blank, never tears (vsync), always supported
+	CREN_PRESENT_MODE_MAILBOX,		// the newest frame replaces the one waiting for the vertical blank, doesn't tear nor block
+	CREN_PRESENT_MODE_IMMEDIATE,	// presents right away, lowest latency but may tear
+
+	CREN_PRESENT_MODE_MAX
+} CRen_PresentMode;
+
 /// @brief all types of shaders
 typedef enum CRen_ShaderType
 {
@@ -2,6 +2,8 @@
 #include "UI/Dockspace.h"
 #include "UI/Viewport.h"
 
+#include <filesystem>
+
 namespace Cosmos
 {
 	Editor::Editor(const ApplicationCreateInfo& ci)
@@ -12,6 +14,16 @@ namespace Cosmos
 
 		mViewport = new Viewport(this);
 		GetGUIRef()->AddWidget(mViewport);
+
+		// restores the last saved (or autosaved) scene, the viewport saves it with ctrl+s
+		std::string scenePath = GetAssetPath("scenes/untitled.scene");
+		if (std::filesystem::exists(scenePath) || std::filesystem::exists(scenePath + ".autosave")) {
+			GetRendererRef()->GetWorld()->LoadScene(scenePath);
+		}
+
+		else {
+			GetRendererRef()->GetWorld()->SetScenePath(scenePath);
+		}
 	}
 
     void Editor::Shutdown()
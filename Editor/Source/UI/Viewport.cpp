@@ -48,12 +48,18 @@ namespace Cosmos
 		DrawSettings();
 	}
 
-	void Viewport::OnRender(int stage)
+	bool Viewport::CaptureRenderState(Cosmos::WidgetRenderState& state)
+	{
+		state.As<RenderState>().gridVisible = mGrid.visible;
+		return true;
+	}
+
+	void Viewport::OnRender(int stage, const Cosmos::WidgetRenderState& state)
 	{
 		CRenVulkanBackend* renderer = (CRenVulkanBackend*)cren_get_vulkan_backend(mApp->GetRendererRef()->GetCRenContext());
 
 		// draw grid
-		if (mGrid.visible && stage != CREN_RENDER_STAGE_PICKING) {
+		if (state.As<RenderState>().gridVisible && stage != CREN_RENDER_STAGE_PICKING) {
 			unsigned int currentFrame = renderer->swapchain.currentFrame;
 			VkDeviceSize offsets[] = { 0 };
 			VkCommandBuffer cmdbuffer = renderer->viewportRenderphase->renderpass->commandBuffers[currentFrame];
@@ -64,6 +70,11 @@ namespace Cosmos
 		}
 	}
 
+	bool Viewport::NeedsRebuild()
+	{
+		return mApp->GetAverageFPS() != mStatistics.shownFPS || cren_camera_is_moving(mApp->GetRendererRef()->GetMainCamera());
+	}
+
 	void Viewport::OnResize(int width, int height)
 	{
 		// viewport is internally-resized
@@ -85,6 +96,10 @@ namespace Cosmos
 			mApp->GetGUIRef()->ToggleCursor(true);
 			cren_camera_set_lock(camera, true);
 		}
+
+		if (keycode == Cosmos::Input::KEYCODE_S && (mod & Cosmos::Input::KEYMOD_CTRL) && !held) {
+			mApp->GetRendererRef()->GetWorld()->SaveScene(mApp->GetAssetPath("scenes/untitled.scene"));
+		}
 	}
 
 	void Viewport::OnButtonPress(Cosmos::Input::Buttoncode buttoncode, Cosmos::Input::Keymod mod)
@@ -287,6 +302,9 @@ namespace Cosmos
 		{
 			UIWidget::SeparatorText(ICON_LC_BUG " Debug Info");
 			if (UIWidget::Selectable("Entity List", selected == Settings::MenuOption::EntityList)) selected = Settings::MenuOption::EntityList;
+
+			UIWidget::SeparatorText(ICON_LC_MONITOR " Rendering");
+			if (UIWidget::Selectable("Presentation", selected == Settings::MenuOption::Rendering)) selected = Settings::MenuOption::Rendering;
 		}
 		UIWidget::EndChildContext();
 
@@ -297,6 +315,7 @@ namespace Cosmos
 			switch (selected)
 			{
 			case Settings::MenuOption::EntityList: { DrawEntityList(); break; }
+			case Settings::MenuOption::Rendering: { DrawRenderingSettings(); break; }
 			}
 		}
 		UIWidget::EndChildContext();
@@ -336,18 +355,23 @@ namespace Cosmos
 				if (selectedEntity->HasComponent<TransformComponent>()) {
 
 					TransformComponent* component = selectedEntity->GetComponent<TransformComponent>();
+					bool changed = false;
 
 					UIWidget::Text("T: ");
 					UIWidget::SameLine();
-					WidgetExtended::Float3Controller("Translation", &component->translation.xyz.x, &component->translation.xyz.y, &component->translation.xyz.z);
+					changed |= WidgetExtended::Float3Controller("Translation", &component->translation.xyz.x, &component->translation.xyz.y, &component->translation.xyz.z);
 
 					UIWidget::Text("R: ");
 					UIWidget::SameLine();
-					WidgetExtended::Float3Controller("Rotation", &component->rotation.xyz.x, &component->rotation.xyz.y, &component->rotation.xyz.z);
+					changed |= WidgetExtended::Float3Controller("Rotation", &component->rotation.xyz.x, &component->rotation.xyz.y, &component->rotation.xyz.z);
 
 					UIWidget::Text("S: ");
 					UIWidget::SameLine();
-					WidgetExtended::Float3Controller("Scale", &component->scale.xyz.x, &component->scale.xyz.y, &component->scale.xyz.z);
+					changed |= WidgetExtended::Float3Controller("Scale", &component->scale.xyz.x, &component->scale.xyz.y, &component->scale.xyz.z);
+
+					if (changed) {
+						mApp->GetRendererRef()->GetWorld()->MarkDirty(selectedEntity->GetID());
+					}
 				}
 
 				if (selectedEntity->HasComponent<EditorComponent>()) {
@@ -384,6 +408,57 @@ namespace Cosmos
 		}
 	}
 
+	void Viewport::DrawRenderingSettings()
+	{
+		Unique<Renderer>& renderer = mApp->GetRendererRef();
+		FramePacer& pacer = mApp->GetFramePacerRef();
+
+		UIWidget::SeparatorText("Present Mode");
+		{
+			static const char* names[CREN_PRESENT_MODE_MAX] = { "FIFO (vsync)", "Mailbox", "Immediate" };
+			static const char* tooltips[CREN_PRESENT_MODE_MAX] = {
+				"Waits for the vertical blank, no tearing",
+				"Replaces the queued image with the newest one, no tearing and lower latency, falls back to Immediate",
+				"Presents right away, lowest latency but may tear, falls back to Mailbox"
+			};
+
+			CRen_PresentMode requested = cren_get_requested_present_mode(renderer->GetCRenContext());
+			CRen_PresentMode current = renderer->GetPresentMode();
+
+			for (int i = 0; i < CREN_PRESENT_MODE_MAX; i++) {
+				if (UIWidget::Selectable(names[i], requested == (CRen_PresentMode)i)) renderer->SetPresentMode((CRen_PresentMode)i);
+				if (UIWidget::IsItemHovered(UIWidget::HoveredFlags_AllowWhenDisabled)) UIWidget::SetTooltip("%s", tooltips[i]);
+			}
+
+			if (requested != current) UIWidget::Text("Not supported by the device, using %s", names[current]);
+		}
+
+		UIWidget::SeparatorText("Frame Pacing");
+		{
+			if (UIWidget::Selectable("Throughput", pacer.GetMode() == PacingMode::Throughput)) pacer.SetMode(PacingMode::Throughput);
+			if (UIWidget::IsItemHovered(UIWidget::HoveredFlags_AllowWhenDisabled)) UIWidget::SetTooltip("Starts frames evenly spaced at the target rate");
+
+			if (UIWidget::Selectable("Low Latency", pacer.GetMode() == PacingMode::LowLatency)) pacer.SetMode(PacingMode::LowLatency);
+			if (UIWidget::IsItemHovered(UIWidget::HoveredFlags_AllowWhenDisabled)) UIWidget::SetTooltip("Starts frames as late as possible while still making the next present");
+
+			bool idle = mApp->GetIdleMode();
+			if (UIWidget::Checkbox("Idle when nothing changes", &idle)) mApp->SetIdleMode(idle);
+			if (UIWidget::IsItemHovered(UIWidget::HoveredFlags_AllowWhenDisabled)) UIWidget::SetTooltip("Stops rendering and sleeps until there's input, camera movement or a scene change");
+		}
+
+		UIWidget::SeparatorText(ICON_LC_TIMER " Timings");
+		{
+			FramePacer::Timings timings = pacer.GetTimings();
+			UIWidget::Text("Target rate: %.1f fps", pacer.GetTargetRate());
+			UIWidget::Text("Frame interval: %.2f ms", timings.interval * 1000.0);
+			UIWidget::Text("Simulation: %.2f ms", timings.simulation * 1000.0);
+			UIWidget::Text("Render (cpu): %.2f ms", timings.render * 1000.0);
+			UIWidget::Text("Render (gpu): %.2f ms", timings.gpu * 1000.0);
+			if (UIWidget::IsItemHovered(UIWidget::HoveredFlags_AllowWhenDisabled)) UIWidget::SetTooltip("Includes the wait on the swapchain image, 0 when the device lacks timestamps");
+			UIWidget::Text("Predicted latency: %.2f ms", timings.latency * 1000.0);
+		}
+	}
+
 	void Viewport::DrawStatistics()
 	{
 		// let's 'glue' the statis to the right-side
@@ -394,9 +469,10 @@ namespace Cosmos
 		float3 cameraPos = cren_camera_get_position(mApp->GetRendererRef()->GetMainCamera());
 		float3 cameraFront = cren_camera_get_front(mApp->GetRendererRef()->GetMainCamera());
 
-		UIWidget::BeginChildContext("##Statistics", { 230.0f, 125.0f }, UIWidget::ChildFlags_None);
+		UIWidget::BeginChildContext("##Statistics", { 230.0f, 165.0f }, UIWidget::ChildFlags_None);
 		
-		UIWidget::Text(ICON_LC_FLAME		 " [%.2f]", (float)mApp->GetAverageFPS());
+		mStatistics.shownFPS = mApp->GetAverageFPS();
+		UIWidget::Text(ICON_LC_FLAME		 " [%.2f]", (float)mStatistics.shownFPS);
 		if (UIWidget::IsItemHovered(UIWidget::HoveredFlags_AllowWhenDisabled)) UIWidget::SetTooltip("Average frames / second");
 		
 		UIWidget::Text(ICON_LC_MOUSE_POINTER " [%.2f, %.2f]", mousePos.xy.x, mousePos.xy.y);
@@ -413,6 +489,30 @@ namespace Cosmos
 		
 		UIWidget::Text(ICON_LC_PROPORTIONS	 " [%.2f, %.2f]", vpSize.xy.x, vpSize.xy.y);
 		if (UIWidget::IsItemHovered(UIWidget::HoveredFlags_AllowWhenDisabled)) UIWidget::SetTooltip("Viewport size");
+
+		// tracked memory, the tooltip breaks it down per tag
+		uint64_t trackedBytes = 0, frameAllocations = 0;
+		char breakdown[1024];
+		int written = 0;
+		for (int tag = 0; tag < CREN_MEMORY_TAG_MAX; tag++) {
+			CRenMemoryStats stats = MemoryTracker::GetStats((CRen_MemoryTag)tag);
+			trackedBytes += stats.liveBytes;
+			frameAllocations += stats.frameAllocations;
+
+			if (written >= 0 && written < (int)sizeof(breakdown)) {
+				written += snprintf(breakdown + written, sizeof(breakdown) - written, "%-9s %9.2f MB (peak %.2f MB), %llu allocs/frame\n",
+					MemoryTracker::GetTagName((CRen_MemoryTag)tag), stats.liveBytes / (1024.0 * 1024.0), stats.peakBytes / (1024.0 * 1024.0), (unsigned long long)stats.frameAllocations);
+			}
+		}
+
+		UIWidget::Text(ICON_LC_MEMORY_STICK " [%.2f MB, %llu/f]", trackedBytes / (1024.0 * 1024.0), (unsigned long long)frameAllocations);
+		if (UIWidget::IsItemHovered(UIWidget::HoveredFlags_AllowWhenDisabled)) UIWidget::SetTooltip("%s", breakdown);
+
+		SceneAutosave& autosave = mApp->GetRendererRef()->GetWorld()->GetAutosaveRef();
+		if (autosave.IsSaving()) {
+			UIWidget::Text(ICON_LC_SAVE			 " [%.0f%%]", autosave.GetProgress() * 100.0f);
+			if (UIWidget::IsItemHovered(UIWidget::HoveredFlags_AllowWhenDisabled)) UIWidget::SetTooltip("Autosave in progress");
+		}
 		UIWidget::EndChildContext();
 	}
 
@@ -20,8 +20,14 @@ namespace Cosmos
 		/// @brief updates the ui logic
 		virtual void OnUpdate() override;
 
+		/// @brief captures whether the grid is drawn, the render thread draws with it
+		virtual bool CaptureRenderState(Cosmos::WidgetRenderState& state) override;
+
 		/// @brief right-place to draw/render objects related to the viewport
-		virtual void OnRender(int stage) override;
+		virtual void OnRender(int stage, const Cosmos::WidgetRenderState& state) override;
+
+		/// @brief the statistics show the frame rate and the camera, they change without input
+		virtual bool NeedsRebuild() override;
 
 		/// @brief the application was resized, must also resize the viewport
 		virtual void OnResize(int width, int height) override;
@@ -43,6 +49,9 @@ namespace Cosmos
 		/// @brief draws the entity list, usefull for debug and easy access to all entities on the scene
 		void DrawEntityList();
 
+		/// @brief draws the rendering settings, present mode and frame pacing with it's measured timings
+		void DrawRenderingSettings();
+
 		/// @brief draw's a statistics subwindow at top-right of the viewport
 		void DrawStatistics();
 
@@ -69,6 +78,7 @@ namespace Cosmos
 			enum MenuOption // this is menus that exists on the viewport
 			{ 
 				EntityList,
+				Rendering,
 
 				MenuOption_Max
 			}; 
@@ -111,8 +121,15 @@ namespace Cosmos
 		struct Statistics 
 		{
 			bool visible;
+			double shownFPS = 0.0; // the frame rate the ui was built with
 		} mStatistics;
 
+		/// @brief what OnRender draws with, captured with each frame
+		struct RenderState
+		{
+			bool gridVisible = true;
+		};
+
 		std::vector<Cosmos::Entity*> mSelectedEntities;
 	};
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "Core/Editor.h"
 
@@ -19,6 +21,29 @@ int main(int argc, char** argv)
 	#endif
 	ci.renderer = CREN_RENDERER_API_VULKAN_1_1;
 	ci.msaa = CREN_MSAA_X4;
+	ci.threadedRendering = true;
+
+	// automated performance runs: --headless [--frames N] [--warmup N] [--stats path]
+	// repeatable sessions: --record path, --replay path [--unpaced]
+	// profiling: --trace path, chrome trace-event json of the last frames
+	// logging: --log path, the log is also written into the file
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--headless") == 0) ci.headless = true;
+		else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) ci.headlessFrames = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) ci.headlessWarmupFrames = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc) ci.headlessStatisticsPath = argv[++i];
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) ci.recordPath = argv[++i];
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) ci.replayPath = argv[++i];
+		else if (strcmp(argv[i], "--unpaced") == 0) ci.replayUnpaced = true;
+		else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) ci.tracePath = argv[++i];
+		else if (strcmp(argv[i], "--no-idle") == 0) ci.idleMode = false;
+		else if (strcmp(argv[i], "--no-ui-reuse") == 0) ci.reuseUI = false;
+		else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) ci.logPath = argv[++i];
+		else printf("Unknown argument: %s\n", argv[i]);
+	}
+
+	// validation layers skew the timings of a performance run
+	if (ci.headless) ci.validations = false;
 
     Cosmos::Editor editor(ci);
 	editor.Run();
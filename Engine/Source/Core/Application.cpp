@@ -1,4 +1,7 @@
 #include "Application.h"
+#include "Core/StartupGraph.h"
+#include "Util/JobSystem.h"
+#include "Util/Profiler.h"
 
 #include <chrono>
 #include <thread>
@@ -6,86 +9,260 @@
 
 namespace Cosmos
 {
+	/// @brief the world updates at this fixed rate, frames run as many of them as their timestep accumulated
+	static constexpr double FIXED_TIMESTEP = 1.0 / 60.0;
+
 	Application::Application(const ApplicationCreateInfo& ci)
 		: mApplicationCreateInfo(ci), mAssetsPath(ci.assetsPath)
 	{
-        mWindow = CreateUnique<Window>(this, ci.appName, ci.width, ci.height, ci.fullscreen, ci.assetsPath);
-        mRenderer = CreateUnique<Renderer>(this, ci.appName, COSMOS_MAKE_VERSION(0, 1, 0, 0), ci.customViewport, ci.validations, ci.vsync, ci.assetsPath, ci.renderer, ci.msaa);
-        mGUI = CreateUnique<GUI>(this);
+        // started here so the main thread owns the job system and helps with the jobs it waits on
+        JobSystem::Initialize(ci.jobWorkers);
+
+        if (ci.logPath) cren_log_set_file(ci.logPath);
+
+        // a replay runs at the size it was recorded with, the recorded cursor positions only make sense on it
+        int width = ci.width;
+        int height = ci.height;
+
+        if (ci.replayPath && mInputRecorder.StartReplay(ci.replayPath)) {
+            width = mInputRecorder.GetWidth();
+            height = mInputRecorder.GetHeight();
+        }
+
+        // the window, the device and the ui backends are created on the main thread, reading shaders, decoding textures and
+        // rasterizing the fonts need neither so they overlap them on the workers
+        StartupGraph startup;
+        uint32_t shaders = startup.AddStage("Shader Loading", [&ci]() { cren_preload_renderer_assets(ci.assetsPath); });
+        startup.AddStage("Texture Decoding", [this]() { cren_preload_image(GetAssetPath("textures/entity.png").c_str(), 4); });
+        uint32_t fonts = startup.AddStage("UI Context and Fonts", [this]() { mGUI = CreateUnique<GUI>(this); });
+
+        uint32_t window = startup.AddStage("Window", [&]() { mWindow = CreateUnique<Window>(this, ci.appName, width, height, ci.fullscreen, ci.assetsPath, ci.headless); }, {}, true);
+        uint32_t renderer = startup.AddStage("Renderer", [&]() {
+            mRenderer = CreateUnique<Renderer>(this, ci.appName, COSMOS_MAKE_VERSION(0, 1, 0, 0), ci.customViewport, ci.validations, ci.vsync, ci.assetsPath, ci.renderer, ci.msaa);
+            }, { window, shaders }, true);
+        startup.AddStage("UI Backends", [this]() { mGUI->InitializeBackends(); }, { renderer, fonts }, true);
+
+        startup.Run();
+        startup.LogReport();
+
+        // window events first, so the subsystems after it see the frame's input
+        mScheduler.Register("Window Events", TickMode::PerFrame, [this](double) { mWindow->OnUpdate(); });
+        mScheduler.Register("GUI Update", TickMode::PerFrame, [this](double) { mGUI->OnUpdate(); });
+        mScheduler.Register("Camera Update", TickMode::PerFrame, [this](double timestep) { mRenderer->OnCameraUpdate((float)timestep); });
+        mWorldSubsystem = mScheduler.Register("World Update", TickMode::Fixed, [this](double timestep) { mRenderer->OnWorldUpdate((float)timestep); }, 1.0 / FIXED_TIMESTEP);
+
+        mFramePacer.SetMode(ci.pacing);
+        mIdleMode = ci.idleMode;
+        mGUI->SetReuse(ci.reuseUI);
+        RequestRedraw();
+
+        if (ci.recordPath && !mInputRecorder.IsReplaying()) mInputRecorder.StartRecording(ci.recordPath, width, height);
     }
 
 	void Application::Run()
 	{
+        const char* tracePath = mApplicationCreateInfo.tracePath;
+        cren_profiler_set_thread_name("Simulation");
+
+        if (mApplicationCreateInfo.headless) {
+            RunHeadless();
+            if (tracePath) cren_profiler_export_chrome(tracePath);
+            Shutdown();
+            JobSystem::Shutdown();
+            cren_profiler_shutdown();
+            cren_log_flush();
+            return;
+        }
+
         using Clock = std::chrono::steady_clock;
         using TimePoint = std::chrono::time_point<Clock>;
         using Duration = std::chrono::duration<double>;
 
         // time tracking
         TimePoint previousTime = Clock::now();
-        double accumulator = 0.0;
-        const double FIXED_TIMESTEP = 1.0 / 60.0;
-        const int MAX_UPDATES = 10;
 
         // fps tracking
         int frameCount = 0;
         double fpsAccumulator = 0.0;
         mAverageFPS = 0.0;
 
-        // fps limiter
-        double targetFPS = mWindow->GetRefreshRate() * 2.0;
-        FrameLimiter frameLimiter(targetFPS);
+        // frame pacing, an unpaced replay runs frames back to back
+        UpdatePacingRate();
+        bool paced = !(mInputRecorder.IsReplaying() && mApplicationCreateInfo.replayUnpaced);
+
+        // the loop below becomes the simulation, publishing a frame snapshot the render thread picks up
+        if (mApplicationCreateInfo.threadedRendering) mRenderer->StartRenderThread();
 
         while (!mWindow->ShouldClose())
         {
-            TimePoint frameStart = Clock::now();
+            // nothing changed since the last rendered frame, sleeps until an event arrives (or the timeout passes, so timers advance
+            // and a blinking caret is redrawn) instead of spinning, a replay doesn't idle so it runs the same frames it recorded
+            bool idleAllowed = mIdleMode && !mInputRecorder.IsReplaying();
+            if (idleAllowed && !NeedsRedraw()) {
+                COSMOS_PROFILE_SCOPE("Idle");
+                if (!mWindow->WaitEvents(mApplicationCreateInfo.idleTimeout) && mGUI->WantTextInput()) RequestRedraw(1);
+            }
+
+            // sleeps until the frame should start, as late as possible when pacing for latency
+            if (paced) {
+                COSMOS_PROFILE_SCOPE("Frame Pacing");
+                mFramePacer.WaitForNextFrame();
+            }
+
+            COSMOS_PROFILE_SCOPE("Simulation Frame");
+            MemoryTracker::BeginFrame();
 
             // deltatime
             TimePoint currentTime = Clock::now();
-            mTimeStep = std::chrono::duration_cast<Duration>(currentTime - previousTime).count();
+            double elapsed = std::chrono::duration_cast<Duration>(currentTime - previousTime).count();
             previousTime = currentTime;
 
-            if (mTimeStep > 0.05) mTimeStep = 0.05;
+            if (!BeginTimeStep(elapsed > 0.05 ? 0.05 : elapsed)) break;
+            float interpolation = Simulate();
+
+            // publish the frame (rendering it here unless threaded) with interpolation, idle frames only simulate
+            mIdling = idleAllowed && !NeedsRedraw();
+            if (!mIdling) {
+                mRenderer->OnRender(interpolation);
+                frameCount++;
 
-            // update window events
-            mWindow->OnUpdate();
-            mGUI->OnUpdate();
+                // a redraw request is consumed by the frame, the requests made meanwhile from other threads are kept
+                uint32_t frames = mRedrawFrames.load(std::memory_order_acquire);
+                while (frames > 0 && !mRedrawFrames.compare_exchange_weak(frames, frames - 1, std::memory_order_acq_rel));
 
-            // accumulate time for fixed updates
-            accumulator += mTimeStep;
+                World* world = mRenderer->GetWorld();
+                if (world) mDrawnModificationCount = world->GetModificationCount();
+            }
+
+            mFramePacer.EndSimulation();
 
-            // fps tracking
-            frameCount++;
-            fpsAccumulator += mTimeStep;
+            // fps tracking, of rendered frames over wall time
+            fpsAccumulator += elapsed;
             if (fpsAccumulator >= 1.0) {
-                mAverageFPS = static_cast<double>(frameCount);
+                mAverageFPS = static_cast<double>(frameCount) / fpsAccumulator;
                 frameCount = 0;
-                fpsAccumulator -= 1.0;
+                fpsAccumulator = 0.0;
             }
+        }
 
-            // cap accumulator
-            if (accumulator > FIXED_TIMESTEP * MAX_UPDATES) {
-                accumulator = FIXED_TIMESTEP * MAX_UPDATES;
-            }
+        mRenderer->StopRenderThread();
+        mInputRecorder.Stop();
+        if (tracePath) cren_profiler_export_chrome(tracePath);
+        Shutdown();
+        JobSystem::Shutdown();
+        cren_profiler_shutdown();
+        cren_log_flush();
+	}
 
-            // fixed timestep updates
-            int updateCount = 0;
-            while (accumulator >= FIXED_TIMESTEP && updateCount < MAX_UPDATES) {
-                mRenderer->OnUpdate(FIXED_TIMESTEP);
-                accumulator -= FIXED_TIMESTEP;
-                updateCount++;
-            }
+    void Application::RunHeadless()
+    {
+        using Clock = std::chrono::steady_clock;
+        using Duration = std::chrono::duration<double>;
 
-            // render with interpolation
-            mRenderer->OnRender(accumulator / FIXED_TIMESTEP);
+        const ApplicationCreateInfo& ci = mApplicationCreateInfo;
+        CRenContext* context = mRenderer->GetCRenContext();
+        FrameStatistics& statistics = mHeadlessStatistics;
+        statistics = FrameStatistics();
+        statistics.Reserve(ci.headlessFrames);
 
-            // use frame limiter instead of manual sleep
-            if (!mRenderer->GetVSync()) {
-                frameLimiter.Wait();
+        // frames run back to back, simulating the same timestep (or the recorded ones, until the replay is over) no matter how long they took
+        bool replaying = mInputRecorder.IsReplaying();
+        uint32_t totalFrames = ci.headlessWarmupFrames + ci.headlessFrames;
+        Clock::time_point runStart = Clock::now();
+
+        for (uint32_t frame = 0; (replaying || frame < totalFrames) && !mWindow->ShouldClose(); frame++)
+        {
+            COSMOS_PROFILE_SCOPE("Headless Frame");
+            Clock::time_point frameStart = Clock::now();
+            uint64_t frameAllocations = ci.allocationCounter ? ci.allocationCounter() : 0;
+            MemoryTracker::BeginFrame();
+
+            if (!BeginTimeStep(ci.headlessTimestep)) break;
+            float interpolation = Simulate();
+            Clock::time_point simulationEnd = Clock::now();
+
+            // the render thread isn't running, the frame is rendered right away
+            mRenderer->OnRender(interpolation);
+            Clock::time_point frameEnd = Clock::now();
+            if (ci.allocationCounter) frameAllocations = ci.allocationCounter() - frameAllocations;
+
+            if (frame < ci.headlessWarmupFrames) {
+                runStart = frameEnd;
+                continue;
             }
+
+            statistics.Record(FrameStatistics::Frame, Duration(frameEnd - frameStart).count());
+            statistics.Record(FrameStatistics::Simulation, Duration(simulationEnd - frameStart).count());
+            statistics.Record(FrameStatistics::Render, Duration(frameEnd - simulationEnd).count());
+
+            double gpuTime = cren_get_gpu_frame_time(context);
+            if (gpuTime > 0.0) statistics.Record(FrameStatistics::GPU, gpuTime);
+
+            // closes the frame's allocation counters right away, the warmup frames are where the containers grow to the scene
+            // without a process-wide counter only the tracked allocations are seen
+            MemoryTracker::BeginFrame();
+            statistics.RecordAllocations(ci.allocationCounter ? frameAllocations : MemoryTracker::GetFrameAllocations());
         }
 
-        Shutdown();
-	}
+        double elapsed = Duration(Clock::now() - runStart).count();
+        size_t measured = statistics.Summarize(FrameStatistics::Frame).samples;
+        mAverageFPS = elapsed > 0.0 ? (double)measured / elapsed : 0.0;
+
+        CREN_LOG(CREN_LOG_SEVERITY_INFO, "Headless run of %zu frames took %.3fs (%.2f fps)", measured, elapsed, mAverageFPS);
+        statistics.Log();
+
+        if (ci.headlessStatisticsPath) statistics.WriteJson(ci.headlessStatisticsPath, ci.appName, ci.headlessTimestep);
+        mInputRecorder.Stop();
+    }
+
+    bool Application::BeginTimeStep(double timestep)
+    {
+        // a replay simulates the recorded timesteps, the frames are the same ones no matter how long they take now
+        if (mInputRecorder.IsReplaying()) {
+            if (mInputRecorder.ReplayFrame(mTimeStep)) return true;
+
+            CREN_LOG(CREN_LOG_SEVERITY_INFO, "Replay is over after %llu frames", (unsigned long long)mInputRecorder.GetFrameCount());
+            return false;
+        }
+
+        mTimeStep = timestep;
+        mInputRecorder.RecordFrame(mTimeStep);
+        return true;
+    }
+
+    float Application::Simulate()
+    {
+        // each subsystem ticks at it's own rate, what's rendered is interpolated between the last two world updates
+        mScheduler.Tick(mTimeStep);
+        return mScheduler.GetInterpolation(mWorldSubsystem);
+    }
+
+    void Application::UpdatePacingRate()
+    {
+        double refreshRate = (double)mWindow->GetRefreshRate();
+        bool vsync = cren_get_requested_present_mode(mRenderer->GetCRenContext()) == CREN_PRESENT_MODE_FIFO;
+        mFramePacer.SetTargetRate(vsync ? refreshRate : refreshRate * 2.0);
+    }
+
+    void Application::RequestRedraw(uint32_t frames)
+    {
+        uint32_t current = mRedrawFrames.load(std::memory_order_acquire);
+        while (current < frames && !mRedrawFrames.compare_exchange_weak(current, frames, std::memory_order_acq_rel));
+
+        // what changed may be shown on the ui as well
+        if (mGUI) mGUI->RequestRebuild(frames);
+    }
+
+    bool Application::NeedsRedraw()
+    {
+        // a minimized window has nothing to draw into, restoring it sends an event
+        if (mWindow->IsMinimized()) return false;
+        if (mRedrawFrames.load(std::memory_order_acquire) > 0) return true;
+        if (cren_camera_is_moving(mRenderer->GetMainCamera())) return true;
+
+        World* world = mRenderer->GetWorld();
+        return world && world->GetModificationCount() != mDrawnModificationCount;
+    }
 
     void Application::Quit()
     {
@@ -1,11 +1,16 @@
 #pragma once
 
 #include "Core/Defines.h"
+#include "Core/FramePacer.h"
+#include "Core/FrameStatistics.h"
 #include "Core/Input.h"
+#include "Core/InputRecorder.h"
 #include "Core/Renderer.h"
+#include "Core/Scheduler.h"
 #include "Core/Window.h"
 #include "UI/GUI.h"
 #include "Util/Memory.h"
+#include <atomic>
 
 namespace Cosmos
 {
@@ -40,6 +45,63 @@ namespace Cosmos
 
 		/// @brief tells how many samples the MSAA algorithm should use
 		CRen_MSAA msaa = CREN_MSAA_X4;
+
+		/// @brief renders on a thread of it's own, overlapping the next frame's simulation with the current frame's rendering
+		/// widgets OnRender run on the render thread, reading what they've set on OnUpdate one frame later
+		bool threadedRendering = true;
+
+		/// @brief how frames are paced, evenly at the target rate or as late as possible for the lowest input latency
+		PacingMode pacing = PacingMode::Throughput;
+
+		/// @brief runs without a window (and without a display), rendering offscreen a fixed number of frames back to back at a fixed timestep
+		/// frames are rendered on the simulation thread so every one of them is measured, the timings are reported when the run ends
+		bool headless = false;
+
+		/// @brief how many frames a headless run renders
+		uint32_t headlessFrames = 1000;
+
+		/// @brief how many frames a headless run renders before measuring, they go through pipeline/texture creation and first uploads
+		uint32_t headlessWarmupFrames = 10;
+
+		/// @brief the timestep every headless frame simulates, in seconds
+		double headlessTimestep = 1.0 / 60.0;
+
+		/// @brief where a headless run writes it's frame statistics (json), they're only logged when not set
+		const char* headlessStatisticsPath = nullptr;
+
+		/// @brief returns how many times the process has allocated through operator new so far (a replaced global operator new)
+		/// a headless run then reports every allocation it's measured frames made, job and std::function ones included, instead of only the tracked ones
+		uint64_t(*allocationCounter)() = nullptr;
+
+		/// @brief records the window events and every frame's timestep into this file, so the session can be replayed as a repeatable workload
+		const char* recordPath = nullptr;
+
+		/// @brief replays a recorded session instead of the live input and clock, the application quits when it's over
+		/// the window is created with the recorded size, and a headless run renders the recorded frames instead of headlessFrames
+		const char* replayPath = nullptr;
+
+		/// @brief replays as fast as frames can be rendered instead of pacing them, the simulated timesteps are still the recorded ones
+		bool replayUnpaced = false;
+
+		/// @brief where the profiler zones still held by every thread are written (chrome trace-event json) when the application ends
+		const char* tracePath = nullptr;
+
+		/// @brief stops rendering while nothing changes (no input, no camera movement, no world modification, no redraw requested)
+		/// the loop then sleeps on the window events instead of spinning, it can be changed later with SetIdleMode
+		bool idleMode = true;
+
+		/// @brief the longest an idle application sleeps before running a frame anyway, simulation time only advances on the frames that run
+		double idleTimeout = 0.5;
+
+		/// @brief draws the last ui frame again while there's no input and no widget asks for a rebuild, instead of rebuilding it every frame
+		/// it can be changed later on the gui with SetReuse
+		bool reuseUI = true;
+
+		/// @brief how many job system workers run besides the main thread, 0 for one less than the hardware threads
+		uint32_t jobWorkers = 0;
+
+		/// @brief also writes the log into this file, messages are written by cren's logging thread so logging doesn't stall the frame
+		const char* logPath = nullptr;
 	};
 
 	class COSMOS_API Application
@@ -67,6 +129,37 @@ namespace Cosmos
 		/// @brief returns the average frames per second
 		inline double GetAverageFPS() { return mAverageFPS; }
 
+		/// @brief returns the timestep of the current frame, in seconds
+		inline double GetTimeStep() { return mTimeStep; }
+
+		/// @brief returns the statistics of the last headless run
+		inline const FrameStatistics& GetHeadlessStatisticsRef() const { return mHeadlessStatistics; }
+
+		/// @brief returns a reference to the frame pacer
+		inline FramePacer& GetFramePacerRef() { return mFramePacer; }
+
+		/// @brief returns a reference to the input recorder, recording or replaying the session when requested on creation
+		inline InputRecorder& GetInputRecorderRef() { return mInputRecorder; }
+
+		/// @brief returns a reference to the scheduler, subsystems registered to it are ticked every frame at their own rate
+		inline Scheduler& GetSchedulerRef() { return mScheduler; }
+
+		/// @brief paces frames at the display refresh rate when presenting with vsync, twice of it otherwise
+		void UpdatePacingRate();
+
+		/// @brief returns if rendering stops while nothing changes
+		inline bool GetIdleMode() const { return mIdleMode; }
+
+		/// @brief sets if rendering stops while nothing changes
+		inline void SetIdleMode(bool idle) { mIdleMode = idle; RequestRedraw(); }
+
+		/// @brief returns if the last frame wasn't rendered because nothing changed
+		inline bool IsIdling() const { return mIdling; }
+
+		/// @brief asks for the next frames to be rendered even if idling, for changes that don't come from input (loaded assets, finished jobs, etc)
+		/// may be called from any thread, a few frames are the default since the ui takes a couple of them to settle
+		void RequestRedraw(uint32_t frames = 3);
+
 	public:
 
 		/// @brief called for initializing main loop
@@ -117,6 +210,20 @@ namespace Cosmos
 		/// @brief utility to retrieve correct asset's location
 		std::string GetAssetPath(const char* subPath, bool removeExtension = false);
 
+	private:
+
+		/// @brief main loop of a headless application, renders the requested frames and reports their timings
+		void RunHeadless();
+
+		/// @brief starts the frame's timestep, taking it from the replay if there's one (false when it's over) or recording it
+		bool BeginTimeStep(double timestep);
+
+		/// @brief ticks the subsystems due this frame (window events included), returns the world interpolation to render with
+		float Simulate();
+
+		/// @brief returns if something changed since the last rendered frame
+		bool NeedsRedraw();
+
 	private:
 
 		ApplicationCreateInfo mApplicationCreateInfo;
@@ -124,37 +231,19 @@ namespace Cosmos
 		Unique<Window> mWindow;
 		Unique<Renderer> mRenderer;
 		Unique<GUI> mGUI;
+		FramePacer mFramePacer;
+		FrameStatistics mHeadlessStatistics;
+		InputRecorder mInputRecorder;
+		Scheduler mScheduler;
+		uint32_t mWorldSubsystem = 0;
 
 		double mTimeStep = 0.0;
-		double mAverageFPS = 0;
-	};
-
-	class COSMOS_API FrameLimiter
-	{
-	public:
-
-		/// @brief constructor
-		FrameLimiter(double targetFPS)
-		{
-			mTargetDuration = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / targetFPS));
-			mFrameStart = std::chrono::steady_clock::now();
-		}
 
-		/// @brief stales the cpu if necessary
-		inline void Wait()
-		{
-			mFrameStart += mTargetDuration;
-
-			// hybrid approach: sleep + busy-wait for precision
-			auto now = std::chrono::steady_clock::now();
-			auto remaining = mFrameStart - now;
-
-			if (remaining > std::chrono::microseconds(2000)) std::this_thread::sleep_for(remaining - std::chrono::microseconds(1500));
-			while (std::chrono::steady_clock::now() < mFrameStart) std::this_thread::yield();
-		}
-
-	private:
-		std::chrono::steady_clock::time_point mFrameStart;
-		std::chrono::nanoseconds mTargetDuration;
+		// idle mode
+		bool mIdleMode = true;
+		bool mIdling = false;
+		std::atomic<uint32_t> mRedrawFrames = 0;
+		uint64_t mDrawnModificationCount = 0;
+		double mAverageFPS = 0;
 	};
 }
\ No newline at end of file
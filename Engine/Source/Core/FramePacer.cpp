@@ -0,0 +1,152 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace Cosmos
+{
+	/// @brief weight of a new sample on the smoothed timings
+	static constexpr double FRAME_PACER_SMOOTHING = 0.1;
+
+	/// @brief slack kept between the predicted end of a frame and it's present, absorbs the jitter of the prediction
+	static constexpr double FRAME_PACER_SAFETY_MARGIN = 0.001;
+
+	/// @brief the most a wait is started early to make up for oversleeping, past it the wait is just late
+	static constexpr double FRAME_PACER_MAX_OVERSLEEP = 0.002;
+
+	static inline double Internal_Smooth(double current, double sample)
+	{
+		return current == 0.0 ? sample : current + (sample - current) * FRAME_PACER_SMOOTHING;
+	}
+
+	static inline FramePacer::Clock::duration Internal_ToDuration(double seconds)
+	{
+		return std::chrono::duration_cast<FramePacer::Clock::duration>(std::chrono::duration<double>(seconds));
+	}
+
+	FramePacer::FramePacer(double targetRate, PacingMode mode)
+		: mMode(mode)
+	{
+		SetTargetRate(targetRate);
+
+		#if defined(_WIN32)
+		// the default timer resolution makes sleeps overshoot by up to 15ms
+		mTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		#endif
+	}
+
+	FramePacer::~FramePacer()
+	{
+		#if defined(_WIN32)
+		if (mTimer) CloseHandle((HANDLE)mTimer);
+		#endif
+	}
+
+	void FramePacer::SetTargetRate(double framesPerSecond)
+	{
+		if (framesPerSecond <= 0.0) return;
+		mPeriod = 1.0 / framesPerSecond;
+	}
+
+	FramePacer::Timings FramePacer::GetTimings() const
+	{
+		Timings timings;
+		timings.simulation = mSimulationTime;
+		timings.render = mRenderTime.load(std::memory_order_relaxed);
+		timings.gpu = mGPUTime.load(std::memory_order_relaxed);
+		timings.interval = mInterval;
+		timings.latency = timings.simulation + timings.render + timings.gpu;
+		return timings;
+	}
+
+	FramePacer::Clock::time_point FramePacer::WaitForNextFrame()
+	{
+		Clock::time_point now = Clock::now();
+
+		if (!mStarted) {
+			mStarted = true;
+			mFrameSchedule = now;
+			mFrameStart = now;
+			return now;
+		}
+
+		Clock::duration period = Internal_ToDuration(mPeriod);
+		Clock::time_point target = mFrameSchedule + period;
+
+		if (mMode == PacingMode::LowLatency) {
+
+			// the frame started now is presented on the first present slot after it's work is done, the render side finishes
+			// it's frames on the display's cadence so the slots are predicted from the last one it reported
+			Clock::duration work = Internal_ToDuration(GetTimings().latency + FRAME_PACER_SAFETY_MARGIN);
+			int64_t lastRenderEnd = mLastRenderEnd.load(std::memory_order_acquire);
+
+			if (lastRenderEnd != 0) {
+				Clock::time_point present = Clock::time_point(Clock::duration(lastRenderEnd)) + period;
+				while (present < now + work) present += period;
+
+				// the phase may move to line up with the display, but frames never start faster than twice the rate
+				target = std::max(present - work, mFrameSchedule + period / 2);
+			}
+		}
+
+		if (target > now) {
+			SleepUntil(target);
+			now = Clock::now();
+		}
+
+		// the schedule advances by whole periods so sleeps don't accumulate drift, but a frame that ran over by more than
+		// a period re-anchors it instead of bursting to catch up
+		mFrameSchedule = (now - target > period) ? now : target;
+		mInterval = Internal_Smooth(mInterval, std::chrono::duration<double>(now - mFrameStart).count());
+		mFrameStart = now;
+		return now;
+	}
+
+	void FramePacer::EndSimulation()
+	{
+		mSimulationTime = Internal_Smooth(mSimulationTime, std::chrono::duration<double>(Clock::now() - mFrameStart).count());
+	}
+
+	void FramePacer::ReportRender(Clock::time_point end, double cpuSeconds, double gpuSeconds)
+	{
+		// a single thread reports, the loads and stores don't need to be a single atomic update
+		mRenderTime.store(Internal_Smooth(mRenderTime.load(std::memory_order_relaxed), cpuSeconds), std::memory_order_relaxed);
+		if (gpuSeconds > 0.0) mGPUTime.store(Internal_Smooth(mGPUTime.load(std::memory_order_relaxed), gpuSeconds), std::memory_order_relaxed);
+		mLastRenderEnd.store(end.time_since_epoch().count(), std::memory_order_release);
+	}
+
+	void FramePacer::SleepUntil(Clock::time_point deadline)
+	{
+		Clock::time_point wakeUp = deadline - Internal_ToDuration(mOversleep);
+		Clock::time_point now = Clock::now();
+		if (wakeUp <= now) return;
+
+		#if defined(_WIN32)
+		if (mTimer) {
+			// relative due time in 100ns units
+			LARGE_INTEGER dueTime;
+			dueTime.QuadPart = -(LONGLONG)(std::chrono::duration_cast<std::chrono::nanoseconds>(wakeUp - now).count() / 100);
+			if (SetWaitableTimerEx((HANDLE)mTimer, &dueTime, 0, nullptr, nullptr, nullptr, 0)) {
+				WaitForSingleObject((HANDLE)mTimer, INFINITE);
+			}
+			else {
+				std::this_thread::sleep_until(wakeUp);
+			}
+		}
+		else {
+			std::this_thread::sleep_until(wakeUp);
+		}
+		#else
+		std::this_thread::sleep_until(wakeUp);
+		#endif
+
+		// learn how late the waits wake up, so the next one is started that much earlier
+		double late = std::chrono::duration<double>(Clock::now() - wakeUp).count();
+		mOversleep = std::clamp(Internal_Smooth(mOversleep, late), 0.0, FRAME_PACER_MAX_OVERSLEEP);
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include <atomic>
+#include <chrono>
+
+namespace Cosmos
+{
+	/// @brief how the frame pacer schedules the start of a frame
+	enum class PacingMode
+	{
+		Throughput,	// frames start evenly spaced at the target rate
+		LowLatency	// frames start as late as they can while still making the next present, so input is sampled closer to the display
+	};
+
+	/// @brief schedules the simulation frames from the measured cpu/gpu frame times, waiting with timed waits instead of spinning
+	/// ReportRender may be called from the render thread, everything else is meant for the simulation thread
+	class COSMOS_API FramePacer
+	{
+	public:
+
+		using Clock = std::chrono::steady_clock;
+
+		/// @brief smoothed frame timings, in seconds
+		struct Timings
+		{
+			double simulation = 0.0;	// cpu time of a simulation frame
+			double render = 0.0;		// cpu time recording and submitting a frame
+			double gpu = 0.0;			// gpu time of a frame
+			double interval = 0.0;		// time between the start of two frames
+			double latency = 0.0;		// predicted time from the start of a frame to it's present
+		};
+
+	public:
+
+		/// @brief constructor
+		FramePacer(double targetRate = 60.0, PacingMode mode = PacingMode::Throughput);
+
+		/// @brief destructor
+		~FramePacer();
+
+		/// @brief the wait timer is owned by the pacer, it's not copyable
+		FramePacer(const FramePacer&) = delete;
+		FramePacer& operator=(const FramePacer&) = delete;
+
+		/// @brief returns the pacing mode
+		inline PacingMode GetMode() const { return mMode; }
+
+		/// @brief sets the pacing mode, it's applied on the next frame
+		inline void SetMode(PacingMode mode) { mMode = mode; }
+
+		/// @brief returns how many frames per second are paced
+		inline double GetTargetRate() const { return 1.0 / mPeriod; }
+
+		/// @brief sets how many frames per second are paced, the display refresh rate when presenting with vsync
+		void SetTargetRate(double framesPerSecond);
+
+		/// @brief returns the smoothed timings
+		Timings GetTimings() const;
+
+	public:
+
+		/// @brief waits until the next frame should start, returning the time it started
+		Clock::time_point WaitForNextFrame();
+
+		/// @brief marks the end of the simulation part of the frame started by the last WaitForNextFrame
+		void EndSimulation();
+
+		/// @brief reports a frame went through the renderer, ending at end and taking cpuSeconds, gpuSeconds is the gpu time of the last completed frame
+		void ReportRender(Clock::time_point end, double cpuSeconds, double gpuSeconds);
+
+	private:
+
+		/// @brief sleeps until deadline, waking a bit earlier by how much the waits have been observed to oversleep
+		void SleepUntil(Clock::time_point deadline);
+
+	private:
+
+		PacingMode mMode = PacingMode::Throughput;
+		double mPeriod = 1.0 / 60.0;
+		Clock::time_point mFrameSchedule = {};	// when the current frame was scheduled to start
+		Clock::time_point mFrameStart = {};		// when the current frame actually started
+		bool mStarted = false;
+		double mOversleep = 0.0;
+		void* mTimer = nullptr; // high resolution waitable timer, windows only
+
+		// smoothed timings, the render ones are written by the render thread
+		double mSimulationTime = 0.0;
+		double mInterval = 0.0;
+		std::atomic<double> mRenderTime = 0.0;
+		std::atomic<double> mGPUTime = 0.0;
+		std::atomic<int64_t> mLastRenderEnd = 0; // nanoseconds since the clock's epoch, 0 until the first report
+	};
+}
@@ -0,0 +1,106 @@
+#include "FrameStatistics.h"
+
+#include <algorithm>
+#include <cren_error.h>
+#include <cstdio>
+
+namespace Cosmos
+{
+	/// @brief nearest-rank percentile of sorted samples
+	static double Internal_Percentile(const std::vector<double>& sorted, double percentile)
+	{
+		size_t rank = (size_t)(percentile / 100.0 * (double)sorted.size() + 0.5);
+		rank = std::clamp(rank, (size_t)1, sorted.size());
+		return sorted[rank - 1];
+	}
+
+	void FrameStatistics::Reserve(size_t frames)
+	{
+		for (std::vector<double>& samples : mSamples) samples.reserve(frames);
+	}
+
+	void FrameStatistics::RecordAllocations(uint64_t allocations)
+	{
+		mAllocationFrames++;
+		mAllocations += allocations;
+		mMaxFrameAllocations = std::max(mMaxFrameAllocations, allocations);
+		if (allocations > 0) mAllocatingFrames++;
+	}
+
+	FrameStatistics::Summary FrameStatistics::Summarize(Series series) const
+	{
+		Summary summary;
+		if (series >= Series_Max || mSamples[series].empty()) return summary;
+
+		std::vector<double> sorted = mSamples[series];
+		std::sort(sorted.begin(), sorted.end());
+
+		double total = 0.0;
+		for (double sample : sorted) total += sample;
+
+		summary.samples = sorted.size();
+		summary.min = sorted.front();
+		summary.max = sorted.back();
+		summary.mean = total / (double)sorted.size();
+		summary.p50 = Internal_Percentile(sorted, 50.0);
+		summary.p95 = Internal_Percentile(sorted, 95.0);
+		summary.p99 = Internal_Percentile(sorted, 99.0);
+		return summary;
+	}
+
+	const char* FrameStatistics::GetSeriesName(Series series)
+	{
+		switch (series)
+		{
+			case Frame: return "frame";
+			case Simulation: return "simulation";
+			case Render: return "render";
+			case GPU: return "gpu";
+			default: return "unknown";
+		}
+	}
+
+	void FrameStatistics::Log() const
+	{
+		for (int i = 0; i < Series_Max; i++) {
+			Summary summary = Summarize((Series)i);
+			if (summary.samples == 0) continue;
+
+			CREN_LOG(CREN_LOG_SEVERITY_INFO, "%-10s [%zu frames] min %.3fms, mean %.3fms, p50 %.3fms, p95 %.3fms, p99 %.3fms, max %.3fms",
+				GetSeriesName((Series)i), summary.samples, summary.min * 1000.0, summary.mean * 1000.0, summary.p50 * 1000.0, summary.p95 * 1000.0, summary.p99 * 1000.0, summary.max * 1000.0);
+		}
+
+		if (mAllocationFrames == 0) return;
+
+		CREN_LOG(mAllocatingFrames > 0 ? CREN_LOG_SEVERITY_WARN : CREN_LOG_SEVERITY_INFO, "%-10s [%zu frames] %zu frames allocated, %llu allocations, max %llu in a frame",
+			"heap", mAllocationFrames, mAllocatingFrames, (unsigned long long)mAllocations, (unsigned long long)mMaxFrameAllocations);
+	}
+
+	bool FrameStatistics::WriteJson(const char* path, const char* appName, double timestep) const
+	{
+		FILE* file = std::fopen(path, "wb");
+		if (!file) {
+			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to open %s for writing the frame statistics", path);
+			return false;
+		}
+
+		// times are written in milliseconds, it's what the regression dashboards plot
+		std::fprintf(file, "{\n  \"application\": \"%s\",\n  \"timestep_ms\": %.6f,\n  \"series\": {", appName ? appName : "", timestep * 1000.0);
+
+		bool first = true;
+		for (int i = 0; i < Series_Max; i++) {
+			Summary summary = Summarize((Series)i);
+			if (summary.samples == 0) continue;
+
+			std::fprintf(file, "%s\n    \"%s\": { \"samples\": %zu, \"min\": %.6f, \"mean\": %.6f, \"p50\": %.6f, \"p95\": %.6f, \"p99\": %.6f, \"max\": %.6f }",
+				first ? "" : ",", GetSeriesName((Series)i), summary.samples, summary.min * 1000.0, summary.mean * 1000.0, summary.p50 * 1000.0, summary.p95 * 1000.0, summary.p99 * 1000.0, summary.max * 1000.0);
+			first = false;
+		}
+
+		std::fprintf(file, "\n  },\n  \"allocations\": { \"frames\": %zu, \"allocating_frames\": %zu, \"total\": %llu, \"max\": %llu }\n}\n",
+			mAllocationFrames, mAllocatingFrames, (unsigned long long)mAllocations, (unsigned long long)mMaxFrameAllocations);
+		bool written = std::ferror(file) == 0;
+		std::fclose(file);
+		return written;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include <cstddef>
+#include <vector>
+
+namespace Cosmos
+{
+	/// @brief keeps every frame's timings of a run and summarizes them, used by headless runs to report frame-time regressions
+	class COSMOS_API FrameStatistics
+	{
+	public:
+
+		/// @brief what's measured on a frame
+		enum Series
+		{
+			Frame = 0,	// the whole frame, cpu wall time
+			Simulation,	// events, ui build and updates
+			Render,		// snapshot publishing, recording and submission
+			GPU,		// gpu time of the frame read back, only when the device supports timestamps
+
+			Series_Max
+		};
+
+		/// @brief summary of a series, in seconds
+		struct Summary
+		{
+			size_t samples = 0;
+			double min = 0.0;
+			double mean = 0.0;
+			double p50 = 0.0;
+			double p95 = 0.0;
+			double p99 = 0.0;
+			double max = 0.0;
+		};
+
+	public:
+
+		/// @brief reserves room for frames samples on every series, so recording doesn't allocate during the run
+		void Reserve(size_t frames);
+
+		/// @brief records a sample of a series
+		inline void Record(Series series, double seconds) { mSamples[series].push_back(seconds); }
+
+		/// @brief records how many heap allocations a measured frame made, a steady-state frame should make none
+		void RecordAllocations(uint64_t allocations);
+
+		/// @brief returns how many measured frames made heap allocations
+		inline size_t GetAllocatingFrames() const { return mAllocatingFrames; }
+
+		/// @brief returns how many heap allocations the measured frames made
+		inline uint64_t GetAllocations() const { return mAllocations; }
+
+		/// @brief returns the summary of a series
+		Summary Summarize(Series series) const;
+
+		/// @brief returns the display name of a series
+		static const char* GetSeriesName(Series series);
+
+	public:
+
+		/// @brief logs the summary of every series with samples
+		void Log() const;
+
+		/// @brief writes the summary of every series as json, returns false if the file couldn't be written
+		bool WriteJson(const char* path, const char* appName, double timestep) const;
+
+	private:
+
+		std::vector<double> mSamples[Series_Max];
+		size_t mAllocationFrames = 0;
+		size_t mAllocatingFrames = 0;
+		uint64_t mAllocations = 0;
+		uint64_t mMaxFrameAllocations = 0;
+	};
+}
@@ -0,0 +1,217 @@
+#include "Core/IDAuthority.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cren.h>
+#include <mutex>
+#include <vector>
+
+namespace Cosmos
+{
+	// forward declarations
+	struct IDAuthorityCache;
+
+	/// @brief state shared between the authority and the thread caches, which may outlive it
+	/// locks are taken in order: cachesMutex, then a cache's mutex, then mutex
+	struct IDAuthorityShared
+	{
+		std::mutex mutex;
+		CRenContext* context = nullptr;
+		std::mutex cachesMutex;
+		std::vector<IDAuthorityCache*> caches; // of every thread holding ids of the authority
+
+		// ids handed out and not destroyed yet, one bit per id, pages are allocated uppon first use and kept until destruction
+		static constexpr uint32_t LIVE_PAGE_BITS = 16;
+		static constexpr uint32_t LIVE_PAGE_WORDS = (1u << LIVE_PAGE_BITS) / 64;
+		std::unique_ptr<std::atomic<std::atomic<uint64_t>*>[]> livePages = std::make_unique<std::atomic<std::atomic<uint64_t>*>[]>(1ull << (32 - LIVE_PAGE_BITS));
+
+		~IDAuthorityShared()
+		{
+			for (uint64_t i = 0; i < (1ull << (32 - LIVE_PAGE_BITS)); i++) {
+				delete[] livePages[i].load(std::memory_order_relaxed);
+			}
+		}
+
+		/// @brief returns the word holding the id's live bit, allocating it's page if needed
+		std::atomic<uint64_t>& LiveWord(uint32_t id)
+		{
+			std::atomic<std::atomic<uint64_t>*>& slot = livePages[id >> LIVE_PAGE_BITS];
+			std::atomic<uint64_t>* page = slot.load(std::memory_order_acquire);
+
+			if (!page) {
+				std::atomic<uint64_t>* created = new std::atomic<uint64_t>[LIVE_PAGE_WORDS]();
+				if (slot.compare_exchange_strong(page, created, std::memory_order_acq_rel, std::memory_order_acquire)) page = created;
+				else delete[] created;
+			}
+
+			return page[(id & ((1u << LIVE_PAGE_BITS) - 1)) >> 6];
+		}
+
+		/// @brief marks the id as live, returns false if it already was
+		bool SetLive(uint32_t id)
+		{
+			uint64_t bit = 1ull << (id & 63);
+			return (LiveWord(id).fetch_or(bit, std::memory_order_acq_rel) & bit) == 0;
+		}
+
+		/// @brief marks the id as not live, returns false if it wasn't live
+		bool ClearLive(uint32_t id)
+		{
+			uint64_t bit = 1ull << (id & 63);
+			return (LiveWord(id).fetch_and(~bit, std::memory_order_acq_rel) & bit) != 0;
+		}
+	};
+
+	/// @brief the ids a thread has reserved from an authority
+	/// the owning thread takes it's mutex on every operation, it's only contended by flushes and registrations from other threads
+	struct IDAuthorityCache
+	{
+		std::shared_ptr<IDAuthorityShared> owner;
+		std::mutex mutex;
+		uint32_t ids[IDAuthority::BLOCK_SIZE * 2] = {};
+		uint32_t count = 0;
+
+		~IDAuthorityCache()
+		{
+			Detach();
+		}
+
+		/// @brief returns every id and leaves the owner's caches
+		void Detach()
+		{
+			if (!owner) return;
+
+			std::lock_guard<std::mutex> cachesLock(owner->cachesMutex);
+			owner->caches.erase(std::remove(owner->caches.begin(), owner->caches.end(), this), owner->caches.end());
+
+			std::lock_guard<std::mutex> lock(mutex);
+			Return(count);
+		}
+
+		/// @brief joins the caches of an authority
+		void Attach(const std::shared_ptr<IDAuthorityShared>& shared)
+		{
+			owner = shared;
+
+			std::lock_guard<std::mutex> cachesLock(owner->cachesMutex);
+			owner->caches.push_back(this);
+		}
+
+		/// @brief reserves a block of ids from the owner's pool, expects the cache's mutex to be held
+		void Refill()
+		{
+			std::lock_guard<std::mutex> lock(owner->mutex);
+			if (!owner->context) return;
+
+			uint32_t reserved = cren_reserve_ids(owner->context, ids + count, IDAuthority::BLOCK_SIZE);
+
+			// the pool gives the most compact ids first, ids are popped from the back
+			std::reverse(ids + count, ids + count + reserved);
+			count += reserved;
+		}
+
+		/// @brief returns the last amount ids back to the owner's pool, expects the cache's mutex to be held
+		void Return(uint32_t amount)
+		{
+			if (!owner || amount == 0) return;
+
+			std::lock_guard<std::mutex> lock(owner->mutex);
+			if (owner->context) cren_release_ids(owner->context, ids + count - amount, amount);
+			count -= amount;
+		}
+
+		/// @brief removes id from the cache, returns false if it's not cached, expects the cache's mutex to be held
+		bool Take(uint32_t id)
+		{
+			uint32_t* end = ids + count;
+			uint32_t* found = std::find(ids, end, id);
+			if (found == end) return false;
+
+			std::copy(found + 1, end, found);
+			count--;
+			return true;
+		}
+	};
+
+	static thread_local IDAuthorityCache sCache;
+
+	/// @brief returns the calling thread's cache of the authority, ids cached from another authority are returned first
+	static IDAuthorityCache& Internal_GetCache(const std::shared_ptr<IDAuthorityShared>& shared)
+	{
+		if (sCache.owner != shared) {
+			sCache.Detach();
+			sCache.Attach(shared);
+		}
+
+		return sCache;
+	}
+
+	IDAuthority::IDAuthority(CRenContext* context)
+		: mShared(std::make_shared<IDAuthorityShared>())
+	{
+		mShared->context = context;
+	}
+
+	IDAuthority::~IDAuthority()
+	{
+		Flush();
+
+		std::lock_guard<std::mutex> lock(mShared->mutex);
+		mShared->context = nullptr;
+	}
+
+	uint32_t IDAuthority::Create()
+	{
+		IDAuthorityCache& cache = Internal_GetCache(mShared);
+		std::lock_guard<std::mutex> cacheLock(cache.mutex);
+		if (cache.count == 0) cache.Refill();
+		if (cache.count == 0) return 0;
+
+		uint32_t id = cache.ids[--cache.count];
+		mShared->SetLive(id);
+		return id;
+	}
+
+	bool IDAuthority::Register(uint32_t id)
+	{
+		if (id == 0) return false;
+
+		// the id may be sitting on any thread's cache, reserved but not handed out
+		std::lock_guard<std::mutex> cachesLock(mShared->cachesMutex);
+		for (IDAuthorityCache* cache : mShared->caches) {
+			std::lock_guard<std::mutex> cacheLock(cache->mutex);
+			if (cache->Take(id)) return mShared->SetLive(id);
+		}
+
+		std::lock_guard<std::mutex> lock(mShared->mutex);
+		return mShared->context && cren_register_id(mShared->context, id) && mShared->SetLive(id);
+	}
+
+	void IDAuthority::Destroy(uint32_t id)
+	{
+		if (id == 0) return;
+
+		// an id that's not live (destroyed twice, from another authority, never registered) would be handed out twice
+		if (!mShared->ClearLive(id)) {
+			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Destroying id %u which is not in use", id);
+			assert(false && "Destroying an id which is not in use");
+			return;
+		}
+
+		IDAuthorityCache& cache = Internal_GetCache(mShared);
+		std::lock_guard<std::mutex> cacheLock(cache.mutex);
+		if (cache.count == IDAuthority::BLOCK_SIZE * 2) cache.Return(IDAuthority::BLOCK_SIZE);
+
+		cache.ids[cache.count++] = id;
+	}
+
+	void IDAuthority::Flush()
+	{
+		std::lock_guard<std::mutex> cachesLock(mShared->cachesMutex);
+		for (IDAuthorityCache* cache : mShared->caches) {
+			std::lock_guard<std::mutex> cacheLock(cache->mutex);
+			cache->Return(cache->count);
+		}
+	}
+}
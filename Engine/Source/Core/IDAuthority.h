@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include <memory>
+
+// forward declarations
+typedef struct CRenContext CRenContext;
+namespace Cosmos { struct IDAuthorityShared; }
+
+namespace Cosmos
+{
+	/// @brief the single source of object ids, shared by the worlds and cren's picking pipeline
+	/// every thread keeps a small block of ids reserved from cren in bulk, so creating/destroying entities from many threads
+	/// rarely touches the shared pool, and released ids are handed out again before new ones, keeping picking buffers small
+	class COSMOS_API IDAuthority
+	{
+	public:
+
+		/// @brief how many ids a thread reserves/returns from the shared pool at once
+		static constexpr uint32_t BLOCK_SIZE = 64;
+
+	public:
+
+		/// @brief constructor, the context must outlive the authority
+		IDAuthority(CRenContext* context);
+
+		/// @brief destructor, returns the ids cached by every thread
+		~IDAuthority();
+
+		/// @brief returns a new unique id, 0 if the id space is exhausted
+		uint32_t Create();
+
+		/// @brief reserves a specific id (loaded from a scene), returns false if it's already in use, ids cached by any thread are taken back
+		bool Register(uint32_t id);
+
+		/// @brief releases the id so it may be handed out again, ids not in use are rejected
+		void Destroy(uint32_t id);
+
+		/// @brief returns every id cached by any thread back into the shared pool
+		void Flush();
+
+	private:
+
+		std::shared_ptr<IDAuthorityShared> mShared;
+	};
+}
@@ -0,0 +1,256 @@
+#include "InputRecorder.h"
+#include "Util/Compression.h"
+#include "Util/Reflection.h"
+
+#include <cren_error.h>
+#include <cstring>
+#include <SDL3/SDL.h>
+
+namespace Cosmos
+{
+	static constexpr uint32_t RECORDING_MAGIC = 0x52495343; // "CSIR"
+	static constexpr uint16_t RECORDING_VERSION = 1;
+
+	/// @brief records are buffered and compressed this many bytes at a time, a crash loses at most the last chunk
+	static constexpr size_t RECORDING_CHUNK_SIZE = 64 * 1024;
+
+	/// @brief what a record holds
+	enum RecordKind : uint8_t
+	{
+		RECORD_FRAME = 0,	// timestep of the frame the following events belong to
+		RECORD_EVENT		// event type, payload size and the event struct, text input has it's text after it
+	};
+
+	/// @brief the file starts with this, the event layouts are the ones of the sdl it was recorded with so it's version is checked on replay
+	struct RecordingHeader
+	{
+		uint32_t magic = RECORDING_MAGIC;
+		uint16_t version = RECORDING_VERSION;
+		uint16_t eventSize = (uint16_t)sizeof(SDL_Event);
+		int32_t sdlVersion = SDL_VERSION;
+		int32_t width = 0;
+		int32_t height = 0;
+	};
+
+	/// @brief returns how many bytes of an event are recorded, only the part of the union it's type uses, 0 if it's not recorded
+	static uint16_t Internal_GetPayloadSize(uint32_t type)
+	{
+		if (type >= SDL_EVENT_WINDOW_FIRST && type <= SDL_EVENT_WINDOW_LAST) return (uint16_t)sizeof(SDL_WindowEvent);
+
+		switch (type)
+		{
+			case SDL_EVENT_QUIT: return (uint16_t)sizeof(SDL_QuitEvent);
+			case SDL_EVENT_KEY_DOWN:
+			case SDL_EVENT_KEY_UP: return (uint16_t)sizeof(SDL_KeyboardEvent);
+			case SDL_EVENT_TEXT_INPUT: return (uint16_t)sizeof(SDL_TextInputEvent);
+			case SDL_EVENT_MOUSE_MOTION: return (uint16_t)sizeof(SDL_MouseMotionEvent);
+			case SDL_EVENT_MOUSE_BUTTON_DOWN:
+			case SDL_EVENT_MOUSE_BUTTON_UP: return (uint16_t)sizeof(SDL_MouseButtonEvent);
+			case SDL_EVENT_MOUSE_WHEEL: return (uint16_t)sizeof(SDL_MouseWheelEvent);
+			default: return 0;
+		}
+	}
+
+	InputRecorder::~InputRecorder()
+	{
+		Stop();
+	}
+
+	bool InputRecorder::StartRecording(const char* path, int width, int height)
+	{
+		Stop();
+
+		mFile = std::fopen(path, "wb");
+		if (!mFile) {
+			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to open %s for recording the session", path);
+			return false;
+		}
+
+		RecordingHeader header;
+		header.width = width;
+		header.height = height;
+		std::fwrite(&header, sizeof(header), 1, mFile);
+
+		mWidth = width;
+		mHeight = height;
+		mFrameCount = 0;
+		mPending.reserve(RECORDING_CHUNK_SIZE + sizeof(SDL_Event) + 512);
+		return true;
+	}
+
+	bool InputRecorder::StartReplay(const char* path)
+	{
+		Stop();
+
+		FILE* file = std::fopen(path, "rb");
+		if (!file) {
+			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to open %s for replaying the session", path);
+			return false;
+		}
+
+		std::vector<uint8_t> contents;
+		uint8_t buffer[16 * 1024];
+		size_t read = 0;
+		while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) contents.insert(contents.end(), buffer, buffer + read);
+		std::fclose(file);
+
+		Reflection::BinaryReader reader(contents.data(), contents.size());
+		RecordingHeader header;
+		if (!reader.ReadValue(header) || header.magic != RECORDING_MAGIC || header.version != RECORDING_VERSION) {
+			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "%s is not a session recording", path);
+			return false;
+		}
+
+		if (header.eventSize != sizeof(SDL_Event) || header.sdlVersion != SDL_VERSION) {
+			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "%s was recorded with another version of SDL (%d), it's events can't be replayed", path, header.sdlVersion);
+			return false;
+		}
+
+		// chunks are decompressed upfront, so replaying doesn't touch the disk or decompress mid-frame
+		mReplayData.clear();
+		while (reader.Remaining() > 0) {
+			uint32_t rawSize = 0, storedSize = 0;
+			reader.ReadValue(rawSize);
+			reader.ReadValue(storedSize);
+			const uint8_t* stored = reader.Consume(storedSize);
+
+			if (!stored) {
+				CREN_LOG(CREN_LOG_SEVERITY_WARN, "%s is truncated, replaying up to it's last whole chunk", path);
+				break;
+			}
+
+			size_t offset = mReplayData.size();
+			mReplayData.resize(offset + rawSize);
+
+			if (storedSize == rawSize) {
+				std::memcpy(mReplayData.data() + offset, stored, rawSize);
+			}
+
+			else if (!Compression::DecompressBlock(stored, storedSize, mReplayData.data() + offset, rawSize)) {
+				CREN_LOG(CREN_LOG_SEVERITY_WARN, "%s has a corrupted chunk, replaying up to it", path);
+				mReplayData.resize(offset);
+				break;
+			}
+		}
+
+		mReplaying = true;
+		mReplayOffset = 0;
+		mWidth = header.width;
+		mHeight = header.height;
+		mFrameCount = 0;
+		return true;
+	}
+
+	void InputRecorder::Stop()
+	{
+		if (mFile) {
+			FlushChunk();
+			std::fclose(mFile);
+			mFile = nullptr;
+			CREN_LOG(CREN_LOG_SEVERITY_INFO, "Recorded %llu frames", (unsigned long long)mFrameCount);
+		}
+
+		mReplaying = false;
+		mReplayData.clear();
+		mReplayData.shrink_to_fit();
+		mReplayOffset = 0;
+	}
+
+	void InputRecorder::RecordFrame(double timestep)
+	{
+		if (!mFile) return;
+
+		if (mPending.size() >= RECORDING_CHUNK_SIZE) FlushChunk();
+
+		Reflection::BinaryWriter writer(mPending);
+		writer.WriteValue((uint8_t)RECORD_FRAME);
+		writer.WriteValue(timestep);
+		mFrameCount++;
+	}
+
+	void InputRecorder::RecordEvent(const SDL_Event& event)
+	{
+		if (!mFile) return;
+
+		uint16_t size = Internal_GetPayloadSize(event.type);
+		if (size == 0) return;
+
+		Reflection::BinaryWriter writer(mPending);
+		writer.WriteValue((uint8_t)RECORD_EVENT);
+		writer.WriteValue((uint32_t)event.type);
+		writer.WriteValue(size);
+		writer.Write(&event, size);
+
+		if (event.type == SDL_EVENT_TEXT_INPUT) writer.WriteString(event.text.text ? event.text.text : "");
+	}
+
+	bool InputRecorder::ReplayFrame(double& timestep)
+	{
+		if (!mReplaying) return false;
+
+		// events of the previous frame that weren't polled are skipped, the frame boundaries are what keeps the replay in step
+		while (mReplayOffset < mReplayData.size()) {
+			uint8_t kind = mReplayData[mReplayOffset];
+			if (kind == RECORD_FRAME) break;
+
+			SDL_Event event;
+			if (!ReplayEvent(event)) return false;
+		}
+
+		Reflection::BinaryReader reader(mReplayData.data() + mReplayOffset, mReplayData.size() - mReplayOffset);
+		uint8_t kind = 0;
+		if (!reader.ReadValue(kind) || !reader.ReadValue(timestep)) return false;
+
+		mReplayOffset = mReplayData.size() - reader.Remaining();
+		mFrameCount++;
+		return true;
+	}
+
+	bool InputRecorder::ReplayEvent(SDL_Event& event)
+	{
+		if (!mReplaying || mReplayOffset >= mReplayData.size() || mReplayData[mReplayOffset] != RECORD_EVENT) return false;
+
+		Reflection::BinaryReader reader(mReplayData.data() + mReplayOffset + 1, mReplayData.size() - mReplayOffset - 1);
+		uint32_t type = 0;
+		uint16_t size = 0;
+		reader.ReadValue(type);
+		reader.ReadValue(size);
+		const uint8_t* payload = reader.Consume(size);
+
+		if (!payload || size > sizeof(SDL_Event)) {
+			CREN_LOG(CREN_LOG_SEVERITY_WARN, "Session recording is corrupted, the replay ends here");
+			mReplayOffset = mReplayData.size();
+			return false;
+		}
+
+		std::memset(&event, 0, sizeof(event));
+		std::memcpy(&event, payload, size);
+
+		if (type == SDL_EVENT_TEXT_INPUT) {
+			reader.ReadString(mReplayText);
+			event.text.text = mReplayText.c_str();
+		}
+
+		mReplayOffset = mReplayData.size() - reader.Remaining();
+		return reader.IsValid();
+	}
+
+	void InputRecorder::FlushChunk()
+	{
+		if (!mFile || mPending.empty()) return;
+
+		// stored as is when it doesn't compress, a stored size equal to the raw size tells them apart
+		std::vector<uint8_t> compressed(Compression::CompressBound(mPending.size()));
+		size_t compressedSize = Compression::CompressBlock(mPending.data(), mPending.size(), compressed.data(), compressed.size());
+		bool stored = compressedSize == 0 || compressedSize >= mPending.size();
+
+		uint32_t rawSize = (uint32_t)mPending.size();
+		uint32_t storedSize = stored ? rawSize : (uint32_t)compressedSize;
+		std::fwrite(&rawSize, sizeof(rawSize), 1, mFile);
+		std::fwrite(&storedSize, sizeof(storedSize), 1, mFile);
+		std::fwrite(stored ? mPending.data() : compressed.data(), 1, storedSize, mFile);
+		std::fflush(mFile);
+
+		mPending.clear();
+	}
+}
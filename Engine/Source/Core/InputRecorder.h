@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// forward declarations
+union SDL_Event;
+
+namespace Cosmos
+{
+	/// @brief records the window events reaching the application and every frame's timestep into a binary file, and plays them back
+	/// a replay feeds the same events on the same frames with the same timesteps, making a session a repeatable profiling workload
+	class COSMOS_API InputRecorder
+	{
+	public:
+
+		/// @brief constructor
+		InputRecorder() = default;
+
+		/// @brief destructor, finishes a recording still in progress
+		~InputRecorder();
+
+		/// @brief the recording file is owned by the recorder, it's not copyable
+		InputRecorder(const InputRecorder&) = delete;
+		InputRecorder& operator=(const InputRecorder&) = delete;
+
+		/// @brief returns if the frames are being recorded
+		inline bool IsRecording() const { return mFile != nullptr; }
+
+		/// @brief returns if a recording is being played back
+		inline bool IsReplaying() const { return mReplaying; }
+
+		/// @brief returns the window width the session was recorded at
+		inline int GetWidth() const { return mWidth; }
+
+		/// @brief returns the window height the session was recorded at
+		inline int GetHeight() const { return mHeight; }
+
+		/// @brief returns how many frames were recorded or played back so far
+		inline uint64_t GetFrameCount() const { return mFrameCount; }
+
+	public:
+
+		/// @brief starts recording into a file, the window size is stored so the replay can match it, returns false if the file couldn't be created
+		bool StartRecording(const char* path, int width, int height);
+
+		/// @brief starts playing back a recording, returns false if the file couldn't be read or isn't a recording
+		bool StartReplay(const char* path);
+
+		/// @brief finishes the recording or the replay
+		void Stop();
+
+	public:
+
+		/// @brief records the start of a frame simulating timestep seconds, the events recorded after it belong to it
+		void RecordFrame(double timestep);
+
+		/// @brief records an event of the current frame, events referencing memory sdl owns (drops, clipboard, user events) aren't recorded
+		void RecordEvent(const SDL_Event& event);
+
+		/// @brief moves the replay to the next frame returning it's timestep, returns false when the recording is over
+		bool ReplayFrame(double& timestep);
+
+		/// @brief returns the next event of the current replayed frame, false when the frame has no more events
+		/// a text input event points to text owned by the recorder, valid until the next call
+		bool ReplayEvent(SDL_Event& event);
+
+	private:
+
+		/// @brief compresses the pending records and appends them to the file as a chunk
+		void FlushChunk();
+
+	private:
+
+		FILE* mFile = nullptr;
+		std::vector<uint8_t> mPending;		// records not yet written, flushed in chunks
+		std::vector<uint8_t> mReplayData;	// the whole recording, decompressed
+		size_t mReplayOffset = 0;
+		std::string mReplayText;
+		bool mReplaying = false;
+		int mWidth = 0;
+		int mHeight = 0;
+		uint64_t mFrameCount = 0;
+	};
+}
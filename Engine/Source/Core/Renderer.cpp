@@ -1,6 +1,9 @@
 #include "Core/Renderer.h"
 #include "Core/Application.h"
+#include "Util/Profiler.h"
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 
 namespace Cosmos
@@ -20,10 +23,13 @@ namespace Cosmos
         ci.validations = validations;
         ci.vsync = vsync;
         ci.customViewport = customViewport;
+        ci.headless = mApp->GetWindowRef()->IsHeadless();
 
         mContext = cren_initialize(ci);
         CREN_ASSERT(mContext != nullptr, "Failed to create CRen Context");
 
+        mIDAuthority = CreateUnique<IDAuthority>(mContext);
+
         // set-up callbacks
         cren_set_user_pointer(mContext, this);
 
@@ -34,7 +40,7 @@ namespace Cosmos
 
         cren_set_draw_ui_raw_data_callback(mContext, [](CRenContext* context, void* commandbuffer) {
             Renderer& rendererClass = *(Renderer*)cren_get_user_pointer(context);
-            rendererClass.mApp->GetGUIRef()->DrawRawData(commandbuffer);
+            if (rendererClass.mRenderingSnapshot) rendererClass.mApp->GetGUIRef()->DrawRawData(rendererClass.mRenderingSnapshot->ui, commandbuffer);
             });
 
         cren_set_resize_callback(mContext, [](CRenContext* context, unsigned int width, unsigned int height) {
@@ -73,24 +79,163 @@ namespace Cosmos
         // initialize the renderer
         cren_create_renderer(mContext);
 
+        // frames are drawn with the camera captured on their snapshot, while the simulation keeps moving the main one
+        mRenderCamera = cren_camera_create(CREN_CAMERA_TYPE_FREE_LOOK, (float)ci.width / (float)ci.height, api);
+        cren_camera_copy(mRenderCamera, cren_get_main_camera(mContext));
+        cren_set_render_camera(mContext, mRenderCamera);
+
         mWorld = new World(mApp, mApp->GetRendererRef()); // loading a default world
     }
 
     Renderer::~Renderer()
     {
+        StopRenderThread();
+
         mWorld->Destroy();
+        mIDAuthority.reset();
+
+        // nothing is in flight anymore, the quads waiting on frames can go
+        cren_lock(mContext);
+        vkDeviceWaitIdle(((CRenVulkanBackend*)cren_get_vulkan_backend(mContext))->device.device);
+        cren_unlock(mContext);
+        ReleaseRetiredQuads(true);
+
+        for (uint32_t i = 0; i < TripleBuffer<FrameSnapshot>::SLOT_COUNT; i++) {
+            FrameSnapshot& snapshot = mSnapshots.GetSlots()[i];
+            cren_camera_destroy(snapshot.camera);
+            GUI::DestroySnapshot(snapshot.ui);
+        }
+
+        cren_set_render_camera(mContext, nullptr);
+        cren_camera_destroy(mRenderCamera);
         cren_shutdown(mContext);
     }
 
-    void Renderer::OnUpdate(float timestep)
+    void Renderer::OnCameraUpdate(float timestep)
     {
         cren_update(mContext, timestep);
+    }
+
+    void Renderer::OnWorldUpdate(float timestep)
+    {
         mWorld->OnUpdate(timestep);
     }
 
     void Renderer::OnRender(float timestep)
     {
-        cren_render(mContext, timestep);
+        COSMOS_PROFILE_SCOPE("Publish Snapshot");
+
+        // the slot is the simulation's until published, the render thread holds another one
+        FrameSnapshot& snapshot = mSnapshots.GetWriteSlot();
+        if (!snapshot.camera) snapshot.camera = cren_camera_create(CREN_CAMERA_TYPE_FREE_LOOK, 1.0f, mAPI);
+        if (!snapshot.ui) snapshot.ui = GUI::CreateSnapshot();
+
+        snapshot.sequence = ++mPublishedSequence;
+        snapshot.timestep = timestep;
+        cren_camera_copy(snapshot.camera, cren_get_main_camera(mContext));
+        snapshot.mousePos = cren_get_mousepos(mContext);
+        snapshot.viewportSize = cren_get_viewport_size(mContext);
+        snapshot.quads.clear();
+        mWorld->CaptureDraws(snapshot.quads);
+        mApp->GetGUIRef()->CaptureSnapshot(snapshot.ui);
+
+        mSnapshots.Publish();
+
+        if (!IsRenderThreaded()) {
+            RenderLatestSnapshot();
+            return;
+        }
+
+        // taking the mutex orders the publish with the render thread checking for it, so the wake up isn't lost
+        { std::lock_guard<std::mutex> lock(mPublishMutex); }
+        mPublishCondition.notify_one();
+    }
+
+    void Renderer::StartRenderThread()
+    {
+        if (IsRenderThreaded()) return;
+
+        mRenderThreadRunning.store(true, std::memory_order_release);
+        mRenderThread = std::thread([this]() {
+            cren_profiler_set_thread_name("Render");
+
+            while (mRenderThreadRunning.load(std::memory_order_acquire)) {
+                {
+                    // the timeout only bounds how long a stop request may wait, publishing wakes the thread
+                    std::unique_lock<std::mutex> lock(mPublishMutex);
+                    mPublishCondition.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+                        return mSnapshots.HasPending() || !mRenderThreadRunning.load(std::memory_order_acquire);
+                        });
+                }
+
+                RenderLatestSnapshot();
+            }
+            });
+    }
+
+    void Renderer::StopRenderThread()
+    {
+        if (!IsRenderThreaded()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(mPublishMutex);
+            mRenderThreadRunning.store(false, std::memory_order_release);
+        }
+        mPublishCondition.notify_one();
+
+        if (mRenderThread.joinable()) mRenderThread.join();
+    }
+
+    void Renderer::DestroyQuad(CRenQuad* quad)
+    {
+        if (!quad) return;
+
+        std::lock_guard<std::mutex> lock(mRetiredMutex);
+        mRetiredQuads.push_back({ quad, mPublishedSequence });
+    }
+
+    void Renderer::RenderLatestSnapshot()
+    {
+        if (!mSnapshots.Acquire()) return;
+
+        COSMOS_PROFILE_SCOPE("Render Snapshot");
+        FrameSnapshot& snapshot = mSnapshots.GetReadSlot();
+        cren_camera_copy(mRenderCamera, snapshot.camera);
+        cren_set_render_view(mContext, snapshot.mousePos, snapshot.viewportSize);
+
+        mRenderingSnapshot = &snapshot;
+        auto renderStart = std::chrono::steady_clock::now();
+        bool rendered = cren_render(mContext, snapshot.timestep);
+        auto renderEnd = std::chrono::steady_clock::now();
+        mRenderingSnapshot = nullptr;
+
+        // the end of a rendered frame is where the pacer predicts the next present from
+        if (rendered) {
+            double cpuTime = std::chrono::duration<double>(renderEnd - renderStart).count();
+            mApp->GetFramePacerRef().ReportRender(renderEnd, cpuTime, cren_get_gpu_frame_time(mContext));
+        }
+
+        if (!rendered) return;
+
+        // a frame recorded without the quad went through the renderer, once as many as there are frames in flight did
+        // cren has waited on the fence of the last frame that may have drawn it
+        std::lock_guard<std::mutex> lock(mRetiredMutex);
+        for (RetiredQuad& retired : mRetiredQuads) {
+            if (snapshot.sequence > retired.sequence && retired.framesLeft > 0) retired.framesLeft--;
+        }
+        ReleaseRetiredQuads(false);
+    }
+
+    void Renderer::ReleaseRetiredQuads(bool force)
+    {
+        // expects mRetiredMutex to be held unless the render thread is stopped
+        auto released = std::remove_if(mRetiredQuads.begin(), mRetiredQuads.end(), [this, force](const RetiredQuad& retired) {
+            if (!force && retired.framesLeft > 0) return false;
+
+            cren_quad_destroy(mContext, retired.quad);
+            return true;
+            });
+        mRetiredQuads.erase(released, mRetiredQuads.end());
     }
 
     void Renderer::Minimize()
@@ -106,6 +251,11 @@ namespace Cosmos
     void Renderer::Resize(int width, int height)
     {
         cren_resize(mContext, width, height);
+
+        // the renderer only adjusts the camera it draws with, the main one would overwrite it with the next snapshot
+        if (!cren_using_custom_viewport(mContext) && height > 0) {
+            cren_camera_set_aspect_ratio(cren_get_main_camera(mContext), (float)width / (float)height);
+        }
     }
 
     bool Renderer::GetVSync()
@@ -113,6 +263,17 @@ namespace Cosmos
         return cren_using_vsync(mContext);
     }
 
+    CRen_PresentMode Renderer::GetPresentMode()
+    {
+        return cren_get_present_mode(mContext);
+    }
+
+    void Renderer::SetPresentMode(CRen_PresentMode mode)
+    {
+        cren_set_present_mode(mContext, mode);
+        mApp->UpdatePacingRate();
+    }
+
     CRenCamera* Renderer::GetMainCamera()
     {
         return cren_get_main_camera(mContext);
@@ -120,8 +281,12 @@ namespace Cosmos
 
     void Renderer::OnRenderCallback(int stage, float timestep)
     {
-        mApp->GetGUIRef()->OnRender(stage);
-        mWorld->OnRender(timestep, stage);
+        if (!mRenderingSnapshot) return;
+        mApp->GetGUIRef()->OnRender(stage, mRenderingSnapshot->ui);
+
+        for (const QuadDraw& draw : mRenderingSnapshot->quads) {
+            cren_quad_render(mContext, draw.quad, (CRen_RenderStage)stage, draw.modelMatrix);
+        }
     }
 
     void Renderer::OnResizeCallback(int width, int height)
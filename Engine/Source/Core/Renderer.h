@@ -1,15 +1,35 @@
 #pragma once
 
 #include "Core/Defines.h"
+#include "Core/IDAuthority.h"
 #include "Scene/World.h"
 #include "Util/Memory.h"
+#include "Util/TripleBuffer.h"
+#include <atomic>
+#include <condition_variable>
 #include <cren.h>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // forward declarations
 namespace Cosmos { class Application; }
+namespace Cosmos { struct UISnapshot; }
 
 namespace Cosmos
 {
+    /// @brief everything needed to draw a frame, built by the simulation at the end of it's frame and left untouched once published
+    struct FrameSnapshot
+    {
+        uint64_t sequence = 0;
+        float timestep = 0.0f;
+        CRenCamera* camera = nullptr; // copy of the main camera
+        float2 mousePos = { 0.0f, 0.0f }; // what the frame picks with
+        float2 viewportSize = { 0.0f, 0.0f };
+        std::vector<QuadDraw> quads;
+        UISnapshot* ui = nullptr;
+    };
+
     class COSMOS_API Renderer
     {
     public:
@@ -28,15 +48,33 @@ namespace Cosmos
 
         /// @brief returns the world currently loaded in
         inline World* GetWorld() { return mWorld; }
+
+        /// @brief returns the id authority, every entity/picking id comes from it
+        inline IDAuthority& GetIDAuthorityRef() { return *mIDAuthority; }
         
     public:
 
-        /// @brief updates the renderer, sending frame data to the gpu at a fixed period
-        void OnUpdate(float timestep);
+        /// @brief moves the camera by the timestep, it's ticked every frame so it moves as smoothly as frames are rendered
+        void OnCameraUpdate(float timestep);
 
-        /// @brief draw stuff
+        /// @brief updates the world, it's ticked at the fixed simulation rate
+        void OnWorldUpdate(float timestep);
+
+        /// @brief publishes what was simulated so far as a frame snapshot, rendering it right away unless the render thread is running
         void OnRender(float timestep);
 
+        /// @brief starts rendering the published snapshots on a thread of it's own, so simulation and rendering overlap
+        void StartRenderThread();
+
+        /// @brief waits for the frame being rendered and stops the render thread, rendering goes back to OnRender
+        void StopRenderThread();
+
+        /// @brief returns if the render thread is running
+        inline bool IsRenderThreaded() const { return mRenderThreadRunning.load(std::memory_order_relaxed); }
+
+        /// @brief destroys a quad once none of the frames still to be rendered/in flight may draw it, call it from the simulation
+        void DestroyQuad(CRenQuad* quad);
+
     public:
 
         /// @brief tells the renderer to minimize
@@ -51,6 +89,12 @@ namespace Cosmos
         /// @brief returns if vsync is currently on
         bool GetVSync();
 
+        /// @brief returns the present mode the swapchain is using, it may differ from the requested one if the device lacks it
+        CRen_PresentMode GetPresentMode();
+
+        /// @brief requests a present mode, the swapchain is recreated with it before the next frame and the frame pacer follows it
+        void SetPresentMode(CRen_PresentMode mode);
+
         /// @brief returns the main cren camera
         CRenCamera* GetMainCamera();
 
@@ -64,9 +108,40 @@ namespace Cosmos
 
     private:
 
+        /// @brief renders the latest published snapshot, does nothing if it was already rendered
+        void RenderLatestSnapshot();
+
+        /// @brief destroys the quads no frame may draw anymore, every retired quad if force is set (device must be idle)
+        void ReleaseRetiredQuads(bool force);
+
+    private:
+
+        /// @brief a quad waiting to be destroyed, snapshots up to sequence may still draw it
+        struct RetiredQuad
+        {
+            CRenQuad* quad = nullptr;
+            uint64_t sequence = 0;
+            uint32_t framesLeft = CREN_CONCURRENTLY_RENDERED_FRAMES;
+        };
+
         Application* mApp = nullptr;
         CRenContext* mContext = nullptr;
         CRen_RendererAPI mAPI;
         World* mWorld = nullptr;
+        Unique<IDAuthority> mIDAuthority;
+
+        // snapshot handoff, the simulation writes and the render thread (or OnRender itself) reads
+        TripleBuffer<FrameSnapshot> mSnapshots;
+        uint64_t mPublishedSequence = 0;
+        FrameSnapshot* mRenderingSnapshot = nullptr;
+        CRenCamera* mRenderCamera = nullptr;
+        std::mutex mRetiredMutex;
+        std::vector<RetiredQuad> mRetiredQuads;
+
+        // render thread
+        std::thread mRenderThread;
+        std::atomic<bool> mRenderThreadRunning = false;
+        std::mutex mPublishMutex;
+        std::condition_variable mPublishCondition;
     };
 }
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cren_error.h>
+#include <cren_profiler.h>
+
+namespace Cosmos
+{
+	/// @brief the fixed subsystems start this fraction of a period apart, the golden ratio keeps any number of them spread out
+	static constexpr double PHASE_STEP = 0.6180339887498949;
+
+	uint32_t Scheduler::Register(const char* name, TickMode mode, TickFunction function, double rate, uint32_t maxTicks)
+	{
+		if (mode == TickMode::Fixed && rate <= 0.0) {
+			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Subsystem %s ticks at a fixed rate but has none", name);
+			return 0;
+		}
+
+		Subsystem subsystem;
+		subsystem.id = mNextID++;
+		subsystem.name = name;
+		subsystem.mode = mode;
+		subsystem.maxTicks = std::max(1u, maxTicks);
+		subsystem.function = std::move(function);
+
+		if (mode == TickMode::Fixed) {
+			double phase = std::fmod(mFixedCount++ * PHASE_STEP, 1.0);
+			subsystem.period = 1.0 / rate;
+			subsystem.accumulator = phase * subsystem.period;
+		}
+
+		// registered from a tick it waits for the frame to be over, the subsystem being ticked stays where it is
+		uint32_t id = subsystem.id;
+		if (mTicking) mRegistered.push_back(std::move(subsystem));
+		else mSubsystems.push_back(std::move(subsystem));
+
+		return id;
+	}
+
+	void Scheduler::Unregister(uint32_t id)
+	{
+		Subsystem* subsystem = Find(id);
+		if (!subsystem) return;
+
+		// a tick may be the one unregistering, the subsystem is only erased after the frame is ticked
+		subsystem->removed = true;
+		subsystem->enabled = false;
+		if (!mTicking) EraseRemoved();
+	}
+
+	void Scheduler::SetRate(uint32_t id, double rate)
+	{
+		Subsystem* subsystem = Find(id);
+		if (!subsystem || subsystem->mode != TickMode::Fixed || rate <= 0.0) return;
+
+		double period = 1.0 / rate;
+		subsystem->accumulator = subsystem->accumulator / subsystem->period * period;
+		subsystem->period = period;
+	}
+
+	void Scheduler::SetEnabled(uint32_t id, bool enabled)
+	{
+		Subsystem* subsystem = Find(id);
+		if (subsystem && !subsystem->removed) subsystem->enabled = enabled;
+	}
+
+	float Scheduler::GetInterpolation(uint32_t id) const
+	{
+		for (const Subsystem& subsystem : mSubsystems) {
+			if (subsystem.id == id && subsystem.mode == TickMode::Fixed) return (float)(subsystem.accumulator / subsystem.period);
+		}
+
+		return 0.0f;
+	}
+
+	void Scheduler::Tick(double timestep)
+	{
+		using Clock = std::chrono::steady_clock;
+		mTicking = true;
+
+		for (Subsystem& subsystem : mSubsystems) {
+			subsystem.ticks = 0;
+			subsystem.cost = 0.0;
+			if (!subsystem.enabled) continue;
+
+			// how many times and with which timestep it ticks this frame
+			uint32_t ticks = 0;
+			double tickTimestep = timestep;
+
+			switch (subsystem.mode)
+			{
+				case TickMode::PerFrame:
+				{
+					ticks = 1;
+					break;
+				}
+
+				case TickMode::Fixed:
+				{
+					subsystem.accumulator = std::min(subsystem.accumulator + timestep, subsystem.period * subsystem.maxTicks);
+					ticks = std::min((uint32_t)(subsystem.accumulator / subsystem.period), subsystem.maxTicks);
+					subsystem.accumulator -= ticks * subsystem.period;
+					tickTimestep = subsystem.period;
+					break;
+				}
+
+				case TickMode::OnInput:
+				{
+					subsystem.sinceTick += timestep;
+					if (!mInputPending) break;
+
+					ticks = 1;
+					tickTimestep = subsystem.sinceTick;
+					subsystem.sinceTick = 0.0;
+					break;
+				}
+			}
+
+			if (ticks == 0) continue;
+
+			Clock::time_point start = Clock::now();
+			for (uint32_t tick = 0; tick < ticks; tick++) {
+				CREN_PROFILE_BEGIN(subsystem.name);
+				subsystem.function(tickTimestep);
+				CREN_PROFILE_END();
+			}
+
+			subsystem.ticks = ticks;
+			subsystem.cost = std::chrono::duration<double>(Clock::now() - start).count();
+		}
+
+		mTicking = false;
+		mInputPending = false;
+
+		for (Subsystem& subsystem : mRegistered) mSubsystems.push_back(std::move(subsystem));
+		mRegistered.clear();
+		EraseRemoved();
+	}
+
+	Scheduler::Subsystem* Scheduler::Find(uint32_t id)
+	{
+		for (std::vector<Subsystem>* subsystems : { &mSubsystems, &mRegistered }) {
+			for (Subsystem& subsystem : *subsystems) {
+				if (subsystem.id == id) return &subsystem;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void Scheduler::EraseRemoved()
+	{
+		for (std::vector<Subsystem>* subsystems : { &mSubsystems, &mRegistered }) {
+			subsystems->erase(std::remove_if(subsystems->begin(), subsystems->end(), [](const Subsystem& subsystem) { return subsystem.removed; }), subsystems->end());
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Cosmos
+{
+	/// @brief when a subsystem is ticked
+	enum class TickMode
+	{
+		Fixed,		// at it's own rate, as many times as the frame's timestep accumulated (physics, ai, autosave, etc)
+		PerFrame,	// once every frame with the frame's timestep (window events, camera, etc)
+		OnInput		// only on frames that had input, with the time since it last ticked
+	};
+
+	/// @brief ticks the subsystems registered to it each at it's own rate, in the order they were registered
+	/// fixed rate subsystems start at staggered phases, so the ones ticking every few frames don't all land on the same frame
+	class COSMOS_API Scheduler
+	{
+	public:
+
+		using TickFunction = std::function<void(double timestep)>;
+
+		/// @brief a registered subsystem
+		struct Subsystem
+		{
+			uint32_t id = 0;
+			const char* name = nullptr;	// also it's profiler zone, so it must outlive the program (a literal)
+			TickMode mode = TickMode::PerFrame;
+			double period = 0.0;		// seconds between ticks of a fixed subsystem
+			uint32_t maxTicks = 10;		// most ticks of a fixed subsystem in a frame, a longer hitch is dropped instead of spiraling
+			double accumulator = 0.0;	// time a fixed subsystem has yet to tick
+			double sinceTick = 0.0;		// time since an on input subsystem ticked
+			bool enabled = true;
+			bool removed = false;
+			uint32_t ticks = 0;			// ticks of the last frame
+			double cost = 0.0;			// seconds spent ticking in the last frame
+			TickFunction function;
+		};
+
+	public:
+
+		/// @brief constructor
+		Scheduler() = default;
+
+		/// @brief destructor
+		~Scheduler() = default;
+
+		/// @brief returns the registered subsystems, in tick order, the ones registered by a tick show up after the frame
+		inline const std::vector<Subsystem>& GetSubsystems() const { return mSubsystems; }
+
+	public:
+
+		/// @brief registers a subsystem ticked after the ones already registered, rate is in ticks per second and only used by fixed subsystems, returns it's id
+		uint32_t Register(const char* name, TickMode mode, TickFunction function, double rate = 0.0, uint32_t maxTicks = 10);
+
+		/// @brief removes a subsystem, it may be called from a tick
+		void Unregister(uint32_t id);
+
+		/// @brief changes the rate of a fixed subsystem, keeping where it is within it's period
+		void SetRate(uint32_t id, double rate);
+
+		/// @brief enables or disables a subsystem, a disabled one doesn't accumulate time either
+		void SetEnabled(uint32_t id, bool enabled);
+
+		/// @brief returns how far a fixed subsystem is into it's next tick, from 0 to 1, for interpolating what it moves
+		float GetInterpolation(uint32_t id) const;
+
+		/// @brief signals input arrived this frame, the on input subsystems ticked after it are ticked
+		inline void NotifyInput() { mInputPending = true; }
+
+		/// @brief ticks the subsystems due this frame, timestep is the frame's in seconds
+		void Tick(double timestep);
+
+	private:
+
+		/// @brief returns the subsystem with id, nullptr if there's none
+		Subsystem* Find(uint32_t id);
+
+		/// @brief erases the unregistered subsystems
+		void EraseRemoved();
+
+	private:
+
+		std::vector<Subsystem> mSubsystems;
+		std::vector<Subsystem> mRegistered; // registered while ticking, they're ticked from the next frame
+		uint32_t mNextID = 1;
+		uint32_t mFixedCount = 0;
+		bool mInputPending = true; // on input subsystems tick on the first frame, so they start out initialized
+		bool mTicking = false;
+	};
+}
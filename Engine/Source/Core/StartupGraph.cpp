@@ -0,0 +1,156 @@
+#include "StartupGraph.h"
+
+#include <algorithm>
+#include <cren_error.h>
+#include <cren_profiler.h>
+#include <string>
+
+namespace Cosmos
+{
+	uint32_t StartupGraph::AddStage(const char* name, StageFunction function, std::initializer_list<uint32_t> dependencies, bool mainThread)
+	{
+		uint32_t index = (uint32_t)mStages.size();
+
+		std::unique_ptr<Stage> stage = std::make_unique<Stage>();
+		stage->name = name;
+		stage->function = std::move(function);
+		stage->mainThread = mainThread;
+
+		for (uint32_t dependency : dependencies) {
+			if (dependency >= index) {
+				CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Startup stage %s depends on a stage added after it, the dependency is ignored", name);
+				continue;
+			}
+
+			stage->dependencies.push_back(dependency);
+			mStages[dependency]->dependents.push_back(index);
+		}
+
+		mStages.push_back(std::move(stage));
+		return index;
+	}
+
+	void StartupGraph::Run()
+	{
+		mStart = Clock::now();
+		size_t mainStages = 0;
+
+		for (std::unique_ptr<Stage>& stage : mStages) {
+			stage->remaining.store((uint32_t)stage->dependencies.size(), std::memory_order_relaxed);
+			stage->submitted.store(false, std::memory_order_relaxed);
+			stage->finished.store(false, std::memory_order_relaxed);
+			if (stage->mainThread) mainStages++;
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)mStages.size(); i++) {
+			if (!mStages[i]->mainThread && mStages[i]->dependencies.empty()) Submit(i);
+		}
+
+		while (mainStages > 0) {
+
+			// the first main thread stage whose dependencies finished, in the order they were added
+			bool ran = false;
+			for (uint32_t i = 0; i < (uint32_t)mStages.size() && !ran; i++) {
+				Stage& stage = *mStages[i];
+				if (!stage.mainThread || stage.submitted.load(std::memory_order_relaxed) || stage.remaining.load(std::memory_order_acquire) > 0) continue;
+
+				stage.submitted.store(true, std::memory_order_relaxed);
+				RunStage(i);
+				mainStages--;
+				ran = true;
+			}
+
+			if (ran) continue;
+
+			// nothing is ready here, waits on a worker stage running jobs meanwhile, it's finishing is what may unblock the main thread
+			Stage* running = nullptr;
+			for (std::unique_ptr<Stage>& stage : mStages) {
+				if (!stage->mainThread && stage->submitted.load(std::memory_order_acquire) && !stage->finished.load(std::memory_order_acquire)) {
+					running = stage.get();
+					break;
+				}
+			}
+
+			if (!running) {
+				CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Startup stages are waiting on each other, %zu main thread stages never ran", mainStages);
+				break;
+			}
+
+			JobSystem::Wait(running->counter);
+		}
+
+		// worker stages nothing on the main thread depended on may still be running
+		for (std::unique_ptr<Stage>& stage : mStages) {
+			if (!stage->mainThread && stage->submitted.load(std::memory_order_acquire)) JobSystem::Wait(stage->counter);
+		}
+
+		mTotalTime = std::chrono::duration<double>(Clock::now() - mStart).count();
+	}
+
+	void StartupGraph::LogReport() const
+	{
+		double work = 0.0;
+		std::vector<const Stage*> ordered;
+		for (const std::unique_ptr<Stage>& stage : mStages) {
+			work += stage->duration;
+			ordered.push_back(stage.get());
+		}
+
+		std::sort(ordered.begin(), ordered.end(), [](const Stage* a, const Stage* b) { return a->start < b->start; });
+
+		CREN_LOG(CREN_LOG_SEVERITY_INFO, "Startup took %.2fms, %.2fms of work over %zu stages (%.2fx overlap)", mTotalTime * 1000.0, work * 1000.0, mStages.size(), mTotalTime > 0.0 ? work / mTotalTime : 0.0);
+
+		for (const Stage* stage : ordered) {
+			CREN_LOG(CREN_LOG_SEVERITY_INFO, "  %-20s %9.2fms, from %9.2fms on %s", stage->name, stage->duration * 1000.0, stage->start * 1000.0, stage->mainThread ? "the main thread" : "a worker");
+		}
+
+		// the critical path ends on the stage finishing last, going back through the dependency each stage waited on the longest
+		const Stage* last = nullptr;
+		for (const std::unique_ptr<Stage>& stage : mStages) {
+			if (!last || stage->start + stage->duration > last->start + last->duration) last = stage.get();
+		}
+
+		std::string path;
+		for (const Stage* stage = last; stage;) {
+			path = path.empty() ? std::string(stage->name) : std::string(stage->name) + " > " + path;
+
+			const Stage* waited = nullptr;
+			for (uint32_t dependency : stage->dependencies) {
+				const Stage* candidate = mStages[dependency].get();
+				if (!waited || candidate->start + candidate->duration > waited->start + waited->duration) waited = candidate;
+			}
+
+			stage = waited;
+		}
+
+		if (!path.empty()) CREN_LOG(CREN_LOG_SEVERITY_INFO, "  critical path: %s", path.c_str());
+	}
+
+	void StartupGraph::RunStage(uint32_t index)
+	{
+		Stage& stage = *mStages[index];
+		Clock::time_point start = Clock::now();
+
+		CREN_PROFILE_BEGIN(stage.name);
+		if (stage.function) stage.function();
+		CREN_PROFILE_END();
+
+		Clock::time_point end = Clock::now();
+		stage.start = std::chrono::duration<double>(start - mStart).count();
+		stage.duration = std::chrono::duration<double>(end - start).count();
+		stage.finished.store(true, std::memory_order_release);
+
+		// main thread stages are picked up by the main thread once their last dependency is released
+		for (uint32_t dependent : stage.dependents) {
+			Stage& next = *mStages[dependent];
+			if (next.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 && !next.mainThread) Submit(dependent);
+		}
+	}
+
+	void StartupGraph::Submit(uint32_t index)
+	{
+		// flagged once the counter counts the job, so waiting on a submitted stage always waits for it
+		JobSystem::Run([this, index]() { RunStage(index); }, &mStages[index]->counter);
+		mStages[index]->submitted.store(true, std::memory_order_release);
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include "Util/JobSystem.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace Cosmos
+{
+	/// @brief initialization split into stages with dependencies, the ones that don't need the main thread run on the job system
+	/// so independent work (reading shaders, decoding textures, rasterizing fonts) overlaps the window and device creation
+	class COSMOS_API StartupGraph
+	{
+	public:
+
+		using StageFunction = std::function<void()>;
+		using Clock = std::chrono::steady_clock;
+
+		/// @brief a stage and how it went
+		struct Stage
+		{
+			const char* name = nullptr;
+			StageFunction function;
+			std::vector<uint32_t> dependencies;
+			std::vector<uint32_t> dependents;
+			bool mainThread = false;				// windowing and the graphics device are created on the main thread
+			std::atomic<uint32_t> remaining = 0;	// dependencies yet to finish
+			std::atomic<bool> submitted = false;
+			std::atomic<bool> finished = false;
+			JobCounter counter;						// counts the job of a worker stage
+			double start = 0.0;						// seconds since the graph started running
+			double duration = 0.0;
+		};
+
+	public:
+
+		/// @brief constructor
+		StartupGraph() = default;
+
+		/// @brief stages point to each other, it's not copyable
+		StartupGraph(const StartupGraph&) = delete;
+		StartupGraph& operator=(const StartupGraph&) = delete;
+
+		/// @brief returns the stages, in the order they were added
+		inline const std::vector<std::unique_ptr<Stage>>& GetStages() const { return mStages; }
+
+		/// @brief returns how long running the graph took, in seconds
+		inline double GetTotalTime() const { return mTotalTime; }
+
+	public:
+
+		/// @brief adds a stage running after dependencies, on the main thread if mainThread or on a worker otherwise, returns it's index
+		/// dependencies must have been added already, so the graph can't have cycles
+		uint32_t AddStage(const char* name, StageFunction function, std::initializer_list<uint32_t> dependencies = {}, bool mainThread = false);
+
+		/// @brief runs every stage, returning once all of them finished, it must be called from the main thread
+		/// the main thread runs it's stages as they become ready and helps with the worker ones while waiting
+		void Run();
+
+		/// @brief logs when each stage started, how long it took and where it ran, along with the critical path
+		void LogReport() const;
+
+	private:
+
+		/// @brief runs a stage, timing it and releasing the stages waiting on it
+		void RunStage(uint32_t index);
+
+		/// @brief queues a worker stage on the job system
+		void Submit(uint32_t index);
+
+	private:
+
+		std::vector<std::unique_ptr<Stage>> mStages;
+		Clock::time_point mStart = {};
+		double mTotalTime = 0.0;
+	};
+}
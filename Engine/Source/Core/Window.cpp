@@ -7,11 +7,17 @@
 #include <SDL3/SDL_vulkan.h>
 #include <backends/imgui_impl_sdl3.h>
 
+// not static on the sdl3 backend (compiled within GUI.cpp), it's just not on it's header
+ImGuiKey ImGui_ImplSDL3_KeyEventToImGuiKey(SDL_Keycode keycode, SDL_Scancode scancode);
+
 namespace Cosmos
 {
-	Window::Window(Application* app, const char* title, int width, int height, bool fullscreen, const char* rootPath)
-		: mApp(app), mTitle(title), mWidth(width), mHeight(height)
+	Window::Window(Application* app, const char* title, int width, int height, bool fullscreen, const char* rootPath, bool headless)
+		: mApp(app), mTitle(title), mWidth(width), mHeight(height), mHeadless(headless)
 	{
+		// nothing is displayed, the video subsystem isn't needed (and may not exist on the host)
+		if (mHeadless) return;
+
 		if (SDL_Init(SDL_INIT_VIDEO) == false) {
 			CREN_LOG(CREN_LOG_SEVERITY_FATAL, "SDL could not be initialized, more info: %s", SDL_GetError());
 			return;
@@ -49,106 +55,185 @@ namespace Cosmos
 
 	Window::~Window()
 	{
+		if (mHeadless) return;
+
 		SDL_DestroyWindow((SDL_Window*)mNativeWindow);
 		SDL_Quit();
 	}
 
 	void Window::OnUpdate()
 	{
+		InputRecorder& recorder = mApp->GetInputRecorderRef();
+
+		if (recorder.IsReplaying()) {
+
+			// the live events are still drained so the window keeps responding, but only closing it is honored
+			SDL_Event live = { 0 };
+			while (!mHeadless && SDL_PollEvent(&live)) {
+				if (live.type == SDL_EVENT_QUIT) mShouldClose = true;
+			}
+
+			// recorded window ids are of the recording session's windows, the events are retargeted to the current one
+			SDL_WindowID windowID = mHeadless ? 0 : SDL_GetWindowID(mNativeWindow);
+			SDL_Event event = { 0 };
+
+			while (recorder.ReplayEvent(event)) {
+				if (event.type >= SDL_EVENT_WINDOW_FIRST && event.type <= SDL_EVENT_WINDOW_LAST) event.window.windowID = windowID;
+				else if (event.type == SDL_EVENT_KEY_DOWN || event.type == SDL_EVENT_KEY_UP) event.key.windowID = windowID;
+				else if (event.type == SDL_EVENT_TEXT_INPUT) event.text.windowID = windowID;
+				else if (event.type == SDL_EVENT_MOUSE_MOTION) event.motion.windowID = windowID;
+				else if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN || event.type == SDL_EVENT_MOUSE_BUTTON_UP) event.button.windowID = windowID;
+				else if (event.type == SDL_EVENT_MOUSE_WHEEL) event.wheel.windowID = windowID;
+
+				ProcessEvent(event);
+			}
+
+			return;
+		}
+
+		if (mHeadless) return;
+
 		SDL_Event event = { 0 };
 
 		while (SDL_PollEvent(&event))
 		{
-			ImGui_ImplSDL3_ProcessEvent(&event);
+			recorder.RecordEvent(event);
+			ProcessEvent(event);
+		}
+	}
 
-			switch (event.type)
-			{
-				case SDL_EVENT_QUIT:
-				{
-					mShouldClose = true;
-					break;
-				}
+	void Window::ProcessEvent(SDL_Event& event)
+	{
+		// anything coming from the user may change what's drawn, and is what the input driven subsystems wait for
+		mApp->RequestRedraw();
+		mApp->GetSchedulerRef().NotifyInput();
+
+		// there's no platform backend without a native window, and a replay doesn't use it since it also reads the live mouse and keyboard
+		// the events are fed to imgui directly so only the recorded input reaches it
+		if (!mHeadless && !mApp->GetInputRecorderRef().IsReplaying()) ImGui_ImplSDL3_ProcessEvent(&event);
+
+		else {
+			ImGuiIO& io = ImGui::GetIO();
+			if (event.type == SDL_EVENT_MOUSE_MOTION) io.AddMousePosEvent(event.motion.x, event.motion.y);
+			else if (event.type == SDL_EVENT_MOUSE_WHEEL) io.AddMouseWheelEvent(-event.wheel.x, event.wheel.y);
+			else if (event.type == SDL_EVENT_TEXT_INPUT) io.AddInputCharactersUTF8(event.text.text);
+			else if (event.type == SDL_EVENT_WINDOW_FOCUS_GAINED || event.type == SDL_EVENT_WINDOW_FOCUS_LOST) io.AddFocusEvent(event.type == SDL_EVENT_WINDOW_FOCUS_GAINED);
+			else if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN || event.type == SDL_EVENT_MOUSE_BUTTON_UP) {
+				int button = event.button.button == SDL_BUTTON_LEFT ? 0 : event.button.button == SDL_BUTTON_RIGHT ? 1 : event.button.button == SDL_BUTTON_MIDDLE ? 2 : -1;
+				if (button >= 0) io.AddMouseButtonEvent(button, event.type == SDL_EVENT_MOUSE_BUTTON_DOWN);
+			}
+			else if (event.type == SDL_EVENT_KEY_DOWN || event.type == SDL_EVENT_KEY_UP) {
+				bool down = event.type == SDL_EVENT_KEY_DOWN;
+				io.AddKeyEvent(ImGuiMod_Ctrl, (event.key.mod & SDL_KMOD_CTRL) != 0);
+				io.AddKeyEvent(ImGuiMod_Shift, (event.key.mod & SDL_KMOD_SHIFT) != 0);
+				io.AddKeyEvent(ImGuiMod_Alt, (event.key.mod & SDL_KMOD_ALT) != 0);
+				io.AddKeyEvent(ImGuiMod_Super, (event.key.mod & SDL_KMOD_GUI) != 0);
+
+				ImGuiKey key = ImGui_ImplSDL3_KeyEventToImGuiKey(event.key.key, event.key.scancode);
+				if (key != ImGuiKey_None) io.AddKeyEvent(key, down);
+			}
+		}
 
-				case SDL_EVENT_KEY_DOWN:
-				{
-					mApp->OnKeyPress((Input::Keycode)event.key.scancode, (Input::Keymod)event.key.mod, false);
-					break;
-				}
+		switch (event.type)
+		{
+			case SDL_EVENT_QUIT:
+			{
+				mShouldClose = true;
+				break;
+			}
 
-				case SDL_EVENT_KEY_UP:
-				{
-					mApp->OnKeyRelease((Input::Keycode)event.key.scancode);
-					break;
-				}
+			case SDL_EVENT_KEY_DOWN:
+			{
+				if (event.key.scancode < KEY_COUNT) mKeysDown[event.key.scancode] = true;
+				mApp->OnKeyPress((Input::Keycode)event.key.scancode, (Input::Keymod)event.key.mod, false);
+				break;
+			}
 
-				case SDL_EVENT_MOUSE_BUTTON_DOWN:
-				{
-					mApp->OnButtonPress((Input::Buttoncode)event.button.button, Input::Keymod::KEYMOD_NONE);
-					break;
-				}
+			case SDL_EVENT_KEY_UP:
+			{
+				if (event.key.scancode < KEY_COUNT) mKeysDown[event.key.scancode] = false;
+				mApp->OnKeyRelease((Input::Keycode)event.key.scancode);
+				break;
+			}
 
-				case SDL_EVENT_MOUSE_BUTTON_UP:
-				{
-					mApp->OnButtonRelease((Input::Buttoncode)event.button.button);
-					break;
-				}
+			case SDL_EVENT_MOUSE_BUTTON_DOWN:
+			{
+				mApp->OnButtonPress((Input::Buttoncode)event.button.button, Input::Keymod::KEYMOD_NONE);
+				break;
+			}
 
-				case SDL_EVENT_MOUSE_WHEEL:
-				{
-					mApp->OnMouseScroll((double)event.wheel.x, -event.wheel.y);
-					break;
-				}
+			case SDL_EVENT_MOUSE_BUTTON_UP:
+			{
+				mApp->OnButtonRelease((Input::Buttoncode)event.button.button);
+				break;
+			}
 
-				case SDL_EVENT_MOUSE_MOTION:
-				{
-					float2 pos = { event.motion.x, event.motion.y };
-					cren_set_mousepos(mApp->GetRendererRef()->GetCRenContext(), pos);
+			case SDL_EVENT_MOUSE_WHEEL:
+			{
+				mApp->OnMouseScroll((double)event.wheel.x, -event.wheel.y);
+				break;
+			}
 
-					mApp->OnMouseMove((double)event.motion.xrel, (double)event.motion.yrel);
-					break;
-				}
+			case SDL_EVENT_MOUSE_MOTION:
+			{
+				float2 pos = { event.motion.x, event.motion.y };
+				mLastMousePosX = (double)event.motion.x;
+				mLastMousePosY = (double)event.motion.y;
+				cren_set_mousepos(mApp->GetRendererRef()->GetCRenContext(), pos);
 
-				case SDL_EVENT_WINDOW_RESIZED:
-				{
-					mWidth = event.window.data1;
-					mHeight = event.window.data2;
-					mApp->OnResize(event.window.data1, event.window.data2);
-					break;
-				}
+				mApp->OnMouseMove((double)event.motion.xrel, (double)event.motion.yrel);
+				break;
+			}
 
-				case SDL_EVENT_WINDOW_MINIMIZED:
-				{
-					mMinimized = true;
-					mApp->OnMinimize();
-					break;
-				}
+			case SDL_EVENT_WINDOW_RESIZED:
+			{
+				mWidth = event.window.data1;
+				mHeight = event.window.data2;
+				mApp->OnResize(event.window.data1, event.window.data2);
+				break;
+			}
 
-				case SDL_EVENT_WINDOW_RESTORED:
-				{
-					mMinimized = false;
-					mApp->OnRestore(mWidth, mHeight);
-					break;
-				}
+			case SDL_EVENT_WINDOW_MINIMIZED:
+			{
+				mMinimized = true;
+				mApp->OnMinimize();
+				break;
+			}
 
-				case SDL_EVENT_WINDOW_DISPLAY_SCALE_CHANGED:
-				{
-					if (event.type == SDL_EVENT_WINDOW_DISPLAY_SCALE_CHANGED) {
-						mApp->OnDPIChange(SDL_GetWindowDisplayScale(mNativeWindow));
-					}
+			case SDL_EVENT_WINDOW_RESTORED:
+			{
+				mMinimized = false;
+				mApp->OnRestore(mWidth, mHeight);
+				break;
+			}
 
-					break;
+			case SDL_EVENT_WINDOW_DISPLAY_SCALE_CHANGED:
+			{
+				if (event.type == SDL_EVENT_WINDOW_DISPLAY_SCALE_CHANGED && !mHeadless) {
+					mApp->OnDPIChange(SDL_GetWindowDisplayScale(mNativeWindow));
 				}
 
-				default:
-				{
-					break;
-				}
+				break;
+			}
+
+			default:
+			{
+				break;
 			}
 		}
 	}
 
+	bool Window::WaitEvents(double timeout)
+	{
+		if (mHeadless) return false;
+
+		return SDL_WaitEventTimeout(nullptr, (Sint32)(timeout * 1000.0));
+	}
+
 	void Window::ToogleCursor(bool hide)
 	{
+		if (mHeadless) return;
+
 		SDL_SetWindowRelativeMouseMode(mNativeWindow, hide);
 
 		if (!hide) {
@@ -160,12 +245,21 @@ namespace Cosmos
 
 	bool Window::IsKeyDown(Input::Keycode key)
 	{
+		// the live keyboard isn't what a replay is simulating
+		if (mHeadless || mApp->GetInputRecorderRef().IsReplaying()) return key < KEY_COUNT && mKeysDown[key];
+
 		const bool* keyboardState = SDL_GetKeyboardState(NULL);
 		return keyboardState[key] == 1;
 	}
 
     const char *const* Window::GetRequiredExtensions(unsigned int* count)
     {
+		// no surface, no surface extensions
+		if (mHeadless) {
+			*count = 0;
+			return nullptr;
+		}
+
 		return SDL_Vulkan_GetInstanceExtensions(count);
     }
 
@@ -189,6 +283,7 @@ namespace Cosmos
 	float Window::GetRefreshRate()
 	{
 		const float DEFAULT_REFRESH_RATE = 60.0f;
+		if (mHeadless) return DEFAULT_REFRESH_RATE;
 
 		SDL_DisplayID display = SDL_GetDisplayForWindow(mNativeWindow);
 		if (display == 0) {
@@ -213,6 +308,8 @@ namespace Cosmos
 
     float2 Window::GetWindowSize()
     {
+		if (mHeadless) return { (float)mWidth, (float)mHeight };
+
 		int width, height;
 		SDL_GetWindowSize(mNativeWindow, &width, &height);
 
@@ -221,6 +318,8 @@ namespace Cosmos
 
 	float2 Window::GetWindowPos()
 	{
+		if (mHeadless) return { 0.0f, 0.0f };
+
 		int x, y;
 
 		SDL_GetWindowPosition(mNativeWindow, &x, &y);
@@ -230,6 +329,14 @@ namespace Cosmos
     float2 Window::GetCursorPos()
 	{
     	float2 pos = { 0.0f, 0.0f };
+
+		// the replayed cursor, in the same global coordinates as the live one
+		if (mHeadless || mApp->GetInputRecorderRef().IsReplaying()) {
+			float2 windowPos = GetWindowPos();
+			pos = { windowPos.xy.x + (float)mLastMousePosX, windowPos.xy.y + (float)mLastMousePosY };
+			return pos;
+		}
+
 		SDL_GetGlobalMouseState(&pos.xy.x, &pos.xy.y);
 		
     	return pos;
@@ -6,6 +6,7 @@
 
 // forward declarations
 struct SDL_Window;
+union SDL_Event;
 namespace Cosmos { class Application; }
 
 namespace Cosmos
@@ -14,8 +15,8 @@ namespace Cosmos
 	{
 	public:
 
-		/// @brief constructs the window and set's up it's resources 
-		Window(Application* app, const char* title, int width, int height, bool fullscreen, const char* rootPath);
+		/// @brief constructs the window and set's up it's resources, headless creates no native window and only keeps the size
+		Window(Application* app, const char* title, int width, int height, bool fullscreen, const char* rootPath, bool headless = false);
 
 		/// @brief shutsdown the window and it's resources
 		~Window();
@@ -38,15 +39,22 @@ namespace Cosmos
 		/// @brief returns if the window is currently minimized
 		inline bool const IsMinimized() const { return mMinimized; }
 
+		/// @brief returns if there's no native window, there're no events and the renderer has no surface
+		inline bool const IsHeadless() const { return mHeadless; }
+
 	public:
 
 		/// @brief updates the input/output window devices as well as the windows events, call this at the begining of the frame
+		/// events are recorded while the application records a session, and come from the recording instead of sdl while it replays one
 		void OnUpdate();
 
+		/// @brief blocks until an event arrives or timeout seconds pass, without taking the event, returns false on timeout
+		bool WaitEvents(double timeout);
+
 		/// @brief hinds/shows the cursor on the window (locks it within the window if hidden)
 		void ToogleCursor(bool hide);
 
-		/// @brief returns if a key is currently pressed
+		/// @brief returns if a key is currently pressed, while replaying (or headless) it's the state left by the events processed so far
 		bool IsKeyDown(Input::Keycode key);
 
 		/// @brief returns the required extensions by the windowing system
@@ -72,9 +80,19 @@ namespace Cosmos
 		/// @brief returns the window's position
 		float2 GetWindowPos();
 
-		/// @brief returns the cursor position
+		/// @brief returns the cursor position, while replaying (or headless) it's the last position the processed events moved it to
 		float2 GetCursorPos();
 
+	protected:
+
+		/// @brief dispatches an event to the gui and the application
+		void ProcessEvent(SDL_Event& event);
+
+	protected:
+
+		/// @brief how many keys are tracked, sdl's scancode count
+		static constexpr unsigned int KEY_COUNT = 512;
+
 	protected:
 
 		Application* mApp;
@@ -84,7 +102,9 @@ namespace Cosmos
 		int mHeight;
 		bool mShouldClose = false;
 		bool mMinimized = false;
+		bool mHeadless = false;
 		double mLastMousePosX = 0.0;
 		double mLastMousePosY = 0.0;
+		bool mKeysDown[KEY_COUNT] = {};
 	};
 }
\ No newline at end of file
@@ -2,12 +2,21 @@
 
 #include "Core/Application.h"
 #include "Core/Defines.h"
+#include "Core/FramePacer.h"
+#include "Core/FrameStatistics.h"
+#include "Core/IDAuthority.h"
 #include "Core/Input.h"
+#include "Core/InputRecorder.h"
 #include "Core/Renderer.h"
+#include "Core/Scheduler.h"
+#include "Core/StartupGraph.h"
 #include "Core/Window.h"
 
 #include "Scene/Components.h"
+#include "Scene/ComponentSerializer.h"
 #include "Scene/Entity.h"
+#include "Scene/SceneAutosave.h"
+#include "Scene/SceneJournal.h"
 #include "Scene/World.h"
 
 #include "UI/Gizmos.h"
@@ -16,8 +25,14 @@
 #include "UI/Widget.h"
 #include "UI/WidgetTypes.h"
 
+#include "Util/Compression.h"
 #include "Util/Container.h"
 #include "Util/Datafile.h"
+#include "Util/FlatMap.h"
 #include "Util/ID.h"
+#include "Util/JobSystem.h"
 #include "Util/Library.h"
 #include "Util/Memory.h"
+#include "Util/Profiler.h"
+#include "Util/Reflection.h"
+#include "Util/TripleBuffer.h"
@@ -0,0 +1,231 @@
+#include "ComponentSerializer.h"
+#include "Entity.h"
+
+#include <string>
+
+namespace Cosmos
+{
+	/// @brief saves a single component type
+	template<typename T>
+	static void Internal_SaveText(Entity* entity, Datafile& entityNode)
+	{
+		static const std::string key = Reflection::TypeInfo<T>::name;
+
+		T* component = entity->GetComponent<T>();
+		if (component) Reflection::SaveText(*component, entityNode[key]);
+	}
+
+	/// @brief loads a single component type
+	template<typename T>
+	static void Internal_LoadText(Entity* entity, Datafile& entityNode)
+	{
+		static const std::string key = Reflection::TypeInfo<T>::name;
+		Datafile* componentNode = entityNode.Find(key);
+		if (!componentNode) return;
+
+		entity->AddComponent<T>();
+		Reflection::LoadText(*entity->GetComponent<T>(), *componentNode);
+	}
+
+	/// @brief writes a block of a component type: name, block size, count, ids, schema and packed payload
+	template<typename T, typename GetID, typename GetComponent>
+	static void Internal_SaveBinaryBlock(size_t count, GetID getID, GetComponent getComponent, Reflection::BinaryWriter& writer)
+	{
+		constexpr size_t packedSize = Reflection::PackedSize<T>();
+		if (count == 0) return;
+
+		writer.WriteString(Reflection::TypeInfo<T>::name);
+		size_t sizePos = writer.GetBufferRef().size();
+		writer.WriteValue((uint64_t)0); // patched once the block is written
+		size_t blockBegin = writer.GetBufferRef().size();
+
+		writer.WriteValue((uint64_t)count);
+		for (size_t i = 0; i < count; i++) writer.WriteValue(getID(i));
+		Reflection::WriteSchema<T>(writer);
+
+		uint8_t* out = writer.Reserve(count * packedSize);
+		for (size_t i = 0; i < count; i++) {
+			Reflection::WritePacked(getComponent(i), out);
+			out += packedSize;
+		}
+
+		uint64_t blockSize = (uint64_t)(writer.GetBufferRef().size() - blockBegin);
+		std::memcpy(writer.GetBufferRef().data() + sizePos, &blockSize, sizeof(blockSize));
+	}
+
+	/// @brief writes a block with every entity that has the component type
+	template<typename T>
+	static void Internal_SaveBinary(const std::vector<Entity*>& entities, Reflection::BinaryWriter& writer)
+	{
+		std::vector<Entity*> owners;
+		std::vector<const T*> components;
+		owners.reserve(entities.size());
+		components.reserve(entities.size());
+
+		for (Entity* entity : entities) {
+			const T* component = entity ? entity->GetComponent<T>() : nullptr;
+			if (!component) continue;
+
+			owners.push_back(entity);
+			components.push_back(component);
+		}
+
+		Internal_SaveBinaryBlock<T>(owners.size(), [&owners](size_t i) { return owners[i]->GetID(); }, [&components](size_t i) -> const T& { return *components[i]; }, writer);
+	}
+
+	/// @brief writes a block with the captured copies of the component type
+	template<typename T>
+	static void Internal_SaveBinaryArray(const std::vector<std::pair<uint32_t, T>>& components, Reflection::BinaryWriter& writer)
+	{
+		Internal_SaveBinaryBlock<T>(components.size(), [&components](size_t i) { return components[i].first; }, [&components](size_t i) -> const T& { return components[i].second; }, writer);
+	}
+
+	/// @brief reads a block of a known component type, the schema is resolved once for the entire block
+	template<typename T>
+	static bool Internal_LoadBinary(Reflection::BinaryReader& reader, const std::function<Entity*(uint32_t)>& resolve)
+	{
+		uint64_t count = 0;
+		if (!reader.ReadValue(count) || count > reader.Remaining() / sizeof(uint32_t)) return false;
+
+		const uint8_t* ids = reader.Consume((size_t)count * sizeof(uint32_t));
+		Reflection::SchemaMapping mapping;
+		if (!ids || !Reflection::ReadSchema<T>(reader, mapping)) return false;
+
+		const uint8_t* payload = reader.Consume((size_t)count * mapping.packedSize);
+		if (!payload) return false;
+
+		for (uint64_t i = 0; i < count; i++) {
+			uint32_t id;
+			std::memcpy(&id, ids + i * sizeof(uint32_t), sizeof(id));
+
+			Entity* entity = resolve(id);
+			if (!entity) continue;
+
+			entity->AddComponent<T>();
+			Reflection::ReadPacked(*entity->GetComponent<T>(), payload + i * mapping.packedSize, mapping);
+		}
+
+		return true;
+	}
+
+	/// @brief dispatches a block to the component type with the matching name, returns false if no component matches
+	template<typename... Components>
+	static bool Internal_LoadBinaryBlock(ComponentList<Components...>, const std::string& name, Reflection::BinaryReader& reader, const std::function<Entity*(uint32_t)>& resolve, bool& result)
+	{
+		return ((name == Reflection::TypeInfo<Components>::name ? (result = Internal_LoadBinary<Components>(reader, resolve), true) : false) || ...);
+	}
+
+	template<typename... Components>
+	static void Internal_SaveTextAll(ComponentList<Components...>, Entity* entity, Datafile& entityNode)
+	{
+		(Internal_SaveText<Components>(entity, entityNode), ...);
+	}
+
+	template<typename... Components>
+	static void Internal_LoadTextAll(ComponentList<Components...>, Entity* entity, Datafile& entityNode)
+	{
+		(Internal_LoadText<Components>(entity, entityNode), ...);
+	}
+
+	template<typename... Components>
+	static void Internal_SaveBinaryAll(ComponentList<Components...>, const std::vector<Entity*>& entities, Reflection::BinaryWriter& writer)
+	{
+		(Internal_SaveBinary<Components>(entities, writer), ...);
+	}
+
+	template<typename... Components>
+	static void Internal_CaptureAll(ComponentList<Components...>, Entity* entity, SerializableComponentSet& components)
+	{
+		auto capture = [entity](auto& slot) {
+			using T = typename std::decay_t<decltype(slot)>::value_type;
+			const T* component = entity->GetComponent<T>();
+			if (component) slot = *component;
+			else slot.reset();
+			};
+
+		(capture(std::get<std::optional<Components>>(components.components)), ...);
+	}
+
+	template<typename... Components>
+	static void Internal_AppendAll(ComponentList<Components...>, uint32_t id, const SerializableComponentSet& components, SerializableComponentArrays& arrays)
+	{
+		auto append = [id](const auto& slot, auto& array) {
+			if (slot) array.emplace_back(id, *slot);
+			};
+
+		(append(std::get<std::optional<Components>>(components.components), std::get<std::vector<std::pair<uint32_t, Components>>>(arrays.arrays)), ...);
+	}
+
+	template<typename... Components>
+	static void Internal_SaveBinaryArrays(ComponentList<Components...>, const SerializableComponentArrays& components, Reflection::BinaryWriter& writer)
+	{
+		(Internal_SaveBinaryArray<Components>(std::get<std::vector<std::pair<uint32_t, Components>>>(components.arrays), writer), ...);
+	}
+
+	template<typename... Components>
+	static void Internal_RemoveAll(ComponentList<Components...>, Entity* entity)
+	{
+		(entity->RemoveComponent<Components>(), ...);
+	}
+
+	void ComponentSerializer::SaveText(Entity* entity, Datafile& dataFile)
+	{
+		if (!entity) return;
+		Internal_SaveTextAll(SerializableComponents{}, entity, dataFile[std::to_string(entity->GetID())]);
+	}
+
+	void ComponentSerializer::LoadText(Entity* entity, Datafile& entityNode)
+	{
+		if (!entity) return;
+		Internal_LoadTextAll(SerializableComponents{}, entity, entityNode);
+	}
+
+	void ComponentSerializer::SaveBinary(const std::vector<Entity*>& entities, std::vector<uint8_t>& buffer)
+	{
+		Reflection::BinaryWriter writer(buffer);
+		Internal_SaveBinaryAll(SerializableComponents{}, entities, writer);
+	}
+
+	bool ComponentSerializer::LoadBinary(const uint8_t* data, size_t size, const std::function<Entity*(uint32_t)>& resolve)
+	{
+		Reflection::BinaryReader reader(data, size);
+		std::string name;
+
+		while (reader.Remaining() > 0) {
+			uint64_t blockSize = 0;
+			if (!reader.ReadString(name) || !reader.ReadValue(blockSize) || blockSize > reader.Remaining()) return false;
+
+			// each block is parsed on it's own range, so unknown or removed components can be skipped
+			const uint8_t* block = reader.Consume((size_t)blockSize);
+			Reflection::BinaryReader blockReader(block, (size_t)blockSize);
+
+			bool result = true;
+			if (Internal_LoadBinaryBlock(SerializableComponents{}, name, blockReader, resolve, result) && !result) return false;
+		}
+
+		return true;
+	}
+
+	void ComponentSerializer::Capture(Entity* entity, SerializableComponentSet& components)
+	{
+		if (!entity) return;
+		Internal_CaptureAll(SerializableComponents{}, entity, components);
+	}
+
+	void ComponentSerializer::Append(uint32_t id, const SerializableComponentSet& components, SerializableComponentArrays& arrays)
+	{
+		Internal_AppendAll(SerializableComponents{}, id, components, arrays);
+	}
+
+	void ComponentSerializer::SaveBinary(const SerializableComponentArrays& components, std::vector<uint8_t>& buffer)
+	{
+		Reflection::BinaryWriter writer(buffer);
+		Internal_SaveBinaryArrays(SerializableComponents{}, components, writer);
+	}
+
+	void ComponentSerializer::RemoveAll(Entity* entity)
+	{
+		if (!entity) return;
+		Internal_RemoveAll(SerializableComponents{}, entity);
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include "Scene/Components.h"
+#include "Util/Reflection.h"
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+// forward declarations
+namespace Cosmos { class Entity; }
+
+namespace Cosmos
+{
+	/// @brief a compile-time list of component types
+	template<typename... Components>
+	struct ComponentList {};
+
+	/// @brief all components written/read with the scene, a reflected component only needs to be listed here to be serialized
+	using SerializableComponents = ComponentList<TransformComponent, EditorComponent>;
+
+	/// @brief copies of components detached from their entities, one array of (id, component) per component type
+	template<typename List>
+	struct ComponentArrays;
+
+	template<typename... Components>
+	struct ComponentArrays<ComponentList<Components...>>
+	{
+		std::tuple<std::vector<std::pair<uint32_t, Components>>...> arrays;
+	};
+
+	/// @brief copies of every serializable component
+	using SerializableComponentArrays = ComponentArrays<SerializableComponents>;
+
+	/// @brief copies of the components of a single entity, the ones it doesn't have are empty
+	template<typename List>
+	struct ComponentSet;
+
+	template<typename... Components>
+	struct ComponentSet<ComponentList<Components...>>
+	{
+		std::tuple<std::optional<Components>...> components;
+	};
+
+	/// @brief copies of an entity's serializable components
+	using SerializableComponentSet = ComponentSet<SerializableComponents>;
+
+	class COSMOS_API ComponentSerializer
+	{
+	public:
+
+		/// @brief saves all serializable components of the entity into dataFile[id]
+		static void SaveText(Entity* entity, Datafile& dataFile);
+
+		/// @brief loads all serializable components present in the entity's node, adding the ones the entity doesn't have yet
+		static void LoadText(Entity* entity, Datafile& entityNode);
+
+		/// @brief appends the components of many entities into a binary buffer, each component type is written as a single block
+		static void SaveBinary(const std::vector<Entity*>& entities, std::vector<uint8_t>& buffer);
+
+		/// @brief reads components previously written by SaveBinary, resolve must return the entity of a given id (or nullptr to skip it)
+		static bool LoadBinary(const uint8_t* data, size_t size, const std::function<Entity*(uint32_t)>& resolve);
+
+		/// @brief copies the serializable components of an entity into the set, replacing what it held
+		static void Capture(Entity* entity, SerializableComponentSet& components);
+
+		/// @brief appends the components of a set into the arrays, under the id of the entity they were captured from
+		static void Append(uint32_t id, const SerializableComponentSet& components, SerializableComponentArrays& arrays);
+
+		/// @brief appends the captured components into a binary buffer, the output is identical to SaveBinary of the captured entities
+		static void SaveBinary(const SerializableComponentArrays& components, std::vector<uint8_t>& buffer);
+
+		/// @brief removes every serializable component from the entity
+		static void RemoveAll(Entity* entity);
+	};
+}
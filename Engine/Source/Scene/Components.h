@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Util/Datafile.h"
+#include "Util/Reflection.h"
 #include <cren.h>
 #include <vecmath/vecmath.h>
 
@@ -16,12 +16,6 @@ namespace Cosmos
 		/// @brief constructor
 		TransformComponent(float3 translation = { 0.0f, 0.0f, 0.0f }, float3 rotation = { 0.0f, 0.0f, 0.0f }, float3 scale = { 1.0f, 1.0f, 1.0f });
 
-		/// @brief saves the component into a data file
-		static void Save(Entity* entity, Datafile& dataFile);
-
-		/// @brief loads the component into the entity from data file
-		static void Load(Entity* entity, Datafile& dataFile);
-
 	public:
 
 		// returns the transformation matrix
@@ -41,15 +35,20 @@ namespace Cosmos
 		/// @brief constrctor
 		EditorComponent();
 
-		/// @brief saves the component into a data file
-		static void Save(Entity* entity, Datafile& dataFile);
-
-		/// @brief loads the component into the entity from data file
-		static void Load(Entity* entity, Datafile& dataFile);
-
 	public:
 
 		CRenQuad* quad = nullptr;
 		bool visible = true;
 	};
-}
\ No newline at end of file
+}
+
+// serialized fields of each component, these are used to generate the scene serializers
+COSMOS_REFLECT_BEGIN(Cosmos::TransformComponent, "Transform")
+	COSMOS_REFLECT_FIELD(translation, "Translation")
+	COSMOS_REFLECT_FIELD(rotation, "Rotation")
+	COSMOS_REFLECT_FIELD(scale, "Scale")
+COSMOS_REFLECT_END()
+
+COSMOS_REFLECT_BEGIN(Cosmos::EditorComponent, "Editor")
+	COSMOS_REFLECT_FIELD(visible, "Visible")
+COSMOS_REFLECT_END()
@@ -2,13 +2,14 @@
 
 #include "Core/Defines.h"
 #include "Components.h"
+#include "Util/Memory.h"
 #include <any>
 #include <unordered_map>
 #include <typeindex>
 
 namespace Cosmos
 {
-    class COSMOS_API Entity
+    class COSMOS_API Entity : public TaggedObject<CREN_MEMORY_TAG_ENTITIES>
     {
     public:
 
@@ -54,7 +55,7 @@ namespace Cosmos
 
         /// @brief adds a unique type of component to the entity
         template<typename T, typename... Args>
-        void AddComponent() 
+        void AddComponent(Args&&... args)
         {
             if (HasComponent<T>()) return;
 
@@ -78,6 +79,6 @@ namespace Cosmos
 
         const char* mName = nullptr;
         uint32_t mID = 0;
-        std::unordered_map<std::type_index, std::any> mComponents;
+        std::unordered_map<std::type_index, std::any, std::hash<std::type_index>, std::equal_to<std::type_index>, TaggedAllocator<std::pair<const std::type_index, std::any>, CREN_MEMORY_TAG_ENTITIES>> mComponents;
     };
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "SceneAutosave.h"
+#include "ComponentSerializer.h"
+#include "Entity.h"
+#include "SceneJournal.h"
+
+#include <chrono>
+#include <cren_error.h>
+
+namespace Cosmos
+{
+	/// @brief fraction of the progress reported once the payload is encoded, the remaining is the write itself
+	static constexpr float AUTOSAVE_ENCODED_PROGRESS = 0.2f;
+
+	SceneAutosave::~SceneAutosave()
+	{
+		Wait();
+	}
+
+	void SceneAutosave::MarkDirty(uint32_t id)
+	{
+		mRemoved.erase(id);
+		mDirty.insert(id);
+	}
+
+	void SceneAutosave::MarkRemoved(uint32_t id)
+	{
+		mDirty.erase(id);
+		mRemoved.insert(id);
+	}
+
+	bool SceneAutosave::Capture(Library<uint32_t, Entity*>& entities, size_t budget)
+	{
+		if (IsSaving()) return false;
+		Wait();
+
+		auto begin = std::chrono::steady_clock::now();
+
+		// dropping a copy is cheap, the removed entities don't count towards the budget
+		for (uint32_t id : mRemoved) mRecords.Erase(id);
+		mRemoved.clear();
+
+		// the copies are plain data, the entities are free to change once this returns (and are marked again when they do)
+		size_t captured = 0;
+		for (auto it = mDirty.begin(); it != mDirty.end() && captured < budget; it = mDirty.erase(it), captured++) {
+			Entity* entity = entities.Get(*it).value_or(nullptr);
+			if (!entity) {
+				mRecords.Erase(*it);
+				continue;
+			}
+
+			Record* record = mRecords.TryGet(*it);
+			if (!record) {
+				mRecords.Insert(*it, Record());
+				record = mRecords.TryGet(*it);
+			}
+
+			const char* name = entity->GetName();
+			record->name = name ? name : "";
+			ComponentSerializer::Capture(entity, record->components);
+		}
+
+		mLastCaptureTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		return mDirty.empty();
+	}
+
+	bool SceneAutosave::Start(const std::string& path)
+	{
+		if (IsSaving() || !mDirty.empty() || !mRemoved.empty()) return false;
+		Wait();
+
+		mProgress.store(0.0f, std::memory_order_relaxed);
+		mSaving.store(true, std::memory_order_release);
+
+		mThread = std::thread([this, path]() {
+
+			// the copy isn't changed until the save is over, the names point into it
+			std::vector<std::pair<uint32_t, const char*>> names;
+			SerializableComponentArrays components;
+			names.reserve(mRecords.Size());
+
+			for (const auto& [id, record] : mRecords.GetAllRef()) {
+				names.emplace_back(id, record.name.c_str());
+				ComponentSerializer::Append(id, record.components, components);
+			}
+
+			std::vector<uint8_t> payload;
+			SceneJournal::EncodeSnapshot(names, components, payload);
+			mProgress.store(AUTOSAVE_ENCODED_PROGRESS, std::memory_order_relaxed);
+
+			bool result = SceneJournal::WriteSnapshotFile(path, payload, [this](float progress) {
+				mProgress.store(AUTOSAVE_ENCODED_PROGRESS + progress * (1.0f - AUTOSAVE_ENCODED_PROGRESS), std::memory_order_relaxed);
+				});
+
+			if (!result) {
+				CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to autosave scene into %s", path.c_str());
+			}
+
+			mProgress.store(1.0f, std::memory_order_relaxed);
+			mLastResult.store(result, std::memory_order_release);
+			mSaving.store(false, std::memory_order_release);
+			});
+
+		return true;
+	}
+
+	void SceneAutosave::Wait()
+	{
+		if (mThread.joinable()) {
+			mThread.join();
+		}
+	}
+}
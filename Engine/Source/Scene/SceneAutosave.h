@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include "Scene/ComponentSerializer.h"
+#include "Util/Library.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+// forward declarations
+namespace Cosmos { class Entity; }
+
+namespace Cosmos
+{
+	/// @brief saves a scene without blocking the caller
+	/// it keeps a copy of every entity's name and serializable components, the calling thread only re-captures the entities marked since
+	/// (a bounded amount per call), walking the whole copy, encoding it and the durable write happen on a background thread
+	class COSMOS_API SceneAutosave
+	{
+	public:
+
+		/// @brief constructor
+		SceneAutosave() = default;
+
+		/// @brief destructor, waits for the save in flight
+		~SceneAutosave();
+
+		/// @brief returns if a save is currently in flight
+		inline bool IsSaving() const { return mSaving.load(std::memory_order_acquire); }
+
+		/// @brief returns the progress of the save in flight, in [0, 1]
+		inline float GetProgress() const { return mProgress.load(std::memory_order_relaxed); }
+
+		/// @brief returns if the last finished save succeeded
+		inline bool GetLastResult() const { return mLastResult.load(std::memory_order_acquire); }
+
+		/// @brief returns how long the last capture took on the calling thread, in milliseconds
+		inline double GetLastCaptureTime() const { return mLastCaptureTime; }
+
+	public:
+
+		/// @brief the entity was added or changed, it's copy is captured again
+		void MarkDirty(uint32_t id);
+
+		/// @brief the entity is gone, it's copy is dropped
+		void MarkRemoved(uint32_t id);
+
+		/// @brief captures up to budget of the marked entities, returns true once the copy is up to date (false while a save is in flight)
+		bool Capture(Library<uint32_t, Entity*>& entities, size_t budget);
+
+		/// @brief starts writing the copy into path on a background thread, returns false if a save is in flight or entities are still marked
+		bool Start(const std::string& path);
+
+		/// @brief blocks until the save in flight (if any) finishes
+		void Wait();
+
+	private:
+
+		/// @brief what's kept of an entity, the name is copied so the entity may be renamed or destroyed while saving
+		struct Record
+		{
+			std::string name;
+			SerializableComponentSet components;
+		};
+
+	private:
+
+		Library<uint32_t, Record> mRecords; // only read by the save in flight, changed by Capture while none is
+		std::unordered_set<uint32_t> mDirty;
+		std::unordered_set<uint32_t> mRemoved;
+		std::thread mThread;
+		std::atomic<bool> mSaving = false;
+		std::atomic<bool> mLastResult = true;
+		std::atomic<float> mProgress = 0.0f;
+		double mLastCaptureTime = 0.0;
+	};
+}
@@ -0,0 +1,365 @@
+#include "SceneJournal.h"
+#include "ComponentSerializer.h"
+#include "Entity.h"
+
+#include "Util/Compression.h"
+#include "Util/Memory.h"
+#include "Util/Reflection.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cren_error.h>
+
+namespace Cosmos
+{
+	/// @brief every record starts with magic, payload size and payload checksum
+	static constexpr uint32_t JOURNAL_SNAPSHOT_MAGIC = 0x4E535343; // "CSSN"
+	static constexpr uint32_t JOURNAL_DELTA_MAGIC = 0x524A5343; // "CSJR"
+	static constexpr uint32_t JOURNAL_COMPRESSED_SNAPSHOT_MAGIC = 0x5A535343; // "CSSZ", the payload is a Compression container
+	static constexpr uint32_t JOURNAL_COMPRESSED_DELTA_MAGIC = 0x5A4A5343; // "CSJZ"
+	static constexpr size_t JOURNAL_RECORD_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
+
+	/// @brief payloads smaller than this are written as they are, the container's header and index would outweigh what's saved
+	static constexpr size_t JOURNAL_COMPRESSION_MIN_SIZE = 4 * 1024;
+
+	/// @brief the journal is folded into the snapshot once it grows past half the snapshot size (and at least this many bytes)
+	static constexpr uint64_t JOURNAL_MIN_COMPACTION_SIZE = 1024 * 1024;
+
+	/// @brief fnv-1a, cheap enough to run on every record and enough to detect torn writes
+	static uint32_t Internal_Checksum(const uint8_t* data, size_t size)
+	{
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= data[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	/// @brief payloads are written in chunks of this size, so progress can be reported while writting
+	static constexpr size_t JOURNAL_WRITE_CHUNK_SIZE = 1024 * 1024;
+
+	/// @brief writes a record (header + payload) into a file, only returning once it reached the disk, outSize receives the record's size on disk
+	/// payloads big enough are block-compressed, the record is written with the compressed variant of magic unless compressing didn't pay off
+	static bool Internal_WriteRecord(const std::string& path, uint32_t magic, const std::vector<uint8_t>& uncompressed, bool append, const std::function<void(float)>& onProgress = {}, uint64_t* outSize = nullptr)
+	{
+		std::vector<uint8_t> compressed;
+		if (uncompressed.size() >= JOURNAL_COMPRESSION_MIN_SIZE) {
+			Compression::Compress(uncompressed.data(), uncompressed.size(), compressed);
+			if (compressed.size() < uncompressed.size()) magic = magic == JOURNAL_SNAPSHOT_MAGIC ? JOURNAL_COMPRESSED_SNAPSHOT_MAGIC : JOURNAL_COMPRESSED_DELTA_MAGIC;
+		}
+
+		const std::vector<uint8_t>& payload = magic == JOURNAL_COMPRESSED_SNAPSHOT_MAGIC || magic == JOURNAL_COMPRESSED_DELTA_MAGIC ? compressed : uncompressed;
+		if (outSize) *outSize = JOURNAL_RECORD_HEADER_SIZE + payload.size();
+
+		std::vector<uint8_t> header;
+		Reflection::BinaryWriter writer(header);
+		writer.WriteValue(magic);
+		writer.WriteValue((uint64_t)payload.size());
+		writer.WriteValue(Internal_Checksum(payload.data(), payload.size()));
+
+		FILE* file = std::fopen(path.c_str(), append ? "ab" : "wb");
+		if (!file) return false;
+
+		bool result = std::fwrite(header.data(), 1, header.size(), file) == header.size();
+		for (size_t written = 0; result && written < payload.size(); written += JOURNAL_WRITE_CHUNK_SIZE) {
+			size_t chunk = std::min(JOURNAL_WRITE_CHUNK_SIZE, payload.size() - written);
+			result &= std::fwrite(payload.data() + written, 1, chunk, file) == chunk;
+			if (onProgress) onProgress((float)(written + chunk) / (float)payload.size());
+		}
+
+		result &= std::fflush(file) == 0;
+
+		#if defined(_WIN32)
+		result &= _commit(_fileno(file)) == 0;
+		#else
+		result &= fsync(fileno(file)) == 0;
+		#endif
+
+		result &= std::fclose(file) == 0;
+		return result;
+	}
+
+	/// @brief reads every valid record of a file, stopping at the first torn/corrupted one, returns how many bytes were valid
+	static uint64_t Internal_ReadRecords(const std::string& path, const std::function<bool(const uint8_t*, size_t)>& onRecord)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) return 0;
+
+		std::streamoff fileSize = file.tellg();
+		if (fileSize <= 0) return 0;
+
+		std::vector<uint8_t> contents((size_t)fileSize);
+		file.seekg(0, std::ios::beg);
+		file.read((char*)contents.data(), fileSize);
+		MemoryTrackScope trackedFile(CREN_MEMORY_TAG_DATAFILE, contents.size());
+
+		Reflection::BinaryReader reader(contents.data(), contents.size());
+		uint64_t validSize = 0;
+		std::string decompressed;
+
+		while (reader.Remaining() >= JOURNAL_RECORD_HEADER_SIZE) {
+			uint32_t magic = 0, checksum = 0;
+			uint64_t size = 0;
+			reader.ReadValue(magic);
+			reader.ReadValue(size);
+			reader.ReadValue(checksum);
+
+			bool compressed = magic == JOURNAL_COMPRESSED_SNAPSHOT_MAGIC || magic == JOURNAL_COMPRESSED_DELTA_MAGIC;
+			if ((magic != JOURNAL_SNAPSHOT_MAGIC && magic != JOURNAL_DELTA_MAGIC && !compressed) || size > reader.Remaining()) break;
+
+			const uint8_t* payload = reader.Consume((size_t)size);
+			if (Internal_Checksum(payload, (size_t)size) != checksum) break;
+
+			if (compressed) {
+				if (!Compression::Decompress(payload, (size_t)size, decompressed)) break;
+				if (!onRecord((const uint8_t*)decompressed.data(), decompressed.size())) break;
+			}
+
+			else if (!onRecord(payload, (size_t)size)) break;
+
+			validSize += JOURNAL_RECORD_HEADER_SIZE + size;
+		}
+
+		return validSize;
+	}
+
+	/// @brief entities decoded from files without a world, used by the compaction
+	struct ShadowEntity
+	{
+		std::string name;
+		Unique<Entity> entity;
+
+		~ShadowEntity()
+		{
+			ComponentSerializer::RemoveAll(entity.get());
+		}
+	};
+
+	SceneJournal::~SceneJournal()
+	{
+		WaitCompaction();
+	}
+
+	bool SceneJournal::WriteSnapshot(const std::string& path, const std::vector<Entity*>& entities)
+	{
+		Bind(path);
+
+		std::vector<uint8_t> payload;
+		EncodeRecord(entities, {}, payload);
+		if (!WriteSnapshotFile(path, payload)) return false;
+
+		std::error_code ec;
+		std::filesystem::remove(path + ".journal", ec);
+		std::filesystem::remove(path + ".compacting", ec);
+
+		uint64_t snapshotSize = std::filesystem::file_size(path, ec);
+		mSnapshotSize = ec ? 0 : snapshotSize;
+		mJournalSize = 0;
+		return true;
+	}
+
+	bool SceneJournal::Append(const std::vector<Entity*>& changed, const std::vector<uint32_t>& removed)
+	{
+		if (mPath.empty()) return false;
+		if (changed.empty() && removed.empty()) return true;
+
+		std::vector<uint8_t> payload;
+		EncodeRecord(changed, removed, payload);
+
+		uint64_t recordSize = 0;
+		if (!Internal_WriteRecord(mPath + ".journal", JOURNAL_DELTA_MAGIC, payload, true, {}, &recordSize)) return false;
+		mJournalSize += recordSize;
+
+		if (mJournalSize > JOURNAL_MIN_COMPACTION_SIZE && mJournalSize > mSnapshotSize / 2) {
+			StartCompaction();
+		}
+
+		return true;
+	}
+
+	bool SceneJournal::Read(const std::string& path, const EntityResolver& resolve, const EntityRemover& remove)
+	{
+		Bind(path);
+
+		auto onRecord = [&resolve, &remove](const uint8_t* data, size_t size) { return DecodeRecord(data, size, resolve, remove); };
+
+		mSnapshotSize = Internal_ReadRecords(path, onRecord);
+		uint64_t compactingSize = Internal_ReadRecords(path + ".compacting", onRecord);
+		mJournalSize = Internal_ReadRecords(path + ".journal", onRecord) + compactingSize;
+
+		// a torn record at the end of the journal would hide every record appended after it, cut it off
+		std::error_code ec;
+		std::string journalPath = path + ".journal";
+		if (std::filesystem::exists(journalPath, ec) && std::filesystem::file_size(journalPath, ec) != mJournalSize - compactingSize) {
+			CREN_LOG(CREN_LOG_SEVERITY_WARN, "Scene journal %s has a torn record, recovering up to the last valid one", journalPath.c_str());
+			std::filesystem::resize_file(journalPath, mJournalSize - compactingSize, ec);
+		}
+
+		return mSnapshotSize > 0 || mJournalSize > 0;
+	}
+
+	void SceneJournal::WaitCompaction()
+	{
+		if (mCompactionThread.joinable()) {
+			mCompactionThread.join();
+		}
+	}
+
+	void SceneJournal::EncodeRecord(const std::vector<Entity*>& entities, const std::vector<uint32_t>& removed, std::vector<uint8_t>& payload)
+	{
+		Reflection::BinaryWriter writer(payload);
+
+		writer.WriteValue((uint64_t)removed.size());
+		writer.Write(removed.data(), removed.size() * sizeof(uint32_t));
+
+		writer.WriteValue((uint64_t)entities.size());
+		for (Entity* entity : entities) {
+			writer.WriteValue(entity->GetID());
+			writer.WriteString(entity->GetName());
+		}
+
+		ComponentSerializer::SaveBinary(entities, payload);
+	}
+
+	void SceneJournal::EncodeSnapshot(const std::vector<std::pair<uint32_t, const char*>>& entities, const SerializableComponentArrays& components, std::vector<uint8_t>& payload)
+	{
+		Reflection::BinaryWriter writer(payload);
+
+		writer.WriteValue((uint64_t)0);
+		writer.WriteValue((uint64_t)entities.size());
+		for (const auto& [id, name] : entities) {
+			writer.WriteValue(id);
+			writer.WriteString(name);
+		}
+
+		ComponentSerializer::SaveBinary(components, payload);
+	}
+
+	bool SceneJournal::WriteSnapshotFile(const std::string& path, const std::vector<uint8_t>& payload, const std::function<void(float)>& onProgress)
+	{
+		std::error_code ec;
+		std::filesystem::path parent = std::filesystem::path(path).parent_path();
+		if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+
+		// written aside and renamed, a crash never leaves a half-written snapshot
+		std::string tmpPath = path + ".tmp";
+		if (!Internal_WriteRecord(tmpPath, JOURNAL_SNAPSHOT_MAGIC, payload, false, onProgress)) return false;
+
+		std::filesystem::rename(tmpPath, path, ec);
+		return !ec;
+	}
+
+	bool SceneJournal::DecodeRecord(const uint8_t* data, size_t size, const EntityResolver& resolve, const EntityRemover& remove)
+	{
+		Reflection::BinaryReader reader(data, size);
+
+		uint64_t removedCount = 0;
+		if (!reader.ReadValue(removedCount) || removedCount > reader.Remaining() / sizeof(uint32_t)) return false;
+
+		for (uint64_t i = 0; i < removedCount; i++) {
+			uint32_t id = 0;
+			reader.ReadValue(id);
+			remove(id);
+		}
+
+		uint64_t entityCount = 0;
+		if (!reader.ReadValue(entityCount)) return false;
+
+		std::unordered_map<uint32_t, Entity*> entities;
+		entities.reserve((size_t)std::min<uint64_t>(entityCount, reader.Remaining()));
+
+		std::string name;
+		for (uint64_t i = 0; i < entityCount; i++) {
+			uint32_t id = 0;
+			if (!reader.ReadValue(id) || !reader.ReadString(name)) return false;
+			entities[id] = resolve(id, name.c_str());
+		}
+
+		size_t componentsSize = reader.Remaining();
+		const uint8_t* components = reader.Consume(componentsSize);
+
+		return ComponentSerializer::LoadBinary(components, componentsSize, [&entities](uint32_t id) -> Entity* {
+			auto it = entities.find(id);
+			return it != entities.end() ? it->second : nullptr;
+			});
+	}
+
+	void SceneJournal::Bind(const std::string& path)
+	{
+		WaitCompaction();
+		mPath = path;
+	}
+
+	void SceneJournal::StartCompaction()
+	{
+		if (mCompacting.load(std::memory_order_acquire)) return;
+		WaitCompaction();
+
+		// new records go into a fresh journal while the rotated one is folded, a leftover from a crashed compaction is folded first
+		std::error_code ec;
+		std::string compactingPath = mPath + ".compacting";
+		if (!std::filesystem::exists(compactingPath, ec)) {
+			std::filesystem::rename(mPath + ".journal", compactingPath, ec);
+			if (ec) return;
+			mJournalSize = 0;
+		}
+
+		mCompacting.store(true, std::memory_order_release);
+		mCompactionThread = std::thread([this, path = mPath]() {
+			uint64_t snapshotSize = Compact(path);
+			if (snapshotSize > 0) mSnapshotSize = snapshotSize;
+			mCompacting.store(false, std::memory_order_release);
+			});
+	}
+
+	uint64_t SceneJournal::Compact(const std::string& path)
+	{
+		std::unordered_map<uint32_t, ShadowEntity> shadows;
+
+		// every upsert carries the entire entity, so a fresh shadow replaces the previous one
+		auto resolve = [&shadows](uint32_t id, const char* name) -> Entity* {
+			shadows.erase(id);
+			ShadowEntity& shadow = shadows[id];
+			shadow.name = name;
+			shadow.entity = CreateUnique<Entity>(shadow.name.c_str(), id);
+			return shadow.entity.get();
+			};
+
+		auto remove = [&shadows](uint32_t id) { shadows.erase(id); };
+		auto onRecord = [&resolve, &remove](const uint8_t* data, size_t size) { return DecodeRecord(data, size, resolve, remove); };
+
+		Internal_ReadRecords(path, onRecord);
+		Internal_ReadRecords(path + ".compacting", onRecord);
+
+		// snapshots are sorted by id, keeping them stable between compactions
+		std::vector<Entity*> entities;
+		entities.reserve(shadows.size());
+		for (auto& [id, shadow] : shadows) entities.push_back(shadow.entity.get());
+		std::sort(entities.begin(), entities.end(), [](Entity* a, Entity* b) { return a->GetID() < b->GetID(); });
+
+		std::vector<uint8_t> payload;
+		EncodeRecord(entities, {}, payload);
+
+		if (!WriteSnapshotFile(path, payload)) {
+			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to write compacted scene snapshot %s", path.c_str());
+			return 0;
+		}
+
+		// replaying the folded journal again would be harmless, so a crash before this point loses nothing
+		std::error_code ec;
+		std::filesystem::remove(path + ".compacting", ec);
+
+		uint64_t snapshotSize = std::filesystem::file_size(path, ec);
+		return ec ? 0 : snapshotSize;
+	}
+}
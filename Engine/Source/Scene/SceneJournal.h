@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include "Scene/ComponentSerializer.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Cosmos
+{
+	/// @brief persists a scene as a binary snapshot plus an append-only journal of delta records
+	/// files used for a scene at 'path':
+	///  - path             : the last full snapshot
+	///  - path.journal     : delta records appended since the last snapshot
+	///  - path.compacting  : journal being folded into a new snapshot by the background compaction
+	/// every record is checksummed, so a torn record left by a crash is detected and ignored while everything before it is recovered
+	/// payloads of a few kilobytes or more are stored block-compressed (Util/Compression), records flag it with their magic
+	class COSMOS_API SceneJournal
+	{
+	public:
+
+		/// @brief an entity entry found while reading the scene, returns the entity components should be loaded into (or nullptr to skip)
+		using EntityResolver = std::function<Entity*(uint32_t id, const char* name)>;
+
+		/// @brief an entity removal found while reading the scene
+		using EntityRemover = std::function<void(uint32_t id)>;
+
+	public:
+
+		/// @brief constructor
+		SceneJournal() = default;
+
+		/// @brief destructor, waits for any compaction in flight
+		~SceneJournal();
+
+		/// @brief returns the snapshot path of the scene currently bound to the journal
+		inline const std::string& GetPath() const { return mPath; }
+
+		/// @brief returns if a background compaction is currently running
+		inline bool IsCompacting() const { return mCompacting.load(std::memory_order_acquire); }
+
+		/// @brief returns how many bytes the journal has accumulated since the last snapshot
+		inline uint64_t GetJournalSize() const { return mJournalSize; }
+
+	public:
+
+		/// @brief writes a full snapshot with every entity and discards the journal, binding the journal to path
+		bool WriteSnapshot(const std::string& path, const std::vector<Entity*>& entities);
+
+		/// @brief appends a record with the changed entities and the removed ids into the bound scene, starting a background compaction when the journal grew too much
+		bool Append(const std::vector<Entity*>& changed, const std::vector<uint32_t>& removed);
+
+		/// @brief reads the snapshot and replays every journal record after it, binding the journal to path
+		bool Read(const std::string& path, const EntityResolver& resolve, const EntityRemover& remove);
+
+		/// @brief blocks until the background compaction (if any) finishes
+		void WaitCompaction();
+
+	public:
+
+		/// @brief encodes entities and removals into a record payload
+		static void EncodeRecord(const std::vector<Entity*>& entities, const std::vector<uint32_t>& removed, std::vector<uint8_t>& payload);
+
+		/// @brief encodes a snapshot payload from components captured with ComponentSerializer::Capture, it doesn't touch any entity
+		static void EncodeSnapshot(const std::vector<std::pair<uint32_t, const char*>>& entities, const SerializableComponentArrays& components, std::vector<uint8_t>& payload);
+
+		/// @brief durably writes a snapshot payload into path, replacing it only once fully written, onProgress receives [0, 1] while writting
+		static bool WriteSnapshotFile(const std::string& path, const std::vector<uint8_t>& payload, const std::function<void(float)>& onProgress = {});
+
+		/// @brief decodes a record payload, returns false if it's malformed
+		static bool DecodeRecord(const uint8_t* data, size_t size, const EntityResolver& resolve, const EntityRemover& remove);
+
+	private:
+
+		/// @brief binds the journal to a scene, waiting for a compaction of a previous scene
+		void Bind(const std::string& path);
+
+		/// @brief rotates the journal and folds it into a new snapshot on a background thread
+		void StartCompaction();
+
+		/// @brief compaction body, reads snapshot + rotated journal and writes them as a single snapshot, returns the new snapshot size or 0 on failure
+		static uint64_t Compact(const std::string& path);
+
+	private:
+
+		std::string mPath = {};
+		std::atomic<uint64_t> mSnapshotSize = 0;
+		uint64_t mJournalSize = 0;
+		std::thread mCompactionThread;
+		std::atomic<bool> mCompacting = false;
+	};
+}
@@ -4,8 +4,14 @@
 #include "Entity.h"
 #include "Components.h"
 
+#include <filesystem>
+#include <unordered_map>
+
 namespace Cosmos
 {
+	/// @brief how many changed entities the autosave re-captures per frame, bounding the time it takes from the simulation
+	static constexpr size_t AUTOSAVE_CAPTURE_BUDGET = 4096;
+
 	World::World(Application* app, Unique<Renderer>& renderer)
 		: mApp(app), mRenderer(renderer)
 	{
@@ -24,12 +30,13 @@ namespace Cosmos
 			return false;
 		}
 
+		MarkDirty(entity->GetID());
 		return mEntities.Insert(entity->GetID(), entity);
 	}
 
 	bool World::CreateEntity(const char* name, const float3& pos)
 	{
-		uint32_t id = cren_create_id(mRenderer->GetCRenContext());
+		uint32_t id = mRenderer->GetIDAuthorityRef().Create();
 		if (id == 0) {
 			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "The renderer could not create a unique ID");
 			return false;
@@ -53,6 +60,7 @@ namespace Cosmos
 		cren_quad_set_billboard(mRenderer->GetCRenContext(), newEnt->GetComponent<EditorComponent>()->quad, true);
 
 		mEntities.Insert(id, newEnt);
+		MarkDirty(id);
 		CREN_LOG(CREN_LOG_SEVERITY_INFO, "Created object %d at %.2f/%.2f/%.2f", id, pos.xyz.x, pos.xyz.y, pos.xyz.z);
 		return true;
 	}
@@ -75,7 +83,7 @@ namespace Cosmos
 		if(entity->HasComponent<EditorComponent>()) 
 		{
 			if (entity->GetComponent<EditorComponent>()->quad) {
-				cren_quad_destroy(mRenderer->GetCRenContext(), entity->GetComponent<EditorComponent>()->quad);
+				mRenderer->DestroyQuad(entity->GetComponent<EditorComponent>()->quad); // frames in flight may still draw it
 			}
 			entity->RemoveComponent<EditorComponent>();
 		}
@@ -85,10 +93,14 @@ namespace Cosmos
 		}
 		
 		mEntities.Erase(idValue);
+		mDirtyEntities.erase(idValue);
+		mRemovedEntities.insert(idValue);
+		mAutosave.MarkRemoved(idValue);
+		mModificationCount++;
 		delete entity;
-		bool deletedIDRes = mIDGenerator.Destroy((ID)(idValue));
+		mRenderer->GetIDAuthorityRef().Destroy(idValue);
 		
-		return deletedIDRes;
+		return true;
 	}
 
 	Entity* World::ExtractEntity(uint32_t idValue)
@@ -101,7 +113,10 @@ namespace Cosmos
 		
 		Entity* entity = found.value();
 		mEntities.Erase(idValue);
-		mIDGenerator.Destroy(idValue);
+		mDirtyEntities.erase(idValue);
+		mRemovedEntities.insert(idValue);
+		mAutosave.MarkRemoved(idValue);
+		mModificationCount++;
 		
 		return entity;
 	}
@@ -121,15 +136,181 @@ namespace Cosmos
 		return mEntities.Get(idValue).value_or(nullptr);
 	}
 
-	void World::OnUpdate(float timestep)
+	void World::MarkDirty(uint32_t idValue)
 	{
-		// not doing anything for now
+		mRemovedEntities.erase(idValue);
+		mDirtyEntities.insert(idValue);
+		mAutosave.MarkDirty(idValue);
+		mModificationCount++;
 	}
 
-	void World::OnRender(float timestep, int32_t stage)
+	bool World::SaveScene(const std::string& path)
 	{
+		std::vector<Entity*> entities;
+		bool result = false;
+
+		// an autosave in flight could finish after this save and look newer than it on load, it's waited for and dropped below
+		mAutosave.Wait();
+
+		// a different scene (or one deleted from disk) needs a full snapshot, afterwards only the modified entities are journaled
+		if (mJournal.GetPath() != path || !std::filesystem::exists(path)) {
+			entities.reserve(mEntities.Size());
+			for (auto& [id, entity] : mEntities) {
+				if (entity) entities.push_back(entity);
+			}
+
+			result = mJournal.WriteSnapshot(path, entities);
+			CREN_LOG(CREN_LOG_SEVERITY_INFO, "Saved scene snapshot %s with %zu entities", path.c_str(), entities.size());
+		}
+
+		else {
+			entities.reserve(mDirtyEntities.size());
+			for (uint32_t id : mDirtyEntities) {
+				Entity* entity = FindEntityByID(id);
+				if (entity) entities.push_back(entity);
+			}
+
+			std::vector<uint32_t> removed(mRemovedEntities.begin(), mRemovedEntities.end());
+			result = mJournal.Append(entities, removed);
+			CREN_LOG(CREN_LOG_SEVERITY_INFO, "Saved scene %s, %zu modified and %zu removed entities", path.c_str(), entities.size(), removed.size());
+		}
+
+		if (!result) {
+			CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Failed to save scene %s", path.c_str());
+			return false;
+		}
+
+		// the scene holds everything the autosave had, it must not be recovered from anymore
+		std::error_code ec;
+		std::filesystem::remove(path + ".autosave", ec);
+
+		// the autosave's copy is rebuilt from the loaded entities, a few of them on each frame it runs
+		for (auto& [id, entity] : mEntities) mAutosave.MarkDirty(id);
+
+		mDirtyEntities.clear();
+		mRemovedEntities.clear();
+		mScenePath = path;
+		mSavedModificationCount = mModificationCount;
+		mAutosaveTimer = 0.0f;
+		return true;
+	}
+
+	bool World::LoadScene(const std::string& path)
+	{
+		Destroy();
+
+		// cached ids are returned, so the ids saved in the scene are free to be registered again
+		IDAuthority& ids = mRenderer->GetIDAuthorityRef();
+		ids.Flush();
+
+		// a saved id already in use (by another world) gives the entity a new id, picking ids must stay unique
+		std::unordered_map<uint32_t, uint32_t> remapped;
+
+		auto resolve = [this, &ids, &remapped](uint32_t id, const char* name) -> Entity* {
+			auto it = remapped.find(id);
+			if (it != remapped.end()) id = it->second;
+
+			Entity* entity = FindEntityByID(id);
+			if (entity) return entity; // a newer record of the same entity overwrites it's components
+
+			if (!ids.Register(id)) {
+				uint32_t newID = ids.Create();
+				if (newID == 0) {
+					CREN_LOG(CREN_LOG_SEVERITY_ERROR, "Skipping entity %s, id %d is in use and the id space is exhausted", name, id);
+					return nullptr;
+				}
+
+				CREN_LOG(CREN_LOG_SEVERITY_WARN, "Entity %s id %d is already in use, remapped to %d", name, id, newID);
+				remapped[id] = newID;
+				id = newID;
+			}
+
+			entity = new Entity(InternName(name), id);
+			mEntities.Insert(id, entity);
+			return entity;
+			};
+
+		auto remove = [this, &remapped](uint32_t id) {
+			auto it = remapped.find(id);
+			if (it != remapped.end()) {
+				DestroyEntity(it->second);
+				remapped.erase(it);
+				return;
+			}
+
+			DestroyEntity(id);
+			};
+
+		// an autosave newer than the scene and it's journal means the editor exited without saving, recover from it
+		std::string source = path;
+		std::string autosavePath = path + ".autosave";
+		std::error_code ec;
+
+		if (std::filesystem::exists(autosavePath, ec)) {
+			auto autosaveTime = std::filesystem::last_write_time(autosavePath, ec);
+			bool newer = true;
+
+			for (const std::string& saved : { path, path + ".journal" }) {
+				if (std::filesystem::exists(saved, ec) && std::filesystem::last_write_time(saved, ec) >= autosaveTime) newer = false;
+			}
+
+			if (newer) {
+				CREN_LOG(CREN_LOG_SEVERITY_WARN, "Recovering scene %s from it's newer autosave", path.c_str());
+				source = autosavePath;
+			}
+		}
+
+		bool result = mJournal.Read(source, resolve, remove);
+
+		// gpu resources are not part of the scene, they're re-created for the loaded entities
 		CRenContext* context = mRenderer->GetCRenContext();
+		for (auto& [id, entity] : mEntities) {
+			EditorComponent* editorComponent = entity ? entity->GetComponent<EditorComponent>() : nullptr;
+			if (!editorComponent || editorComponent->quad) continue;
+
+			editorComponent->quad = cren_quad_create(context, mApp->GetAssetPath("textures/entity.png").c_str(), id);
+			cren_quad_set_billboard(context, editorComponent->quad, true);
+		}
 
+		mDirtyEntities.clear();
+		mRemovedEntities.clear();
+		mScenePath = path;
+		mSavedModificationCount = mModificationCount;
+
+		// the saved ids of remapped entities are replaced on the next save
+		for (auto& [savedID, newID] : remapped) {
+			mRemovedEntities.insert(savedID);
+			MarkDirty(newID);
+		}
+
+		CREN_LOG(CREN_LOG_SEVERITY_INFO, "Loaded scene %s with %zu entities", path.c_str(), mEntities.Size());
+		return result;
+	}
+
+	const char* World::InternName(const char* name)
+	{
+		return mEntityNames.emplace(name).first->c_str();
+	}
+
+	void World::OnUpdate(float timestep)
+	{
+		// autosave only re-captures the entities changed since it's last capture here, a bounded amount per frame until it caught up
+		// walking the whole scene and the write happen on the autosave thread
+		if (mAutosaveInterval <= 0.0f || mScenePath.empty()) return;
+
+		mAutosaveTimer += timestep;
+		if (mAutosaveTimer < mAutosaveInterval || mModificationCount == mSavedModificationCount || mAutosave.IsSaving()) return;
+		if (!mAutosave.Capture(mEntities, AUTOSAVE_CAPTURE_BUDGET)) return;
+
+		mAutosaveTimer = 0.0f;
+		if (mAutosave.Start(mScenePath + ".autosave")) {
+			mSavedModificationCount = mModificationCount;
+			CREN_LOG(CREN_LOG_SEVERITY_INFO, "Autosaving scene %s, last capture took %.3fms", mScenePath.c_str(), mAutosave.GetLastCaptureTime());
+		}
+	}
+
+	void World::CaptureDraws(std::vector<QuadDraw>& draws)
+	{
 		for (auto& [id, entity] : mEntities) {
 			
 			// validation
@@ -145,8 +326,7 @@ namespace Cosmos
 				if (editorComponent->visible) {
 					CRenQuad* quad = editorComponent->quad;
 					if (quad) {
-						fmat4 modelMatrix = transformComponent->GetTransform();
-						cren_quad_render(context, quad, (CRen_RenderStage)stage, modelMatrix);
+						draws.push_back({ quad, transformComponent->GetTransform() });
 					}
 				}
 			}
@@ -155,7 +335,8 @@ namespace Cosmos
 
 	bool World::Destroy()
 	{
-		std::vector<uint32_t> entityIDs;
+		ArenaScope scope;
+		ArenaVector<uint32_t> entityIDs(scope.GetAllocator<uint32_t>());
 		entityIDs.reserve(mEntities.Size());
 		
 		for (auto& [id, entity] : mEntities) {
@@ -167,7 +348,6 @@ namespace Cosmos
 		}
 		
 		mEntities.Clear();
-		mIDGenerator.Reset();
 
 		return true;
 	}
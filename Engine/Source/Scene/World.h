@@ -2,18 +2,30 @@
 
 #include "Core/Defines.h"
 
-#include "Util/ID.h"
+#include "Scene/SceneAutosave.h"
+#include "Scene/SceneJournal.h"
 #include "Util/Library.h"
 #include "Util/Memory.h"
+#include <string>
+#include <unordered_set>
+#include <vector>
 #include <vecmath/vecmath.h>
 
 // forward declaration
 namespace Cosmos { class Application; }
 namespace Cosmos { class Renderer; };
 namespace Cosmos { class Entity; }
+typedef struct CRenQuad CRenQuad;
 
 namespace Cosmos
 {
+	/// @brief a quad and where to draw it, captured from the world at the end of a simulation frame for the render thread
+	struct QuadDraw
+	{
+		CRenQuad* quad = nullptr;
+		fmat4 modelMatrix;
+	};
+
 	class COSMOS_API World
 	{
 	public:
@@ -27,6 +39,21 @@ namespace Cosmos
 		/// @brief returns a reference ot the world's entities
 		inline Library<uint32_t, Entity*>& GetEntityLibraryRef() { return mEntities; }
 
+		/// @brief returns a reference to the world's autosave
+		inline SceneAutosave& GetAutosaveRef() { return mAutosave; }
+
+		/// @brief sets how many seconds autosave waits between saves of a modified world, 0 disables it
+		inline void SetAutosaveInterval(float seconds) { mAutosaveInterval = seconds; }
+
+		/// @brief returns the scene path the world was last saved into/loaded from
+		inline const std::string& GetScenePath() const { return mScenePath; }
+
+		/// @brief sets the scene path autosave writes next to, without saving or loading it
+		inline void SetScenePath(const std::string& path) { mScenePath = path; }
+
+		/// @brief returns how many times the world was modified, it changing means there's something new to draw
+		inline uint64_t GetModificationCount() const { return mModificationCount; }
+
 	public:
 
 		/// @brief attempts to add an existing entity into the world, returns false on failure
@@ -38,7 +65,7 @@ namespace Cosmos
 		/// @brief attempts to destroy an entity, returns false if entity with idValue was not found
 		bool DestroyEntity(uint32_t idValue);
 
-		/// @brief extracts the entity from world without freeing it's resources
+		/// @brief extracts the entity from world without freeing it's resources, the entity keeps it's id
 		Entity* ExtractEntity(uint32_t idValue);
 
 		/// @brief transfer an entity with given id to another world
@@ -47,13 +74,25 @@ namespace Cosmos
 		/// @brief finds the entity by it's id value, returns NULL on failure
 		Entity* FindEntityByID(uint32_t idValue);
 
+		/// @brief flags an entity as modified, so it's written on the next incremental save
+		void MarkDirty(uint32_t idValue);
+
+	public:
+
+		/// @brief saves the world into path, a full snapshot is written the first time and only modified entities are appended afterwards
+		/// the autosave in flight is waited for and path's autosave removed, so it's never recovered over this save
+		bool SaveScene(const std::string& path);
+
+		/// @brief replaces the world's entities with the ones saved on path (or it's autosave, when newer), returns false if nothing could be read
+		bool LoadScene(const std::string& path);
+
 	public:
 
 		/// @brief updates the world logic
 		void OnUpdate(float timestep);
 
-		/// @brief render the world drawables
-		void OnRender(float timestep, int32_t stage);
+		/// @brief appends the visible drawables of the world, the render thread draws them without touching the entities
+		void CaptureDraws(std::vector<QuadDraw>& draws);
 
 		/// @brief deletes all entities on the world
 		bool Destroy();
@@ -62,7 +101,24 @@ namespace Cosmos
 
 		Application* mApp = nullptr;
 		Unique<Renderer>& mRenderer;
-		IDGenerator mIDGenerator = {};
 		Library<uint32_t, Entity*> mEntities = {};
+
+	private:
+
+		/// @brief entities reference their names, loaded names are kept alive here
+		const char* InternName(const char* name);
+
+	private:
+
+		SceneJournal mJournal;
+		std::unordered_set<uint32_t> mDirtyEntities;
+		std::unordered_set<uint32_t> mRemovedEntities;
+		std::unordered_set<std::string> mEntityNames;
+		std::string mScenePath = {};
+		float mAutosaveInterval = 60.0f;
+		float mAutosaveTimer = 0.0f;
+		uint64_t mModificationCount = 0;
+		uint64_t mSavedModificationCount = 0;
+		SceneAutosave mAutosave; // declared last, it's destructor waits for the save in flight (which only reads the autosave's own copy)
 	};
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "Core/Application.h"
 
 #include <cren_error.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -30,10 +33,10 @@ namespace Cosmos
 	static int Internal_SDL3_CreateVulkanSurface(ImGuiViewport* viewport, ImU64 vk_instance, const void* vk_allocator, ImU64* out_vk_surface)
 	{
 		ImGui_ImplSDL3_ViewportData* vd = (ImGui_ImplSDL3_ViewportData*)viewport->PlatformUserData;
-		(void)vk_allocator;
 
+		// imgui destroys the surface with it's allocator, so it must be created with it as well
 		CREN_LOG(CREN_LOG_SEVERITY_TODO, "Use cren_surface_create instead of SDL's one");
-		bool ret = SDL_Vulkan_CreateSurface(vd->Window, (VkInstance)vk_instance, NULL, (VkSurfaceKHR*)out_vk_surface);
+		bool ret = SDL_Vulkan_CreateSurface(vd->Window, (VkInstance)vk_instance, (const VkAllocationCallbacks*)vk_allocator, (VkSurfaceKHR*)out_vk_surface);
 		return ret ? 0 : 1; // ret ? VK_SUCCESS : VK_NOT_READY 
 	}
 
@@ -44,15 +47,199 @@ namespace Cosmos
 		}
 	}
 
+	/// @brief the draw data of a built ui frame, the draw lists are kept across captures so their buffers stop growing
+	struct UISnapshot
+	{
+		ImDrawData drawData;
+		ImVector<ImDrawList*> drawLists;
+		ImVector<WidgetRenderState> widgets; // of the visible widgets that render something
+		uint64_t build = 0; // which ui frame it holds
+	};
+
+	/// @brief copies src into dst keeping dst's buffer, ImVector's assignment frees and reallocates it on every copy
+	template<typename T>
+	static void Internal_CopyVector(ImVector<T>& dst, const ImVector<T>& src)
+	{
+		dst.resize(src.Size);
+		if (src.Size > 0) std::memcpy(dst.Data, src.Data, (size_t)src.Size * sizeof(T));
+	}
+
+	/// @brief a reused ui frame is still rebuilt this often, so readouts no widget flags keep advancing
+	static constexpr double REBUILD_INTERVAL = 0.5;
+
+	/// @brief where the glyphs baked in a session are cached, the next sessions bake them ahead while the window and device are created
+	static constexpr const char* GLYPH_CACHE_PATH = "UI.glyphs";
+	static constexpr uint32_t GLYPH_CACHE_MAGIC = 0x48504C47; // "GLPH"
+	static constexpr uint32_t GLYPH_CACHE_VERSION = 1;
+
+	/// @brief how many dpi scales the glyph cache keeps, the least recently used one is dropped
+	static constexpr size_t GLYPH_CACHE_MAX_SCALES = 4;
+
+	/// @brief font sizes not used within these frames when the ui closes aren't cached, they belong to a previous dpi scale
+	static constexpr int GLYPH_CACHE_RECENT_FRAMES = 60;
+
+	/// @brief the glyphs of a baked font size, as cached
+	struct GlyphCacheEntry
+	{
+		float dpiScale = 1.0f;
+		uint32_t font = 0; // it's index on the atlas
+		float size = 0.0f;
+		float density = 1.0f;
+		std::vector<uint32_t> codepoints;
+	};
+
 	static ImFont* sIconFA = nullptr;
 	static ImFont* sIconLC = nullptr;
 	static ImFont* sRobotoMono = nullptr;
+	static std::vector<GlyphCacheEntry> sGlyphCache; // the cached scales, most recently used first
+
+	/// @brief identifies the fonts added to the atlas, a cache made with other fonts or sizes is ignored
+	static uint64_t Internal_GlyphCacheFingerprint()
+	{
+		uint64_t hash = 14695981039346656037ull;
+		auto mix = [&hash](uint64_t value) { hash = (hash ^ value) * 1099511628211ull; };
+
+		for (const ImFontConfig& source : ImGui::GetIO().Fonts->Sources) {
+			uint32_t sizeBits = 0;
+			memcpy(&sizeBits, &source.SizePixels, sizeof(sizeBits));
+			mix((uint64_t)source.FontDataSize);
+			mix(sizeBits);
+			mix(source.MergeMode ? 1 : 0);
+		}
+
+		return hash;
+	}
+
+	/// @brief reads the glyph cache, it's empty if there's none or it was made for other fonts
+	static std::vector<GlyphCacheEntry> Internal_ReadGlyphCache(uint64_t fingerprint)
+	{
+		std::vector<GlyphCacheEntry> entries;
+		FILE* file = std::fopen(GLYPH_CACHE_PATH, "rb");
+		if (!file) return entries;
+
+		uint32_t magic = 0, version = 0, count = 0;
+		uint64_t storedFingerprint = 0;
+		bool valid = std::fread(&magic, sizeof(magic), 1, file) == 1 && std::fread(&version, sizeof(version), 1, file) == 1;
+		valid = valid && std::fread(&storedFingerprint, sizeof(storedFingerprint), 1, file) == 1 && std::fread(&count, sizeof(count), 1, file) == 1;
+		valid = valid && magic == GLYPH_CACHE_MAGIC && version == GLYPH_CACHE_VERSION && storedFingerprint == fingerprint;
+
+		for (uint32_t i = 0; valid && i < count; i++) {
+			GlyphCacheEntry entry;
+			uint32_t codepoints = 0;
+			valid = std::fread(&entry.dpiScale, sizeof(entry.dpiScale), 1, file) == 1 && std::fread(&entry.font, sizeof(entry.font), 1, file) == 1;
+			valid = valid && std::fread(&entry.size, sizeof(entry.size), 1, file) == 1 && std::fread(&entry.density, sizeof(entry.density), 1, file) == 1;
+			valid = valid && std::fread(&codepoints, sizeof(codepoints), 1, file) == 1 && codepoints <= 0x110000;
+			if (!valid) break;
+
+			entry.codepoints.resize(codepoints);
+			valid = codepoints == 0 || std::fread(entry.codepoints.data(), sizeof(uint32_t), codepoints, file) == codepoints;
+			if (valid) entries.push_back(std::move(entry));
+		}
+
+		std::fclose(file);
+
+		if (!valid) {
+			CREN_LOG(CREN_LOG_SEVERITY_WARN, "Ignoring the glyph cache %s, it's outdated or corrupted", GLYPH_CACHE_PATH);
+			entries.clear();
+		}
+
+		return entries;
+	}
+
+	/// @brief writes the glyph cache
+	static void Internal_WriteGlyphCache(const std::vector<GlyphCacheEntry>& entries, uint64_t fingerprint)
+	{
+		FILE* file = std::fopen(GLYPH_CACHE_PATH, "wb");
+		if (!file) {
+			CREN_LOG(CREN_LOG_SEVERITY_WARN, "Failed to open %s for writing the glyph cache", GLYPH_CACHE_PATH);
+			return;
+		}
+
+		uint32_t magic = GLYPH_CACHE_MAGIC, version = GLYPH_CACHE_VERSION, count = (uint32_t)entries.size();
+		std::fwrite(&magic, sizeof(magic), 1, file);
+		std::fwrite(&version, sizeof(version), 1, file);
+		std::fwrite(&fingerprint, sizeof(fingerprint), 1, file);
+		std::fwrite(&count, sizeof(count), 1, file);
+
+		for (const GlyphCacheEntry& entry : entries) {
+			uint32_t codepoints = (uint32_t)entry.codepoints.size();
+			std::fwrite(&entry.dpiScale, sizeof(entry.dpiScale), 1, file);
+			std::fwrite(&entry.font, sizeof(entry.font), 1, file);
+			std::fwrite(&entry.size, sizeof(entry.size), 1, file);
+			std::fwrite(&entry.density, sizeof(entry.density), 1, file);
+			std::fwrite(&codepoints, sizeof(codepoints), 1, file);
+			std::fwrite(entry.codepoints.data(), sizeof(uint32_t), codepoints, file);
+		}
+
+		std::fclose(file);
+	}
+
+	/// @brief bakes the cached glyphs of a dpi scale into the atlas, they're uploaded with the first frame
+	static void Internal_BakeCachedGlyphs(float dpiScale)
+	{
+		ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+		size_t glyphs = 0;
+
+		for (const GlyphCacheEntry& entry : sGlyphCache) {
+			if (entry.dpiScale != dpiScale || entry.font >= (uint32_t)atlas->Fonts.Size) continue;
+
+			ImFontBaked* baked = atlas->Fonts[entry.font]->GetFontBaked(entry.size, entry.density);
+			for (uint32_t codepoint : entry.codepoints) baked->FindGlyph((ImWchar)codepoint);
+			glyphs += entry.codepoints.size();
+		}
+
+		if (glyphs > 0) CREN_LOG(CREN_LOG_SEVERITY_TRACE, "Baked %zu cached glyphs for dpi scale %.2f", glyphs, dpiScale);
+	}
+
+	/// @brief caches the glyphs of the font sizes the ui is using, replacing the ones of the current dpi scale
+	static void Internal_SaveGlyphCache()
+	{
+		ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+		if (!atlas->Builder) return;
+
+		float dpiScale = ImGui::GetStyle().FontScaleDpi;
+		std::vector<GlyphCacheEntry> entries;
+
+		ImStableVector<ImFontBaked, 32>& bakedPool = atlas->Builder->BakedPool;
+		for (int i = 0; i < bakedPool.Size; i++) {
+			ImFontBaked& baked = bakedPool[i];
+			if (baked.WantDestroy || baked.Glyphs.Size == 0 || baked.LastUsedFrame < ImGui::GetFrameCount() - GLYPH_CACHE_RECENT_FRAMES) continue;
+
+			GlyphCacheEntry entry;
+			entry.dpiScale = dpiScale;
+			entry.size = baked.Size;
+			entry.density = baked.RasterizerDensity;
+
+			for (int font = 0; font < atlas->Fonts.Size; font++) {
+				if (atlas->Fonts[font] == baked.ContainerFont) entry.font = (uint32_t)font;
+			}
+
+			for (const ImFontGlyph& glyph : baked.Glyphs) entry.codepoints.push_back(glyph.Codepoint);
+			entries.push_back(std::move(entry));
+		}
+
+		// the other scales are kept after this one, up to the limit
+		size_t scales = 1;
+		float lastScale = dpiScale;
+		for (const GlyphCacheEntry& entry : sGlyphCache) {
+			if (entry.dpiScale == dpiScale) continue;
+			if (entry.dpiScale != lastScale) {
+				if (++scales > GLYPH_CACHE_MAX_SCALES) break;
+				lastScale = entry.dpiScale;
+			}
+
+			entries.push_back(entry);
+		}
+
+		Internal_WriteGlyphCache(entries, Internal_GlyphCacheFingerprint());
+	}
 
 	GUI::GUI(Application* app)
 		: mApp(app)
 	{
 		// initial config
 		IMGUI_CHECKVERSION();
+		ImGui::SetAllocatorFunctions([](size_t size, void*) { return cren_memory_alloc(CREN_MEMORY_TAG_UI, size); }, [](void* ptr, void*) { cren_memory_free(ptr); });
 		mContext = ImGui::CreateContext();
 		ImGuiIO& io = ImGui::GetIO(); (void)io;
 		io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
@@ -74,14 +261,54 @@ namespace Cosmos
 		ImGui::StyleColorsDark();
 		SetStyle();
 
-		CRenContext* renderer = mApp->GetRendererRef()->GetCRenContext();
+		// fonts
+		constexpr const ImWchar iconRanges1[] = { ICON_MIN_FA, ICON_MAX_FA, 0 };
+		constexpr const ImWchar iconRanges2[] = { ICON_MIN_LC, ICON_MAX_LC, 0 };
+		float iconSize = 13.0f;
+		float fontSize = 18.0f;
+
+		if (platform == CREN_PLATFORM_ANDROID) {
+			CREN_LOG(CREN_LOG_SEVERITY_TODO, "[Android:Todo]: Figure out an automate way to resize things, maybe wait ImGui-texture branch?");
+			iconSize = 13.0f * 3.0f;
+			fontSize = 18.0f * 3.0f;
+		}
+
+		ImFontConfig iconCFG;
+		iconCFG.MergeMode = true;
+		iconCFG.GlyphMinAdvanceX = iconSize;
+		iconCFG.PixelSnapH = true;
+
+		sRobotoMono = io.Fonts->AddFontFromMemoryCompressedTTF(txt_robotomono_medium_compressed_data, txt_robotomono_medium_compressed_size, fontSize);
+		sIconFA = io.Fonts->AddFontFromMemoryCompressedTTF(icon_awesome_compressed_data, icon_awesome_compressed_size, iconSize, &iconCFG, iconRanges1);
+		sIconLC = io.Fonts->AddFontFromMemoryCompressedTTF(icon_lucide_compressed_data, icon_lucide_compressed_size, iconSize, &iconCFG, iconRanges2);
+
+		// glyphs are baked as the ui first uses them, building the atlas before the vulkan backend flags it supports that would preload
+		// every glyph of every range (thousands of icons), so instead it's flagged already and only what past sessions used is baked here
+		io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+		sGlyphCache = Internal_ReadGlyphCache(Internal_GlyphCacheFingerprint());
+		Internal_BakeCachedGlyphs(ImGui::GetStyle().FontScaleDpi);
+	}
+
+	void GUI::InitializeBackends()
+	{
+		// the context may have been created on another thread
+		ImGui::SetCurrentContext((ImGuiContext*)mContext);
+		ImGuiIO& io = ImGui::GetIO();
+
+		// without a window there're no platform windows nor inputs, the display is the offscreen target
+		// a replay has no platform windows either, they'd be driven by the live platform backend and the recorded positions are of the main window
+		bool headless = mApp->GetWindowRef()->IsHeadless();
+		if (headless || mApp->GetInputRecorderRef().IsReplaying()) io.ConfigFlags &= ~ImGuiConfigFlags_ViewportsEnable;
+
+		if (headless) {
+			io.DisplaySize = ImVec2((float)mApp->GetWindowRef()->GetWidth(), (float)mApp->GetWindowRef()->GetHeight());
+		}
 
 		// sdl and vulkan initialization
 		ImGuiPlatformIO& platformIO = ImGui::GetPlatformIO();
 		platformIO.Platform_CreateVkSurface = Internal_SDL3_CreateVulkanSurface;
 
-		ImGui::SetCurrentContext((ImGuiContext*)mContext);
-		ImGui_ImplSDL3_InitForVulkan(mApp->GetWindowRef()->GetAPIWindow());
+		if (!headless) ImGui_ImplSDL3_InitForVulkan(mApp->GetWindowRef()->GetAPIWindow());
 		
 		CRenVulkanBackend* vkBackend = (CRenVulkanBackend*)cren_get_vulkan_backend(mApp->GetRendererRef()->GetCRenContext());
 
@@ -107,34 +334,12 @@ namespace Cosmos
 		appInfo.PipelineInfoMain = mainPipe;
 		appInfo.PipelineInfoForViewports = mainPipe; // we're managing our own viewport implementation
 		appInfo.UseDynamicRendering = false;
-		appInfo.Allocator = NULL;
+		appInfo.Allocator = crenvk_get_allocation_callbacks(); // imgui's vulkan objects are accounted with cren's
 		appInfo.CheckVkResultFn = Internal_ImGui_ReturnVulkanError;
 		appInfo.MinAllocationSize = 1024 * 1024;
 		//appInfo.CustomShaderVertCreateInfo; // optional customize vertex shader
 		//appInfo.CustomShaderFragCreateInfo; // optional customize fragment shader
 		ImGui_ImplVulkan_Init(&appInfo);
-		
-		// fonts
-		constexpr const ImWchar iconRanges1[] = { ICON_MIN_FA, ICON_MAX_FA, 0 };
-		constexpr const ImWchar iconRanges2[] = { ICON_MIN_LC, ICON_MAX_LC, 0 };
-		float iconSize = 13.0f;
-		float fontSize = 18.0f;
-
-		if (platform == CREN_PLATFORM_ANDROID) {
-			CREN_LOG(CREN_LOG_SEVERITY_TODO, "[Android:Todo]: Figure out an automate way to resize things, maybe wait ImGui-texture branch?");
-			iconSize = 13.0f * 3.0f;
-			fontSize = 18.0f * 3.0f;
-		}
-
-		ImFontConfig iconCFG;
-		iconCFG.MergeMode = true;
-		iconCFG.GlyphMinAdvanceX = iconSize;
-		iconCFG.PixelSnapH = true;
-
-		sRobotoMono = io.Fonts->AddFontFromMemoryCompressedTTF(txt_robotomono_medium_compressed_data, txt_robotomono_medium_compressed_size, fontSize);
-		sIconFA = io.Fonts->AddFontFromMemoryCompressedTTF(icon_awesome_compressed_data, icon_awesome_compressed_size, iconSize, &iconCFG, iconRanges1);
-		sIconLC = io.Fonts->AddFontFromMemoryCompressedTTF(icon_lucide_compressed_data, icon_lucide_compressed_size, iconSize, &iconCFG, iconRanges2);
-		io.Fonts->Build();
 	}
 
 	GUI::~GUI()
@@ -143,8 +348,9 @@ namespace Cosmos
 		CRenContext* renderer = mApp->GetRendererRef()->GetCRenContext();
 		vkDeviceWaitIdle(backend->device.device);
 
+		Internal_SaveGlyphCache();
 		ImGui_ImplVulkan_Shutdown();
-		ImGui_ImplSDL3_Shutdown();
+		if (!mApp->GetWindowRef()->IsHeadless()) ImGui_ImplSDL3_Shutdown();
 
 		mWidgets.Clear();
 		ImGui::DestroyContext((ImGuiContext*)mContext);
@@ -152,8 +358,50 @@ namespace Cosmos
 
 	void GUI::OnUpdate()
 	{
+		// the swapchain was recreated by the render thread, the backend waits for the device idle so it's told under the device lock
+		uint32_t minImageCount = mMinImageCount.exchange(0, std::memory_order_acq_rel);
+		if (minImageCount > 0) {
+			CRenContext* renderer = mApp->GetRendererRef()->GetCRenContext();
+			cren_lock(renderer);
+			ImGui_ImplVulkan_SetMinImageCount(minImageCount);
+			cren_unlock(renderer);
+		}
+
+		// nothing the ui shows changed, the last frame's draw data is drawn again and none of imgui nor the widgets run
+		mSinceBuild += mApp->GetTimeStep();
+		mReusing = !NeedsRebuild();
+		if (mReusing) return;
+
 		ImGui_ImplVulkan_NewFrame();
-		ImGui_ImplSDL3_NewFrame();
+
+		// the platform backend reads the live window size, mouse and gamepads, a replay feeds imgui only what was recorded (see Window::ProcessEvent)
+		InputRecorder& recorder = mApp->GetInputRecorderRef();
+		Unique<Window>& window = mApp->GetWindowRef();
+		if (!window->IsHeadless() && !recorder.IsReplaying()) ImGui_ImplSDL3_NewFrame();
+
+		else if (!window->IsHeadless()) {
+			ImGuiIO& io = ImGui::GetIO();
+			float density = SDL_GetWindowPixelDensity(window->GetAPIWindow());
+			io.DisplaySize = ImVec2((float)window->GetWidth(), (float)window->GetHeight());
+			io.DisplayFramebufferScale = ImVec2(density, density);
+		}
+
+		// what the platform backend would feed, frames advance by the simulated timestep, so do recorded/replayed ones to stay in step
+		if (window->IsHeadless() || recorder.IsRecording() || recorder.IsReplaying()) {
+			ImGuiIO& io = ImGui::GetIO();
+			io.DeltaTime = mSinceBuild > 0.0 ? (float)mSinceBuild : 1.0f / 60.0f;
+		}
+
+		// a rebuild request is consumed by the frame, the requests made meanwhile from other threads are kept
+		uint32_t frames = mRebuildFrames.load(std::memory_order_acquire);
+		while (frames > 0 && !mRebuildFrames.compare_exchange_weak(frames, frames - 1, std::memory_order_acq_rel));
+
+		World* world = mApp->GetRendererRef()->GetWorld();
+		if (world) mBuiltModificationCount = world->GetModificationCount();
+
+		mSinceBuild = 0.0;
+		mBuildCount++;
+
 		ImGui::NewFrame();
 		ImGuizmo::BeginFrame();
 
@@ -164,20 +412,40 @@ namespace Cosmos
 
 		ImGui::Render();
 
+		// textures are uploaded and platform windows presented here, the device is shared with the render thread
+		CRenContext* renderer = mApp->GetRendererRef()->GetCRenContext();
+		cren_lock(renderer);
+
+		ImDrawData* data = ImGui::GetDrawData();
+		if (data && data->Textures) {
+			for (ImTextureData* texture : *data->Textures) {
+				if (texture->Status != ImTextureStatus_OK) ImGui_ImplVulkan_UpdateTexture(texture);
+			}
+		}
+
 		ImGuiIO& io = ImGui::GetIO();
 		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		{
 			ImGui::UpdatePlatformWindows();
 			ImGui::RenderPlatformWindowsDefault();
 		}
+
+		cren_unlock(renderer);
 	}
 
-	void GUI::OnRender(int stage)
+	void GUI::OnRender(int stage, UISnapshot* snapshot)
 	{
-		mWidgets.ForEach([stage](Widget* widget)
-			{
-				if (widget->GetVisibility()) widget->OnRender(stage);
-			});
+		if (!snapshot) return;
+
+		for (const WidgetRenderState& state : snapshot->widgets) {
+			state.widget->OnRender(stage, state);
+		}
+	}
+
+	void GUI::RequestRebuild(uint32_t frames)
+	{
+		uint32_t current = mRebuildFrames.load(std::memory_order_acquire);
+		while (current < frames && !mRebuildFrames.compare_exchange_weak(current, frames, std::memory_order_acq_rel));
 	}
 
 	void GUI::AddWidget(Widget* widget)
@@ -286,17 +554,106 @@ namespace Cosmos
 
 	void GUI::OnDPIChange(float scale)
 	{
+		// fonts are baked at the scaled sizes as they're used, the ones a previous session used at this scale are baked right away
+		ImGui::GetStyle().FontScaleDpi = scale;
+		Internal_BakeCachedGlyphs(scale);
+		RequestRebuild();
 	}
 
 	void GUI::SetMinImageCount(unsigned int count)
 	{
-		ImGui_ImplVulkan_SetMinImageCount(count);
+		mMinImageCount.store(count, std::memory_order_release);
 	}
 
-	void GUI::DrawRawData(void* commandbuffer)
+	void GUI::DrawRawData(UISnapshot* snapshot, void* commandbuffer)
 	{
+		if (!snapshot || !snapshot->drawData.Valid) return;
+		ImGui_ImplVulkan_RenderDrawData(&snapshot->drawData, (VkCommandBuffer)commandbuffer);
+	}
+
+	void GUI::CaptureSnapshot(UISnapshot* snapshot)
+	{
+		// the widgets may change what they render without rebuilding the ui, their state is captured every frame
+		snapshot->widgets.resize(0);
+		mWidgets.ForEach([snapshot](Widget* widget)
+			{
+				if (!widget->GetVisibility()) return;
+
+				WidgetRenderState state;
+				state.widget = widget;
+				if (widget->CaptureRenderState(state)) snapshot->widgets.push_back(state);
+			});
+
+		// while the ui is reused the snapshot slots end up holding it's frame already
+		if (mBuildCount > 0 && snapshot->build == mBuildCount) return;
+		snapshot->build = mBuildCount;
+
 		ImDrawData* data = ImGui::GetDrawData();
-		ImGui_ImplVulkan_RenderDrawData(data, (VkCommandBuffer)commandbuffer);
+		ImDrawData& copy = snapshot->drawData;
+		copy.Clear();
+
+		if (!data || !data->Valid) return;
+
+		copy.Valid = true;
+		copy.CmdListsCount = data->CmdListsCount;
+		copy.TotalIdxCount = data->TotalIdxCount;
+		copy.TotalVtxCount = data->TotalVtxCount;
+		copy.DisplayPos = data->DisplayPos;
+		copy.DisplaySize = data->DisplaySize;
+		copy.FramebufferScale = data->FramebufferScale;
+		copy.OwnerViewport = data->OwnerViewport;
+		copy.Textures = nullptr; // already uploaded on OnUpdate
+
+		for (int i = 0; i < data->CmdListsCount; i++) {
+			if (i == snapshot->drawLists.Size) {
+				snapshot->drawLists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+			}
+
+			const ImDrawList* source = data->CmdLists[i];
+			ImDrawList* list = snapshot->drawLists[i];
+			Internal_CopyVector(list->CmdBuffer, source->CmdBuffer);
+			Internal_CopyVector(list->IdxBuffer, source->IdxBuffer);
+			Internal_CopyVector(list->VtxBuffer, source->VtxBuffer);
+			list->Flags = source->Flags;
+			copy.CmdLists.push_back(list);
+		}
+	}
+
+	UISnapshot* GUI::CreateSnapshot()
+	{
+		return IM_NEW(UISnapshot)();
+	}
+
+	void GUI::DestroySnapshot(UISnapshot* snapshot)
+	{
+		if (!snapshot) return;
+
+		for (ImDrawList* list : snapshot->drawLists) IM_DELETE(list);
+		IM_DELETE(snapshot);
+	}
+
+	bool GUI::NeedsRebuild()
+	{
+		if (!mReuse || mBuildCount == 0) return true;
+		if (mRebuildFrames.load(std::memory_order_acquire) > 0) return true;
+
+		// performance runs measure the ui every frame, and recorded sessions must build the same frames when replayed
+		InputRecorder& recorder = mApp->GetInputRecorderRef();
+		if (mApp->GetWindowRef()->IsHeadless() || recorder.IsRecording() || recorder.IsReplaying()) return true;
+
+		// a text field's caret blinks
+		if (ImGui::GetIO().WantTextInput || mSinceBuild >= REBUILD_INTERVAL) return true;
+
+		World* world = mApp->GetRendererRef()->GetWorld();
+		if (world && world->GetModificationCount() != mBuiltModificationCount) return true;
+
+		bool widgetRebuild = false;
+		mWidgets.ForEach([&widgetRebuild](Widget* widget)
+			{
+				if (widget->GetVisibility() && widget->NeedsRebuild()) widgetRebuild = true;
+			});
+
+		return widgetRebuild;
 	}
 
 	bool GUI::WantToCaptureMouse()
@@ -304,6 +661,11 @@ namespace Cosmos
 		return ImGui::GetIO().WantCaptureMouse;
 	}
 
+	bool GUI::WantTextInput()
+	{
+		return ImGui::GetIO().WantTextInput;
+	}
+
 	void GUI::SetStyle()
 	{
 		ImGuiStyle* style = &ImGui::GetStyle();
@@ -3,9 +3,11 @@
 #include "Core/Defines.h"
 #include "UI/Widget.h"
 #include "Util/Container.h"
+#include <atomic>
 
 // forward declarations
 namespace Cosmos { class Application; }
+namespace Cosmos { struct UISnapshot; }
 
 namespace Cosmos
 {
@@ -13,19 +15,22 @@ namespace Cosmos
 	{
 	public:
 
-		/// @brief setup and prepare all needed resources
+		/// @brief creates the ui context and builds the font atlas, it touches neither the window nor the renderer so it may run on a worker during startup
 		GUI(Application* app);
 
 		/// @brief release all used resources
 		~GUI();
 
+		/// @brief initializes the platform and renderer backends, on the main thread once the window and renderer exist
+		void InitializeBackends();
+
 	public:
 
 		/// @brief called when updating the ui widgets
 		void OnUpdate();
 
-		/// @brief called when rendering the ui widgets
-		void OnRender(int stage);
+		/// @brief called when rendering the ui widgets captured in snapshot, this runs on the render thread while the next frame is being built
+		void OnRender(int stage, UISnapshot* snapshot);
 
 		/// @brief adds a new widget to the widgets list
 		void AddWidget(Widget* widget);
@@ -33,6 +38,19 @@ namespace Cosmos
 		/// @brief returns the first widget by it's name or NULL if not found
 		Widget* FindWidgetByName(const char* name);
 
+		/// @brief returns if the last ui frame is drawn again while nothing changed, instead of being rebuilt every frame
+		inline bool GetReuse() const { return mReuse; }
+
+		/// @brief sets if the last ui frame is drawn again while nothing changed
+		inline void SetReuse(bool reuse) { mReuse = reuse; RequestRebuild(); }
+
+		/// @brief returns if the last OnUpdate reused the previous ui frame instead of building one
+		inline bool IsReusing() const { return mReusing; }
+
+		/// @brief asks for the next frames to rebuild the ui, for changes that don't come from input, may be called from any thread
+		/// a few frames are the default since the ui takes a couple of them to settle
+		void RequestRebuild(uint32_t frames = 3);
+
 	public:
 
 		// @brief hides/unhides the mouse cursor from the ui
@@ -72,24 +90,47 @@ namespace Cosmos
 
 	public:
 
-		/// @brief informs the ui-backend that the quantity of images in the swapchain has changed
+		/// @brief informs the ui-backend that the quantity of images in the swapchain has changed, may be called from the render thread
+		/// the backend is only told on the next OnUpdate, imgui belongs to the simulation
 		void SetMinImageCount(unsigned int count);
 
-		/// @brief informs the ui-backend that it's time to draw it's data
-		void DrawRawData(void* commandbuffer);
+		/// @brief informs the ui-backend that it's time to draw the data captured in snapshot
+		void DrawRawData(UISnapshot* snapshot, void* commandbuffer);
+
+		/// @brief copies the draw data of the last built ui frame and the widgets render state into snapshot, so it can be drawn while the next one is built
+		void CaptureSnapshot(UISnapshot* snapshot);
+
+		/// @brief creates an empty ui snapshot
+		static UISnapshot* CreateSnapshot();
+
+		/// @brief releases a ui snapshot, it doesn't require the ui to be alive
+		static void DestroySnapshot(UISnapshot* snapshot);
 
 		/// @brief returns if currently attempting to capture the mouse
 		bool WantToCaptureMouse();
 
+		/// @brief returns if a text field is being edited, it's caret blinks
+		bool WantTextInput();
+
 	private:
 
 		/// @brief set's the custom style
 		void SetStyle();
 
+		/// @brief returns if something the ui shows may have changed since it was last built
+		bool NeedsRebuild();
+
 	private:
 
 		Application* mApp;
 		DualContainer<Widget*> mWidgets;
 		void* mContext;
+		bool mReuse = true;
+		bool mReusing = false;
+		std::atomic<uint32_t> mRebuildFrames = 3;
+		uint64_t mBuildCount = 0;				// ui frames built, snapshots holding the last one aren't copied again
+		uint64_t mBuiltModificationCount = 0;	// world modifications the last ui frame showed
+		double mSinceBuild = 0.0;				// seconds since the last ui frame was built
+		std::atomic<uint32_t> mMinImageCount = 0;	// swapchain image count the backend is yet to be told about, 0 if none
 	};
 }
\ No newline at end of file
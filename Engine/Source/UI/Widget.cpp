@@ -338,9 +338,10 @@ namespace Cosmos::WidgetExtended
 		ImGui::PopID();
 	}
 
-	COSMOS_API void Float3Controller(const char* label, float* x, float* y, float* z)
+	COSMOS_API bool Float3Controller(const char* label, float* x, float* y, float* z)
 	{
 		ImGui::PushID(label);
+		bool changed = false;
 
 		constexpr ImVec4 colorX = ImVec4{ 0.8f, 0.1f, 0.15f, 1.0f };
 		constexpr ImVec4 colorY = ImVec4{ 0.25f, 0.7f, 0.2f, 1.0f };
@@ -356,7 +357,7 @@ namespace Cosmos::WidgetExtended
 			ImGui::SmallButton("X");
 			ImGui::SameLine();
 			ImGui::PushItemWidth(50);
-			ImGui::DragFloat("##X", x, 0.1f, 0.0f, 0.0f, "%.2f");
+			changed |= ImGui::DragFloat("##X", x, 0.1f, 0.0f, 0.0f, "%.2f");
 			ImGui::SameLine();
 			ImGui::PopItemWidth();
 
@@ -372,7 +373,7 @@ namespace Cosmos::WidgetExtended
 			ImGui::SmallButton("Y");
 			ImGui::SameLine();
 			ImGui::PushItemWidth(50);
-			ImGui::DragFloat("##Y", y, 0.1f, 0.0f, 0.0f, "%.2f");
+			changed |= ImGui::DragFloat("##Y", y, 0.1f, 0.0f, 0.0f, "%.2f");
 			ImGui::SameLine();
 			ImGui::PopItemWidth();
 
@@ -388,7 +389,7 @@ namespace Cosmos::WidgetExtended
 			ImGui::SmallButton("Z");
 			ImGui::SameLine();
 			ImGui::PushItemWidth(50);
-			ImGui::DragFloat("##Z", z, 0.1f, 0.0f, 0.0f, "%.2f");
+			changed |= ImGui::DragFloat("##Z", z, 0.1f, 0.0f, 0.0f, "%.2f");
 			ImGui::SameLine();
 			ImGui::PopItemWidth();
 
@@ -398,6 +399,8 @@ namespace Cosmos::WidgetExtended
 		ImGui::NewLine();
 
 		ImGui::PopID();
+
+		return changed;
 	}
 
 	COSMOS_API void VerticalSeparator(float thickness)
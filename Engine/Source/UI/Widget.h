@@ -3,6 +3,7 @@
 #include "Core/Defines.h"
 #include "Core/Input.h"
 #include "WidgetTypes.h"
+#include <type_traits>
 #include <vecmath/vecmath.h>
 
 #define IMGUI_DEFINE_MATH_OPERATORS
@@ -10,6 +11,27 @@
 
 namespace Cosmos
 {
+	// forward declarations
+	class Widget;
+
+	/// @brief what a widget renders with, captured as the frame is published so the render thread never reads the widget while it's updated
+	struct WidgetRenderState
+	{
+		Widget* widget = nullptr;
+		alignas(16) uint8_t data[64] = {};
+
+		/// @brief returns the state as the widget's own type, it must fit and be trivially copyable
+		template<typename T>
+		T& As()
+		{
+			static_assert(sizeof(T) <= sizeof(data) && alignof(T) <= 16 && std::is_trivially_copyable_v<T>, "Widget render state doesn't fit");
+			return *reinterpret_cast<T*>(data);
+		}
+
+		template<typename T>
+		const T& As() const { return const_cast<WidgetRenderState*>(this)->As<T>(); }
+	};
+
 	class COSMOS_API Widget
 	{
 	public:
@@ -34,8 +56,14 @@ namespace Cosmos
 		// user interface drawing
 		inline virtual void OnUpdate() {};
 
-		// renderer drawing
-		inline virtual void OnRender(int stage) {};
+		/// @brief copies what OnRender draws with into state, on the simulation, returns false if the widget doesn't render anything
+		inline virtual bool CaptureRenderState(WidgetRenderState& state) { return false; }
+
+		/// @brief renderer drawing, on the render thread with the state captured alongside the frame
+		inline virtual void OnRender(int stage, const WidgetRenderState& state) {};
+
+		/// @brief returns if what the widget shows changed without any input (live readouts, progress), polled on the frames the ui would be reused
+		inline virtual bool NeedsRebuild() { return false; }
 
 	public:
 
@@ -176,5 +204,6 @@ namespace Cosmos::WidgetExtended
 	/// @param x first controller value
 	/// @param y second controller value
 	/// @param z third controller value
-	COSMOS_API void Float3Controller(const char* label, float* x, float* y, float* z);
+	/// @return true if any of the values changed
+	COSMOS_API bool Float3Controller(const char* label, float* x, float* y, float* z);
 }
\ No newline at end of file
@@ -0,0 +1,359 @@
+#include "Compression.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+namespace Cosmos
+{
+	static constexpr uint32_t CONTAINER_MAGIC = 0x43425343; // "CSBC"
+	static constexpr uint16_t CONTAINER_VERSION = 1;
+	static constexpr size_t CONTAINER_HEADER_SIZE = 24;
+	static constexpr size_t CONTAINER_INDEX_ENTRY_SIZE = 16;
+
+	/// @brief lz4 block format constraints, the last match must start 12 bytes before the end and the last 5 bytes are always literals
+	static constexpr size_t MIN_MATCH = 4;
+	static constexpr size_t LAST_LITERALS = 5;
+	static constexpr size_t MF_LIMIT = 12;
+	static constexpr size_t MAX_DISTANCE = 65535;
+	static constexpr uint32_t HASH_LOG = 12;
+
+	template<typename T>
+	static inline T Internal_Load(const uint8_t* ptr)
+	{
+		T value;
+		std::memcpy(&value, ptr, sizeof(T));
+		return value;
+	}
+
+	template<typename T>
+	static inline void Internal_Store(uint8_t* ptr, T value)
+	{
+		std::memcpy(ptr, &value, sizeof(T));
+	}
+
+	static inline uint32_t Internal_Hash(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - HASH_LOG);
+	}
+
+	/// @brief writes the remainder of a length that didn't fit into it's token nibble
+	static inline void Internal_WriteLength(uint8_t*& op, size_t length)
+	{
+		while (length >= 255) {
+			*op++ = 255;
+			length -= 255;
+		}
+		*op++ = (uint8_t)length;
+	}
+
+	/// @brief reads the remainder of a length that didn't fit into it's token nibble, returns false when running out of input
+	static inline bool Internal_ReadLength(const uint8_t*& ip, const uint8_t* iend, size_t& length)
+	{
+		uint8_t value = 0;
+		do {
+			if (ip >= iend) return false;
+			value = *ip++;
+			length += value;
+		} while (value == 255);
+		return true;
+	}
+
+	/// @brief runs job(i) for every i in [0, count) over threadCount threads, the calling thread included, 0 runs it on the job system
+	static void Internal_ParallelFor(size_t count, uint32_t threadCount, const std::function<void(size_t)>& job)
+	{
+		// a block is a job, they're big enough to be worth stealing one at a time
+		if (threadCount == 0) {
+			JobSystem::ParallelFor(count, [&job](size_t begin, size_t end) { for (size_t i = begin; i < end; i++) job(i); }, 1);
+			return;
+		}
+
+		std::atomic<size_t> next = 0;
+		auto worker = [&next, count, &job]() {
+			for (size_t i = next++; i < count; i = next++) job(i);
+			};
+
+		std::vector<std::thread> threads;
+		size_t extraThreads = std::min<size_t>(threadCount, count) > 0 ? std::min<size_t>(threadCount, count) - 1 : 0;
+		threads.reserve(extraThreads);
+
+		for (size_t i = 0; i < extraThreads; i++) threads.emplace_back(worker);
+		worker();
+		for (std::thread& thread : threads) thread.join();
+	}
+
+	size_t Compression::CompressBound(size_t size)
+	{
+		return size + size / 255 + 16;
+	}
+
+	size_t Compression::CompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+	{
+		const uint8_t* ip = src;
+		const uint8_t* anchor = src;
+		const uint8_t* iend = src + srcSize;
+		uint8_t* op = dst;
+		uint8_t* oend = dst + dstCapacity;
+
+		if (srcSize > MF_LIMIT) {
+			const uint8_t* mflimit = iend - MF_LIMIT;
+			const uint8_t* matchlimit = iend - LAST_LITERALS;
+			uint32_t table[1 << HASH_LOG] = {};
+
+			ip++;
+			while (ip < mflimit) {
+				uint32_t sequence = Internal_Load<uint32_t>(ip);
+				uint32_t hash = Internal_Hash(sequence);
+				const uint8_t* ref = src + table[hash];
+				table[hash] = (uint32_t)(ip - src);
+
+				// no match, step faster the longer we go without finding one (incompressible data is skipped quickly)
+				if ((size_t)(ip - ref) > MAX_DISTANCE || Internal_Load<uint32_t>(ref) != sequence) {
+					ip += 1 + ((ip - anchor) >> 6);
+					continue;
+				}
+
+				// extend the match backwards into the pending literals and then forward
+				while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+					ip--;
+					ref--;
+				}
+
+				const uint8_t* matchEnd = ip + MIN_MATCH;
+				const uint8_t* refEnd = ref + MIN_MATCH;
+				while (matchEnd < matchlimit && *matchEnd == *refEnd) {
+					matchEnd++;
+					refEnd++;
+				}
+
+				size_t literalLength = (size_t)(ip - anchor);
+				size_t matchLength = (size_t)(matchEnd - ip) - MIN_MATCH;
+				if ((size_t)(oend - op) < 1 + literalLength + literalLength / 255 + 1 + 2 + matchLength / 255 + 1) return 0;
+
+				// sequence: token, literals, offset, match length
+				uint8_t* token = op++;
+				*token = (uint8_t)(std::min<size_t>(literalLength, 15) << 4);
+				if (literalLength >= 15) Internal_WriteLength(op, literalLength - 15);
+
+				std::memcpy(op, anchor, literalLength);
+				op += literalLength;
+
+				Internal_Store<uint16_t>(op, (uint16_t)(ip - ref));
+				op += 2;
+
+				*token |= (uint8_t)std::min<size_t>(matchLength, 15);
+				if (matchLength >= 15) Internal_WriteLength(op, matchLength - 15);
+
+				ip = matchEnd;
+				anchor = ip;
+
+				if (ip < mflimit) {
+					table[Internal_Hash(Internal_Load<uint32_t>(ip - 2))] = (uint32_t)(ip - 2 - src);
+				}
+			}
+		}
+
+		// remaining bytes are literals
+		size_t lastLength = (size_t)(iend - anchor);
+		if ((size_t)(oend - op) < 1 + lastLength + lastLength / 255 + 1) return 0;
+
+		uint8_t* token = op++;
+		*token = (uint8_t)(std::min<size_t>(lastLength, 15) << 4);
+		if (lastLength >= 15) Internal_WriteLength(op, lastLength - 15);
+
+		std::memcpy(op, anchor, lastLength);
+		op += lastLength;
+
+		return (size_t)(op - dst);
+	}
+
+	bool Compression::DecompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+	{
+		const uint8_t* ip = src;
+		const uint8_t* iend = src + srcSize;
+		uint8_t* op = dst;
+		uint8_t* oend = dst + dstSize;
+
+		while (ip < iend) {
+			uint8_t token = *ip++;
+
+			size_t literalLength = token >> 4;
+			if (literalLength == 15 && !Internal_ReadLength(ip, iend, literalLength)) return false;
+			if (literalLength > (size_t)(iend - ip) || literalLength > (size_t)(oend - op)) return false;
+
+			std::memcpy(op, ip, literalLength);
+			op += literalLength;
+			ip += literalLength;
+
+			// the last sequence has no match
+			if (ip == iend) break;
+			if (iend - ip < 2) return false;
+
+			size_t offset = Internal_Load<uint16_t>(ip);
+			ip += 2;
+			if (offset == 0 || offset > (size_t)(op - dst)) return false;
+
+			size_t matchLength = token & 15;
+			if (matchLength == 15 && !Internal_ReadLength(ip, iend, matchLength)) return false;
+			matchLength += MIN_MATCH;
+			if (matchLength > (size_t)(oend - op)) return false;
+
+			// overlapping matches repeat the last offset bytes, they must be copied forward byte by byte
+			const uint8_t* match = op - offset;
+			if (offset >= matchLength) {
+				std::memcpy(op, match, matchLength);
+				op += matchLength;
+			}
+
+			else {
+				for (size_t i = 0; i < matchLength; i++) *op++ = *match++;
+			}
+		}
+
+		return op == oend;
+	}
+
+	bool Compression::IsCompressed(const void* data, size_t size)
+	{
+		if (size < CONTAINER_HEADER_SIZE) return false;
+
+		const uint8_t* bytes = (const uint8_t*)data;
+		return Internal_Load<uint32_t>(bytes) == CONTAINER_MAGIC && Internal_Load<uint16_t>(bytes + 4) == CONTAINER_VERSION;
+	}
+
+	void Compression::Compress(const void* data, size_t size, std::vector<uint8_t>& output, size_t blockSize, uint32_t threadCount)
+	{
+		const uint8_t* src = (const uint8_t*)data;
+		blockSize = std::clamp<size_t>(blockSize, 1024, UINT32_MAX / 2);
+		size_t blockCount = (size + blockSize - 1) / blockSize;
+
+		std::vector<std::vector<uint8_t>> blocks(blockCount);
+		Internal_ParallelFor(blockCount, threadCount, [&](size_t i) {
+			size_t rawSize = std::min(blockSize, size - i * blockSize);
+			std::vector<uint8_t>& block = blocks[i];
+			block.resize(CompressBound(rawSize));
+
+			// blocks that don't shrink are stored as-is, readers tell them apart by compressed size == uncompressed size
+			size_t compressedSize = CompressBlock(src + i * blockSize, rawSize, block.data(), block.size());
+			if (compressedSize == 0 || compressedSize >= rawSize) {
+				block.assign(src + i * blockSize, src + i * blockSize + rawSize);
+			}
+
+			else {
+				block.resize(compressedSize);
+			}
+			});
+
+		size_t headerSize = CONTAINER_HEADER_SIZE + blockCount * CONTAINER_INDEX_ENTRY_SIZE;
+		size_t totalSize = headerSize;
+		for (const std::vector<uint8_t>& block : blocks) totalSize += block.size();
+
+		output.resize(totalSize);
+		uint8_t* out = output.data();
+
+		Internal_Store<uint32_t>(out, CONTAINER_MAGIC);
+		Internal_Store<uint16_t>(out + 4, CONTAINER_VERSION);
+		Internal_Store<uint16_t>(out + 6, 0);
+		Internal_Store<uint32_t>(out + 8, (uint32_t)blockSize);
+		Internal_Store<uint32_t>(out + 12, (uint32_t)blockCount);
+		Internal_Store<uint64_t>(out + 16, (uint64_t)size);
+
+		uint64_t offset = headerSize;
+		for (size_t i = 0; i < blockCount; i++) {
+			uint8_t* entry = out + CONTAINER_HEADER_SIZE + i * CONTAINER_INDEX_ENTRY_SIZE;
+			Internal_Store<uint64_t>(entry, offset);
+			Internal_Store<uint32_t>(entry + 8, (uint32_t)blocks[i].size());
+			Internal_Store<uint32_t>(entry + 12, (uint32_t)std::min(blockSize, size - i * blockSize));
+
+			std::memcpy(out + offset, blocks[i].data(), blocks[i].size());
+			offset += blocks[i].size();
+		}
+	}
+
+	bool Compression::Decompress(const void* data, size_t size, std::string& output, const std::function<void(size_t)>& onAvailable, uint32_t threadCount)
+	{
+		const uint8_t* src = (const uint8_t*)data;
+		if (!IsCompressed(data, size)) return false;
+
+		size_t blockSize = Internal_Load<uint32_t>(src + 8);
+		size_t blockCount = Internal_Load<uint32_t>(src + 12);
+		uint64_t rawSize = Internal_Load<uint64_t>(src + 16);
+
+		if (blockCount > (size - CONTAINER_HEADER_SIZE) / CONTAINER_INDEX_ENTRY_SIZE) return false;
+		if (rawSize > (uint64_t)blockCount * blockSize) return false;
+
+		// validate the entire index up-front, workers can then trust it
+		struct Block { const uint8_t* src; size_t srcSize; size_t dstOffset; size_t dstSize; };
+		std::vector<Block> blocks(blockCount);
+		size_t dstOffset = 0;
+
+		for (size_t i = 0; i < blockCount; i++) {
+			const uint8_t* entry = src + CONTAINER_HEADER_SIZE + i * CONTAINER_INDEX_ENTRY_SIZE;
+			uint64_t offset = Internal_Load<uint64_t>(entry);
+			size_t compressedSize = Internal_Load<uint32_t>(entry + 8);
+			size_t uncompressedSize = Internal_Load<uint32_t>(entry + 12);
+
+			if (offset > size || compressedSize > size - offset || uncompressedSize > blockSize) return false;
+
+			blocks[i] = { src + offset, compressedSize, dstOffset, uncompressedSize };
+			dstOffset += uncompressedSize;
+		}
+
+		if (dstOffset != rawSize) return false;
+		output.resize((size_t)rawSize);
+
+		auto decompress = [&blocks, &output](size_t i) {
+			const Block& block = blocks[i];
+			uint8_t* dst = (uint8_t*)output.data() + block.dstOffset;
+
+			if (block.srcSize == block.dstSize) {
+				std::memcpy(dst, block.src, block.dstSize);
+				return true;
+			}
+
+			return DecompressBlock(block.src, block.srcSize, dst, block.dstSize);
+			};
+
+		// without a consumer every thread decompresses, the result is only known once all blocks are done
+		if (!onAvailable) {
+			std::atomic<bool> result = true;
+			Internal_ParallelFor(blockCount, threadCount, [&](size_t i) {
+				if (result && !decompress(i)) result = false;
+				});
+
+			return result;
+		}
+
+		// with a consumer, every block is a job decompressing ahead while the calling thread hands them out in order
+		std::unique_ptr<JobCounter[]> counters = std::make_unique<JobCounter[]>(blockCount);
+		std::vector<uint8_t> failed(blockCount, 0);
+		std::atomic<bool> abort = false;
+
+		for (size_t i = 0; i < blockCount; i++) {
+			JobSystem::Run([&decompress, &failed, &abort, i]() { if (!abort && !decompress(i)) failed[i] = 1; }, &counters[i]);
+		}
+
+		bool result = true;
+		size_t waited = 0;
+		for (; waited < blockCount; waited++) {
+			// waiting runs queued jobs meanwhile, the calling thread decompresses as well
+			JobSystem::Wait(counters[waited]);
+			if (failed[waited]) {
+				result = false;
+				abort = true;
+				break;
+			}
+
+			onAvailable(blocks[waited].dstOffset + blocks[waited].dstSize);
+		}
+
+		// the jobs reference the counters, they must all finish even when aborted
+		for (; waited < blockCount; waited++) JobSystem::Wait(counters[waited]);
+
+		if (result && blockCount == 0) onAvailable(0);
+		return result;
+	}
+}
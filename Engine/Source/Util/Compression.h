@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Cosmos
+{
+	/// @brief lz4-class block compression and a container of independently decompressible blocks
+	/// container layout:
+	///  - header : magic, version, flags, block size, block count, uncompressed size
+	///  - index  : per block it's offset in the container, compressed size and uncompressed size
+	///  - blocks : each block is either lz4-style sequences or stored as-is when it doesn't compress
+	/// since every block has it's own entry in the index, blocks are decompressed in parallel and handed to the reader in order
+	class COSMOS_API Compression
+	{
+	public:
+
+		/// @brief default amount of uncompressed bytes per block
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	public:
+
+		/// @brief returns the worst-case size of a compressed block
+		static size_t CompressBound(size_t size);
+
+		/// @brief compresses a single block, returns the compressed size or 0 if it doesn't fit into dstCapacity
+		static size_t CompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+
+		/// @brief decompresses a single block, dstSize must be it's exact uncompressed size, returns false on malformed input
+		static bool DecompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+	public:
+
+		/// @brief returns if data begins with a container header
+		static bool IsCompressed(const void* data, size_t size);
+
+		/// @brief compresses data into a block container, blocks are compressed in parallel by threadCount threads (0 for the job system)
+		static void Compress(const void* data, size_t size, std::vector<uint8_t>& output, size_t blockSize = DEFAULT_BLOCK_SIZE, uint32_t threadCount = 0);
+
+		/// @brief decompresses a block container, blocks are decompressed in parallel by threadCount threads (0 for the job system)
+		/// @param onAvailable if set, is called on the calling thread with how many leading bytes of output are ready, every time a block completes in order, blocks are then always jobs
+		static bool Decompress(const void* data, size_t size, std::string& output, const std::function<void(size_t available)>& onAvailable = {}, uint32_t threadCount = 0);
+	};
+}
@@ -1,134 +1,211 @@
 #pragma once
 
 #include "Core/Defines.h"
+#include "Util/FlatMap.h"
 #include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <optional>
 #include <vector>
 
 namespace Cosmos
 {
+    /// @brief a container of unique elements split in a bottom and a top half, meant to be read far more often than it's modified
+    /// readers work on an immutable snapshot and never lock nor allocate, writers copy the snapshot, modify the copy and publish it
+    /// elements are unique since each snapshot indexes them by value, pushing one that's already in the container is refused
     template<typename T>
     class COSMOS_API DualContainer
     {
+    private:
+
+        /// @brief an immutable version of the container, elements before middle are the bottom half
+        struct Snapshot
+        {
+            std::vector<T> elements;
+            size_t middle = 0;
+            FlatMap<T, size_t> positions; // index of each element
+        };
+
+        /// @brief holds a snapshot for reading, it's not reclaimed while any reader is active
+        class ReadGuard
+        {
+        public:
+
+            ReadGuard(const DualContainer& container)
+                : mContainer(container)
+            {
+                // announced before loading, so a writer either sees this reader or this reader sees the writer's snapshot
+                mContainer.mReaders.fetch_add(1, std::memory_order_seq_cst);
+                mSnapshot = mContainer.mCurrent.load(std::memory_order_seq_cst);
+            }
+
+            ~ReadGuard()
+            {
+                mContainer.mReaders.fetch_sub(1, std::memory_order_release);
+            }
+
+            inline const Snapshot* operator->() const { return mSnapshot; }
+
+        private:
+
+            const DualContainer& mContainer;
+            const Snapshot* mSnapshot = nullptr;
+        };
+
     public:
 
         /// @brief constructor
-        DualContainer() = default;
+        DualContainer() : mCurrent(new Snapshot()) {}
 
         /// @brief destructor
-        ~DualContainer() = default;
+        ~DualContainer()
+        {
+            delete mCurrent.load(std::memory_order_relaxed);
+            for (Snapshot* snapshot : mRetired) delete snapshot;
+        }
 
     public:
 
         /// @brief returns if container is empty
         inline bool Empty() const
         {
-            std::lock_guard<std::mutex> lock(mMutex);
-            return mElements.empty();
+            ReadGuard snapshot(*this);
+            return snapshot->elements.empty();
         }
 
         /// @brief returns the container size
         inline size_t Size() const
         {
-            std::lock_guard<std::mutex> lock(mMutex);
-            return mElements.size();
+            ReadGuard snapshot(*this);
+            return snapshot->elements.size();
         }
 
-        /// @brief adds an element to the top half (move version)
-        inline void PushToTop(const T& element)
+        /// @brief adds an element to the top half, returns false if it's already in the container
+        inline bool PushToTop(const T& element)
         {
-            std::lock_guard<std::mutex> lock(mMutex);
-            mElements.emplace_back(element);
+            return Internal_Write([&element](Snapshot& snapshot) {
+                if (snapshot.positions.contains(element)) return false;
+
+                snapshot.elements.emplace_back(element);
+                snapshot.positions.try_emplace(element, snapshot.elements.size() - 1);
+                return true;
+                });
         }
 
-        /// @brief adds an element to the bottom half (move version)
-        inline void PushToBottom(T&& element) {
-            std::lock_guard<std::mutex> lock(mMutex);
-            mElements.emplace(mElements.begin() + mMiddlePos, std::move(element));
-            mMiddlePos++;
+        /// @brief adds an element to the bottom half (move version), returns false if it's already in the container
+        inline bool PushToBottom(T&& element)
+        {
+            return Internal_Write([&element](Snapshot& snapshot) {
+                if (snapshot.positions.contains(element)) return false;
+
+                snapshot.elements.emplace(snapshot.elements.begin() + snapshot.middle, std::move(element));
+                snapshot.middle++;
+                Internal_Reindex(snapshot, snapshot.middle - 1);
+                return true;
+                });
         }
 
         /// @brief removes an element from anywhere in the container
         inline bool Remove(const T& element)
         {
-            std::lock_guard<std::mutex> lock(mMutex);
+            return Internal_Write([&element](Snapshot& snapshot) {
+                auto found = snapshot.positions.find(element);
+                if (found == snapshot.positions.end()) return false;
 
-            // search in bottom half first
-            auto bottomIt = std::find(mElements.begin(), mElements.begin() + mMiddlePos, element);
-            if (bottomIt != mElements.begin() + mMiddlePos) {
-                mElements.erase(bottomIt);
-                mMiddlePos--;
-                return true;
-            }
+                size_t position = found->second;
+                snapshot.positions.erase(element);
+                snapshot.elements.erase(snapshot.elements.begin() + position);
+                if (position < snapshot.middle) snapshot.middle--;
 
-            // search in top half
-            auto topIt = std::find(mElements.begin() + mMiddlePos, mElements.end(), element);
-            if (topIt != mElements.end()) {
-                mElements.erase(topIt);
+                Internal_Reindex(snapshot, position);
                 return true;
-            }
-
-            return false;
+                });
         }
 
         /// @brief checks if element exists anywhere in container
         inline bool Contains(const T& element) const
         {
-            std::lock_guard<std::mutex> lock(mMutex);
-
-            // search bottom half
-            if (std::find(mElements.begin(), mElements.begin() + mMiddlePos, element) != mElements.begin() + mMiddlePos) return true;
-
-            // search top half
-            return std::find(mElements.begin() + mMiddlePos, mElements.end(), element) != mElements.end();
+            ReadGuard snapshot(*this);
+            return snapshot->positions.contains(element);
         }
 
         /// @brief clears the entire container
         inline void Clear()
         {
-            std::lock_guard<std::mutex> lock(mMutex);
-            mElements.clear();
-            mMiddlePos = 0;
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+            Internal_Publish(new Snapshot());
         }
 
     public:
 
-        /// @brief finds an element by predicate in both halves
+        /// @brief finds an element by predicate, bottom half first
         template<typename Predicate>
         std::optional<T> FindIf(Predicate pred) const
         {
-            std::lock_guard<std::mutex> lock(mMutex);
-
-            // Search bottom half first
-            auto bottomIt = std::find_if(mElements.begin(), mElements.begin() + mMiddlePos, pred);
-            if (bottomIt != mElements.begin() + mMiddlePos) {
-                return *bottomIt;
-            }
+            ReadGuard snapshot(*this);
 
-            // Search top half
-            auto topIt = std::find_if(mElements.begin() + mMiddlePos, mElements.end(), pred);
-            if (topIt != mElements.end()) {
-                return *topIt;
+            auto it = std::find_if(snapshot->elements.begin(), snapshot->elements.end(), pred);
+            if (it != snapshot->elements.end()) {
+                return *it;
             }
 
             return std::nullopt;
         }
 
-        /// calls a function for each element
+        /// calls a function for each element, elements added/removed by func are only seen by the next iteration
+        /// the snapshot is shared with every other reader, so elements are given as const (what a pointer element points to is still mutable)
         template<typename Function>
-        inline void ForEach(Function func)
+        inline void ForEach(Function func) const
         {
-            std::lock_guard<std::mutex> lock(mMutex);
-            for (auto& element : mElements) {
+            ReadGuard snapshot(*this);
+            for (const auto& element : snapshot->elements) {
                 func(element);
             }
         }
 
     private:
 
-        mutable std::mutex mMutex;
-        std::vector<T> mElements;
-        size_t mMiddlePos = 0;
+        /// @brief refreshes the positions of the elements starting at first, they've shifted
+        static void Internal_Reindex(Snapshot& snapshot, size_t first)
+        {
+            for (size_t i = first; i < snapshot.elements.size(); i++) {
+                snapshot.positions.insert_or_assign(snapshot.elements[i], i);
+            }
+        }
+
+        /// @brief copies the current snapshot, modifies the copy and publishes it if modify returns true
+        template<typename Function>
+        bool Internal_Write(Function modify)
+        {
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+
+            Snapshot* next = new Snapshot(*mCurrent.load(std::memory_order_relaxed));
+            if (!modify(*next)) {
+                delete next;
+                return false;
+            }
+
+            Internal_Publish(next);
+            return true;
+        }
+
+        /// @brief swaps the current snapshot, the replaced ones are reclaimed once a write finds no active readers
+        void Internal_Publish(Snapshot* next)
+        {
+            mRetired.push_back(mCurrent.exchange(next, std::memory_order_seq_cst));
+
+            // readers arriving from now on load the new snapshot, so with none active the retired ones are unreachable
+            if (mReaders.load(std::memory_order_seq_cst) == 0) {
+                for (Snapshot* snapshot : mRetired) delete snapshot;
+                mRetired.clear();
+            }
+        }
+
+    private:
+
+        std::atomic<Snapshot*> mCurrent;
+        mutable std::atomic<uint32_t> mReaders = 0;
+        std::mutex mWriteMutex;
+        std::vector<Snapshot*> mRetired;
     };
-}
\ No newline at end of file
+}
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Core/Defines.h"
+#include "Util/Compression.h"
+#include <cstring>
 #include <sstream>
 #include <functional>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector> 
@@ -19,13 +22,13 @@ namespace Cosmos
 		// helper to write to files
 		struct Writer
 		{
-			std::ofstream& file;
+			std::ostream& file;
 			int32_t indentationLevel;
 			std::string indentation;
 			char separator;
 
 			// constructor
-			Writer(std::ofstream& file, int32_t indentationLevel = 0, const std::string indentation = "\t", char separator = ',')
+			Writer(std::ostream& file, int32_t indentationLevel = 0, const std::string indentation = "\t", char separator = ',')
 				: file(file), indentation(indentation), separator(separator), indentationLevel(0)
 			{
 			}
@@ -33,9 +36,28 @@ namespace Cosmos
 
 	public: // functions
 
-		// writes a data file to a file  (THIS IS CURRENTLY NOT PORTABLE)
-		static inline bool Write(const Datafile& dataFile, const std::string& path, char separator = ',')
+		// writes a data file to a file, optionally as a block-compressed container (THIS IS CURRENTLY NOT PORTABLE)
+		static inline bool Write(const Datafile& dataFile, const std::string& path, char separator = ',', bool compressed = false)
 		{
+			if (compressed) {
+				std::ostringstream text;
+				Writer writer(text, 0, "\t", separator);
+				WriteRecursively(dataFile, writer);
+
+				const std::string& contents = text.str();
+				std::vector<uint8_t> container;
+				Compression::Compress(contents.data(), contents.size(), container);
+
+				std::ofstream file(path, std::ios::binary);
+				if (!file.is_open()) {
+					return false;
+				}
+
+				file.write((const char*)container.data(), (std::streamsize)container.size());
+				file.close();
+				return !file.fail();
+			}
+
 			std::ofstream file(path);
 			if (file.is_open()) {
 				Writer writer(file, 0, "\t", separator);
@@ -47,129 +69,137 @@ namespace Cosmos
 			return false;
 		}
 
-		// reads data from a file
+		// reads data from a file, compressed files are decompressed in parallel while the already available lines are parsed
 		static inline bool Read(Datafile& dataFile, const std::string& path, char separator = ',')
 		{
-			std::ifstream file(path);
-			if (file.is_open()) {
-				// variables may be outside the loop and we may need to refer to previous iterations
-				std::string propName = {};
-				std::string propValue = {};
+			std::string buffer;
+			if (!ReadFileContents(path, buffer)) {
+				return false;
+			}
 
-				// using a stack to handle the reading
-				// may re-factor this later
-				std::stack<std::reference_wrapper<Datafile>> dfStack;
-				dfStack.push(dataFile);
+			if (!Compression::IsCompressed(buffer.data(), buffer.size())) {
+				ParseRange(dataFile, buffer.data(), buffer.data() + buffer.size(), separator);
+				return true;
+			}
 
-				while (!file.eof()) {
-					std::string line;
-					std::getline(file, line);
+			std::string text;
+			std::string propName = {};
+			std::stack<std::reference_wrapper<Datafile>> dfStack;
+			dfStack.push(dataFile);
+			size_t parsed = 0;
 
-					RemoveWhiteSpaces(line);
+			auto onAvailable = [&](size_t available) {
+				// only complete lines are parsed, a line split between blocks waits for the next block
+				const char* begin = text.data() + parsed;
+				const char* end = text.data() + available;
 
-					// line is not empty
-					if (line.empty()) {
-						continue;
-					}
+				if (available < text.size()) {
+					while (end > begin && end[-1] != '\n') end--;
+				}
 
-					// test if it's a comment
-					if (line[0] == '#') {
-						Datafile comment;
-						comment.mIsComment = true;
-						dfStack.top().get().mObjectVec.push_back({ line, comment });
+				ParseRange(dfStack, propName, begin, end, separator);
+				parsed = (size_t)(end - text.data());
+				};
 
-						continue;
-					}
+			return Compression::Decompress(buffer.data(), buffer.size(), text, onAvailable);
+		}
 
-					// check if equals symbol exists, if it does it is a property
-					size_t x = line.find_first_of('=');
-					if (x != std::string::npos) {
-						propName = line.substr(0, x);
-						RemoveWhiteSpaces(propName);
+		// reads data from a file, only indexing the top-level nodes, their subtrees are parsed uppon first access
+		// the first access parses into the node even through const functions, so an indexed data file must not be accessed by multiple threads at once, not even for reading
+		static inline bool ReadIndexed(Datafile& dataFile, const std::string& path, char separator = ',')
+		{
+			auto source = std::make_shared<std::string>();
+			if (!ReadFileContents(path, *source)) {
+				return false;
+			}
 
-						propValue = line.substr(x + 1, line.size());
-						RemoveWhiteSpaces(propValue);
+			// indexing needs the entire text, compressed files are decompressed upfront
+			if (Compression::IsCompressed(source->data(), source->size())) {
+				std::string text;
+				if (!Compression::Decompress(source->data(), source->size(), text)) {
+					return false;
+				}
+				source->swap(text);
+			}
 
-						// elements may contain quotes and separations, must deal with this particularity
-						bool inQuotes = false;
-						std::string token = {};
-						size_t tokenCount = 0;
+			const char* base = source->data();
+			const char* cur = base;
+			const char* end = base + source->size();
 
-						for (const auto c : propValue) {
-							if (c == '\"') {
-								inQuotes = true;
-							}
+			// top-level properties and comments are cheap and parsed right away, nodes only have their body offsets recorded
+			std::string propName = {};
+			std::stack<std::reference_wrapper<Datafile>> dfStack;
+			dfStack.push(dataFile);
 
-							else {
-								// it's in quotes, appends to a string
-								if (inQuotes) {
-									token.append(1, c);
-								}
-
-								else {
-									// char is the separator, register the new property
-									if (c == separator) {
-										RemoveWhiteSpaces(token);
-										dfStack.top().get()[propName].SetString(token, tokenCount);
-
-										token.clear();
-										tokenCount++;
-									}
-
-									// char is part of the token, appends to a string
-									else {
-										token.append(1, c);
-									}
-								}
-							}
-						}
+			Datafile* pending = nullptr;
+			size_t depth = 0;
 
-						// any left char makes the final token, used to handle any mistake in the file avoiding crashes
-						if (!token.empty()) {
-							RemoveWhiteSpaces(token);
-							dfStack.top().get()[propName].SetString(token, tokenCount);
-						}
+			while (cur < end) {
+				const char* lineBegin = cur;
+				const char* lineEnd = NextLine(cur, end);
+				std::string line(lineBegin, lineEnd);
+				RemoveWhiteSpaces(line);
+
+				if (line.empty()) {
+					continue;
+				}
+
+				// inside a top-level node, only track the scope depth
+				if (depth > 0) {
+					if (line[0] == '#' || line.find_first_of('=') != std::string::npos) {
+						continue;
 					}
 
-					else { // no ' = ' sign 
-						// the previous property is the new node
-						if (line[0] == '{') {
-							dfStack.push(dfStack.top().get()[propName]);
-						}
+					if (line[0] == '{') {
+						depth++;
+					}
 
-						else {
-							// node has been finished, pop it from the stack
-							if (line[0] == '}') {
-								dfStack.pop();
-							}
+					else if (line[0] == '}') {
+						depth--;
 
-							// line is a property with no assignment 
-							else {
-								propName = line;
-							}
+						// node body ends right before the closing brace
+						if (depth == 0) {
+							pending->mLazyEnd = (size_t)(lineBegin - base);
+							pending = nullptr;
 						}
 					}
+
+					continue;
 				}
-				file.close();
-				return true;
+
+				// a top-level node is starting, it's body begins at the next line
+				if (line[0] == '{' && line.find_first_of('=') == std::string::npos) {
+					pending = &dataFile[propName];
+					pending->mLazySource = source;
+					pending->mLazySeparator = separator;
+					pending->mLazyBegin = (size_t)(cur - base);
+					pending->mLazyEnd = source->size();
+					depth++;
+					continue;
+				}
+
+				ParseLine(line, dfStack, propName, separator);
 			}
-			return false;
+
+			return true;
 		}
 
 	public: // operator overloading
 
 		inline Datafile& operator[](const std::string& name)
 		{
-			// node map already does not contains an object with this name
-			if (mObjectMap.count(name) == 0)
-			{
-				// create the object in the map and create a new empty DataFile on the object vector
-				mObjectMap[name] = mObjectVec.size();
+			// node map already does not contains an object with this name, create the object in the map and create a new empty DataFile on the object vector
+			IndexChildren();
+			auto [it, inserted] = mObjectMap.try_emplace(name, mObjectVec.size());
+			if (inserted) {
 				mObjectVec.push_back({ name, Datafile() });
+				mIndexedCount = mObjectVec.size();
 			}
 
-			// returns the object by it's map index
-			return mObjectVec[mObjectMap[name]].second;
+			// returns the object by it's map index, parsing it if it was only indexed
+			Datafile& node = mObjectVec[it->second].second;
+			node.Resolve();
+			return node;
 		}
 
 		// trying to access a children node
@@ -180,7 +210,9 @@ namespace Cosmos
 				std::cerr << "Out of bounds, children doesnt exists" << std::endl;
 			}
 
-			return mObjectVec[index].second;
+			Datafile& node = mObjectVec[index].second;
+			node.Resolve();
+			return node;
 		}
 
 	public: // utils
@@ -194,15 +226,79 @@ namespace Cosmos
 		// returns the number of children this node has
 		inline size_t GetChildrenCount() const
 		{
+			Resolve();
 			return mObjectVec.size();
 		}
 
+		// returns the name of a children node
+		inline const std::string& GetChildName(size_t index) const
+		{
+			Resolve();
+			return mObjectVec[index].first;
+		}
+
+		// returns if this node's subtree has already been parsed, nodes read with ReadIndexed are only parsed uppon first access
+		inline bool IsResolved() const
+		{
+			return mLazySource == nullptr;
+		}
+
+		// parses this node's subtree if it was only indexed, this is called automatically when accessing the node, it's not thread-safe
+		// the parsed children are a cache of the source, so it's done from const functions as well
+		inline void Resolve() const
+		{
+			if (mLazySource == nullptr) {
+				return;
+			}
+
+			// marks the node as resolved before parsing, the local reference keeps the source alive meanwhile
+			std::shared_ptr<const std::string> source = std::move(mLazySource);
+			mLazySource = nullptr;
+
+			Datafile parsed;
+			ParseRange(parsed, source->data() + mLazyBegin, source->data() + mLazyEnd, mLazySeparator);
+
+			// a node repeated in the file already has the children of it's previous bodies
+			if (mObjectVec.empty()) {
+				mObjectVec = std::move(parsed.mObjectVec);
+				return;
+			}
+
+			for (auto& child : parsed.mObjectVec) {
+				mObjectVec.push_back(std::move(child));
+			}
+		}
+
 		// returns if either a property of this node exists or not
 		inline bool Exists(std::string property) const
 		{
+			Resolve();
+			IndexChildren();
 			return mObjectMap.find(property) != mObjectMap.end() ? true : false;
 		}
 
+		// returns a child node by name without creating it, nullptr if it doesn't exist
+		inline Datafile* Find(const std::string& name)
+		{
+			Resolve();
+			IndexChildren();
+			auto it = mObjectMap.find(name);
+			if (it == mObjectMap.end()) {
+				return nullptr;
+			}
+
+			Datafile& node = mObjectVec[it->second].second;
+			node.Resolve();
+			return &node;
+		}
+
+		// appends a child node without looking it's name up, the caller must know no child has the name already
+		inline Datafile& Append(const std::string& name)
+		{
+			mObjectVec.push_back({ name, Datafile() });
+			return mObjectVec.back().second;
+		}
+
 	public: // getters and setters
 
 		// sets a new string value of a property
@@ -258,6 +354,9 @@ namespace Cosmos
 
 			// iterate through each property of tthis DataFile node
 			for (auto const& prop : dataFile.mObjectVec) {
+				// nodes that were only indexed must be parsed before written, otherwise they'd be written as empty properties
+				prop.second.Resolve();
+
 				// property doesnt contain any children, so it's an assignment
 				if (prop.second.mObjectVec.empty()) {
 					writer.file << Indentation(writer.indentation, writer.indentationLevel) << prop.first << (prop.second.mIsComment ? "" : " = ");
@@ -301,6 +400,155 @@ namespace Cosmos
 			}
 		}
 
+		// reads the entire file into memory at once
+		static inline bool ReadFileContents(const std::string& path, std::string& output)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file.is_open()) {
+				return false;
+			}
+
+			std::streamoff size = file.tellg();
+			file.seekg(0, std::ios::beg);
+
+			output.resize(size > 0 ? (size_t)size : 0);
+			if (size > 0) {
+				file.read(output.data(), size);
+			}
+
+			file.close();
+			return true;
+		}
+
+		// returns the end of the line starting at cur and advances cur to the begining of the next one
+		static inline const char* NextLine(const char*& cur, const char* end)
+		{
+			const char* lineEnd = (const char*)std::memchr(cur, '\n', (size_t)(end - cur));
+			if (lineEnd == nullptr) {
+				lineEnd = end;
+				cur = end;
+				return lineEnd;
+			}
+
+			cur = lineEnd + 1;
+			return lineEnd;
+		}
+
+		// parses a range of text into the datafile
+		static inline void ParseRange(Datafile& dataFile, const char* begin, const char* end, char separator)
+		{
+			// variables may be outside the loop and we may need to refer to previous iterations
+			std::string propName = {};
+
+			// using a stack to handle the reading
+			// may re-factor this later
+			std::stack<std::reference_wrapper<Datafile>> dfStack;
+			dfStack.push(dataFile);
+
+			ParseRange(dfStack, propName, begin, end, separator);
+		}
+
+		// parses a range of text continuing from a previous range's state, ranges must end on a line boundary
+		static inline void ParseRange(std::stack<std::reference_wrapper<Datafile>>& dfStack, std::string& propName, const char* begin, const char* end, char separator)
+		{
+			const char* cur = begin;
+			while (cur < end) {
+				const char* lineBegin = cur;
+				const char* lineEnd = NextLine(cur, end);
+				std::string line(lineBegin, lineEnd);
+				RemoveWhiteSpaces(line);
+
+				// line is not empty
+				if (line.empty()) {
+					continue;
+				}
+
+				ParseLine(line, dfStack, propName, separator);
+			}
+		}
+
+		// parses a single, already trimmed, non-empty line
+		static inline void ParseLine(const std::string& line, std::stack<std::reference_wrapper<Datafile>>& dfStack, std::string& propName, char separator)
+		{
+			// test if it's a comment
+			if (line[0] == '#') {
+				Datafile comment;
+				comment.mIsComment = true;
+				dfStack.top().get().mObjectVec.push_back({ line, comment });
+
+				return;
+			}
+
+			// check if equals symbol exists, if it does it is a property
+			size_t x = line.find_first_of('=');
+			if (x != std::string::npos) {
+				propName = line.substr(0, x);
+				RemoveWhiteSpaces(propName);
+
+				std::string propValue = line.substr(x + 1, line.size());
+				RemoveWhiteSpaces(propValue);
+
+				// elements may contain quotes and separations, must deal with this particularity
+				bool inQuotes = false;
+				std::string token = {};
+				size_t tokenCount = 0;
+
+				for (const auto c : propValue) {
+					if (c == '\"') {
+						inQuotes = true;
+					}
+
+					else {
+						// it's in quotes, appends to a string
+						if (inQuotes) {
+							token.append(1, c);
+						}
+
+						else {
+							// char is the separator, register the new property
+							if (c == separator) {
+								RemoveWhiteSpaces(token);
+								dfStack.top().get()[propName].SetString(token, tokenCount);
+
+								token.clear();
+								tokenCount++;
+							}
+
+							// char is part of the token, appends to a string
+							else {
+								token.append(1, c);
+							}
+						}
+					}
+				}
+
+				// any left char makes the final token, used to handle any mistake in the file avoiding crashes
+				if (!token.empty()) {
+					RemoveWhiteSpaces(token);
+					dfStack.top().get()[propName].SetString(token, tokenCount);
+				}
+			}
+
+			else { // no ' = ' sign 
+				// the previous property is the new node
+				if (line[0] == '{') {
+					dfStack.push(dfStack.top().get()[propName]);
+				}
+
+				else {
+					// node has been finished, pop it from the stack
+					if (line[0] == '}') {
+						if (dfStack.size() > 1) dfStack.pop();
+					}
+
+					// line is a property with no assignment 
+					else {
+						propName = line;
+					}
+				}
+			}
+		}
+
 		// returns the indentation level stringified
 		static inline std::string Indentation(const std::string& str, const size_t count)
 		{
@@ -313,6 +561,16 @@ namespace Cosmos
 			return res;
 		}
 
+		// adds the children appended (or parsed) since the last lookup into the name map, comments are not looked up
+		inline void IndexChildren() const
+		{
+			for (; mIndexedCount < mObjectVec.size(); mIndexedCount++) {
+				if (!mObjectVec[mIndexedCount].second.mIsComment) {
+					mObjectMap.try_emplace(mObjectVec[mIndexedCount].first, mIndexedCount);
+				}
+			}
+		}
+
 		// removes the white spaces of a string
 		static void RemoveWhiteSpaces(std::string& str)
 		{
@@ -327,7 +585,14 @@ namespace Cosmos
 	private:
 
 		std::vector<std::string> mContent; // the items of this serializer
-		std::vector<std::pair<std::string, Datafile>> mObjectVec; // child nodes of this datafile
-		std::unordered_map<std::string, size_t>  mObjectMap;
+		mutable std::vector<std::pair<std::string, Datafile>> mObjectVec; // child nodes of this datafile, filled from const functions when an indexed node is resolved
+		mutable std::unordered_map<std::string, size_t>  mObjectMap; // built lazily, children are appended without it
+		mutable size_t mIndexedCount = 0; // how many children of the object vector were added to the map
+
+		// only set for nodes read with ReadIndexed that were not accessed yet
+		mutable std::shared_ptr<const std::string> mLazySource = nullptr; // the entire file contents, shared by all pending nodes
+		size_t mLazyBegin = 0; // offset where the node body begins within the source
+		size_t mLazyEnd = 0; // offset where the node body ends within the source
+		char mLazySeparator = ',';
 	};
 }
\ No newline at end of file
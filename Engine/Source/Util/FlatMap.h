@@ -0,0 +1,473 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define COSMOS_FLATMAP_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace Cosmos
+{
+    /// @brief open-addressing hash map with the swiss table layout, elements live in a single flat array next to one control byte per slot
+    /// the control byte holds 7 bits of the hash (or empty/deleted), lookups compare 16 control bytes at once (sse2) and only touch the slots that match
+    /// unlike std::unordered_map inserting doesn't allocate a node and growing invalidates iterators and references
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class FlatMap // template class should not be exported, no COSMOS_API
+    {
+    public:
+
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<const Key, Value>;
+        using size_type = size_t;
+
+        /// @brief how many control bytes are probed at once
+        static constexpr size_t GROUP_WIDTH = 16;
+
+    private:
+
+        using Control = int8_t;
+        static constexpr Control CONTROL_EMPTY = -128;
+        static constexpr Control CONTROL_DELETED = -2;
+
+        /// @brief a window of GROUP_WIDTH control bytes, matches return one bit per slot
+        struct Group
+        {
+            #if defined(COSMOS_FLATMAP_SSE2)
+            __m128i control;
+
+            explicit Group(const Control* position) : control(_mm_loadu_si128((const __m128i*)position)) {}
+
+            inline uint32_t Match(Control h2) const { return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), control)); }
+
+            inline uint32_t MatchEmpty() const { return Match(CONTROL_EMPTY); }
+
+            // empty and deleted are the only negative control bytes
+            inline uint32_t MatchEmptyOrDeleted() const { return (uint32_t)_mm_movemask_epi8(control); }
+            #else
+            Control control[GROUP_WIDTH];
+
+            explicit Group(const Control* position) { std::memcpy(control, position, GROUP_WIDTH); }
+
+            inline uint32_t Match(Control h2) const
+            {
+                uint32_t bits = 0;
+                for (uint32_t i = 0; i < GROUP_WIDTH; i++) bits |= (uint32_t)(control[i] == h2) << i;
+                return bits;
+            }
+
+            inline uint32_t MatchEmpty() const { return Match(CONTROL_EMPTY); }
+
+            inline uint32_t MatchEmptyOrDeleted() const
+            {
+                uint32_t bits = 0;
+                for (uint32_t i = 0; i < GROUP_WIDTH; i++) bits |= (uint32_t)(control[i] < 0) << i;
+                return bits;
+            }
+            #endif
+        };
+
+    public:
+
+        template<bool IsConst>
+        class Iterator
+        {
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename FlatMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+            using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+            Iterator() = default;
+
+            Iterator(const Control* control, value_type* slot, const Control* end)
+                : mControl(control), mSlot(slot), mEnd(end)
+            {
+                SkipUnused();
+            }
+
+            operator Iterator<true>() const { return Iterator<true>(mControl, mSlot, mEnd); }
+
+            inline reference operator*() const { return *mSlot; }
+            inline pointer operator->() const { return mSlot; }
+
+            inline Iterator& operator++() { ++mControl; ++mSlot; SkipUnused(); return *this; }
+            inline Iterator operator++(int) { Iterator previous = *this; ++(*this); return previous; }
+
+            inline bool operator==(const Iterator& other) const { return mSlot == other.mSlot; }
+            inline bool operator!=(const Iterator& other) const { return mSlot != other.mSlot; }
+
+        private:
+
+            /// @brief advances to the next full slot a group at a time, the control bytes are padded past the end so the last group is readable
+            inline void SkipUnused()
+            {
+                while (mControl != mEnd && *mControl < 0) {
+                    uint32_t full = ~Group(mControl).MatchEmptyOrDeleted() & ((1u << GROUP_WIDTH) - 1);
+                    size_t skip = full ? Internal_TrailingZeros(full) : GROUP_WIDTH;
+                    if (skip > (size_t)(mEnd - mControl)) skip = (size_t)(mEnd - mControl);
+
+                    mControl += skip;
+                    mSlot += skip;
+                }
+            }
+
+        private:
+
+            friend class FlatMap;
+            const Control* mControl = nullptr;
+            value_type* mSlot = nullptr;
+            const Control* mEnd = nullptr;
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+    public:
+
+        /// @brief constructor, doesn't allocate until the first insertion
+        FlatMap() = default;
+
+        /// @brief destructor
+        ~FlatMap() { Internal_Release(); }
+
+        /// @brief copy constructor
+        FlatMap(const FlatMap& other)
+        {
+            reserve(other.size());
+            for (const value_type& element : other) try_emplace(element.first, element.second);
+        }
+
+        /// @brief move constructor
+        FlatMap(FlatMap&& other) noexcept { Internal_Swap(other); }
+
+        /// @brief copy assignment
+        FlatMap& operator=(const FlatMap& other)
+        {
+            if (this != &other) {
+                FlatMap copy(other);
+                Internal_Swap(copy);
+            }
+            return *this;
+        }
+
+        /// @brief move assignment
+        FlatMap& operator=(FlatMap&& other) noexcept
+        {
+            if (this != &other) {
+                Internal_Release();
+                Internal_Swap(other);
+            }
+            return *this;
+        }
+
+    public:
+
+        /// @brief returns how many elements the map holds
+        inline size_t size() const { return mSize; }
+
+        /// @brief returns if the map holds no elements
+        inline bool empty() const { return mSize == 0; }
+
+        /// @brief returns how many slots are allocated
+        inline size_t capacity() const { return mCapacity; }
+
+        /// @brief destroys every element, keeping the allocated slots
+        void clear()
+        {
+            Internal_DestroyElements();
+            if (mCapacity > 0) std::memset(mControl, (uint8_t)CONTROL_EMPTY, mCapacity + GROUP_WIDTH);
+            mSize = 0;
+            mGrowthLeft = Internal_MaxLoad(mCapacity);
+        }
+
+        /// @brief allocates enough slots to hold count elements without growing
+        void reserve(size_t count)
+        {
+            size_t capacity = GROUP_WIDTH;
+            while (Internal_MaxLoad(capacity) < count) capacity *= 2;
+            if (capacity > mCapacity) Internal_Resize(capacity);
+        }
+
+    public:
+
+        /// @brief returns an iterator to the element with key or end()
+        inline iterator find(const Key& key)
+        {
+            return Internal_MakeIterator(Internal_Find(key, Internal_Hash(key)));
+        }
+
+        /// @brief returns a const iterator to the element with key or end()
+        inline const_iterator find(const Key& key) const
+        {
+            return Internal_MakeIterator(Internal_Find(key, Internal_Hash(key)));
+        }
+
+        /// @brief returns if the map has an element with key
+        inline bool contains(const Key& key) const { return Internal_Find(key, Internal_Hash(key)) != mCapacity; }
+
+        /// @brief returns the value of key, throws std::out_of_range if it doesn't exist
+        Value& at(const Key& key)
+        {
+            size_t index = Internal_Find(key, Internal_Hash(key));
+            if (index == mCapacity) throw std::out_of_range("FlatMap::at");
+            return mSlots[index].second;
+        }
+
+        /// @brief returns the value of key, throws std::out_of_range if it doesn't exist
+        const Value& at(const Key& key) const
+        {
+            size_t index = Internal_Find(key, Internal_Hash(key));
+            if (index == mCapacity) throw std::out_of_range("FlatMap::at");
+            return mSlots[index].second;
+        }
+
+        /// @brief constructs the value in place if key doesn't exist, returns the element and if it was inserted
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+        {
+            size_t hash = Internal_Hash(key);
+            size_t index = Internal_Find(key, hash);
+            if (index != mCapacity) return { Internal_MakeIterator(index), false };
+
+            index = Internal_PrepareInsert(hash);
+            new (mSlots + index) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+            return { Internal_MakeIterator(index), true };
+        }
+
+        /// @brief inserts or assigns the value of key, returns the element and if it was inserted
+        template<typename V>
+        std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value)
+        {
+            size_t index = Internal_Find(key, Internal_Hash(key));
+            if (index != mCapacity) {
+                mSlots[index].second = std::forward<V>(value);
+                return { Internal_MakeIterator(index), false };
+            }
+
+            return try_emplace(key, std::forward<V>(value));
+        }
+
+        /// @brief erases the element with key, returns how many were erased
+        size_t erase(const Key& key)
+        {
+            size_t index = Internal_Find(key, Internal_Hash(key));
+            if (index == mCapacity) return 0;
+
+            mSlots[index].~value_type();
+            mSize--;
+
+            // a slot can only become empty again if no probe ever went past it, meaning there was never a full group around it
+            size_t mask = mCapacity - 1;
+            uint32_t emptyBefore = Group(mControl + ((index - GROUP_WIDTH) & mask)).MatchEmpty();
+            uint32_t emptyAfter = Group(mControl + index).MatchEmpty();
+            bool neverFull = emptyBefore && emptyAfter && Internal_LeadingZeros(emptyBefore) + Internal_TrailingZeros(emptyAfter) < GROUP_WIDTH;
+
+            Internal_SetControl(index, neverFull ? CONTROL_EMPTY : CONTROL_DELETED);
+            if (neverFull) mGrowthLeft++;
+            return 1;
+        }
+
+    public:
+
+        /// @brief iterators
+        inline iterator begin() { return iterator(mControl, mSlots, mControl + mCapacity); }
+        inline iterator end() { return iterator(mControl + mCapacity, mSlots + mCapacity, mControl + mCapacity); }
+
+        /// @brief const iterators
+        inline const_iterator begin() const { return const_iterator(mControl, mSlots, mControl + mCapacity); }
+        inline const_iterator end() const { return const_iterator(mControl + mCapacity, mSlots + mCapacity, mControl + mCapacity); }
+        inline const_iterator cbegin() const { return begin(); }
+        inline const_iterator cend() const { return end(); }
+
+    private:
+
+        /// @brief std::hash of integers is usually the identity, the bits are mixed so both the slot (h1) and control byte (h2) are well distributed
+        inline size_t Internal_Hash(const Key& key) const
+        {
+            uint64_t hash = (uint64_t)mHash(key) * 0x9E3779B97F4A7C15ull;
+            return (size_t)(hash ^ (hash >> 32));
+        }
+
+        static inline size_t Internal_H1(size_t hash) { return hash >> 7; }
+        static inline Control Internal_H2(size_t hash) { return (Control)(hash & 0x7F); }
+
+        /// @brief how many elements fit in capacity slots, a 7/8 load factor
+        static inline size_t Internal_MaxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+        static inline uint32_t Internal_TrailingZeros(uint32_t bits)
+        {
+            #if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanForward(&index, bits);
+            return (uint32_t)index;
+            #else
+            return (uint32_t)__builtin_ctz(bits);
+            #endif
+        }
+
+        /// @brief leading zeros within the group's GROUP_WIDTH bits
+        static inline uint32_t Internal_LeadingZeros(uint32_t bits)
+        {
+            #if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanReverse(&index, bits);
+            return (uint32_t)(GROUP_WIDTH - 1 - index);
+            #else
+            return (uint32_t)__builtin_clz(bits) - (32 - GROUP_WIDTH);
+            #endif
+        }
+
+        /// @brief sets the control byte of a slot, the first GROUP_WIDTH bytes are mirrored past the end so groups never wrap
+        inline void Internal_SetControl(size_t index, Control control)
+        {
+            mControl[index] = control;
+            if (index < GROUP_WIDTH) mControl[mCapacity + index] = control;
+        }
+
+        inline iterator Internal_MakeIterator(size_t index) const
+        {
+            return iterator(mControl + index, mSlots + index, mControl + mCapacity);
+        }
+
+        /// @brief returns the slot index of key or mCapacity, probing groups in a triangular sequence that visits every group once
+        size_t Internal_Find(const Key& key, size_t hash) const
+        {
+            if (mCapacity == 0) return mCapacity;
+
+            size_t mask = mCapacity - 1;
+            size_t position = Internal_H1(hash) & mask;
+            Control h2 = Internal_H2(hash);
+
+            for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+                Group group(mControl + position);
+
+                for (uint32_t bits = group.Match(h2); bits; bits &= bits - 1) {
+                    size_t index = (position + Internal_TrailingZeros(bits)) & mask;
+                    if (mEqual(mSlots[index].first, key)) return index;
+                }
+
+                // the element would have been placed on the first empty slot found
+                if (group.MatchEmpty()) return mCapacity;
+                position = (position + step) & mask;
+            }
+        }
+
+        /// @brief returns the first empty or deleted slot on the probe sequence of hash
+        size_t Internal_FindInsertSlot(size_t hash) const
+        {
+            size_t mask = mCapacity - 1;
+            size_t position = Internal_H1(hash) & mask;
+
+            for (size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+                uint32_t bits = Group(mControl + position).MatchEmptyOrDeleted();
+                if (bits) return (position + Internal_TrailingZeros(bits)) & mask;
+                position = (position + step) & mask;
+            }
+        }
+
+        /// @brief claims a slot for a new element with hash, growing (or purging deleted slots) when there's no room left
+        size_t Internal_PrepareInsert(size_t hash)
+        {
+            if (mCapacity == 0) Internal_Resize(GROUP_WIDTH);
+
+            size_t index = Internal_FindInsertSlot(hash);
+            if (mGrowthLeft == 0 && mControl[index] != CONTROL_DELETED) {
+                // mostly deleted slots are purged in place, otherwise the table doubles
+                Internal_Resize(mSize + 1 > Internal_MaxLoad(mCapacity) / 2 ? mCapacity * 2 : mCapacity);
+                index = Internal_FindInsertSlot(hash);
+            }
+
+            if (mControl[index] == CONTROL_EMPTY) mGrowthLeft--;
+            Internal_SetControl(index, Internal_H2(hash));
+            mSize++;
+            return index;
+        }
+
+        /// @brief moves every element into a new table with capacity slots
+        void Internal_Resize(size_t capacity)
+        {
+            Control* oldControl = mControl;
+            value_type* oldSlots = mSlots;
+            size_t oldCapacity = mCapacity;
+
+            mControl = new Control[capacity + GROUP_WIDTH];
+            std::memset(mControl, (uint8_t)CONTROL_EMPTY, capacity + GROUP_WIDTH);
+            mSlots = std::allocator<value_type>().allocate(capacity);
+            mCapacity = capacity;
+            mGrowthLeft = Internal_MaxLoad(capacity) - mSize;
+
+            for (size_t i = 0; i < oldCapacity; i++) {
+                if (oldControl[i] < 0) continue;
+
+                size_t hash = Internal_Hash(oldSlots[i].first);
+                size_t index = Internal_FindInsertSlot(hash);
+                Internal_SetControl(index, Internal_H2(hash));
+                new (mSlots + index) value_type(std::move(oldSlots[i]));
+                oldSlots[i].~value_type();
+            }
+
+            if (oldCapacity > 0) {
+                delete[] oldControl;
+                std::allocator<value_type>().deallocate(oldSlots, oldCapacity);
+            }
+        }
+
+        void Internal_DestroyElements()
+        {
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (size_t i = 0; i < mCapacity; i++) {
+                    if (mControl[i] >= 0) mSlots[i].~value_type();
+                }
+            }
+        }
+
+        void Internal_Release()
+        {
+            if (mCapacity == 0) return;
+
+            Internal_DestroyElements();
+            delete[] mControl;
+            std::allocator<value_type>().deallocate(mSlots, mCapacity);
+            mControl = nullptr;
+            mSlots = nullptr;
+            mCapacity = mSize = mGrowthLeft = 0;
+        }
+
+        void Internal_Swap(FlatMap& other) noexcept
+        {
+            std::swap(mControl, other.mControl);
+            std::swap(mSlots, other.mSlots);
+            std::swap(mCapacity, other.mCapacity);
+            std::swap(mSize, other.mSize);
+            std::swap(mGrowthLeft, other.mGrowthLeft);
+        }
+
+    private:
+
+        Control* mControl = nullptr;
+        value_type* mSlots = nullptr;
+        size_t mCapacity = 0; // always a power of two, at least GROUP_WIDTH
+        size_t mSize = 0;
+        size_t mGrowthLeft = 0; // empty slots that may still be used before the load factor is exceeded
+        Hash mHash = {};
+        KeyEqual mEqual = {};
+    };
+}
@@ -1,9 +1,10 @@
 #pragma once
 
 #include "Core/Defines.h"
+#include <algorithm>
 #include <atomic>
-#include <mutex>
-#include <unordered_set>
+#include <limits>
+#include <memory>
 
 namespace Cosmos
 {
@@ -31,67 +32,138 @@ namespace Cosmos
         uint32_t value;
     };
 
+    /// @brief lock-free generator of ids in [1, capacity]
+    /// live ids are tracked in a dense atomic bitset, released ids are recycled through a lock-free free-list (a stack of slot links)
+    /// the free-list head carries a generation tag incremented on every push/pop, so a stale head can never be swapped back in (aba)
+    /// a second bitset marks ids sitting in the free-list, an id recreated with Create(value) stays listed and is never pushed twice
+    /// every operation is O(1) and allocation-free, Create is lock-free and IsValid/Destroy's bit flip are wait-free
     class COSMOS_API IDGenerator
     {
     public:
 
-        /// @brief creates an ID
-        ID Create()
+        /// @brief default amount of ids a generator can have alive at once, users expecting more pass their own capacity
+        static constexpr uint32_t DEFAULT_CAPACITY = 1u << 12;
+
+    public:
+
+        /// @brief constructor, all memory used by the generator is allocated here
+        IDGenerator(uint32_t capacity = DEFAULT_CAPACITY)
+            : mCapacity(std::max(1u, std::min(capacity, MAX_ID)))
+            , mLive(new std::atomic<uint64_t>[((size_t)mCapacity + 1 + 63) / 64])
+            , mListed(new std::atomic<uint64_t>[((size_t)mCapacity + 1 + 63) / 64])
+            , mNext(new std::atomic<uint32_t>[(size_t)mCapacity + 1])
         {
-            std::lock_guard<std::mutex> lock(mMutex);
-            uint32_t newId = ++mCounter;
+            Reset();
+        }
 
-            // prevent overflow
-            if (newId == 0 || newId > MAX_ID) throw std::runtime_error("ID overflow");
+        /// @brief returns how many ids the generator can have alive at once
+        inline uint32_t GetCapacity() const { return mCapacity; }
 
-            mActiveIds.insert(newId);
-            return ID{ newId };
+    public:
+
+        /// @brief creates an ID, recycled ids are handed out first, returns ID::Null() once the capacity is exhausted
+        ID Create()
+        {
+            // recycled ids
+            uint64_t head = mFreeHead.load(std::memory_order_acquire);
+            while ((uint32_t)head != FREE_LIST_END) {
+                uint32_t index = (uint32_t)head;
+                uint32_t next = mNext[index].load(std::memory_order_relaxed);
+                uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+
+                if (!mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire)) continue;
+                mListed[index >> 6].fetch_and(~(1ull << (index & 63)), std::memory_order_acq_rel);
+
+                // the id may have been claimed by Create(value) while it sat in the free-list, it's owned elsewhere now
+                if (Acquire(index)) return ID{ index };
+                head = mFreeHead.load(std::memory_order_acquire);
+            }
+
+            // never used ids
+            for (;;) {
+                uint32_t index = mCounter.fetch_add(1, std::memory_order_relaxed);
+                if (index == 0 || index > mCapacity) {
+                    mCounter.store(mCapacity + 1, std::memory_order_relaxed); // keeps the counter from wrapping around
+                    return ID::Null();
+                }
+
+                if (Acquire(index)) return ID{ index };
+            }
         }
 
         /// @brief creates an ID with a specific value
         bool Create(uint32_t idValue)
         {
-            if (idValue == 0 || idValue > MAX_ID) return false;
-
-            std::lock_guard<std::mutex> lock(mMutex);
-            if (!mActiveIds.insert(idValue).second) return false; // already exists
+            if (idValue == 0 || idValue > mCapacity) return false;
+            if (!Acquire(idValue)) return false; // already exists
 
             // update counter to avoid reusing lower IDs
-            if (idValue > mCounter) mCounter = idValue;
+            uint32_t counter = mCounter.load(std::memory_order_relaxed);
+            while (counter <= idValue && !mCounter.compare_exchange_weak(counter, idValue + 1, std::memory_order_relaxed)) {}
             return true;
         }
 
-        /// @brief removes an id
+        /// @brief removes an id, making it available for recycling
         bool Destroy(ID id)
         {
-            if (id.GetValue() == 0) return false;
+            uint32_t index = id.GetValue();
+            if (index == 0 || index > mCapacity) return false;
 
-            std::lock_guard<std::mutex> lock(mMutex);
-            return mActiveIds.erase(id.GetValue()) > 0;
+            uint64_t bit = 1ull << (index & 63);
+            if ((mLive[index >> 6].fetch_and(~bit, std::memory_order_acq_rel) & bit) == 0) return false;
+
+            // the id was recreated by Create(value) while still in the free-list, it's recycled from there already
+            if ((mListed[index >> 6].fetch_or(bit, std::memory_order_acq_rel) & bit) != 0) return true;
+
+            uint64_t head = mFreeHead.load(std::memory_order_relaxed);
+            uint64_t newHead;
+            do {
+                mNext[index].store((uint32_t)head, std::memory_order_relaxed);
+                newHead = (((head >> 32) + 1) << 32) | index;
+            } while (!mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+
+            return true;
         }
 
         /// @brief checks if id is active
         bool IsValid(ID id) const
         {
-            if (id.GetValue() == 0) return false;
+            uint32_t index = id.GetValue();
+            if (index == 0 || index > mCapacity) return false;
 
-            std::lock_guard<std::mutex> lock(mMutex);
-            return mActiveIds.find(id.GetValue()) != mActiveIds.end();
+            return (mLive[index >> 6].load(std::memory_order_acquire) >> (index & 63)) & 1;
         }
 
-        /// @brief clear all id's in use
+        /// @brief clear all id's in use, must not run concurrently with other operations
         void Reset()
         {
-            std::lock_guard<std::mutex> lock(mMutex);
-            mCounter = 0;
-            mActiveIds.clear();
+            for (size_t i = 0; i < ((size_t)mCapacity + 1 + 63) / 64; i++) {
+                mLive[i].store(0, std::memory_order_relaxed);
+                mListed[i].store(0, std::memory_order_relaxed);
+            }
+            mCounter.store(1, std::memory_order_relaxed);
+            mFreeHead.store(FREE_LIST_END, std::memory_order_release);
+        }
+
+    private:
+
+        /// @brief sets the id's live bit, returns false if it was already set
+        inline bool Acquire(uint32_t index)
+        {
+            uint64_t bit = 1ull << (index & 63);
+            return (mLive[index >> 6].fetch_or(bit, std::memory_order_acq_rel) & bit) == 0;
         }
 
     private:
 
         static constexpr uint32_t MAX_ID = std::numeric_limits<uint32_t>::max() - 1;
-        uint32_t mCounter = 0;
-        std::unordered_set<uint32_t> mActiveIds;
-        mutable std::mutex mMutex;
+        static constexpr uint32_t FREE_LIST_END = 0; // id 0 is null, so it never is a free-list entry
+
+        uint32_t mCapacity = 0;
+        std::unique_ptr<std::atomic<uint64_t>[]> mLive;
+        std::unique_ptr<std::atomic<uint64_t>[]> mListed;
+        std::unique_ptr<std::atomic<uint32_t>[]> mNext;
+        std::atomic<uint32_t> mCounter = 1;
+        std::atomic<uint64_t> mFreeHead = FREE_LIST_END; // generation tag << 32 | first free id
     };
 }
\ No newline at end of file
@@ -0,0 +1,360 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cren_profiler.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace Cosmos
+{
+	/// @brief a queued function and the counter waiting on it
+	struct Job
+	{
+		JobSystem::Function function;
+		JobCounter* counter = nullptr;
+
+		/// @brief counts the job as finished, returning the jobs depending on it's counter once it reaches zero
+		std::vector<Job*> Finish()
+		{
+			// the counter may be destroyed as soon as a waiter sees it reach zero, so nothing touches it after the lock is released
+			std::vector<Job*> continuations;
+			if (!counter) return continuations;
+
+			std::lock_guard<std::mutex> lock(counter->mMutex);
+			if (counter->mPending.fetch_sub(1, std::memory_order_acq_rel) == 1) continuations.swap(counter->mContinuations);
+			return continuations;
+		}
+	};
+
+	/// @brief chase-lev deque, only it's owner pushes and pops (at the bottom), any thread steals (from the top)
+	/// the capacity is fixed, jobs are coarse and ranges split lazily so a deque rarely holds more than a few dozen
+	class Internal_JobDeque
+	{
+	public:
+
+		/// @brief pushes a job at the bottom, owner only, returns false if it's full
+		bool Push(Job* job)
+		{
+			int64_t bottom = mBottom.load(std::memory_order_relaxed);
+			int64_t top = mTop.load(std::memory_order_acquire);
+			if (bottom - top >= (int64_t)JobSystem::DEQUE_CAPACITY) return false;
+
+			mBuffer[bottom & DEQUE_MASK].store(job, std::memory_order_relaxed);
+			mBottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// @brief pops the last pushed job, owner only, racing the thieves for the last one
+		Job* Pop()
+		{
+			int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+			mBottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t top = mTop.load(std::memory_order_relaxed);
+
+			if (top > bottom) {
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Job* job = mBuffer[bottom & DEQUE_MASK].load(std::memory_order_relaxed);
+			if (top == bottom) {
+				if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+
+			return job;
+		}
+
+		/// @brief takes the oldest job, any thread, returns nullptr if it's empty or another thread won it
+		Job* Steal()
+		{
+			int64_t top = mTop.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t bottom = mBottom.load(std::memory_order_acquire);
+			if (top >= bottom) return nullptr;
+
+			Job* job = mBuffer[top & DEQUE_MASK].load(std::memory_order_relaxed);
+			if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+			return job;
+		}
+
+		/// @brief returns if it looks empty, it may change right after
+		bool IsEmpty() const
+		{
+			return mTop.load(std::memory_order_acquire) >= mBottom.load(std::memory_order_acquire);
+		}
+
+	private:
+
+		static constexpr int64_t DEQUE_MASK = (int64_t)JobSystem::DEQUE_CAPACITY - 1;
+		static_assert((JobSystem::DEQUE_CAPACITY & (JobSystem::DEQUE_CAPACITY - 1)) == 0, "Deque capacity must be a power of two");
+
+		alignas(64) std::atomic<int64_t> mTop = 0;
+		alignas(64) std::atomic<int64_t> mBottom = 0;
+		std::atomic<Job*> mBuffer[JobSystem::DEQUE_CAPACITY] = {};
+	};
+
+	/// @brief state shared by the workers, allocated once and never freed so no thread is joined while the module unloads
+	struct Internal_JobState
+	{
+		std::vector<std::unique_ptr<Internal_JobDeque>> deques; // 0 is the owner's, then one per worker
+		std::vector<std::thread> workers;
+		std::atomic<bool> running = false;
+
+		std::mutex injectionMutex; // jobs from threads without a deque
+		std::deque<Job*> injection;
+		std::atomic<size_t> injectionSize = 0;
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+		std::atomic<uint32_t> sleeping = 0;
+	};
+
+	static std::mutex sInitializeMutex;
+	static std::atomic<Internal_JobState*> sState = nullptr;
+	static thread_local int32_t tDequeIndex = -1; // the calling thread's deque, -1 if it has none
+
+	/// @brief returns the state, initializing the system with defaults if it's the first use
+	static Internal_JobState* Internal_GetState()
+	{
+		Internal_JobState* state = sState.load(std::memory_order_acquire);
+		if (state) return state;
+
+		JobSystem::Initialize();
+		return sState.load(std::memory_order_acquire);
+	}
+
+	/// @brief returns if any job is queued, it may change right after
+	static bool Internal_HasJobs(Internal_JobState* state)
+	{
+		if (state->injectionSize.load(std::memory_order_seq_cst) > 0) return true;
+
+		for (const std::unique_ptr<Internal_JobDeque>& deque : state->deques) {
+			if (!deque->IsEmpty()) return true;
+		}
+
+		return false;
+	}
+
+	/// @brief takes a job for the thread owning deque index, it's own jobs first, then shared ones, then the other deques
+	static Job* Internal_FindJob(Internal_JobState* state, int32_t index)
+	{
+		if (index >= 0) {
+			if (Job* job = state->deques[index]->Pop()) return job;
+		}
+
+		if (state->injectionSize.load(std::memory_order_acquire) > 0) {
+			std::lock_guard<std::mutex> lock(state->injectionMutex);
+			if (!state->injection.empty()) {
+				Job* job = state->injection.front();
+				state->injection.pop_front();
+				state->injectionSize.store(state->injection.size(), std::memory_order_release);
+				return job;
+			}
+		}
+
+		// thieves start from different deques so they don't all fight over the same one
+		size_t count = state->deques.size();
+		size_t start = (size_t)(index + 1);
+		for (size_t i = 0; i < count; i++) {
+			size_t victim = (start + i) % count;
+			if ((int32_t)victim == index) continue;
+			if (Job* job = state->deques[victim]->Steal()) return job;
+		}
+
+		return nullptr;
+	}
+
+	/// @brief queues a job whose dependency (if any) already finished, waking a sleeping worker for it
+	static void Internal_Submit(Internal_JobState* state, Job* job);
+
+	/// @brief runs a job and counts it as finished, queueing the jobs that were waiting on it's counter
+	static void Internal_Execute(Internal_JobState* state, Job* job)
+	{
+		job->function();
+
+		std::vector<Job*> continuations = job->Finish();
+		delete job;
+
+		for (Job* continuation : continuations) Internal_Submit(state, continuation);
+	}
+
+	static void Internal_Submit(Internal_JobState* state, Job* job)
+	{
+		// a full deque runs the job right away, it's what the thread would do next anyway
+		if (tDequeIndex >= 0 && (size_t)tDequeIndex < state->deques.size()) {
+			if (!state->deques[tDequeIndex]->Push(job)) {
+				Internal_Execute(state, job);
+				return;
+			}
+		}
+
+		else {
+			std::lock_guard<std::mutex> lock(state->injectionMutex);
+			state->injection.push_back(job);
+			state->injectionSize.store(state->injection.size(), std::memory_order_release);
+		}
+
+		// pairs with the sleeper counting itself before looking for jobs, one of the two sees the other
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (state->sleeping.load(std::memory_order_relaxed) > 0) {
+			std::lock_guard<std::mutex> lock(state->sleepMutex);
+			state->sleepCondition.notify_one();
+		}
+	}
+
+	/// @brief loop of a worker thread, it spins briefly when out of jobs before sleeping
+	static void Internal_WorkerLoop(Internal_JobState* state, int32_t index)
+	{
+		tDequeIndex = index;
+
+		std::string name = "Job Worker " + std::to_string(index);
+		cren_profiler_set_thread_name(name.c_str());
+
+		constexpr uint32_t SPIN_COUNT = 64;
+		uint32_t idle = 0;
+
+		while (state->running.load(std::memory_order_acquire)) {
+			if (Job* job = Internal_FindJob(state, index)) {
+				Internal_Execute(state, job);
+				idle = 0;
+				continue;
+			}
+
+			if (++idle < SPIN_COUNT) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			// the timeout only guards against a missed wake up, submitting always notifies a sleeper
+			state->sleeping.fetch_add(1, std::memory_order_seq_cst);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			{
+				std::unique_lock<std::mutex> lock(state->sleepMutex);
+				if (state->running.load(std::memory_order_acquire) && !Internal_HasJobs(state)) {
+					state->sleepCondition.wait_for(lock, std::chrono::milliseconds(100));
+				}
+			}
+			state->sleeping.fetch_sub(1, std::memory_order_relaxed);
+			idle = 0;
+		}
+	}
+
+	/// @brief runs [begin, end) splitting it in halves while it's bigger than grain, the upper halves are queued for others to steal
+	static void Internal_RunRange(size_t begin, size_t end, size_t grain, const JobSystem::RangeFunction& function, JobCounter& counter)
+	{
+		while (end - begin > grain) {
+			size_t middle = begin + (end - begin) / 2;
+			JobSystem::Run([middle, end, grain, &function, &counter]() { Internal_RunRange(middle, end, grain, function, counter); }, &counter);
+			end = middle;
+		}
+
+		function(begin, end);
+	}
+
+	void JobSystem::Initialize(uint32_t workerCount)
+	{
+		std::lock_guard<std::mutex> lock(sInitializeMutex);
+		if (sState.load(std::memory_order_acquire)) return;
+
+		if (workerCount == 0) {
+			uint32_t hardware = std::thread::hardware_concurrency();
+			workerCount = hardware > 1 ? hardware - 1 : 1;
+		}
+
+		static Internal_JobState* state = new Internal_JobState();
+		state->deques.clear();
+		for (uint32_t i = 0; i <= workerCount; i++) state->deques.push_back(std::make_unique<Internal_JobDeque>());
+
+		tDequeIndex = 0;
+		state->running.store(true, std::memory_order_release);
+		sState.store(state, std::memory_order_release);
+
+		for (uint32_t i = 1; i <= workerCount; i++) state->workers.emplace_back(Internal_WorkerLoop, state, (int32_t)i);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		std::lock_guard<std::mutex> lock(sInitializeMutex);
+		Internal_JobState* state = sState.load(std::memory_order_acquire);
+		if (!state) return;
+
+		state->running.store(false, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> sleepLock(state->sleepMutex);
+			state->sleepCondition.notify_all();
+		}
+
+		for (std::thread& worker : state->workers) worker.join();
+		state->workers.clear();
+
+		// whatever is left runs here, so nothing waiting on a counter hangs; jobs it queues land in the owner deque and are picked up too
+		int32_t previousIndex = tDequeIndex;
+		tDequeIndex = 0;
+		while (Job* job = Internal_FindJob(state, 0)) Internal_Execute(state, job);
+		tDequeIndex = previousIndex == 0 ? -1 : previousIndex;
+
+		sState.store(nullptr, std::memory_order_release);
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return (uint32_t)Internal_GetState()->workers.size();
+	}
+
+	void JobSystem::Run(Function function, JobCounter* counter, JobCounter* dependency)
+	{
+		Internal_JobState* state = Internal_GetState();
+
+		Job* job = new Job();
+		job->function = std::move(function);
+		job->counter = counter;
+
+		if (counter) counter->mPending.fetch_add(1, std::memory_order_relaxed);
+
+		// the dependency's lock orders this with it's last job finishing, so it's either still pending and keeps the job, or already done
+		if (dependency) {
+			std::lock_guard<std::mutex> lock(dependency->mMutex);
+			if (dependency->mPending.load(std::memory_order_acquire) > 0) {
+				dependency->mContinuations.push_back(job);
+				return;
+			}
+		}
+
+		Internal_Submit(state, job);
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		Internal_JobState* state = Internal_GetState();
+
+		while (!counter.IsDone()) {
+			if (Job* job = Internal_FindJob(state, tDequeIndex)) Internal_Execute(state, job);
+			else std::this_thread::yield();
+		}
+
+		// the last job may still be releasing the counter's lock
+		std::lock_guard<std::mutex> lock(counter.mMutex);
+	}
+
+	void JobSystem::ParallelFor(size_t count, const RangeFunction& function, size_t grain)
+	{
+		if (count == 0) return;
+
+		// about eight ranges per thread, enough for the faster threads to steal from the slower without splitting it to crumbs
+		if (grain == 0) grain = std::max<size_t>(1, count / (((size_t)GetWorkerCount() + 1) * 8));
+
+		if (count <= grain) {
+			function(0, count);
+			return;
+		}
+
+		JobCounter counter;
+		Internal_RunRange(0, count, grain, function, counter);
+		Wait(counter);
+	}
+}
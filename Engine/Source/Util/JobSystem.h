@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Cosmos
+{
+	// forward declarations
+	struct Job;
+
+	/// @brief counts the unfinished jobs it was handed to, waiting on it runs other jobs meanwhile
+	/// jobs may depend on a counter, they're only queued once it reaches zero
+	class COSMOS_API JobCounter
+	{
+	public:
+
+		/// @brief constructor
+		JobCounter() = default;
+
+		/// @brief jobs point to it, it's not copyable
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		/// @brief returns if every job handed to the counter finished, only JobSystem::Wait makes it safe to destroy the counter
+		inline bool IsDone() const { return mPending.load(std::memory_order_acquire) == 0; }
+
+	private:
+
+		friend class JobSystem;
+		friend struct Job;
+		std::atomic<uint32_t> mPending = 0;
+		std::mutex mMutex;					// orders the last job finishing with continuations being added
+		std::vector<Job*> mContinuations;	// jobs depending on the counter, queued once it reaches zero
+	};
+
+	/// @brief runs jobs over a pool of worker threads, each with it's own work-stealing deque (chase-lev)
+	/// the thread that initializes it (the main thread) owns a deque as well and runs jobs while it waits on them
+	class COSMOS_API JobSystem
+	{
+	public:
+
+		using Function = std::function<void()>;
+		using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+		/// @brief how many jobs a deque holds, a thread pushing into a full one runs the job itself
+		static constexpr size_t DEQUE_CAPACITY = 4096;
+
+	public:
+
+		/// @brief starts workerCount workers (0 for one less than the hardware threads, at least one), the calling thread becomes the owner
+		/// it's otherwise started by the first job, on whatever thread submits it
+		static void Initialize(uint32_t workerCount = 0);
+
+		/// @brief stops the workers, the jobs still queued are run by the calling thread first, it must be the one that initialized it
+		static void Shutdown();
+
+		/// @brief returns how many worker threads there are, the owner thread not included
+		static uint32_t GetWorkerCount();
+
+	public:
+
+		/// @brief queues a job, counter (if any) counts it until it finishes and it only runs after dependency (if any) reaches zero
+		/// jobs are pushed into the submitting thread's deque, threads without one (not the owner nor a worker) share a locked queue
+		static void Run(Function function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+		/// @brief runs queued jobs (own first, then stolen) until counter reaches zero
+		static void Wait(JobCounter& counter);
+
+		/// @brief calls function over [0, count) in ranges, returning once all of them ran, the calling thread takes part
+		/// ranges are halved while bigger than grain, leaving the other halves for idle workers to steal, 0 picks a grain from the worker count
+		static void ParallelFor(size_t count, const RangeFunction& function, size_t grain = 0);
+	};
+}
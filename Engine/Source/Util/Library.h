@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Core/Defines.h"
-#include <unordered_map>
+#include "Util/FlatMap.h"
 #include <string>
 #include <utility>
 #include <optional>
@@ -20,7 +20,7 @@ namespace Cosmos
         ~Library() = default;
         
         /// @brief returns a const reference to all objects inside the library
-        inline const std::unordered_map<Key, Value>& GetAllRef() const { return mContent; }
+        inline const FlatMap<Key, Value>& GetAllRef() const { return mContent; }
 
         /// @brief returns the library size
         inline size_t Size() const { return mContent.size(); }
@@ -29,7 +29,7 @@ namespace Cosmos
         inline bool Empty() const { return mContent.empty(); }
         
         /// @bief returns if the library has a given key
-        inline bool Contains(const Key& key) const { return mContent.find(key) != mContent.end();  }
+        inline bool Contains(const Key& key) const { return mContent.contains(key); }
         
         /// @brief returns the content's reference at a specific key
         inline Value& At(const Key& key) {  return mContent.at(key); }
@@ -62,7 +62,7 @@ namespace Cosmos
         // @brief inserts an item into the library
         inline bool Insert(const Key& key, Value value)
         {
-            return mContent.emplace(key, std::move(value)).second;
+            return mContent.try_emplace(key, std::move(value)).second;
         }
         
         /// @brief inserts or modifies a value into a key, returns true if inserted, false if assigned
@@ -82,6 +82,6 @@ namespace Cosmos
         inline auto cend() const { return mContent.cend(); }
 
     private:
-        std::unordered_map<Key, Value> mContent;
+        FlatMap<Key, Value> mContent;
     };
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Memory.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace Cosmos
+{
+	LinearArena::LinearArena(size_t chunkSize)
+		: mChunkSize(chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE)
+	{
+	}
+
+	LinearArena::~LinearArena()
+	{
+		for (Chunk& chunk : mChunks) {
+			std::free(chunk.data);
+		}
+	}
+
+	LinearArena& LinearArena::GetThreadArena()
+	{
+		static thread_local LinearArena arena;
+		return arena;
+	}
+
+	void* LinearArena::Allocate(size_t size, size_t alignment)
+	{
+		for (;;) {
+			// bump within the current chunk, moving on to the next one (kept from before the last reset) when it's full
+			while (mChunkIndex < mChunks.size()) {
+				Chunk& chunk = mChunks[mChunkIndex];
+				uintptr_t base = (uintptr_t)chunk.data;
+				uintptr_t aligned = (base + mOffset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+				if (aligned + size <= base + chunk.size) {
+					mOffset = (size_t)(aligned - base) + size;
+					return (void*)aligned;
+				}
+
+				mChunkIndex++;
+				mOffset = 0;
+			}
+
+			// the arena hasn't grown this big before
+			Chunk chunk;
+			chunk.size = std::max(mChunkSize, size + alignment);
+			chunk.data = (uint8_t*)std::malloc(chunk.size);
+			if (!chunk.data) throw std::bad_alloc();
+
+			mChunks.push_back(chunk);
+			mChunkIndex = mChunks.size() - 1;
+			mOffset = 0;
+		}
+	}
+
+	void LinearArena::Reset()
+	{
+		mChunkIndex = 0;
+		mOffset = 0;
+	}
+
+	size_t LinearArena::GetUsedSize() const
+	{
+		size_t used = 0;
+		for (size_t i = 0; i < mChunkIndex && i < mChunks.size(); i++) used += mChunks[i].size;
+		return used + mOffset;
+	}
+
+	size_t LinearArena::GetReservedSize() const
+	{
+		size_t reserved = 0;
+		for (const Chunk& chunk : mChunks) reserved += chunk.size;
+		return reserved;
+	}
+}
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "Core/Defines.h"
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <vector>
+#include <cren_memory.h>
 #include <memm/memm.h>
 
 namespace Cosmos
@@ -21,4 +25,233 @@ namespace Cosmos
 	{
 		return std::make_shared<T>(std::forward<Args>(args)...);
 	}
-}
\ No newline at end of file
+}
+
+namespace Cosmos
+{
+	/// @brief bump allocator over a list of chunks, memory is only reclaimed all at once (Reset) or back to a marker (Rewind)
+	/// chunks are kept across resets, once the arena has grown to it's peak usage allocating never touches the global heap
+	/// not thread-safe, each thread has it's own arena (GetThreadArena)
+	class COSMOS_API LinearArena
+	{
+	public:
+
+		/// @brief a position in the arena, everything allocated after it is released by rewinding to it
+		struct Marker
+		{
+			size_t chunk = 0;
+			size_t offset = 0;
+		};
+
+		/// @brief size of the chunks the arena grows by, bigger allocations get a chunk of their own
+		static constexpr size_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+
+	public:
+
+		/// @brief constructor, doesn't allocate until the first allocation
+		LinearArena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+		/// @brief destructor, frees all chunks
+		~LinearArena();
+
+		/// @brief arenas hand out pointers into their chunks, they're not copyable
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		/// @brief returns the calling thread's arena, meant for job temporaries released with an ArenaScope
+		static LinearArena& GetThreadArena();
+
+	public:
+
+		/// @brief returns size bytes aligned to alignment (a power of two), they're valid until a reset/rewind past them
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		/// @brief releases everything, keeping the chunks for reuse
+		void Reset();
+
+		/// @brief returns the current position
+		inline Marker GetMarker() const { return { mChunkIndex, mOffset }; }
+
+		/// @brief releases everything allocated after the marker was taken
+		inline void Rewind(const Marker& marker) { mChunkIndex = marker.chunk; mOffset = marker.offset; }
+
+		/// @brief returns how many bytes are in use, including alignment padding and the unused tail of skipped chunks
+		size_t GetUsedSize() const;
+
+		/// @brief returns how many bytes the chunks hold
+		size_t GetReservedSize() const;
+
+	private:
+
+		struct Chunk
+		{
+			uint8_t* data = nullptr;
+			size_t size = 0;
+		};
+
+		std::vector<Chunk> mChunks;
+		size_t mChunkIndex = 0;
+		size_t mOffset = 0;
+		size_t mChunkSize = DEFAULT_CHUNK_SIZE;
+	};
+
+	/// @brief stl allocator adaptor over an arena, deallocations are no-ops (the arena releases it all at once)
+	/// containers should reserve upfront, since the buffers left behind by growing are only reclaimed with the arena
+	template<typename T>
+	class ArenaAllocator
+	{
+	public:
+
+		using value_type = T;
+
+		ArenaAllocator(LinearArena& arena) noexcept : mArena(&arena) {}
+
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) noexcept : mArena(other.GetArena()) {}
+
+		inline T* allocate(size_t count) { return (T*)mArena->Allocate(sizeof(T) * count, alignof(T)); }
+
+		inline void deallocate(T*, size_t) noexcept {}
+
+		inline LinearArena* GetArena() const { return mArena; }
+
+		template<typename U>
+		inline bool operator==(const ArenaAllocator<U>& other) const { return mArena == other.GetArena(); }
+
+		template<typename U>
+		inline bool operator!=(const ArenaAllocator<U>& other) const { return mArena != other.GetArena(); }
+
+	private:
+
+		LinearArena* mArena = nullptr;
+	};
+
+	template<typename T>
+	using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+	/// @brief rewinds an arena when leaving the scope, everything allocated from it inside the scope is released
+	class ArenaScope
+	{
+	public:
+
+		/// @brief constructor, defaults to the calling thread's arena
+		ArenaScope(LinearArena& arena = LinearArena::GetThreadArena()) : mArena(arena), mMarker(arena.GetMarker()) {}
+
+		/// @brief destructor, rewinds the arena
+		~ArenaScope() { mArena.Rewind(mMarker); }
+
+		/// @brief returns the arena
+		inline LinearArena& GetArena() { return mArena; }
+
+		/// @brief returns an stl allocator over the arena
+		template<typename T>
+		inline ArenaAllocator<T> GetAllocator() { return ArenaAllocator<T>(mArena); }
+
+	private:
+
+		LinearArena& mArena;
+		LinearArena::Marker mMarker;
+	};
+
+	/// @brief per-subsystem memory accounting, the counters live in cren so device memory and engine objects are reported together
+	class COSMOS_API MemoryTracker
+	{
+	public:
+
+		/// @brief records size bytes allocated elsewhere under tag
+		static inline void Track(CRen_MemoryTag tag, size_t size) { cren_memory_track(tag, size); }
+
+		/// @brief records the release of bytes previously tracked under tag
+		static inline void Untrack(CRen_MemoryTag tag, size_t size) { cren_memory_untrack(tag, size); }
+
+		/// @brief closes the current frame's allocation counts, called once per frame by the application
+		static inline void BeginFrame() { cren_memory_begin_frame(); }
+
+		/// @brief returns the counters of a tag
+		static inline CRenMemoryStats GetStats(CRen_MemoryTag tag)
+		{
+			CRenMemoryStats stats = {};
+			cren_memory_get_stats(tag, &stats);
+			return stats;
+		}
+
+		/// @brief returns the allocations made during the last complete frame, under every tag
+		static inline uint64_t GetFrameAllocations()
+		{
+			uint64_t allocations = 0;
+			for (int tag = 0; tag < CREN_MEMORY_TAG_MAX; tag++) allocations += GetStats((CRen_MemoryTag)tag).frameAllocations;
+			return allocations;
+		}
+
+		/// @brief returns the display name of a tag
+		static inline const char* GetTagName(CRen_MemoryTag tag) { return cren_memory_tag_name(tag); }
+	};
+
+	/// @brief tracks bytes under a tag while in scope, for buffers owned by types that don't take an allocator
+	class MemoryTrackScope
+	{
+	public:
+
+		MemoryTrackScope(CRen_MemoryTag tag, size_t size) : mTag(tag), mSize(size) { cren_memory_track(tag, size); }
+
+		~MemoryTrackScope() { cren_memory_untrack(mTag, mSize); }
+
+		MemoryTrackScope(const MemoryTrackScope&) = delete;
+		MemoryTrackScope& operator=(const MemoryTrackScope&) = delete;
+
+	private:
+
+		CRen_MemoryTag mTag;
+		size_t mSize;
+	};
+
+	/// @brief stl allocator adaptor that accounts the container's memory under Tag
+	template<typename T, CRen_MemoryTag Tag>
+	class TaggedAllocator
+	{
+	public:
+
+		using value_type = T;
+
+		template<typename U>
+		struct rebind { using other = TaggedAllocator<U, Tag>; };
+
+		TaggedAllocator() noexcept = default;
+
+		template<typename U>
+		TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept {}
+
+		inline T* allocate(size_t count)
+		{
+			static_assert(alignof(T) <= 16, "tagged allocations are aligned as malloc's");
+
+			void* ptr = cren_memory_alloc(Tag, sizeof(T) * count);
+			if (!ptr) throw std::bad_alloc();
+			return (T*)ptr;
+		}
+
+		inline void deallocate(T* ptr, size_t) noexcept { cren_memory_free(ptr); }
+
+		template<typename U>
+		inline bool operator==(const TaggedAllocator<U, Tag>&) const { return true; }
+
+		template<typename U>
+		inline bool operator!=(const TaggedAllocator<U, Tag>&) const { return false; }
+	};
+
+	/// @brief base class that accounts every heap instance of the derived class under Tag
+	template<CRen_MemoryTag Tag>
+	class TaggedObject
+	{
+	public:
+
+		static inline void* operator new(size_t size)
+		{
+			void* ptr = cren_memory_alloc(Tag, size);
+			if (!ptr) throw std::bad_alloc();
+			return ptr;
+		}
+
+		static inline void operator delete(void* ptr) noexcept { cren_memory_free(ptr); }
+	};
+}
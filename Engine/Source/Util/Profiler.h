@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include <cren_profiler.h>
+
+namespace Cosmos
+{
+	/// @brief profiles the scope it lives in as a zone, use COSMOS_PROFILE_SCOPE instead so it's removed with the profiler
+	class ProfileScope
+	{
+	public:
+
+		/// @brief constructor, name must outlive the profiler (a string literal)
+		inline ProfileScope(const char* name) { cren_profiler_begin(name); }
+
+		/// @brief destructor
+		inline ~ProfileScope() { cren_profiler_end(); }
+
+		/// @brief a zone is closed exactly once
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+	};
+}
+
+/// @brief macros for profiling zones, removed entirely when CREN_PROFILER_DISABLED is defined (ENABLE_PROFILER=OFF)
+#define COSMOS_PROFILE_CONCAT_INTERNAL(a, b) a##b
+#define COSMOS_PROFILE_CONCAT(a, b) COSMOS_PROFILE_CONCAT_INTERNAL(a, b)
+
+#ifdef CREN_PROFILER_DISABLED
+	#define COSMOS_PROFILE_SCOPE(name) ((void)0)
+	#define COSMOS_PROFILE_FUNCTION() ((void)0)
+#else
+	#define COSMOS_PROFILE_SCOPE(name) Cosmos::ProfileScope COSMOS_PROFILE_CONCAT(profileScope, __LINE__)(name)
+	#define COSMOS_PROFILE_FUNCTION() COSMOS_PROFILE_SCOPE(__FUNCTION__)
+#endif
@@ -0,0 +1,518 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include "Util/Datafile.h"
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <vecmath/vecmath.h>
+
+namespace Cosmos::Reflection
+{
+    /// @brief all field types the serializers know how to handle
+    enum class FieldType : uint8_t
+    {
+        Unknown = 0,
+        Bool,
+        Int32,
+        UInt32,
+        Float,
+        Double,
+        Float2,
+        Float3,
+        Float4
+    };
+
+    /// @brief describes a single member of a reflected type
+    struct Field
+    {
+        const char* name;
+        size_t offset;
+        size_t size;
+        FieldType type;
+    };
+
+    /// @brief holds the field table of a type, specialized by the COSMOS_REFLECT macros
+    template<typename T>
+    struct TypeInfo
+    {
+        static constexpr bool reflected = false;
+    };
+
+    /// @brief returns the field type of a member type at compile time
+    template<typename M>
+    constexpr FieldType FieldTypeOf()
+    {
+        if constexpr (std::is_same_v<M, bool>) return FieldType::Bool;
+        else if constexpr (std::is_same_v<M, int32_t>) return FieldType::Int32;
+        else if constexpr (std::is_same_v<M, uint32_t>) return FieldType::UInt32;
+        else if constexpr (std::is_same_v<M, float>) return FieldType::Float;
+        else if constexpr (std::is_same_v<M, double>) return FieldType::Double;
+        else if constexpr (std::is_same_v<M, float2>) return FieldType::Float2;
+        else if constexpr (std::is_same_v<M, float3>) return FieldType::Float3;
+        else if constexpr (std::is_same_v<M, float4>) return FieldType::Float4;
+        else return FieldType::Unknown;
+    }
+
+    /// @brief returns if the type has a field table
+    template<typename T>
+    constexpr bool IsReflected()
+    {
+        return TypeInfo<T>::reflected;
+    }
+
+    /// @brief returns how many fields the type has
+    template<typename T>
+    constexpr size_t FieldCount()
+    {
+        return sizeof(TypeInfo<T>::fields) / sizeof(Field);
+    }
+
+    /// @brief returns the size of all fields tightly packed, this is the size one element takes in the binary format
+    template<typename T>
+    constexpr size_t PackedSize()
+    {
+        size_t size = 0;
+        for (size_t i = 0; i < FieldCount<T>(); i++) size += TypeInfo<T>::fields[i].size;
+        return size;
+    }
+
+    /// @brief returns if the fields cover the entire type in declaration order without padding, allowing whole-object memcpy
+    template<typename T>
+    constexpr bool IsMemcpyable()
+    {
+        if (!std::is_trivially_copyable_v<T>) return false;
+
+        size_t expected = 0;
+        for (size_t i = 0; i < FieldCount<T>(); i++) {
+            if (TypeInfo<T>::fields[i].offset != expected) return false;
+            expected += TypeInfo<T>::fields[i].size;
+        }
+        return expected == sizeof(T);
+    }
+}
+
+/// @brief declares the field table of a type, must be used at global scope after the type's declaration
+#define COSMOS_REFLECT_BEGIN(TYPE, NAME)                                                    \
+    template<> struct Cosmos::Reflection::TypeInfo<TYPE>                                    \
+    {                                                                                       \
+        using Type = TYPE;                                                                  \
+        static constexpr bool reflected = true;                                             \
+        static constexpr const char* name = NAME;                                           \
+        static constexpr Cosmos::Reflection::Field fields[] = {
+
+/// @brief adds a member into the field table, KEY is the name used by the serializers
+#define COSMOS_REFLECT_FIELD(MEMBER, KEY)                                                   \
+            Cosmos::Reflection::Field{ KEY, offsetof(Type, MEMBER), sizeof(Type::MEMBER),   \
+                Cosmos::Reflection::FieldTypeOf<decltype(Type::MEMBER)>() },
+
+/// @brief finishes the field table
+#define COSMOS_REFLECT_END()                                                                \
+        };                                                                                  \
+        static_assert(sizeof(fields) > 0, "Reflected type must have at least one field");   \
+    };
+
+namespace Cosmos::Reflection
+{
+    /// @brief appends raw data into a growing byte buffer
+    class BinaryWriter
+    {
+    public:
+
+        /// @brief constructor
+        BinaryWriter(std::vector<uint8_t>& buffer) : mBuffer(buffer) {}
+
+        /// @brief writes raw bytes
+        inline void Write(const void* data, size_t size)
+        {
+            size_t pos = mBuffer.size();
+            mBuffer.resize(pos + size);
+            if (size > 0) std::memcpy(mBuffer.data() + pos, data, size);
+        }
+
+        /// @brief writes a trivially copyable value
+        template<typename V>
+        inline void WriteValue(const V& value)
+        {
+            static_assert(std::is_trivially_copyable_v<V>, "Only trivially copyable values can be written");
+            Write(&value, sizeof(V));
+        }
+
+        /// @brief writes a length-prefixed string
+        inline void WriteString(const char* str)
+        {
+            uint16_t len = (uint16_t)std::strlen(str);
+            WriteValue(len);
+            Write(str, len);
+        }
+
+        /// @brief reserves space for size bytes and returns where they begin, the pointer is invalidated by the next write
+        inline uint8_t* Reserve(size_t size)
+        {
+            size_t pos = mBuffer.size();
+            mBuffer.resize(pos + size);
+            return mBuffer.data() + pos;
+        }
+
+        /// @brief returns the underlying buffer
+        inline std::vector<uint8_t>& GetBufferRef() { return mBuffer; }
+
+    private:
+
+        std::vector<uint8_t>& mBuffer;
+    };
+
+    /// @brief reads raw data from a byte range, every read fails once the range is exhausted
+    class BinaryReader
+    {
+    public:
+
+        /// @brief constructor
+        BinaryReader(const uint8_t* data, size_t size) : mCur(data), mEnd(data + size) {}
+
+        /// @brief returns if all reads so far succeeded
+        inline bool IsValid() const { return mValid; }
+
+        /// @brief returns how many bytes are left
+        inline size_t Remaining() const { return (size_t)(mEnd - mCur); }
+
+        /// @brief reads raw bytes
+        inline bool Read(void* data, size_t size)
+        {
+            if (!mValid || Remaining() < size) return mValid = false;
+            if (size > 0) std::memcpy(data, mCur, size);
+            mCur += size;
+            return true;
+        }
+
+        /// @brief reads a trivially copyable value
+        template<typename V>
+        inline bool ReadValue(V& value)
+        {
+            static_assert(std::is_trivially_copyable_v<V>, "Only trivially copyable values can be read");
+            return Read(&value, sizeof(V));
+        }
+
+        /// @brief reads a length-prefixed string
+        inline bool ReadString(std::string& str)
+        {
+            uint16_t len = 0;
+            if (!ReadValue(len) || Remaining() < len) return mValid = false;
+            str.assign((const char*)mCur, len);
+            mCur += len;
+            return true;
+        }
+
+        /// @brief returns the current position and skips size bytes, nullptr if there's not enough data
+        inline const uint8_t* Consume(size_t size)
+        {
+            if (!mValid || Remaining() < size) { mValid = false; return nullptr; }
+            const uint8_t* ptr = mCur;
+            mCur += size;
+            return ptr;
+        }
+
+    private:
+
+        const uint8_t* mCur = nullptr;
+        const uint8_t* mEnd = nullptr;
+        bool mValid = true;
+    };
+
+    /// @brief field keys converted into strings once per type, so serializing many objects doesn't rebuild them
+    template<typename T>
+    struct TextKeys
+    {
+        std::vector<std::string> fields;
+        std::string components[4] = { "X", "Y", "Z", "W" };
+
+        /// @brief returns the keys of the type
+        static const TextKeys& Get()
+        {
+            static const TextKeys keys = []() {
+                TextKeys result;
+                for (size_t i = 0; i < FieldCount<T>(); i++) result.fields.emplace_back(TypeInfo<T>::fields[i].name);
+                return result;
+            }();
+            return keys;
+        }
+    };
+
+    /// @brief returns the child with a given key or nullptr, checking the expected position first to avoid the lookup when the node was written by SaveText
+    inline Datafile* FindChild(Datafile& node, const std::string& key, size_t expectedIndex)
+    {
+        if (expectedIndex < node.GetChildrenCount() && node.GetChildName(expectedIndex) == key) return &node[expectedIndex];
+        return node.Find(key);
+    }
+
+    /// @brief returns the child with a given key, creating it if missing
+    /// while every key so far was found at it's position (or appended there) the node holds only the previous keys, so a new one is appended without a lookup
+    inline Datafile& FindOrAddChild(Datafile& node, const std::string& key, size_t expectedIndex, bool& inOrder)
+    {
+        if (inOrder) {
+            if (expectedIndex < node.GetChildrenCount() && node.GetChildName(expectedIndex) == key) return node[expectedIndex];
+            if (expectedIndex == node.GetChildrenCount()) return node.Append(key);
+            inOrder = false;
+        }
+
+        return node[key];
+    }
+
+    /// @brief returns how many float components a vector field type has, 0 if not a vector
+    constexpr size_t VectorComponents(FieldType type)
+    {
+        switch (type)
+        {
+            case FieldType::Float2: return 2;
+            case FieldType::Float3: return 3;
+            case FieldType::Float4: return 4;
+            default: return 0;
+        }
+    }
+
+    /// @brief writes every reflected field of an object into a datafile node
+    template<typename T>
+    void SaveText(const T& object, Datafile& node)
+    {
+        static_assert(IsReflected<T>(), "Type must be reflected with COSMOS_REFLECT_BEGIN");
+        const TextKeys<T>& keys = TextKeys<T>::Get();
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(&object);
+        bool inOrder = true;
+
+        for (size_t i = 0; i < FieldCount<T>(); i++) {
+            const Field& field = TypeInfo<T>::fields[i];
+            const uint8_t* ptr = base + field.offset;
+            Datafile& child = FindOrAddChild(node, keys.fields[i], i, inOrder);
+
+            switch (field.type)
+            {
+                case FieldType::Bool: { bool v; std::memcpy(&v, ptr, sizeof(v)); child.SetInt(v ? 1 : 0); break; }
+                case FieldType::Int32: { int32_t v; std::memcpy(&v, ptr, sizeof(v)); child.SetInt(v); break; }
+                case FieldType::UInt32: { uint32_t v; std::memcpy(&v, ptr, sizeof(v)); child.SetString(std::to_string(v)); break; }
+                case FieldType::Float: { float v; std::memcpy(&v, ptr, sizeof(v)); child.SetDouble(v); break; }
+                case FieldType::Double: { double v; std::memcpy(&v, ptr, sizeof(v)); child.SetDouble(v); break; }
+                case FieldType::Float2:
+                case FieldType::Float3:
+                case FieldType::Float4:
+                {
+                    // vector unions are laid out as consecutive floats
+                    bool componentsInOrder = true;
+                    for (size_t c = 0; c < VectorComponents(field.type); c++) {
+                        float v;
+                        std::memcpy(&v, ptr + c * sizeof(float), sizeof(v));
+                        FindOrAddChild(child, keys.components[c], c, componentsInOrder).SetDouble(v);
+                    }
+                    break;
+                }
+                default: break;
+            }
+        }
+    }
+
+    /// @brief reads every reflected field of an object from a datafile node, missing fields are left untouched
+    template<typename T>
+    void LoadText(T& object, Datafile& node)
+    {
+        static_assert(IsReflected<T>(), "Type must be reflected with COSMOS_REFLECT_BEGIN");
+        const TextKeys<T>& keys = TextKeys<T>::Get();
+        uint8_t* base = reinterpret_cast<uint8_t*>(&object);
+
+        for (size_t i = 0; i < FieldCount<T>(); i++) {
+            const Field& field = TypeInfo<T>::fields[i];
+            Datafile* found = FindChild(node, keys.fields[i], i);
+            if (!found) continue;
+
+            uint8_t* ptr = base + field.offset;
+            Datafile& child = *found;
+
+            switch (field.type)
+            {
+                case FieldType::Bool: { bool v = child.GetInt() != 0; std::memcpy(ptr, &v, sizeof(v)); break; }
+                case FieldType::Int32: { int32_t v = child.GetInt(); std::memcpy(ptr, &v, sizeof(v)); break; }
+                case FieldType::UInt32: { uint32_t v = (uint32_t)std::strtoul(child.GetString().c_str(), nullptr, 10); std::memcpy(ptr, &v, sizeof(v)); break; }
+                case FieldType::Float: { float v = (float)child.GetDouble(); std::memcpy(ptr, &v, sizeof(v)); break; }
+                case FieldType::Double: { double v = child.GetDouble(); std::memcpy(ptr, &v, sizeof(v)); break; }
+                case FieldType::Float2:
+                case FieldType::Float3:
+                case FieldType::Float4:
+                {
+                    for (size_t c = 0; c < VectorComponents(field.type); c++) {
+                        Datafile* component = FindChild(child, keys.components[c], c);
+                        if (!component) continue;
+
+                        float v = (float)component->GetDouble();
+                        std::memcpy(ptr + c * sizeof(float), &v, sizeof(v));
+                    }
+                    break;
+                }
+                default: break;
+            }
+        }
+    }
+
+    /// @brief writes the field table of a type, so readers can detect layout changes
+    template<typename T>
+    void WriteSchema(BinaryWriter& writer)
+    {
+        writer.WriteString(TypeInfo<T>::name);
+        writer.WriteValue((uint32_t)FieldCount<T>());
+
+        for (size_t i = 0; i < FieldCount<T>(); i++) {
+            const Field& field = TypeInfo<T>::fields[i];
+            writer.WriteString(field.name);
+            writer.WriteValue((uint8_t)field.type);
+            writer.WriteValue((uint32_t)field.size);
+        }
+    }
+
+    /// @brief maps a schema stored in a file into the current field table of a type, resolved once per component block
+    struct SchemaMapping
+    {
+        struct StoredField
+        {
+            int32_t localIndex; // -1 if the field no longer exists
+            uint32_t size;
+            size_t packedOffset;
+        };
+
+        bool identical = false; // stored layout is exactly the current one
+        size_t packedSize = 0; // size of one stored element
+        std::vector<StoredField> stored;
+    };
+
+    /// @brief reads a schema previously written with WriteSchema, returns false if it describes another type
+    template<typename T>
+    bool ReadSchema(BinaryReader& reader, SchemaMapping& mapping)
+    {
+        std::string typeName;
+        uint32_t fieldCount = 0;
+        if (!reader.ReadString(typeName) || !reader.ReadValue(fieldCount)) return false;
+        if (typeName != TypeInfo<T>::name) return false;
+
+        mapping = {};
+        mapping.identical = fieldCount == FieldCount<T>();
+        mapping.stored.reserve(fieldCount);
+
+        std::string fieldName;
+        for (uint32_t i = 0; i < fieldCount; i++) {
+            uint8_t type = 0;
+            uint32_t size = 0;
+            if (!reader.ReadString(fieldName) || !reader.ReadValue(type) || !reader.ReadValue(size)) return false;
+
+            SchemaMapping::StoredField stored = { -1, size, mapping.packedSize };
+            for (size_t f = 0; f < FieldCount<T>(); f++) {
+                const Field& field = TypeInfo<T>::fields[f];
+                if (fieldName == field.name && (FieldType)type == field.type && size == field.size) {
+                    stored.localIndex = (int32_t)f;
+                    break;
+                }
+            }
+
+            mapping.identical &= stored.localIndex == (int32_t)i;
+            mapping.packedSize += size;
+            mapping.stored.push_back(stored);
+        }
+
+        return true;
+    }
+
+    /// @brief writes one object tightly packed, in field order
+    template<typename T>
+    inline void WritePacked(const T& object, uint8_t* out)
+    {
+        if constexpr (IsMemcpyable<T>()) {
+            std::memcpy(out, &object, sizeof(T));
+        }
+
+        else {
+            const uint8_t* base = reinterpret_cast<const uint8_t*>(&object);
+            for (size_t i = 0; i < FieldCount<T>(); i++) {
+                const Field& field = TypeInfo<T>::fields[i];
+                std::memcpy(out, base + field.offset, field.size);
+                out += field.size;
+            }
+        }
+    }
+
+    /// @brief reads one packed object using a previously resolved schema mapping
+    template<typename T>
+    inline void ReadPacked(T& object, const uint8_t* in, const SchemaMapping& mapping)
+    {
+        uint8_t* base = reinterpret_cast<uint8_t*>(&object);
+
+        if (mapping.identical) {
+            if constexpr (IsMemcpyable<T>()) {
+                std::memcpy(base, in, sizeof(T));
+            }
+
+            else {
+                for (size_t i = 0; i < FieldCount<T>(); i++) {
+                    const Field& field = TypeInfo<T>::fields[i];
+                    std::memcpy(base + field.offset, in, field.size);
+                    in += field.size;
+                }
+            }
+            return;
+        }
+
+        // layout changed since the file was written, only copy the fields that still exist
+        for (const SchemaMapping::StoredField& stored : mapping.stored) {
+            if (stored.localIndex < 0) continue;
+            const Field& field = TypeInfo<T>::fields[stored.localIndex];
+            std::memcpy(base + field.offset, in + stored.packedOffset, field.size);
+        }
+    }
+
+    /// @brief writes an array of objects as a schema followed by the element count and the packed payload
+    template<typename T>
+    void SaveBinary(const T* objects, size_t count, BinaryWriter& writer)
+    {
+        static_assert(IsReflected<T>(), "Type must be reflected with COSMOS_REFLECT_BEGIN");
+        WriteSchema<T>(writer);
+        writer.WriteValue((uint64_t)count);
+
+        uint8_t* out = writer.Reserve(count * PackedSize<T>());
+        if constexpr (IsMemcpyable<T>()) {
+            if (count > 0) std::memcpy(out, objects, count * sizeof(T));
+        }
+
+        else {
+            for (size_t i = 0; i < count; i++) {
+                WritePacked(objects[i], out);
+                out += PackedSize<T>();
+            }
+        }
+    }
+
+    /// @brief reads an array of objects written by SaveBinary, appending them into the output vector
+    template<typename T>
+    bool LoadBinary(std::vector<T>& objects, BinaryReader& reader)
+    {
+        static_assert(IsReflected<T>(), "Type must be reflected with COSMOS_REFLECT_BEGIN");
+        SchemaMapping mapping;
+        uint64_t count = 0;
+        if (!ReadSchema<T>(reader, mapping) || !reader.ReadValue(count)) return false;
+        if (mapping.packedSize != 0 && count > reader.Remaining() / mapping.packedSize) return false;
+
+        const uint8_t* in = reader.Consume((size_t)count * mapping.packedSize);
+        if (!in) return false;
+
+        size_t first = objects.size();
+        if constexpr (IsMemcpyable<T>()) {
+            if (mapping.identical) {
+                objects.resize(first + (size_t)count);
+                if (count > 0) std::memcpy(objects.data() + first, in, (size_t)count * sizeof(T));
+                return true;
+            }
+        }
+
+        objects.reserve(first + (size_t)count);
+        for (uint64_t i = 0; i < count; i++) {
+            T& object = objects.emplace_back();
+            ReadPacked(object, in + i * mapping.packedSize, mapping);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Core/Defines.h"
+#include <atomic>
+#include <cstdint>
+
+namespace Cosmos
+{
+    /// @brief hands values from one producer thread to one consumer thread without either of them ever waiting on the other
+    /// the producer writes into it's own slot and publishes it, the consumer acquires the latest published slot and reads it
+    /// values published faster than they're acquired are dropped, so the consumer is never more than one value behind
+    template<typename T>
+    class TripleBuffer
+    {
+    public:
+
+        /// @brief constructor
+        TripleBuffer() = default;
+
+        /// @brief the slots are handed to two threads by index, they're not copyable
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    public:
+
+        /// @brief returns the slot the producer writes the next value into, the consumer never sees it until it's published
+        inline T& GetWriteSlot() { return mSlots[mWriteIndex]; }
+
+        /// @brief makes the write slot the latest value, the producer gets the unused slot back to write the next one
+        inline void Publish()
+        {
+            uint32_t previous = mMiddle.exchange(mWriteIndex | FRESH_BIT, std::memory_order_acq_rel);
+            mWriteIndex = previous & INDEX_MASK;
+        }
+
+        /// @brief returns if a value was published since the consumer last acquired one
+        inline bool HasPending() const { return (mMiddle.load(std::memory_order_acquire) & FRESH_BIT) != 0; }
+
+        /// @brief moves the consumer to the latest published value, returns false (keeping the current one) if nothing new was published
+        inline bool Acquire()
+        {
+            if (!HasPending()) return false;
+
+            uint32_t previous = mMiddle.exchange(mReadIndex, std::memory_order_acq_rel);
+            mReadIndex = previous & INDEX_MASK;
+            return true;
+        }
+
+        /// @brief returns the value the consumer holds, it stays untouched by the producer until the next acquire
+        inline T& GetReadSlot() { return mSlots[mReadIndex]; }
+
+        /// @brief returns all slots, only meant for setting up/releasing them while neither thread is using the buffer
+        inline T* GetSlots() { return mSlots; }
+
+        /// @brief how many slots there are
+        static constexpr uint32_t SLOT_COUNT = 3;
+
+    private:
+
+        static constexpr uint32_t INDEX_MASK = 3;
+        static constexpr uint32_t FRESH_BIT = 4;
+
+        T mSlots[SLOT_COUNT] = {};
+        uint32_t mWriteIndex = 0;           // producer only
+        std::atomic<uint32_t> mMiddle = 1;  // the slot in between, with FRESH_BIT while it holds an unacquired value
+        uint32_t mReadIndex = 2;            // consumer only
+    };
+}